@@ -127,6 +127,12 @@ enum ePF_FileCompare BKE_packedfile_compare_to_file(const char *ref_file_name,
 
 /* Read. */
 
+/**
+ * The data of a packed file, use it rather than #PackedFile.data which is null until the first
+ * access when reading the data from the blend-file was deferred (see
+ * #BLO_read_deferred_packed_data_set).
+ */
+const void *BKE_packedfile_data_get(const struct PackedFile *pf);
 int BKE_packedfile_seek(struct PackedFile *pf, int offset, int whence);
 void BKE_packedfile_rewind(struct PackedFile *pf);
 int BKE_packedfile_read(struct PackedFile *pf, void *data, int size);
@@ -42,6 +42,23 @@
 
 #include "BLO_read_write.hh"
 
+#include "CLG_log.h"
+
+static CLG_LogRef LOG = {"bke.packedfile"};
+
+const void *BKE_packedfile_data_get(const PackedFile *pf)
+{
+  if (UNLIKELY(pf->data == nullptr)) {
+    PackedFile *pf_mutable = const_cast<PackedFile *>(pf);
+    if (!BLO_read_deferred_data_ensure(&pf_mutable->data)) {
+      /* The whole code assumes the data is never null, see #BKE_packedfile_blend_read. */
+      CLOG_ERROR(&LOG, "unable to read deferred packed file data");
+      pf_mutable->data = MEM_callocN(size_t(pf->size), __func__);
+    }
+  }
+  return pf->data;
+}
+
 int BKE_packedfile_seek(PackedFile *pf, int offset, int whence)
 {
   int oldseek = -1, seek = 0;
@@ -87,7 +104,7 @@ int BKE_packedfile_read(PackedFile *pf, void *data, int size)
     }
 
     if (size > 0) {
-      memcpy(data, ((char *)pf->data) + pf->seek, size);
+      memcpy(data, ((const char *)BKE_packedfile_data_get(pf)) + pf->seek, size);
     }
     else {
       size = 0;
@@ -147,7 +164,10 @@ int BKE_packedfile_count_all(Main *bmain)
 void BKE_packedfile_free(PackedFile *pf)
 {
   if (pf) {
-    BLI_assert(pf->data != nullptr);
+    if (pf->data == nullptr) {
+      /* Deferred data which was never read. */
+      BLO_read_deferred_data_release(&pf->data);
+    }
 
     MEM_SAFE_FREE(pf->data);
     MEM_freeN(pf);
@@ -160,12 +180,11 @@ void BKE_packedfile_free(PackedFile *pf)
 PackedFile *BKE_packedfile_duplicate(const PackedFile *pf_src)
 {
   BLI_assert(pf_src != nullptr);
-  BLI_assert(pf_src->data != nullptr);
 
   PackedFile *pf_dst;
 
   pf_dst = static_cast<PackedFile *>(MEM_dupallocN(pf_src));
-  pf_dst->data = MEM_dupallocN(pf_src->data);
+  pf_dst->data = MEM_dupallocN(BKE_packedfile_data_get(pf_src));
 
   return pf_dst;
 }
@@ -334,7 +353,7 @@ int BKE_packedfile_write_to_file(ReportList *reports,
     ret_value = RET_ERROR;
   }
   else {
-    if (write(file, pf->data, pf->size) != pf->size) {
+    if (write(file, BKE_packedfile_data_get(pf), pf->size) != pf->size) {
       BKE_reportf(reports, RPT_ERROR, "Error writing file '%s'", filepath);
       ret_value = RET_ERROR;
     }
@@ -405,7 +424,7 @@ enum ePF_FileCompare BKE_packedfile_compare_to_file(const char *ref_file_name,
           break;
         }
 
-        if (memcmp(buf, ((const char *)pf->data) + i, len) != 0) {
+        if (memcmp(buf, ((const char *)BKE_packedfile_data_get(pf)) + i, len) != 0) {
           ret_val = PF_CMP_DIFFERS;
           break;
         }
@@ -514,7 +533,7 @@ static void unpack_generate_paths(const char *filepath,
       if (imapf != nullptr && imapf->packedfile != nullptr) {
         const PackedFile *pf = imapf->packedfile;
         enum eImbFileType ftype = eImbFileType(
-            IMB_ispic_type_from_memory((const uchar *)pf->data, pf->size));
+            IMB_ispic_type_from_memory((const uchar *)BKE_packedfile_data_get(pf), pf->size));
         if (ima->source == IMA_SRC_TILED) {
           char tile_number[6];
           SNPRINTF(tile_number, ".%d", imapf->tile_number);
@@ -885,8 +904,10 @@ void BKE_packedfile_blend_write(BlendWriter *writer, const PackedFile *pf)
   if (pf == nullptr) {
     return;
   }
+  /* Before writing the struct, to write the address of deferred data once read. */
+  const void *data = BKE_packedfile_data_get(pf);
   BLO_write_struct(writer, PackedFile, pf);
-  BLO_write_raw(writer, pf->size, pf->data);
+  BLO_write_raw(writer, pf->size, data);
 }
 
 void BKE_packedfile_blend_read(BlendDataReader *reader, PackedFile **pf_p)
@@ -897,6 +918,10 @@ void BKE_packedfile_blend_read(BlendDataReader *reader, PackedFile **pf_p)
     return;
   }
 
+  if (BLO_read_deferred_packed_address(reader, &pf->data)) {
+    /* Read on first access by #BKE_packedfile_data_get. */
+    return;
+  }
   BLO_read_packed_address(reader, &pf->data);
   if (pf->data == nullptr) {
     /* We cannot allow a PackedFile with a nullptr data field,
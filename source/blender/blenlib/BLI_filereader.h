@@ -32,12 +32,18 @@ struct FileReader;
 typedef int64_t (*FileReaderReadFn)(struct FileReader *reader, void *buffer, size_t size);
 typedef off64_t (*FileReaderSeekFn)(struct FileReader *reader, off64_t offset, int whence);
 typedef void (*FileReaderCloseFn)(struct FileReader *reader);
+typedef void (*FileReaderReleaseCacheFn)(struct FileReader *reader);
 
 /** General structure for all #FileReaders, implementations add custom fields at the end. */
 typedef struct FileReader {
   FileReaderReadFn read;
   FileReaderSeekFn seek;
   FileReaderCloseFn close;
+  /**
+   * Optional, frees the memory used to speed up sequential reads, for a reader kept open for a
+   * few random reads. The reader stays usable.
+   */
+  FileReaderReleaseCacheFn release_cache;
 
   off64_t offset;
 } FileReader;
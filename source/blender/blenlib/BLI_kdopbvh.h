@@ -15,9 +15,11 @@ extern "C" {
 #endif
 
 struct BVHTree;
+struct BVHTreeFlat;
 struct DistProjectedAABBPrecalc;
 
 typedef struct BVHTree BVHTree;
+typedef struct BVHTreeFlat BVHTreeFlat;
 #define USE_KDOPBVH_WATERTIGHT
 
 typedef struct BVHTreeAxisRange {
@@ -90,6 +92,8 @@ enum {
 };
 #define BVH_RAYCAST_DEFAULT (BVH_RAYCAST_WATERTIGHT)
 #define BVH_RAYCAST_DIST_MAX (FLT_MAX / 2.0f)
+/** Maximum number of rays of #BLI_bvhtree_ray_cast_packet. */
+#define BVH_RAYCAST_PACKET_MAX 16
 
 /**
  * Callback must update nearest in case it finds a nearest result.
@@ -153,6 +157,28 @@ bool BLI_bvhtree_update_node(
  */
 void BLI_bvhtree_update_tree(BVHTree *tree);
 
+/**
+ * Serialize a balanced tree in a compact position independent layout (bounding volumes, node
+ * links as indices), typically written to a file and memory mapped later on.
+ *
+ * \param buffer: Memory of at least #BLI_bvhtree_serialize_size bytes, aligned to 8 bytes.
+ */
+size_t BLI_bvhtree_serialize_size(const BVHTree *tree);
+void BLI_bvhtree_serialize(const BVHTree *tree, void *buffer);
+/**
+ * Create a read-only tree from a buffer written by #BLI_bvhtree_serialize. The bounding volumes
+ * are used in place, only the node links are allocated, so the buffer (e.g. from #BLI_mmap_open)
+ * must outlive the tree. Insert and update functions must not be used on the tree, free it with
+ * #BLI_bvhtree_free.
+ *
+ * \param r_index_range: Optional, the smallest and largest index of the leafs ({0, -1} without
+ * leafs). The indices aren't validated, the caller can check them against its own data.
+ * \return NULL when the buffer isn't a valid serialized tree.
+ */
+BVHTree *BLI_bvhtree_new_from_buffer(const void *buffer,
+                                     size_t buffer_size,
+                                     int r_index_range[2]);
+
 /**
  * Use to check the total number of threads #BLI_bvhtree_overlap will use.
  *
@@ -272,6 +298,32 @@ void BLI_bvhtree_ray_cast_all(const BVHTree *tree,
                               BVHTree_RayCastCallback callback,
                               void *userdata);
 
+/**
+ * Flattened copy of a balanced tree used by packet ray-casts, the x, y and z bounds of the nodes
+ * are stored in a cache aligned array with the children of each node contiguous.
+ *
+ * \note The copy doesn't follow #BLI_bvhtree_update_tree, create it again after an update.
+ */
+BVHTreeFlat *BLI_bvhtree_flat_new(const BVHTree *tree);
+void BLI_bvhtree_flat_free(BVHTreeFlat *flat);
+
+/**
+ * Cast up to #BVH_RAYCAST_PACKET_MAX rays together, typically 4, 8 or 16 coherent rays
+ * (close origins and directions, e.g. neighbor pixels or texels). The results are the same as
+ * one #BLI_bvhtree_ray_cast_ex per ray, a packet with different direction signs is cast
+ * one ray at a time.
+ *
+ * \param hits: One hit per ray, initialized like the hit of #BLI_bvhtree_ray_cast_ex
+ * (index -1 and the maximum distance of the ray).
+ */
+void BLI_bvhtree_ray_cast_packet(const BVHTreeFlat *flat,
+                                 const BVHTreeRay *rays,
+                                 BVHTreeRayHit *hits,
+                                 int ray_num,
+                                 BVHTree_RayCastCallback callback,
+                                 void *userdata,
+                                 int flag);
+
 float BLI_bvhtree_bb_raycast(const float bv[6],
                              const float light_start[3],
                              const float light_end[3],
@@ -69,6 +69,24 @@ int BLI_kdtree_nd_(calc_duplicates_fast)(const KDTree *tree,
 
 int BLI_kdtree_nd_(deduplicate)(KDTree *tree);
 
+/**
+ * Serialize a balanced tree, the nodes only link each other by index so a buffer written to a
+ * file can be memory mapped and searched in place.
+ *
+ * \param buffer: Memory of at least #BLI_kdtree_nd_(serialize_size) bytes, aligned to 4 bytes.
+ */
+size_t BLI_kdtree_nd_(serialize_size)(const KDTree *tree) ATTR_NONNULL(1);
+void BLI_kdtree_nd_(serialize)(const KDTree *tree, void *buffer) ATTR_NONNULL(1, 2);
+/**
+ * Create a read-only tree using the nodes of a buffer written by #BLI_kdtree_nd_(serialize) in
+ * place, the buffer (e.g. from #BLI_mmap_open) must outlive the tree. Insert, balance and
+ * deduplicate must not be used on the tree, free it with #BLI_kdtree_nd_(free).
+ *
+ * \return NULL when the buffer isn't a valid serialized tree of the same dimension.
+ */
+KDTree *BLI_kdtree_nd_(new_from_buffer)(const void *buffer, size_t buffer_size)
+    ATTR_NONNULL(1) ATTR_WARN_UNUSED_RESULT;
+
 /** Versions of find/range search that take a squared distance callback to support bias. */
 int BLI_kdtree_nd_(find_nearest_n_with_len_squared_cb)(
     const KDTree *tree,
@@ -15,12 +15,16 @@
  *
  * - Ray-cast:
  *   #BLI_bvhtree_ray_cast, #BVHRayCastData
+ * - Packet ray-cast:
+ *   #BLI_bvhtree_ray_cast_packet, #BVHRayPacketData
  * - Nearest point on surface:
  *   #BLI_bvhtree_find_nearest, #BVHNearestData
  * - Overlapping 2 trees:
  *   #BLI_bvhtree_overlap, #BVHOverlapData_Shared, #BVHOverlapData_Thread
  * - Range Query:
  *   #BLI_bvhtree_range_query
+ * - Serialization:
+ *   #BLI_bvhtree_serialize, #BLI_bvhtree_new_from_buffer
  */
 
 #include "MEM_guardedalloc.h"
@@ -860,6 +864,37 @@ static void non_recursive_bvh_div_nodes(const BVHTree *tree,
 /** \name BLI_bvhtree API
  * \{ */
 
+/**
+ * Range of #bvhtree_kdop_axes used by a KDOP type.
+ */
+static bool bvhtree_kdop_axes_range(int axis, axis_t *r_start_axis, axis_t *r_stop_axis)
+{
+  if (axis == 26) {
+    *r_start_axis = 0;
+    *r_stop_axis = 13;
+  }
+  else if (axis == 18) {
+    *r_start_axis = 7;
+    *r_stop_axis = 13;
+  }
+  else if (axis == 14) {
+    *r_start_axis = 0;
+    *r_stop_axis = 7;
+  }
+  else if (axis == 8) { /* AABB */
+    *r_start_axis = 0;
+    *r_stop_axis = 4;
+  }
+  else if (axis == 6) { /* OBB */
+    *r_start_axis = 0;
+    *r_stop_axis = 3;
+  }
+  else {
+    return false;
+  }
+  return true;
+}
+
 BVHTree *BLI_bvhtree_new(int maxsize, float epsilon, char tree_type, char axis)
 {
   BVHTree *tree;
@@ -880,27 +915,7 @@ BVHTree *BLI_bvhtree_new(int maxsize, float epsilon, char tree_type, char axis)
     tree->tree_type = tree_type;
     tree->axis = axis;
 
-    if (axis == 26) {
-      tree->start_axis = 0;
-      tree->stop_axis = 13;
-    }
-    else if (axis == 18) {
-      tree->start_axis = 7;
-      tree->stop_axis = 13;
-    }
-    else if (axis == 14) {
-      tree->start_axis = 0;
-      tree->stop_axis = 7;
-    }
-    else if (axis == 8) { /* AABB */
-      tree->start_axis = 0;
-      tree->stop_axis = 4;
-    }
-    else if (axis == 6) { /* OBB */
-      tree->start_axis = 0;
-      tree->stop_axis = 3;
-    }
-    else {
+    if (!bvhtree_kdop_axes_range(axis, &tree->start_axis, &tree->stop_axis)) {
       /* should never happen! */
       BLI_assert_unreachable();
 
@@ -1008,6 +1023,9 @@ bool BLI_bvhtree_update_node(
 {
   BVHNode *node = NULL;
 
+  /* Trees from a buffer are read-only. */
+  BLI_assert(tree->nodebv != NULL);
+
   /* check if index exists */
   if (index > tree->leaf_num) {
     return false;
@@ -1033,6 +1051,8 @@ void BLI_bvhtree_update_tree(BVHTree *tree)
    * TRICKY: the way we build the tree all the children have an index greater than the parent
    * This allows us todo a bottom up update by starting on the bigger numbered branch. */
 
+  BLI_assert(tree->nodebv != NULL);
+
   BVHNode **root = tree->nodes + tree->leaf_num;
   BVHNode **index = tree->nodes + tree->leaf_num + tree->branch_num - 1;
 
@@ -1073,6 +1093,267 @@ void BLI_bvhtree_get_bounding_box(const BVHTree *tree, float r_bb_min[3], float
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name BLI_bvhtree_serialize
+ *
+ * A serialized tree is a header followed by the bounding volumes, the nodes, the children of the
+ * nodes and the order of the leafs, the links are indices in the node array. Each array is
+ * aligned to 8 bytes and stored in the native byte order, a buffer written with another byte
+ * order is rejected by its magic number.
+ * \{ */
+
+#define BVH_SERIAL_MAGIC 0x54485642 /* "BVHT" in little endian. */
+#define BVH_SERIAL_VERSION 1
+
+#define BVH_SERIAL_ALIGN(size) (((size) + 7) & ~(size_t)7)
+
+/**
+ * Queries recurse down the tree, deeper trees are rejected. Balanced trees are much shallower,
+ * the number of leafs is limited to less than 2^27.
+ */
+#define BVH_SERIAL_MAX_DEPTH 64
+
+typedef struct BVHSerialHeader {
+  uint magic;
+  uint version;
+  /** Size of the serialized tree in bytes. */
+  uint64_t size;
+  int leaf_num;
+  int branch_num;
+  float epsilon;
+  char tree_type;
+  axis_t axis, start_axis, stop_axis;
+} BVHSerialHeader;
+
+BLI_STATIC_ASSERT(sizeof(BVHSerialHeader) == 32, "unexpected padding")
+
+typedef struct BVHSerialNode {
+  int index;
+  /** -1 for the root. */
+  int parent;
+  uchar node_num;
+  uchar main_axis;
+  char _pad[2];
+} BVHSerialNode;
+
+typedef struct BVHSerialLayout {
+  size_t bv, nodes, children, leafs, size;
+} BVHSerialLayout;
+
+static void bvhtree_serial_layout(
+    int node_num, int leaf_num, int tree_type, int axis, BVHSerialLayout *r_layout)
+{
+  size_t ofs = sizeof(BVHSerialHeader);
+  r_layout->bv = ofs;
+  ofs = BVH_SERIAL_ALIGN(ofs + sizeof(float) * (size_t)node_num * (size_t)axis);
+  r_layout->nodes = ofs;
+  ofs = BVH_SERIAL_ALIGN(ofs + sizeof(BVHSerialNode) * (size_t)node_num);
+  r_layout->children = ofs;
+  ofs = BVH_SERIAL_ALIGN(ofs + sizeof(int) * (size_t)node_num * (size_t)tree_type);
+  r_layout->leafs = ofs;
+  ofs = BVH_SERIAL_ALIGN(ofs + sizeof(int) * (size_t)leaf_num);
+  r_layout->size = ofs;
+}
+
+size_t BLI_bvhtree_serialize_size(const BVHTree *tree)
+{
+  BVHSerialLayout layout;
+  bvhtree_serial_layout(
+      tree->leaf_num + tree->branch_num, tree->leaf_num, tree->tree_type, tree->axis, &layout);
+  return layout.size;
+}
+
+void BLI_bvhtree_serialize(const BVHTree *tree, void *buffer)
+{
+  /* Only balanced trees are supported. */
+  BLI_assert(tree->branch_num > 0);
+
+  const int node_num = tree->leaf_num + tree->branch_num;
+  const int tree_type = tree->tree_type;
+  BVHSerialLayout layout;
+  bvhtree_serial_layout(node_num, tree->leaf_num, tree_type, tree->axis, &layout);
+
+  /* Clear the padding bytes, the same tree always gives the same buffer. */
+  memset(buffer, 0, layout.size);
+
+  BVHSerialHeader *header = buffer;
+  header->magic = BVH_SERIAL_MAGIC;
+  header->version = BVH_SERIAL_VERSION;
+  header->size = layout.size;
+  header->leaf_num = tree->leaf_num;
+  header->branch_num = tree->branch_num;
+  header->epsilon = tree->epsilon;
+  header->tree_type = tree->tree_type;
+  header->axis = tree->axis;
+  header->start_axis = tree->start_axis;
+  header->stop_axis = tree->stop_axis;
+
+  float *bv = POINTER_OFFSET(buffer, layout.bv);
+  BVHSerialNode *nodes = POINTER_OFFSET(buffer, layout.nodes);
+  int *children = POINTER_OFFSET(buffer, layout.children);
+  int *leafs = POINTER_OFFSET(buffer, layout.leafs);
+
+  for (int i = 0; i < node_num; i++) {
+    const BVHNode *node = &tree->nodearray[i];
+    memcpy(&bv[i * tree->axis], node->bv, sizeof(float) * (size_t)tree->axis);
+
+    nodes[i].index = node->index;
+    nodes[i].parent = node->parent ? (int)(node->parent - tree->nodearray) : -1;
+    nodes[i].node_num = (uchar)node->node_num;
+    nodes[i].main_axis = (uchar)node->main_axis;
+
+    for (int j = 0; j < tree_type; j++) {
+      children[i * tree_type + j] = (j < node->node_num) ?
+                                        (int)(node->children[j] - tree->nodearray) :
+                                        -1;
+    }
+  }
+
+  /* The leafs are sorted by the balance, keep the order of #BVHTree.nodes. */
+  for (int i = 0; i < tree->leaf_num; i++) {
+    leafs[i] = (int)(tree->nodes[i] - tree->nodearray);
+  }
+}
+
+BVHTree *BLI_bvhtree_new_from_buffer(const void *buffer,
+                                     size_t buffer_size,
+                                     int r_index_range[2])
+{
+  const BVHSerialHeader *header = buffer;
+  if (buffer_size < sizeof(*header) || header->magic != BVH_SERIAL_MAGIC ||
+      header->version != BVH_SERIAL_VERSION)
+  {
+    return NULL;
+  }
+
+  const int tree_type = header->tree_type;
+  const int leaf_num = header->leaf_num;
+  axis_t start_axis, stop_axis;
+  if (tree_type < 2 || tree_type > MAX_TREETYPE || leaf_num < 0 ||
+      leaf_num > INT_MAX / (2 * MAX_TREETYPE) ||
+      header->branch_num != implicit_needed_branches(tree_type, leaf_num) ||
+      !bvhtree_kdop_axes_range(header->axis, &start_axis, &stop_axis) ||
+      header->start_axis != start_axis || header->stop_axis != stop_axis)
+  {
+    return NULL;
+  }
+
+  const int node_num = leaf_num + header->branch_num;
+  BVHSerialLayout layout;
+  bvhtree_serial_layout(node_num, leaf_num, tree_type, header->axis, &layout);
+  if (header->size != layout.size || layout.size > buffer_size) {
+    return NULL;
+  }
+
+  /* The bounding volumes are only read, trees from a buffer can't be updated. */
+  float *bv = (float *)POINTER_OFFSET(buffer, layout.bv);
+  const BVHSerialNode *nodes = POINTER_OFFSET(buffer, layout.nodes);
+  const int *children = POINTER_OFFSET(buffer, layout.children);
+  const int *leafs = POINTER_OFFSET(buffer, layout.leafs);
+
+  BVHTree *tree = MEM_callocN(sizeof(BVHTree), "BVHTree");
+  tree->epsilon = header->epsilon;
+  tree->leaf_num = leaf_num;
+  tree->branch_num = header->branch_num;
+  tree->start_axis = start_axis;
+  tree->stop_axis = stop_axis;
+  tree->axis = header->axis;
+  tree->tree_type = header->tree_type;
+
+  /* #BVHTree.nodebv stays NULL, the bounding volumes aren't owned by the tree. */
+  tree->nodes = MEM_malloc_arrayN((size_t)node_num, sizeof(BVHNode *), "BVHNodes");
+  tree->nodechild = MEM_calloc_arrayN(
+      (size_t)node_num * (size_t)tree_type, sizeof(BVHNode *), "BVHNodeBV");
+  tree->nodearray = MEM_calloc_arrayN((size_t)node_num, sizeof(BVHNode), "BVHNodeArray");
+
+  /* Validate the links while restoring the pointers, so a corrupted buffer can't make a query
+   * read out of bounds, loop forever or overflow the stack:
+   * - Leafs have no children, branches have children except the root of an empty tree.
+   * - The children of a branch are leafs or branches after it.
+   * - Every node but the root is the child of exactly one branch, its parent.
+   * - The depth of the tree is bounded.
+   *
+   * Branches are only referenced by branches before them, so the depth of a branch is known
+   * once it is reached. */
+  int *depths = MEM_malloc_arrayN((size_t)node_num, sizeof(int), __func__);
+  for (int i = 0; i < node_num; i++) {
+    depths[i] = -1;
+  }
+  depths[leaf_num] = 0;
+
+  int index_range[2] = {INT_MAX, INT_MIN};
+  for (int i = 0; i < node_num; i++) {
+    BVHNode *node = &tree->nodearray[i];
+    const BVHSerialNode *node_src = &nodes[i];
+    const bool is_leaf = i < leaf_num;
+    const bool is_root = i == leaf_num;
+
+    if (node_src->node_num > tree_type || (is_leaf && node_src->node_num != 0) ||
+        node_src->main_axis >= 13 || (is_root && node_src->parent != -1))
+    {
+      goto fail;
+    }
+    if (!is_leaf) {
+      if (depths[i] == -1) {
+        goto fail;
+      }
+      if (node_src->node_num == 0 && !(leaf_num == 0 && node_src->index == 0)) {
+        goto fail;
+      }
+    }
+
+    node->bv = &bv[i * header->axis];
+    node->children = &tree->nodechild[i * tree_type];
+    node->parent = (node_src->parent != -1) ? &tree->nodearray[node_src->parent] : NULL;
+    node->index = node_src->index;
+    node->node_num = (char)node_src->node_num;
+    node->main_axis = (char)node_src->main_axis;
+    if (is_leaf) {
+      index_range[0] = min_ii(index_range[0], node->index);
+      index_range[1] = max_ii(index_range[1], node->index);
+    }
+
+    for (int j = 0; j < node->node_num; j++) {
+      const int child = children[i * tree_type + j];
+      if (!((child >= 0 && child < leaf_num) || (child > i && child < node_num)) ||
+          depths[child] != -1 || nodes[child].parent != i || depths[i] >= BVH_SERIAL_MAX_DEPTH)
+      {
+        goto fail;
+      }
+      depths[child] = depths[i] + 1;
+      node->children[j] = &tree->nodearray[child];
+    }
+  }
+
+  for (int i = 0; i < leaf_num; i++) {
+    if (depths[i] == -1 || leafs[i] < 0 || leafs[i] >= leaf_num) {
+      goto fail;
+    }
+    tree->nodes[i] = &tree->nodearray[leafs[i]];
+  }
+  MEM_freeN(depths);
+  for (int i = leaf_num; i < node_num; i++) {
+    tree->nodes[i] = &tree->nodearray[i];
+  }
+
+#ifdef USE_SKIP_LINKS
+  build_skip_links(tree, tree->nodes[tree->leaf_num], NULL, NULL);
+#endif
+
+  if (r_index_range) {
+    r_index_range[0] = (leaf_num != 0) ? index_range[0] : 0;
+    r_index_range[1] = (leaf_num != 0) ? index_range[1] : -1;
+  }
+  return tree;
+
+fail:
+  MEM_freeN(depths);
+  BLI_bvhtree_free(tree);
+  return NULL;
+}
+
+/** \} */
+
 /* -------------------------------------------------------------------- */
 /** \name BLI_bvhtree_overlap
  * \{ */
@@ -2119,6 +2400,323 @@ void BLI_bvhtree_ray_cast_all(const BVHTree *tree,
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name BLI_bvhtree_ray_cast_packet
+ *
+ * The rays of a packet traverse together a flattened copy of the tree. The slab tests of all
+ * the rays against a node are written as a branchless loop over the lanes of the packet,
+ * which the compiler vectorizes.
+ *
+ * \{ */
+
+typedef struct BVHFlatNode {
+  float min[3];
+  float max[3];
+  /** Index of the first child in the flat array for branches, user index for leafs. */
+  int index;
+  /** Number of children, zero for leafs. */
+  uchar node_num;
+  uchar main_axis;
+} BVHFlatNode;
+
+/* optimization, two nodes per cache line */
+BLI_STATIC_ASSERT(sizeof(BVHFlatNode) == 32, "wrong size")
+
+struct BVHTreeFlat {
+  /** Used by incoherent rays. */
+  const BVHTree *tree;
+  /** Breadth first order, the children of a node are contiguous. */
+  BVHFlatNode *nodes;
+  int node_num;
+  /** Maximum number of nodes on the traversal stack. */
+  int stack_size;
+};
+
+typedef struct BVHRayPacketData {
+  const BVHTreeFlat *flat;
+
+  BVHTree_RayCastCallback callback;
+  void *userdata;
+
+  const BVHTreeRay *rays;
+  BVHTreeRayHit *hits;
+
+  /** Number of rays rounded up to a multiple of 4, extra lanes never hit. */
+  int lane_num;
+  /** Common sign of the ray directions. */
+  bool dir_positive[3];
+
+  /* Rays in structure of arrays for the slab tests. */
+  float origin[3][BVH_RAYCAST_PACKET_MAX];
+  float idot_axis[3][BVH_RAYCAST_PACKET_MAX];
+  float radius[BVH_RAYCAST_PACKET_MAX];
+  float dist[BVH_RAYCAST_PACKET_MAX];
+} BVHRayPacketData;
+
+BVHTreeFlat *BLI_bvhtree_flat_new(const BVHTree *tree)
+{
+  BVHTreeFlat *flat = MEM_callocN(sizeof(BVHTreeFlat), __func__);
+  flat->tree = tree;
+
+  if (tree->leaf_num == 0 || tree->branch_num == 0) {
+    return flat;
+  }
+
+  const int node_max = tree->leaf_num + tree->branch_num;
+  const BVHNode **queue = MEM_malloc_arrayN((size_t)node_max, sizeof(*queue), __func__);
+  int *depth = MEM_malloc_arrayN((size_t)node_max, sizeof(*depth), __func__);
+  flat->nodes = MEM_mallocN_aligned(sizeof(BVHFlatNode) * (size_t)node_max, 64, __func__);
+
+  queue[0] = tree->nodes[tree->leaf_num];
+  depth[0] = 0;
+  int node_num = 1;
+  int depth_max = 0;
+
+  for (int i = 0; i < node_num; i++) {
+    const BVHNode *node = queue[i];
+    BVHFlatNode *flat_node = &flat->nodes[i];
+
+    for (int axis = 0; axis < 3; axis++) {
+      flat_node->min[axis] = node->bv[2 * axis];
+      flat_node->max[axis] = node->bv[2 * axis + 1];
+    }
+    flat_node->node_num = (uchar)node->node_num;
+    flat_node->main_axis = (uchar)node->main_axis;
+
+    if (node->node_num == 0) {
+      flat_node->index = node->index;
+      continue;
+    }
+
+    flat_node->index = node_num;
+    for (int j = 0; j < node->node_num; j++) {
+      BLI_assert(node_num < node_max);
+      queue[node_num] = node->children[j];
+      depth[node_num] = depth[i] + 1;
+      node_num++;
+    }
+    depth_max = max_ii(depth_max, depth[i] + 1);
+  }
+
+  flat->node_num = node_num;
+  /* Each level replaces the popped node by its children. */
+  flat->stack_size = depth_max * (tree->tree_type - 1) + 1;
+
+  MEM_freeN(queue);
+  MEM_freeN(depth);
+
+  return flat;
+}
+
+void BLI_bvhtree_flat_free(BVHTreeFlat *flat)
+{
+  if (flat) {
+    MEM_SAFE_FREE(flat->nodes);
+    MEM_freeN(flat);
+  }
+}
+
+/**
+ * Check the rays have the same direction signs, near zero components match any sign.
+ */
+static bool ray_packet_is_coherent(const BVHTreeRay *rays, int ray_num, bool r_dir_positive[3])
+{
+  for (int axis = 0; axis < 3; axis++) {
+    bool positive = false, negative = false;
+    for (int i = 0; i < ray_num; i++) {
+      const float dir = rays[i].direction[axis];
+      positive |= (dir >= FLT_EPSILON);
+      negative |= (dir <= -FLT_EPSILON);
+    }
+    if (positive && negative) {
+      return false;
+    }
+    r_dir_positive[axis] = !negative;
+  }
+  return true;
+}
+
+/**
+ * Slab test of all the lanes against a node, same as #fast_ray_nearest_hit and
+ * #ray_nearest_hit for the lanes with a radius.
+ * \return The bit mask of the lanes hitting the node closer than their current hit.
+ */
+static uint ray_packet_node_test(const BVHRayPacketData *data,
+                                 const BVHFlatNode *node,
+                                 float r_dist[BVH_RAYCAST_PACKET_MAX])
+{
+  float tnear[BVH_RAYCAST_PACKET_MAX];
+  float tfar[BVH_RAYCAST_PACKET_MAX];
+  const int lane_num = data->lane_num;
+
+  for (int l = 0; l < lane_num; l++) {
+    const float radius = data->radius[l];
+    const float t1x = (node->min[0] - radius - data->origin[0][l]) * data->idot_axis[0][l];
+    const float t2x = (node->max[0] + radius - data->origin[0][l]) * data->idot_axis[0][l];
+    const float t1y = (node->min[1] - radius - data->origin[1][l]) * data->idot_axis[1][l];
+    const float t2y = (node->max[1] + radius - data->origin[1][l]) * data->idot_axis[1][l];
+    const float t1z = (node->min[2] - radius - data->origin[2][l]) * data->idot_axis[2][l];
+    const float t2z = (node->max[2] + radius - data->origin[2][l]) * data->idot_axis[2][l];
+
+    tnear[l] = max_ff(max_ff(min_ff(t1x, t2x), min_ff(t1y, t2y)), min_ff(t1z, t2z));
+    tfar[l] = min_ff(min_ff(max_ff(t1x, t2x), max_ff(t1y, t2y)), max_ff(t1z, t2z));
+  }
+
+  uint mask = 0;
+  for (int l = 0; l < lane_num; l++) {
+    const bool hit = (tnear[l] <= tfar[l]) && (tfar[l] >= 0.0f) && (tnear[l] < data->dist[l]);
+    mask |= (uint)hit << l;
+    /* Like #ray_nearest_hit, a ray with a radius starting inside the node hits it at zero. */
+    r_dist[l] = (data->radius[l] != 0.0f) ? max_ff(tnear[l], 0.0f) : tnear[l];
+  }
+
+  return mask;
+}
+
+static void ray_packet_leaf(BVHRayPacketData *data,
+                            int index,
+                            uint mask,
+                            const float dist[BVH_RAYCAST_PACKET_MAX])
+{
+  for (int l = 0; mask != 0; l++, mask >>= 1) {
+    if ((mask & 1) == 0) {
+      continue;
+    }
+
+    const BVHTreeRay *ray = &data->rays[l];
+    BVHTreeRayHit *hit = &data->hits[l];
+    if (data->callback) {
+      data->callback(data->userdata, index, ray, hit);
+    }
+    else {
+      hit->index = index;
+      hit->dist = dist[l];
+      madd_v3_v3v3fl(hit->co, ray->origin, ray->direction, dist[l]);
+    }
+    data->dist[l] = hit->dist;
+  }
+}
+
+static void ray_packet_traverse(BVHRayPacketData *data)
+{
+  const BVHFlatNode *nodes = data->flat->nodes;
+  int *stack = BLI_array_alloca(stack, (size_t)data->flat->stack_size);
+  int stack_len = 0;
+  float dist[BVH_RAYCAST_PACKET_MAX];
+
+  stack[stack_len++] = 0;
+  while (stack_len > 0) {
+    const BVHFlatNode *node = &nodes[stack[--stack_len]];
+    const uint mask = ray_packet_node_test(data, node, dist);
+    if (mask == 0) {
+      continue;
+    }
+
+    if (node->node_num == 0) {
+      ray_packet_leaf(data, node->index, mask, dist);
+      continue;
+    }
+
+    /* Push the children so the first along the ray directions is popped first. */
+    if (data->dir_positive[node->main_axis]) {
+      for (int i = node->node_num - 1; i >= 0; i--) {
+        stack[stack_len++] = node->index + i;
+      }
+    }
+    else {
+      for (int i = 0; i < node->node_num; i++) {
+        stack[stack_len++] = node->index + i;
+      }
+    }
+    BLI_assert(stack_len <= data->flat->stack_size);
+  }
+}
+
+void BLI_bvhtree_ray_cast_packet(const BVHTreeFlat *flat,
+                                 const BVHTreeRay *rays,
+                                 BVHTreeRayHit *hits,
+                                 int ray_num,
+                                 BVHTree_RayCastCallback callback,
+                                 void *userdata,
+                                 int flag)
+{
+  BLI_assert(ray_num >= 0 && ray_num <= BVH_RAYCAST_PACKET_MAX);
+
+  if (flat->node_num == 0 || ray_num == 0) {
+    return;
+  }
+
+  BVHRayPacketData data;
+
+  /* Incoherent rays would traverse most of the tree for each other, cast them one by one. */
+  if (!ray_packet_is_coherent(rays, ray_num, data.dir_positive)) {
+    for (int i = 0; i < ray_num; i++) {
+      BLI_bvhtree_ray_cast_ex(flat->tree,
+                              rays[i].origin,
+                              rays[i].direction,
+                              rays[i].radius,
+                              &hits[i],
+                              callback,
+                              userdata,
+                              flag);
+    }
+    return;
+  }
+
+  BVHTreeRay packet_rays[BVH_RAYCAST_PACKET_MAX];
+#ifdef USE_KDOPBVH_WATERTIGHT
+  struct IsectRayPrecalc isect_precalc[BVH_RAYCAST_PACKET_MAX];
+#else
+  UNUSED_VARS(flag);
+#endif
+
+  data.flat = flat;
+  data.callback = callback;
+  data.userdata = userdata;
+  data.rays = packet_rays;
+  data.hits = hits;
+  data.lane_num = (ray_num + 3) & ~3;
+
+  for (int l = 0; l < data.lane_num; l++) {
+    if (l >= ray_num) {
+      /* Padding lane, never closer than its hit. */
+      for (int axis = 0; axis < 3; axis++) {
+        data.origin[axis][l] = 0.0f;
+        data.idot_axis[axis][l] = 1.0f;
+      }
+      data.radius[l] = 0.0f;
+      data.dist[l] = -FLT_MAX;
+      continue;
+    }
+
+    const BVHTreeRay *ray = &rays[l];
+    BLI_ASSERT_UNIT_V3(ray->direction);
+
+    packet_rays[l] = *ray;
+#ifdef USE_KDOPBVH_WATERTIGHT
+    if (flag & BVH_RAYCAST_WATERTIGHT) {
+      isect_ray_tri_watertight_v3_precalc(&isect_precalc[l], ray->direction);
+      packet_rays[l].isect_precalc = &isect_precalc[l];
+    }
+    else {
+      packet_rays[l].isect_precalc = NULL;
+    }
+#endif
+
+    for (int axis = 0; axis < 3; axis++) {
+      const float dir = ray->direction[axis];
+      data.origin[axis][l] = ray->origin[axis];
+      data.idot_axis[axis][l] = (fabsf(dir) < FLT_EPSILON) ? FLT_MAX : 1.0f / dir;
+    }
+    data.radius[l] = ray->radius;
+    data.dist[l] = hits[l].dist;
+  }
+
+  ray_packet_traverse(&data);
+}
+
+/** \} */
+
 /* -------------------------------------------------------------------- */
 /** \name BLI_bvhtree_range_query
  *
@@ -11,10 +11,32 @@
 
 #include "BLI_filereader.h"
 #include "BLI_math_base.h"
+#include "BLI_task.h"
+#include "BLI_threads.h"
 
 #include "MEM_guardedalloc.h"
 
-typedef struct {
+/** Maximum number of frames decompressed ahead of the read position. */
+#define ZSTD_PREFETCH_FRAMES_MAX 16
+
+typedef enum eZstdFrameSlotState {
+  ZSTD_SLOT_EMPTY = 0,
+  /** A task is pushed to decompress the frame, it may also be taken by the reading thread. */
+  ZSTD_SLOT_QUEUED,
+  ZSTD_SLOT_RUNNING,
+  ZSTD_SLOT_DONE,
+} eZstdFrameSlotState;
+
+/** Frame of the read-ahead window, frame `i` uses the slot `i % slots_num`. */
+typedef struct ZstdFrameSlot {
+  int frame;
+  eZstdFrameSlotState state;
+  /** Set when #ZSTD_SLOT_DONE, NULL if the frame couldn't be read. */
+  char *content;
+  ZSTD_DCtx *ctx;
+} ZstdFrameSlot;
+
+typedef struct ZstdReader {
   FileReader reader;
 
   FileReader *base;
@@ -31,6 +53,21 @@ typedef struct {
     char *cached_content;
     int cached_frame;
   } seek;
+
+  /**
+   * Frames after the read position are decompressed in parallel when reading sequentially,
+   * only used by seekable files when the task scheduler has multiple threads.
+   */
+  struct {
+    TaskPool *pool;
+    ZstdFrameSlot *slots;
+    int slots_num;
+    /** Protects the state of the slots. */
+    ThreadMutex mutex;
+    ThreadCondition cond;
+    /** Protects the base reader, used by all the threads. */
+    ThreadMutex base_mutex;
+  } prefetch;
 } ZstdReader;
 
 static bool zstd_read_u32(FileReader *base, uint32_t *val)
@@ -153,39 +190,161 @@ static int zstd_frame_from_pos(ZstdReader *zstd, size_t pos)
   return low;
 }
 
-/* Ensure that the currently loaded frame is the correct one. */
-static const char *zstd_ensure_cache(ZstdReader *zstd, int frame)
+/* Read and decompress a frame, returns NULL on error. */
+static char *zstd_frame_decompress(ZstdReader *zstd, ZSTD_DCtx *ctx, int frame)
 {
-  if (zstd->seek.cached_frame == frame) {
-    /* Cached frame matches, so just return it. */
-    return zstd->seek.cached_content;
-  }
-
-  /* Cached frame doesn't match, so discard it and cache the wanted one instead. */
-  MEM_SAFE_FREE(zstd->seek.cached_content);
-
   size_t compressed_size = zstd->seek.compressed_ofs[frame + 1] - zstd->seek.compressed_ofs[frame];
   size_t uncompressed_size = zstd->seek.uncompressed_ofs[frame + 1] -
                              zstd->seek.uncompressed_ofs[frame];
 
   char *uncompressed_data = MEM_mallocN(uncompressed_size, __func__);
   char *compressed_data = MEM_mallocN(compressed_size, __func__);
-  if (zstd->base->seek(zstd->base, zstd->seek.compressed_ofs[frame], SEEK_SET) < 0 ||
-      zstd->base->read(zstd->base, compressed_data, compressed_size) < compressed_size)
-  {
+
+  if (zstd->prefetch.pool) {
+    BLI_mutex_lock(&zstd->prefetch.base_mutex);
+  }
+  const bool read_ok =
+      zstd->base->seek(zstd->base, zstd->seek.compressed_ofs[frame], SEEK_SET) >= 0 &&
+      zstd->base->read(zstd->base, compressed_data, compressed_size) >= compressed_size;
+  if (zstd->prefetch.pool) {
+    BLI_mutex_unlock(&zstd->prefetch.base_mutex);
+  }
+  if (!read_ok) {
     MEM_freeN(compressed_data);
     MEM_freeN(uncompressed_data);
     return NULL;
   }
 
   size_t res = ZSTD_decompressDCtx(
-      zstd->ctx, uncompressed_data, uncompressed_size, compressed_data, compressed_size);
+      ctx, uncompressed_data, uncompressed_size, compressed_data, compressed_size);
   MEM_freeN(compressed_data);
   if (ZSTD_isError(res) || res < uncompressed_size) {
     MEM_freeN(uncompressed_data);
     return NULL;
   }
 
+  return uncompressed_data;
+}
+
+static void zstd_prefetch_task(TaskPool *__restrict pool, void *taskdata)
+{
+  ZstdReader *zstd = BLI_task_pool_user_data(pool);
+  ZstdFrameSlot *slot = taskdata;
+
+  BLI_mutex_lock(&zstd->prefetch.mutex);
+  if (slot->state != ZSTD_SLOT_QUEUED) {
+    /* Taken by the reading thread, or handled by another task pushed for the slot. */
+    BLI_mutex_unlock(&zstd->prefetch.mutex);
+    return;
+  }
+  slot->state = ZSTD_SLOT_RUNNING;
+  const int frame = slot->frame;
+  BLI_mutex_unlock(&zstd->prefetch.mutex);
+
+  char *content = zstd_frame_decompress(zstd, slot->ctx, frame);
+
+  BLI_mutex_lock(&zstd->prefetch.mutex);
+  slot->content = content;
+  slot->state = ZSTD_SLOT_DONE;
+  BLI_condition_notify_all(&zstd->prefetch.cond);
+  BLI_mutex_unlock(&zstd->prefetch.mutex);
+}
+
+/* Get a frame from the read-ahead window, moving the window to start at the frame. */
+static const char *zstd_prefetch_ensure(ZstdReader *zstd, int frame)
+{
+  const int slots_num = zstd->prefetch.slots_num;
+  /* Only read ahead when reading sequentially, a seek only needs the frame it lands in. */
+  const bool is_sequential = ELEM(zstd->seek.cached_frame, -1, frame - 1);
+  const int frame_end = is_sequential ? min_ii(frame + slots_num, zstd->seek.frames_num) :
+                                        frame + 1;
+
+  /* The cached frame may be in a slot reused below. */
+  zstd->seek.cached_frame = -1;
+  zstd->seek.cached_content = NULL;
+
+  ZstdFrameSlot *push_slots[ZSTD_PREFETCH_FRAMES_MAX];
+  int push_slots_num = 0;
+
+  BLI_mutex_lock(&zstd->prefetch.mutex);
+  for (int i = frame; i < frame_end; i++) {
+    ZstdFrameSlot *slot = &zstd->prefetch.slots[i % slots_num];
+    if (slot->frame == i && slot->state != ZSTD_SLOT_EMPTY) {
+      continue;
+    }
+    /* The slot holds a frame before the window (or after it, after a seek). */
+    while (slot->state == ZSTD_SLOT_RUNNING) {
+      BLI_condition_wait(&zstd->prefetch.cond, &zstd->prefetch.mutex);
+    }
+    MEM_SAFE_FREE(slot->content);
+    /* A task still queued for the slot decompresses the new frame. */
+    if (slot->state != ZSTD_SLOT_QUEUED && i != frame) {
+      push_slots[push_slots_num++] = slot;
+    }
+    slot->frame = i;
+    slot->state = ZSTD_SLOT_QUEUED;
+  }
+
+  ZstdFrameSlot *slot = &zstd->prefetch.slots[frame % slots_num];
+  if (slot->state == ZSTD_SLOT_QUEUED) {
+    /* Decompress on the reading thread rather than waiting for the task to start. */
+    slot->state = ZSTD_SLOT_RUNNING;
+    BLI_mutex_unlock(&zstd->prefetch.mutex);
+
+    for (int i = 0; i < push_slots_num; i++) {
+      BLI_task_pool_push(zstd->prefetch.pool, zstd_prefetch_task, push_slots[i], false, NULL);
+    }
+    push_slots_num = 0;
+
+    char *content = zstd_frame_decompress(zstd, slot->ctx, frame);
+
+    BLI_mutex_lock(&zstd->prefetch.mutex);
+    slot->content = content;
+    slot->state = ZSTD_SLOT_DONE;
+    BLI_condition_notify_all(&zstd->prefetch.cond);
+  }
+  while (slot->state == ZSTD_SLOT_RUNNING) {
+    BLI_condition_wait(&zstd->prefetch.cond, &zstd->prefetch.mutex);
+  }
+  const char *content = slot->content;
+  if (content == NULL) {
+    /* Error while reading the frame, try again on the next read. */
+    slot->state = ZSTD_SLOT_EMPTY;
+  }
+  BLI_mutex_unlock(&zstd->prefetch.mutex);
+
+  for (int i = 0; i < push_slots_num; i++) {
+    BLI_task_pool_push(zstd->prefetch.pool, zstd_prefetch_task, push_slots[i], false, NULL);
+  }
+
+  if (content) {
+    /* The content is owned by the slot, it stays valid until the window moves past it. */
+    zstd->seek.cached_frame = frame;
+    zstd->seek.cached_content = (char *)content;
+  }
+  return content;
+}
+
+/* Ensure that the currently loaded frame is the correct one. */
+static const char *zstd_ensure_cache(ZstdReader *zstd, int frame)
+{
+  if (zstd->seek.cached_frame == frame) {
+    /* Cached frame matches, so just return it. */
+    return zstd->seek.cached_content;
+  }
+
+  if (zstd->prefetch.pool) {
+    return zstd_prefetch_ensure(zstd, frame);
+  }
+
+  /* Cached frame doesn't match, so discard it and cache the wanted one instead. */
+  MEM_SAFE_FREE(zstd->seek.cached_content);
+
+  char *uncompressed_data = zstd_frame_decompress(zstd, zstd->ctx, frame);
+  if (uncompressed_data == NULL) {
+    return NULL;
+  }
+
   zstd->seek.cached_frame = frame;
   zstd->seek.cached_content = uncompressed_data;
   return uncompressed_data;
@@ -273,11 +432,45 @@ static int64_t zstd_read(FileReader *reader, void *buffer, size_t size)
   return output.pos;
 }
 
+static void zstd_prefetch_free(ZstdReader *zstd)
+{
+  if (zstd->prefetch.pool == NULL) {
+    return;
+  }
+
+  /* Wait for the running tasks, the queued ones are skipped. */
+  BLI_task_pool_cancel(zstd->prefetch.pool);
+  BLI_task_pool_free(zstd->prefetch.pool);
+  for (int i = 0; i < zstd->prefetch.slots_num; i++) {
+    ZstdFrameSlot *slot = &zstd->prefetch.slots[i];
+    MEM_SAFE_FREE(slot->content);
+    ZSTD_freeDCtx(slot->ctx);
+  }
+  MEM_freeN(zstd->prefetch.slots);
+  BLI_mutex_end(&zstd->prefetch.mutex);
+  BLI_mutex_end(&zstd->prefetch.base_mutex);
+  BLI_condition_end(&zstd->prefetch.cond);
+  memset(&zstd->prefetch, 0, sizeof(zstd->prefetch));
+
+  /* The cached content was owned by a slot. */
+  zstd->seek.cached_content = NULL;
+  zstd->seek.cached_frame = -1;
+}
+
+static void zstd_release_cache(FileReader *reader)
+{
+  ZstdReader *zstd = (ZstdReader *)reader;
+
+  /* The next reads decompress only the frame they need on the calling thread. */
+  zstd_prefetch_free(zstd);
+}
+
 static void zstd_close(FileReader *reader)
 {
   ZstdReader *zstd = (ZstdReader *)reader;
 
   ZSTD_freeDCtx(zstd->ctx);
+  zstd_prefetch_free(zstd);
   if (zstd->reader.seek) {
     MEM_freeN(zstd->seek.uncompressed_ofs);
     MEM_freeN(zstd->seek.compressed_ofs);
@@ -294,6 +487,29 @@ static void zstd_close(FileReader *reader)
   MEM_freeN(zstd);
 }
 
+static void zstd_prefetch_init(ZstdReader *zstd)
+{
+  /* With a single thread the task pool runs the tasks immediately, nothing to gain. */
+  const int threads_num = BLI_task_scheduler_num_threads();
+  if (threads_num < 2 || zstd->seek.frames_num < 2) {
+    return;
+  }
+
+  /* Enough frames to keep all the threads busy, bounded to limit the memory usage. */
+  zstd->prefetch.slots_num = min_iii(
+      threads_num + 1, ZSTD_PREFETCH_FRAMES_MAX, zstd->seek.frames_num);
+  zstd->prefetch.slots = MEM_calloc_arrayN(
+      zstd->prefetch.slots_num, sizeof(ZstdFrameSlot), __func__);
+  for (int i = 0; i < zstd->prefetch.slots_num; i++) {
+    zstd->prefetch.slots[i].frame = -1;
+    zstd->prefetch.slots[i].ctx = ZSTD_createDCtx();
+  }
+  BLI_mutex_init(&zstd->prefetch.mutex);
+  BLI_mutex_init(&zstd->prefetch.base_mutex);
+  BLI_condition_init(&zstd->prefetch.cond);
+  zstd->prefetch.pool = BLI_task_pool_create(zstd, TASK_PRIORITY_HIGH);
+}
+
 FileReader *BLI_filereader_new_zstd(FileReader *base)
 {
   ZstdReader *zstd = MEM_callocN(sizeof(ZstdReader), __func__);
@@ -304,6 +520,9 @@ FileReader *BLI_filereader_new_zstd(FileReader *base)
   if (zstd_read_seek_table(zstd)) {
     zstd->reader.read = zstd_read_seekable;
     zstd->reader.seek = zstd_seek;
+    zstd->reader.release_cache = zstd_release_cache;
+
+    zstd_prefetch_init(zstd);
   }
   else {
     zstd->reader.read = zstd_read;
@@ -38,6 +38,8 @@ struct KDTree {
   uint nodes_len;
   uint root;
   int max_node_index;
+  /** The nodes are in a serialized buffer, see #BLI_kdtree_nd_(new_from_buffer). */
+  bool nodes_is_buffer;
 #ifndef NDEBUG
   bool is_balanced;        /* ensure we call balance first */
   uint nodes_len_capacity; /* max size of the tree */
@@ -97,6 +99,7 @@ KDTree *BLI_kdtree_nd_(new)(uint nodes_len_capacity)
   tree->nodes_len = 0;
   tree->root = KD_NODE_ROOT_IS_INIT;
   tree->max_node_index = -1;
+  tree->nodes_is_buffer = false;
 
 #ifndef NDEBUG
   tree->is_balanced = false;
@@ -109,7 +112,9 @@ KDTree *BLI_kdtree_nd_(new)(uint nodes_len_capacity)
 void BLI_kdtree_nd_(free)(KDTree *tree)
 {
   if (tree) {
-    MEM_freeN(tree->nodes);
+    if (!tree->nodes_is_buffer) {
+      MEM_freeN(tree->nodes);
+    }
     MEM_freeN(tree);
   }
 }
@@ -119,6 +124,8 @@ void BLI_kdtree_nd_(free)(KDTree *tree)
  */
 void BLI_kdtree_nd_(insert)(KDTree *tree, int index, const float co[KD_DIMS])
 {
+  BLI_assert(!tree->nodes_is_buffer);
+
   KDTreeNode *node = &tree->nodes[tree->nodes_len++];
 
 #ifndef NDEBUG
@@ -197,6 +204,8 @@ static uint kdtree_balance(KDTreeNode *nodes, uint nodes_len, uint axis, const u
 
 void BLI_kdtree_nd_(balance)(KDTree *tree)
 {
+  BLI_assert(!tree->nodes_is_buffer);
+
   if (tree->root != KD_NODE_ROOT_IS_INIT) {
     for (uint i = 0; i < tree->nodes_len; i++) {
       tree->nodes[i].left = KD_NODE_UNSET;
@@ -979,6 +988,7 @@ static int kdtree_node_cmp_deduplicate(const void *n0_p, const void *n1_p)
  */
 int BLI_kdtree_nd_(deduplicate)(KDTree *tree)
 {
+  BLI_assert(!tree->nodes_is_buffer);
 #ifndef NDEBUG
   tree->is_balanced = false;
 #endif
@@ -997,3 +1007,142 @@ int BLI_kdtree_nd_(deduplicate)(KDTree *tree)
 }
 
 /** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Serialization
+ *
+ * The nodes only link each other by index, they are written as is after a header, in the native
+ * byte order. A buffer written with another byte order or dimension is rejected by the header.
+ * \{ */
+
+#define KD_SERIAL_MAGIC 0x5254444b /* "KDTR" in little endian. */
+#define KD_SERIAL_VERSION 1
+
+typedef struct KDTreeSerialHeader {
+  uint magic;
+  uint version;
+  uint dims;
+  uint node_size;
+  uint nodes_len;
+  uint root;
+  int max_node_index;
+  uint _pad;
+} KDTreeSerialHeader;
+
+size_t BLI_kdtree_nd_(serialize_size)(const KDTree *tree)
+{
+  return sizeof(KDTreeSerialHeader) + sizeof(KDTreeNode) * (size_t)tree->nodes_len;
+}
+
+void BLI_kdtree_nd_(serialize)(const KDTree *tree, void *buffer)
+{
+  /* Only balanced trees are supported. */
+  BLI_assert(tree->root != KD_NODE_ROOT_IS_INIT);
+
+  KDTreeSerialHeader *header = buffer;
+  memset(header, 0, sizeof(*header));
+  header->magic = KD_SERIAL_MAGIC;
+  header->version = KD_SERIAL_VERSION;
+  header->dims = KD_DIMS;
+  header->node_size = sizeof(KDTreeNode);
+  header->nodes_len = tree->nodes_len;
+  header->root = tree->root;
+  header->max_node_index = tree->max_node_index;
+
+  memcpy(header + 1, tree->nodes, sizeof(KDTreeNode) * (size_t)tree->nodes_len);
+}
+
+/**
+ * Check the links of balanced nodes read from a buffer: the balance stores the sub-tree of a
+ * node in a range of the nodes, the left sub-tree before the node and the right one after it.
+ * Walking the tree while narrowing these ranges visits each node at most once, so a corrupted
+ * buffer can't make a search read out of bounds or loop forever.
+ */
+static bool kdtree_buffer_nodes_valid(const KDTreeNode *nodes,
+                                      const uint nodes_len,
+                                      const uint root)
+{
+  if (nodes_len == 0) {
+    return root == KD_NODE_UNSET;
+  }
+  if (root >= nodes_len) {
+    return false;
+  }
+
+  /* Each node pushes at most two sub-trees and visits one, so the stack can't exceed the
+   * number of nodes. */
+  struct {
+    uint index, start, end;
+  } *stack = MEM_malloc_arrayN(nodes_len + 1, sizeof(*stack), __func__);
+  uint stack_len = 0;
+  bool valid = true;
+
+  stack[stack_len].index = root;
+  stack[stack_len].start = 0;
+  stack[stack_len].end = nodes_len;
+  stack_len++;
+
+  while (stack_len) {
+    stack_len--;
+    const uint i = stack[stack_len].index;
+    const uint start = stack[stack_len].start;
+    const uint end = stack[stack_len].end;
+    const KDTreeNode *node = &nodes[i];
+
+    if (i < start || i >= end || node->d >= KD_DIMS) {
+      valid = false;
+      break;
+    }
+    if (node->left != KD_NODE_UNSET) {
+      stack[stack_len].index = node->left;
+      stack[stack_len].start = start;
+      stack[stack_len].end = i;
+      stack_len++;
+    }
+    if (node->right != KD_NODE_UNSET) {
+      stack[stack_len].index = node->right;
+      stack[stack_len].start = i + 1;
+      stack[stack_len].end = end;
+      stack_len++;
+    }
+  }
+
+  MEM_freeN(stack);
+  return valid;
+}
+
+KDTree *BLI_kdtree_nd_(new_from_buffer)(const void *buffer, size_t buffer_size)
+{
+  const KDTreeSerialHeader *header = buffer;
+  if (buffer_size < sizeof(*header) || header->magic != KD_SERIAL_MAGIC ||
+      header->version != KD_SERIAL_VERSION || header->dims != KD_DIMS ||
+      header->node_size != sizeof(KDTreeNode) ||
+      (buffer_size - sizeof(*header)) / sizeof(KDTreeNode) < header->nodes_len)
+  {
+    return NULL;
+  }
+
+  /* The nodes are only read, trees from a buffer can't be modified. */
+  KDTreeNode *nodes = (KDTreeNode *)(header + 1);
+  const uint nodes_len = header->nodes_len;
+
+  if (!kdtree_buffer_nodes_valid(nodes, nodes_len, header->root)) {
+    return NULL;
+  }
+
+  KDTree *tree = MEM_mallocN(sizeof(KDTree), "KDTree");
+  tree->nodes = nodes;
+  tree->nodes_len = nodes_len;
+  tree->root = header->root;
+  tree->max_node_index = header->max_node_index;
+  tree->nodes_is_buffer = true;
+
+#ifndef NDEBUG
+  tree->is_balanced = true;
+  tree->nodes_len_capacity = nodes_len;
+#endif
+
+  return tree;
+}
+
+/** \} */
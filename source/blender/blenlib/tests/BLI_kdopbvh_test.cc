@@ -10,8 +10,13 @@
 
 #include "BLI_compiler_attrs.h"
 #include "BLI_kdopbvh.h"
+#include "BLI_math_geom.h"
 #include "BLI_math_vector.h"
 #include "BLI_rand.h"
+#include "BLI_utildefines.h"
+
+#include <cfloat>
+#include <cstring>
 
 /* -------------------------------------------------------------------- */
 /* Helper Functions */
@@ -134,3 +139,359 @@ TEST(kdopbvh, OptimalFindNearest_500)
 {
   find_nearest_points_test(500, 1.0, 1000, 12, true);
 }
+
+/* -------------------------------------------------------------------- */
+/* Packet Ray-Cast */
+
+struct RayCastTris {
+  float (*tris)[3][3];
+};
+
+static void ray_cast_tri_callback(void *userdata,
+                                  int index,
+                                  const BVHTreeRay *ray,
+                                  BVHTreeRayHit *hit)
+{
+  const RayCastTris *data = static_cast<const RayCastTris *>(userdata);
+  const float(*tri)[3] = data->tris[index];
+  float dist;
+  if (isect_ray_tri_watertight_v3(
+          ray->origin, ray->isect_precalc, tri[0], tri[1], tri[2], &dist, nullptr) &&
+      dist < hit->dist)
+  {
+    hit->index = index;
+    hit->dist = dist;
+    madd_v3_v3v3fl(hit->co, ray->origin, ray->direction, dist);
+  }
+}
+
+/**
+ * Cast packets of rays against random triangles and compare with single ray-casts.
+ * Coherent packets share an origin and have close directions, incoherent packets have random
+ * directions.
+ */
+static void ray_cast_packet_test(
+    int tris_len, int tree_type, int ray_num, bool coherent, bool use_callback, int random_seed)
+{
+  RNG *rng = BLI_rng_new(random_seed);
+  BVHTree *tree = BLI_bvhtree_new(tris_len, 0.0, tree_type, 6);
+
+  RayCastTris data;
+  data.tris = static_cast<float(*)[3][3]>(MEM_mallocN(sizeof(float[3][3]) * tris_len, __func__));
+
+  for (int i = 0; i < tris_len; i++) {
+    float center[3];
+    rng_v3_round(center, 3, rng, 1000, 1.0f);
+    for (int j = 0; j < 3; j++) {
+      rng_v3_round(data.tris[i][j], 3, rng, 1000, 0.1f);
+      add_v3_v3(data.tris[i][j], center);
+    }
+    BLI_bvhtree_insert(tree, i, &data.tris[i][0][0], 3);
+  }
+  BLI_bvhtree_balance(tree);
+
+  BVHTreeFlat *flat = BLI_bvhtree_flat_new(tree);
+  BVHTree_RayCastCallback callback = use_callback ? ray_cast_tri_callback : nullptr;
+
+  for (int packet = 0; packet < 64; packet++) {
+    BVHTreeRay rays[BVH_RAYCAST_PACKET_MAX];
+    BVHTreeRayHit hits[BVH_RAYCAST_PACKET_MAX];
+
+    float origin[3], dir[3];
+    BLI_rng_get_float_unit_v3(rng, origin);
+    mul_v3_fl(origin, 2.0f);
+    rng_v3_round(dir, 3, rng, 1000, 0.5f);
+    sub_v3_v3v3(dir, dir, origin);
+
+    for (int i = 0; i < ray_num; i++) {
+      BVHTreeRay &ray = rays[i];
+      copy_v3_v3(ray.origin, origin);
+      if (coherent) {
+        rng_v3_round(ray.direction, 3, rng, 1000, 0.05f);
+        add_v3_v3(ray.direction, dir);
+      }
+      else {
+        BLI_rng_get_float_unit_v3(rng, ray.direction);
+      }
+      normalize_v3(ray.direction);
+      ray.radius = 0.0f;
+
+      hits[i].index = -1;
+      hits[i].dist = BVH_RAYCAST_DIST_MAX;
+    }
+
+    BLI_bvhtree_ray_cast_packet(
+        flat, rays, hits, ray_num, callback, &data, BVH_RAYCAST_WATERTIGHT);
+
+    for (int i = 0; i < ray_num; i++) {
+      BVHTreeRayHit hit;
+      hit.index = -1;
+      hit.dist = BVH_RAYCAST_DIST_MAX;
+      BLI_bvhtree_ray_cast_ex(tree,
+                              rays[i].origin,
+                              rays[i].direction,
+                              0.0f,
+                              &hit,
+                              callback,
+                              &data,
+                              BVH_RAYCAST_WATERTIGHT);
+
+      /* Equally distant nodes can be visited in another order, only compare distances. */
+      EXPECT_EQ(hits[i].index == -1, hit.index == -1);
+      EXPECT_FLOAT_EQ(hits[i].dist, hit.dist);
+    }
+  }
+
+  BLI_bvhtree_flat_free(flat);
+  BLI_bvhtree_free(tree);
+  BLI_rng_free(rng);
+  MEM_freeN(data.tris);
+}
+
+TEST(kdopbvh, RayCastPacket_Empty)
+{
+  BVHTree *tree = BLI_bvhtree_new(0, 0.0, 4, 6);
+  BLI_bvhtree_balance(tree);
+  BVHTreeFlat *flat = BLI_bvhtree_flat_new(tree);
+
+  BVHTreeRay ray = {{0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f}, 0.0f, nullptr};
+  BVHTreeRayHit hit;
+  hit.index = -1;
+  hit.dist = BVH_RAYCAST_DIST_MAX;
+  BLI_bvhtree_ray_cast_packet(flat, &ray, &hit, 1, nullptr, nullptr, BVH_RAYCAST_DEFAULT);
+  EXPECT_EQ(hit.index, -1);
+
+  BLI_bvhtree_flat_free(flat);
+  BLI_bvhtree_free(tree);
+}
+TEST(kdopbvh, RayCastPacket_Coherent_4)
+{
+  ray_cast_packet_test(500, 4, 4, true, true, 1234);
+}
+TEST(kdopbvh, RayCastPacket_Coherent_7)
+{
+  ray_cast_packet_test(500, 2, 7, true, true, 123);
+}
+TEST(kdopbvh, RayCastPacket_Coherent_16)
+{
+  ray_cast_packet_test(2000, 4, 16, true, true, 12);
+}
+TEST(kdopbvh, RayCastPacket_Coherent_NoCallback)
+{
+  ray_cast_packet_test(500, 8, 8, true, false, 1);
+}
+TEST(kdopbvh, RayCastPacket_Incoherent_16)
+{
+  ray_cast_packet_test(500, 4, 16, false, true, 12);
+}
+
+/* -------------------------------------------------------------------- */
+/* Serialization */
+
+static void serialize_test(int points_len, int tree_type, int axis, int random_seed)
+{
+  RNG *rng = BLI_rng_new(random_seed);
+  BVHTree *tree = BLI_bvhtree_new(points_len, 0.0, tree_type, axis);
+
+  void *mem = MEM_mallocN(sizeof(float[3]) * points_len, __func__);
+  float(*points)[3] = (float(*)[3])mem;
+
+  for (int i = 0; i < points_len; i++) {
+    rng_v3_round(points[i], 3, rng, 1000, 1.0f);
+    BLI_bvhtree_insert(tree, i, points[i], 1);
+  }
+  BLI_bvhtree_balance(tree);
+
+  const size_t size = BLI_bvhtree_serialize_size(tree);
+  void *buffer = MEM_mallocN(size, __func__);
+  BLI_bvhtree_serialize(tree, buffer);
+
+  /* A truncated buffer is rejected. */
+  EXPECT_EQ(BLI_bvhtree_new_from_buffer(buffer, size - 1, nullptr), nullptr);
+
+  int index_range[2];
+  BVHTree *tree_buffer = BLI_bvhtree_new_from_buffer(buffer, size, index_range);
+  ASSERT_NE(tree_buffer, nullptr);
+  EXPECT_EQ(index_range[0], 0);
+  EXPECT_EQ(index_range[1], points_len - 1);
+  EXPECT_EQ(BLI_bvhtree_get_len(tree_buffer), points_len);
+  EXPECT_EQ(BLI_bvhtree_get_tree_type(tree_buffer), tree_type);
+
+  /* The same tree serializes to the same buffer. */
+  void *buffer_again = MEM_mallocN(size, __func__);
+  BLI_bvhtree_serialize(tree_buffer, buffer_again);
+  EXPECT_EQ(memcmp(buffer, buffer_again, size), 0);
+
+  for (int i = 0; i < points_len * 2; i++) {
+    float co[3];
+    rng_v3_round(co, 3, rng, 1000, 1.5f);
+    BVHTreeNearest nearest, nearest_buffer;
+    nearest.index = nearest_buffer.index = -1;
+    nearest.dist_sq = nearest_buffer.dist_sq = FLT_MAX;
+    BLI_bvhtree_find_nearest(tree, co, &nearest, nullptr, nullptr);
+    BLI_bvhtree_find_nearest(tree_buffer, co, &nearest_buffer, nullptr, nullptr);
+    EXPECT_EQ(nearest.index, nearest_buffer.index);
+    EXPECT_EQ(nearest.dist_sq, nearest_buffer.dist_sq);
+  }
+
+  BLI_bvhtree_free(tree_buffer);
+  BLI_bvhtree_free(tree);
+  BLI_rng_free(rng);
+  MEM_freeN(buffer_again);
+  MEM_freeN(buffer);
+  MEM_freeN(points);
+}
+
+TEST(kdopbvh, Serialize_Empty)
+{
+  serialize_test(0, 4, 6, 1);
+}
+TEST(kdopbvh, Serialize_1)
+{
+  serialize_test(1, 2, 6, 1234);
+}
+TEST(kdopbvh, Serialize_500)
+{
+  serialize_test(500, 4, 6, 12);
+}
+TEST(kdopbvh, Serialize_500_KDOP_26)
+{
+  serialize_test(500, 8, 26, 123);
+}
+
+TEST(kdopbvh, Serialize_Invalid)
+{
+  BVHTree *tree = BLI_bvhtree_new(1, 0.0, 4, 6);
+  {
+    float co[3] = {0};
+    BLI_bvhtree_insert(tree, 0, co, 1);
+  }
+  BLI_bvhtree_balance(tree);
+
+  const size_t size = BLI_bvhtree_serialize_size(tree);
+  void *buffer = MEM_mallocN(size, __func__);
+  BLI_bvhtree_serialize(tree, buffer);
+
+  /* Wrong magic number, e.g. another byte order. */
+  static_cast<char *>(buffer)[0] ^= 0xff;
+  EXPECT_EQ(BLI_bvhtree_new_from_buffer(buffer, size, nullptr), nullptr);
+
+  BLI_bvhtree_free(tree);
+  MEM_freeN(buffer);
+}
+
+/* Node links of a serialized tree, mirrors the layout written by #BLI_bvhtree_serialize. */
+struct SerialNode {
+  int index;
+  int parent;
+  uchar node_num;
+  uchar main_axis;
+  char _pad[2];
+};
+
+struct SerialLinks {
+  SerialNode *nodes;
+  int *children;
+};
+
+static size_t serial_align(size_t size)
+{
+  return (size + 7) & ~size_t(7);
+}
+
+static SerialLinks serial_links(void *buffer, int node_num, int axis)
+{
+  const size_t header_size = 32;
+  const size_t nodes_offset = serial_align(header_size + sizeof(float) * node_num * axis);
+  const size_t children_offset = serial_align(nodes_offset + sizeof(SerialNode) * node_num);
+  SerialLinks links;
+  links.nodes = static_cast<SerialNode *>(POINTER_OFFSET(buffer, nodes_offset));
+  links.children = static_cast<int *>(POINTER_OFFSET(buffer, children_offset));
+  return links;
+}
+
+static void *serialize_points(int points_len, int tree_type, size_t *r_size)
+{
+  BVHTree *tree = BLI_bvhtree_new(points_len, 0.0, tree_type, 6);
+  for (int i = 0; i < points_len; i++) {
+    const float co[3] = {float(i), 0.0f, 0.0f};
+    BLI_bvhtree_insert(tree, i, co, 1);
+  }
+  BLI_bvhtree_balance(tree);
+
+  *r_size = BLI_bvhtree_serialize_size(tree);
+  void *buffer = MEM_mallocN(*r_size, __func__);
+  BLI_bvhtree_serialize(tree, buffer);
+  BLI_bvhtree_free(tree);
+  return buffer;
+}
+
+/**
+ * Links the leafs of a binary tree as a chain of branches, each branch having a leaf and the next
+ * branch as children. The tree is as deep as its number of branches.
+ */
+static void *serialize_chain(int leaf_num, size_t *r_size)
+{
+  void *buffer = serialize_points(leaf_num, 2, r_size);
+  const int branch_num = leaf_num - 1;
+  SerialLinks links = serial_links(buffer, leaf_num + branch_num, 6);
+  for (int i = 0; i < branch_num; i++) {
+    const int branch = leaf_num + i;
+    const int next = (i + 1 < branch_num) ? branch + 1 : i + 1;
+    links.nodes[branch].parent = (i == 0) ? -1 : branch - 1;
+    links.nodes[branch].node_num = 2;
+    links.children[branch * 2 + 0] = i;
+    links.children[branch * 2 + 1] = next;
+    links.nodes[i].parent = branch;
+    links.nodes[next].parent = branch;
+  }
+  return buffer;
+}
+
+TEST(kdopbvh, Serialize_Malformed)
+{
+  const int leaf_num = 16;
+  const int tree_type = 4;
+  size_t size;
+  void *buffer = serialize_points(leaf_num, tree_type, &size);
+  BVHTree *tree_buffer = BLI_bvhtree_new_from_buffer(buffer, size, nullptr);
+  ASSERT_NE(tree_buffer, nullptr);
+  BLI_bvhtree_free(tree_buffer);
+
+  const int node_num = leaf_num + 5;
+  SerialLinks links = serial_links(buffer, node_num, 6);
+  SerialLinks links_copy;
+  void *buffer_copy = MEM_mallocN(size, __func__);
+
+  /* A branch without children would be traversed as a leaf with an unchecked index. */
+  memcpy(buffer_copy, buffer, size);
+  links_copy = serial_links(buffer_copy, node_num, 6);
+  links_copy.nodes[leaf_num].node_num = 0;
+  EXPECT_EQ(BLI_bvhtree_new_from_buffer(buffer_copy, size, nullptr), nullptr);
+
+  /* A node shared by two branches. */
+  memcpy(buffer_copy, buffer, size);
+  links_copy = serial_links(buffer_copy, node_num, 6);
+  const int root = leaf_num;
+  const int last_child = links.children[root * tree_type + tree_type - 1];
+  const int shared_child = links.children[root * tree_type];
+  links_copy.children[root * tree_type + tree_type - 1] = shared_child;
+  EXPECT_NE(last_child, shared_child);
+  EXPECT_EQ(BLI_bvhtree_new_from_buffer(buffer_copy, size, nullptr), nullptr);
+
+  MEM_freeN(buffer_copy);
+  MEM_freeN(buffer);
+
+  /* Deep trees could overflow the stack of recursive queries. */
+  buffer = serialize_chain(20, &size);
+  tree_buffer = BLI_bvhtree_new_from_buffer(buffer, size, nullptr);
+  EXPECT_NE(tree_buffer, nullptr);
+  if (tree_buffer) {
+    BLI_bvhtree_free(tree_buffer);
+  }
+  MEM_freeN(buffer);
+
+  buffer = serialize_chain(100, &size);
+  EXPECT_EQ(BLI_bvhtree_new_from_buffer(buffer, size, nullptr), nullptr);
+  MEM_freeN(buffer);
+}
@@ -4,6 +4,8 @@
 
 #include "testing/testing.h"
 
+#include "MEM_guardedalloc.h"
+
 #include "BLI_kdtree.h"
 
 #include <cmath>
@@ -63,3 +65,88 @@ TEST(kdtree, Deduplicate)
 {
   deduplicate_test();
 }
+
+static void serialize_test(int tree_size)
+{
+  KDTree_3d *tree = BLI_kdtree_3d_new(tree_size);
+  for (int i = 0; i < tree_size; i++) {
+    float co[3] = {fmodf(i * 7.121f, 0.6037f), fmodf(i * 3.17f, 0.913f), fmodf(i * 1.31f, 0.29f)};
+    BLI_kdtree_3d_insert(tree, i, co);
+  }
+  BLI_kdtree_3d_balance(tree);
+
+  const size_t size = BLI_kdtree_3d_serialize_size(tree);
+  void *buffer = MEM_mallocN(size, __func__);
+  BLI_kdtree_3d_serialize(tree, buffer);
+
+  /* A truncated buffer or another dimension is rejected. */
+  if (tree_size != 0) {
+    EXPECT_EQ(BLI_kdtree_3d_new_from_buffer(buffer, size - 1), nullptr);
+  }
+  EXPECT_EQ(BLI_kdtree_2d_new_from_buffer(buffer, size), nullptr);
+
+  KDTree_3d *tree_buffer = BLI_kdtree_3d_new_from_buffer(buffer, size);
+  ASSERT_NE(tree_buffer, nullptr);
+
+  for (int i = 0; i < 100; i++) {
+    const float co[3] = {fmodf(i * 0.37f, 0.7f), fmodf(i * 0.53f, 1.0f), fmodf(i * 0.11f, 0.3f)};
+    KDTreeNearest_3d nearest, nearest_buffer;
+    EXPECT_EQ(BLI_kdtree_3d_find_nearest(tree, co, &nearest),
+              BLI_kdtree_3d_find_nearest(tree_buffer, co, &nearest_buffer));
+    if (tree_size != 0) {
+      EXPECT_EQ(nearest.dist, nearest_buffer.dist);
+    }
+  }
+
+  BLI_kdtree_3d_free(tree_buffer);
+  BLI_kdtree_3d_free(tree);
+  MEM_freeN(buffer);
+}
+
+TEST(kdtree, Serialize)
+{
+  serialize_test(0);
+  serialize_test(1);
+  serialize_test(1000);
+}
+
+TEST(kdtree, SerializeCycle)
+{
+  /* Layout of a serialized 3D tree, see #KDTreeSerialHeader and #KDTreeNode. */
+  struct SerialNode {
+    uint left, right;
+    float co[3];
+    int index;
+    uint d;
+  };
+  const size_t header_size = sizeof(uint[8]);
+  const uint unset = uint(-1);
+
+  KDTree_3d *tree = BLI_kdtree_3d_new(100);
+  for (int i = 0; i < 100; i++) {
+    const float co[3] = {float(i), float(i % 7), float(i % 3)};
+    BLI_kdtree_3d_insert(tree, i, co);
+  }
+  BLI_kdtree_3d_balance(tree);
+
+  const size_t size = BLI_kdtree_3d_serialize_size(tree);
+  ASSERT_EQ(size, header_size + sizeof(SerialNode) * 100);
+  char *buffer = static_cast<char *>(MEM_mallocN(size, __func__));
+  BLI_kdtree_3d_serialize(tree, buffer);
+  BLI_kdtree_3d_free(tree);
+
+  /* Link back the left child of a node to this node, each link alone stays ordered. */
+  SerialNode *nodes = reinterpret_cast<SerialNode *>(buffer + header_size);
+  uint parent = 0;
+  while (parent < 100 && nodes[parent].left == unset) {
+    parent++;
+  }
+  ASSERT_LT(parent, 100);
+  const uint child = nodes[parent].left;
+  EXPECT_LT(child, parent);
+  nodes[child].right = parent;
+
+  EXPECT_EQ(BLI_kdtree_3d_new_from_buffer(buffer, size), nullptr);
+
+  MEM_freeN(buffer);
+}
@@ -0,0 +1,221 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "testing/testing.h"
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_kdopbvh.h"
+#include "BLI_math_geom.h"
+#include "BLI_math_vector.h"
+#include "BLI_rand.h"
+#include "BLI_timeit.hh"
+
+/* Compare the packet ray-cast against one ray-cast per ray, for a grid of rays cast from a
+ * pinhole camera (coherent rays) and for random rays (incoherent). */
+
+/* Number of triangles of the scene. */
+static constexpr int TRIS_NUM = 200000;
+/* Camera resolution, the packets are tiles of 4x4 pixels. */
+static constexpr int RES = 1024;
+static constexpr int TILE = 4;
+
+struct RayCastScene {
+  float (*tris)[3][3];
+  BVHTree *tree;
+  BVHTreeFlat *flat;
+};
+
+static void ray_cast_tri_callback(void *userdata,
+                                  int index,
+                                  const BVHTreeRay *ray,
+                                  BVHTreeRayHit *hit)
+{
+  const RayCastScene *scene = static_cast<const RayCastScene *>(userdata);
+  const float(*tri)[3] = scene->tris[index];
+  float dist;
+  if (isect_ray_tri_watertight_v3(
+          ray->origin, ray->isect_precalc, tri[0], tri[1], tri[2], &dist, nullptr) &&
+      dist < hit->dist)
+  {
+    hit->index = index;
+    hit->dist = dist;
+  }
+}
+
+static void scene_create(RayCastScene &scene, int tree_type)
+{
+  RNG *rng = BLI_rng_new(42);
+  scene.tris = static_cast<float(*)[3][3]>(
+      MEM_mallocN(sizeof(float[3][3]) * TRIS_NUM, __func__));
+  scene.tree = BLI_bvhtree_new(TRIS_NUM, 0.0f, tree_type, 6);
+
+  for (int i = 0; i < TRIS_NUM; i++) {
+    float center[3];
+    BLI_rng_get_float_unit_v3(rng, center);
+    mul_v3_fl(center, BLI_rng_get_float(rng) * 10.0f);
+    for (int j = 0; j < 3; j++) {
+      BLI_rng_get_float_unit_v3(rng, scene.tris[i][j]);
+      mul_v3_fl(scene.tris[i][j], 0.05f);
+      add_v3_v3(scene.tris[i][j], center);
+    }
+    BLI_bvhtree_insert(scene.tree, i, &scene.tris[i][0][0], 3);
+  }
+  BLI_bvhtree_balance(scene.tree);
+
+  {
+    SCOPED_TIMER("flatten");
+    scene.flat = BLI_bvhtree_flat_new(scene.tree);
+  }
+
+  BLI_rng_free(rng);
+}
+
+static void scene_free(RayCastScene &scene)
+{
+  BLI_bvhtree_flat_free(scene.flat);
+  BLI_bvhtree_free(scene.tree);
+  MEM_freeN(scene.tris);
+}
+
+/* Ray of the pixel (x, y) of a camera at z = -20 looking at the origin. */
+static void camera_ray(BVHTreeRay &ray, int x, int y)
+{
+  ray.origin[0] = 0.0f;
+  ray.origin[1] = 0.0f;
+  ray.origin[2] = -20.0f;
+  ray.direction[0] = (float(x) + 0.5f) / float(RES) - 0.5f;
+  ray.direction[1] = (float(y) + 0.5f) / float(RES) - 0.5f;
+  ray.direction[2] = 1.0f;
+  normalize_v3(ray.direction);
+  ray.radius = 0.0f;
+  ray.isect_precalc = nullptr;
+}
+
+static void random_ray(BVHTreeRay &ray, RNG *rng)
+{
+  BLI_rng_get_float_unit_v3(rng, ray.origin);
+  mul_v3_fl(ray.origin, 20.0f);
+  BLI_rng_get_float_unit_v3(rng, ray.direction);
+  ray.radius = 0.0f;
+  ray.isect_precalc = nullptr;
+}
+
+static void init_hits(BVHTreeRayHit *hits, int num)
+{
+  for (int i = 0; i < num; i++) {
+    hits[i].index = -1;
+    hits[i].dist = BVH_RAYCAST_DIST_MAX;
+  }
+}
+
+static void ray_cast_camera_tests(int tree_type)
+{
+  RayCastScene scene;
+  scene_create(scene, tree_type);
+
+  int single_hits = 0, packet_hits = 0;
+  {
+    SCOPED_TIMER("camera single");
+    for (int y = 0; y < RES; y++) {
+      for (int x = 0; x < RES; x++) {
+        BVHTreeRay ray;
+        BVHTreeRayHit hit;
+        camera_ray(ray, x, y);
+        init_hits(&hit, 1);
+        BLI_bvhtree_ray_cast(
+            scene.tree, ray.origin, ray.direction, 0.0f, &hit, ray_cast_tri_callback, &scene);
+        single_hits += (hit.index != -1);
+      }
+    }
+  }
+  {
+    SCOPED_TIMER("camera packet");
+    for (int ty = 0; ty < RES; ty += TILE) {
+      for (int tx = 0; tx < RES; tx += TILE) {
+        BVHTreeRay rays[TILE * TILE];
+        BVHTreeRayHit hits[TILE * TILE];
+        for (int i = 0; i < TILE * TILE; i++) {
+          camera_ray(rays[i], tx + i % TILE, ty + i / TILE);
+        }
+        init_hits(hits, TILE * TILE);
+        BLI_bvhtree_ray_cast_packet(scene.flat,
+                                    rays,
+                                    hits,
+                                    TILE * TILE,
+                                    ray_cast_tri_callback,
+                                    &scene,
+                                    BVH_RAYCAST_DEFAULT);
+        for (int i = 0; i < TILE * TILE; i++) {
+          packet_hits += (hits[i].index != -1);
+        }
+      }
+    }
+  }
+  EXPECT_EQ(single_hits, packet_hits);
+
+  scene_free(scene);
+}
+
+static void ray_cast_random_tests(int tree_type)
+{
+  RayCastScene scene;
+  scene_create(scene, tree_type);
+
+  const int ray_num = RES * RES / 4;
+  int single_hits = 0, packet_hits = 0;
+  {
+    RNG *rng = BLI_rng_new(1);
+    SCOPED_TIMER("random single");
+    for (int i = 0; i < ray_num; i++) {
+      BVHTreeRay ray;
+      BVHTreeRayHit hit;
+      random_ray(ray, rng);
+      init_hits(&hit, 1);
+      BLI_bvhtree_ray_cast(
+          scene.tree, ray.origin, ray.direction, 0.0f, &hit, ray_cast_tri_callback, &scene);
+      single_hits += (hit.index != -1);
+    }
+    BLI_rng_free(rng);
+  }
+  {
+    RNG *rng = BLI_rng_new(1);
+    SCOPED_TIMER("random packet");
+    for (int i = 0; i < ray_num; i += BVH_RAYCAST_PACKET_MAX) {
+      BVHTreeRay rays[BVH_RAYCAST_PACKET_MAX];
+      BVHTreeRayHit hits[BVH_RAYCAST_PACKET_MAX];
+      for (int j = 0; j < BVH_RAYCAST_PACKET_MAX; j++) {
+        random_ray(rays[j], rng);
+      }
+      init_hits(hits, BVH_RAYCAST_PACKET_MAX);
+      BLI_bvhtree_ray_cast_packet(scene.flat,
+                                  rays,
+                                  hits,
+                                  BVH_RAYCAST_PACKET_MAX,
+                                  ray_cast_tri_callback,
+                                  &scene,
+                                  BVH_RAYCAST_DEFAULT);
+      for (int j = 0; j < BVH_RAYCAST_PACKET_MAX; j++) {
+        packet_hits += (hits[j].index != -1);
+      }
+    }
+    BLI_rng_free(rng);
+  }
+  EXPECT_EQ(single_hits, packet_hits);
+
+  scene_free(scene);
+}
+
+TEST(kdopbvh, RayCastCamera_Tree2)
+{
+  ray_cast_camera_tests(2);
+}
+TEST(kdopbvh, RayCastCamera_Tree4)
+{
+  ray_cast_camera_tests(4);
+}
+TEST(kdopbvh, RayCastRandom_Tree4)
+{
+  ray_cast_random_tests(4);
+}
@@ -261,6 +261,22 @@ void *BLO_read_struct_array_with_size(BlendDataReader *reader,
 #define BLO_read_packed_address(reader, ptr_p) \
   *((void **)ptr_p) = BLO_read_get_new_packed_address((reader), *(ptr_p))
 
+/**
+ * Like #BLO_read_packed_address, but when reading with deferred packed data (see
+ * #BLO_read_deferred_packed_data_set) a large block isn't read: `*ptr_p` is set to null and the
+ * data is read by #BLO_read_deferred_data_ensure on first access.
+ *
+ * \return Whether reading the data was deferred, otherwise `*ptr_p` is unchanged.
+ */
+bool BLO_read_deferred_packed_address(BlendDataReader *reader, void **ptr_p);
+/**
+ * Read deferred data into `*ptr_p`, can be called from any thread.
+ * \return False when the data isn't deferred or reading the file failed.
+ */
+bool BLO_read_deferred_data_ensure(void **ptr_p);
+/** Forget the deferred data of `ptr_p`, when freeing the owner of the pointer. */
+void BLO_read_deferred_data_release(void **ptr_p);
+
 /* Read all elements in list
  *
  * Updates all `->prev` and `->next` pointers of the list elements.
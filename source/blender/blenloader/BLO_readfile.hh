@@ -191,6 +191,33 @@ BlendFileData *BLO_read_from_memfile(Main *oldmain,
                                      const BlendFileReadParams *params,
                                      ReportList *reports);
 
+/**
+ * Convert the data-blocks of files written with another DNA or endianness in parallel before
+ * reading the IDs (enabled by default). The read data is identical either way, disabling it is
+ * only meant to compare with the sequential conversion, e.g. in benchmarks.
+ */
+void BLO_read_parallel_conversion_set(bool use_parallel);
+/** Number of data-blocks converted in parallel since the start of the program. */
+size_t BLO_read_parallel_conversion_num_get();
+
+/**
+ * Defer reading the large packed files data (images, sounds, fonts...) of files on disk until
+ * their first access, see #BLO_read_deferred_packed_address (disabled by default). Meant for
+ * the game runtime, where the data of many assets is never used in a session.
+ */
+void BLO_read_deferred_packed_data_set(bool use_deferred);
+
+struct BLODeferredDataStats {
+  /** Data-blocks which reading was deferred. */
+  size_t deferred_num;
+  size_t deferred_size;
+  /** Deferred data-blocks read on access. */
+  size_t read_num;
+  size_t read_size;
+};
+/** Statistics of the deferred data since the start of the program. */
+void BLO_read_deferred_data_stats_get(BLODeferredDataStats *r_stats);
+
 /**
  * Frees a BlendFileData structure and *all* the data associated with it
  * (the userdef data, and the main libblock data).
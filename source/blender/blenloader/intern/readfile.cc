@@ -6,6 +6,7 @@
  * \ingroup blenloader
  */
 
+#include <atomic>
 #include <cctype> /* for isdigit. */
 #include <cerrno>
 #include <climits>
@@ -55,8 +56,10 @@
 #include "BLI_map.hh"
 #include "BLI_memarena.h"
 #include "BLI_mempool.h"
+#include "BLI_task.hh"
 #include "BLI_threads.h"
 #include "BLI_time.h"
+#include "BLI_vector.hh"
 
 #include "BLT_translation.hh"
 
@@ -183,6 +186,9 @@ static CLG_LogRef LOG_UNDO = {"blo.readfile.undo"};
 /* local prototypes */
 static void read_libraries(FileData *basefd, ListBase *mainlist);
 static void *read_struct(FileData *fd, BHead *bh, const char *blockname);
+static void *read_data_undeferred(FileData *fd, const void *adr, bool increase_users);
+/** Release the reference of the file data to the file shared with the deferred data. */
+static void read_deferred_file_release(BLODeferredFile *deferred_file);
 static BHead *find_bhead_from_code_name(FileData *fd, const short idcode, const char *name);
 static BHead *find_bhead_from_idname(FileData *fd, const char *idname);
 
@@ -305,6 +311,13 @@ static void *oldnewmap_liblookup(OldNewMap *onm, const void *addr, const bool is
   return nullptr;
 }
 
+/* Lookup and remove, the caller owns the returned address. */
+static void *oldnewmap_pop(OldNewMap *onm, const void *addr)
+{
+  std::optional<NewAddress> entry = onm->map.pop_try(addr);
+  return entry ? entry->newp : nullptr;
+}
+
 static void oldnewmap_clear(OldNewMap *onm)
 {
   /* Free unused data. */
@@ -1239,6 +1252,7 @@ static FileData *blo_filedata_from_file_descriptor(const char *filepath,
 
   FileData *fd = filedata_new(reports);
   fd->file = file;
+  fd->flags |= FD_FLAGS_IS_FILE;
 
   return fd;
 }
@@ -1354,7 +1368,13 @@ void blo_filedata_free(FileData *fd)
     MEM_freeN(new_bhead);
   }
 #endif
-  fd->file->close(fd->file);
+  if (fd->deferred_file) {
+    /* The file stays open for the deferred data. */
+    read_deferred_file_release(fd->deferred_file);
+  }
+  else {
+    fd->file->close(fd->file);
+  }
 
   if (fd->filesdna) {
     DNA_sdna_free(fd->filesdna);
@@ -1375,6 +1395,14 @@ void blo_filedata_free(FileData *fd)
   if (fd->packedmap) {
     oldnewmap_free(fd->packedmap);
   }
+  if (fd->deferredmap) {
+    oldnewmap_free(fd->deferredmap);
+  }
+  if (fd->convertedmap) {
+    /* When reading stopped early. */
+    oldnewmap_clear(fd->convertedmap);
+    oldnewmap_free(fd->convertedmap);
+  }
   if (fd->libmap && !(fd->flags & FD_FLAGS_NOT_MY_LIBMAP)) {
     oldnewmap_free(fd->libmap);
   }
@@ -1451,13 +1479,21 @@ short BLO_version_from_file(const char *filepath)
 /* Only direct data-blocks. */
 static void *newdataadr(FileData *fd, const void *adr)
 {
-  return oldnewmap_lookup_and_inc(fd->datamap, adr, true);
+  void *newp = oldnewmap_lookup_and_inc(fd->datamap, adr, true);
+  if (UNLIKELY(newp == nullptr && fd->deferredmap)) {
+    newp = read_data_undeferred(fd, adr, true);
+  }
+  return newp;
 }
 
 /* Only direct data-blocks. */
 static void *newdataadr_no_us(FileData *fd, const void *adr)
 {
-  return oldnewmap_lookup_and_inc(fd->datamap, adr, false);
+  void *newp = oldnewmap_lookup_and_inc(fd->datamap, adr, false);
+  if (UNLIKELY(newp == nullptr && fd->deferredmap)) {
+    newp = read_data_undeferred(fd, adr, false);
+  }
+  return newp;
 }
 
 void *blo_read_get_new_globaldata_address(FileData *fd, const void *adr)
@@ -1472,7 +1508,7 @@ static void *newpackedadr(FileData *fd, const void *adr)
     return oldnewmap_lookup_and_inc(fd->packedmap, adr, true);
   }
 
-  return oldnewmap_lookup_and_inc(fd->datamap, adr, true);
+  return newdataadr(fd, adr);
 }
 
 /* only lib data */
@@ -1804,6 +1840,13 @@ static void *read_struct(FileData *fd, BHead *bh, const char *blockname)
 {
   void *temp = nullptr;
 
+  if (fd->convertedmap) {
+    temp = oldnewmap_pop(fd->convertedmap, bh);
+    if (temp) {
+      return temp;
+    }
+  }
+
   if (bh->len) {
 #ifdef USE_BHEAD_READ_ON_DEMAND
     BHead *bh_orig = bh;
@@ -2363,6 +2406,192 @@ static void fix_relpaths_library(const char *basepath, Main *main)
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name Deferred Data
+ *
+ * Optionally (see #BLO_read_deferred_packed_data_set), the large raw data-blocks of a file on disk
+ * aren't read with their ID. When the data is needed while reading the ID it's read then, but the
+ * packed files data (images, sounds, fonts...) only keeps a reference to the file, and is read on
+ * first access with #BLO_read_deferred_data_ensure. The file stays open until all the deferred
+ * data is read or freed.
+ * \{ */
+
+/** Smallest data-block which reading is deferred. */
+#define READ_DEFER_MIN_SIZE (64 << 10)
+
+struct BLODeferredFile {
+  FileReader *file;
+  /** The file data reading the file and the deferred data. */
+  int users;
+};
+
+struct DeferredData {
+  BLODeferredFile *file;
+  off64_t file_offset;
+  int len;
+};
+
+static bool read_use_deferred_packed_data = false;
+
+/** Deferred data from the address of the pointer to set, protected by #deferred_mutex. */
+static blender::Map<void **, DeferredData> *deferred_data = nullptr;
+static BLODeferredDataStats deferred_stats = {0};
+static ThreadMutex deferred_mutex = BLI_MUTEX_INITIALIZER;
+
+void BLO_read_deferred_packed_data_set(const bool use_deferred)
+{
+  read_use_deferred_packed_data = use_deferred;
+}
+
+void BLO_read_deferred_data_stats_get(BLODeferredDataStats *r_stats)
+{
+  BLI_mutex_lock(&deferred_mutex);
+  *r_stats = deferred_stats;
+  BLI_mutex_unlock(&deferred_mutex);
+}
+
+static bool read_data_use_deferred(const FileData *fd, const BHead *bhead)
+{
+  if (!read_use_deferred_packed_data || (fd->flags & FD_FLAGS_IS_FILE) == 0) {
+    return false;
+  }
+  /* Only raw data, read as is. */
+  if (bhead->SDNAnr != 0 || bhead->len < READ_DEFER_MIN_SIZE ||
+      fd->compflags[0] == SDNA_CMP_NOT_EQUAL)
+  {
+    return false;
+  }
+#ifdef USE_BHEAD_READ_ON_DEMAND
+  return BHEADN_FROM_BHEAD(bhead)->has_data == false;
+#else
+  return false;
+#endif
+}
+
+/* Read a deferred data-block used by something else than packed data. */
+static void *read_data_undeferred(FileData *fd, const void *adr, const bool increase_users)
+{
+  BHead *bhead = static_cast<BHead *>(oldnewmap_pop(fd->deferredmap, adr));
+  if (bhead == nullptr) {
+    return nullptr;
+  }
+  void *data = read_struct(fd, bhead, "Data from deferred block");
+  oldnewmap_insert(fd->datamap, bhead->old, data, 0);
+  return oldnewmap_lookup_and_inc(fd->datamap, adr, increase_users);
+}
+
+/* Called with #deferred_mutex locked. */
+static void read_deferred_file_release_locked(BLODeferredFile *deferred_file)
+{
+  BLI_assert(deferred_file->users > 0);
+  deferred_file->users--;
+  if (deferred_file->users == 0) {
+    deferred_file->file->close(deferred_file->file);
+    MEM_freeN(deferred_file);
+  }
+}
+
+static void read_deferred_file_release(BLODeferredFile *deferred_file)
+{
+  BLI_mutex_lock(&deferred_mutex);
+  /* Only the deferred data is read from now on, at random positions. */
+  FileReader *file = deferred_file->file;
+  if (file->release_cache && deferred_file->users > 1) {
+    file->release_cache(file);
+  }
+  read_deferred_file_release_locked(deferred_file);
+  BLI_mutex_unlock(&deferred_mutex);
+}
+
+bool BLO_read_deferred_packed_address(BlendDataReader *reader, void **ptr_p)
+{
+  FileData *fd = reader->fd;
+  if (fd->deferredmap == nullptr || fd->packedmap) {
+    return false;
+  }
+  BHead *bhead = static_cast<BHead *>(oldnewmap_pop(fd->deferredmap, *ptr_p));
+  if (bhead == nullptr) {
+    return false;
+  }
+
+  BLI_mutex_lock(&deferred_mutex);
+  if (fd->deferred_file == nullptr) {
+    fd->deferred_file = MEM_cnew<BLODeferredFile>(__func__);
+    fd->deferred_file->file = fd->file;
+    fd->deferred_file->users = 1;
+  }
+  fd->deferred_file->users++;
+  if (deferred_data == nullptr) {
+    deferred_data = MEM_new<blender::Map<void **, DeferredData>>(__func__);
+  }
+  deferred_data->add_overwrite(
+      ptr_p, {fd->deferred_file, BHEADN_FROM_BHEAD(bhead)->file_offset, bhead->len});
+  deferred_stats.deferred_num++;
+  deferred_stats.deferred_size += size_t(bhead->len);
+  BLI_mutex_unlock(&deferred_mutex);
+
+  *ptr_p = nullptr;
+  return true;
+}
+
+/* Called with #deferred_mutex locked. */
+static void read_deferred_data_remove_locked(void **ptr_p)
+{
+  deferred_data->remove(ptr_p);
+  if (deferred_data->is_empty()) {
+    MEM_delete(deferred_data);
+    deferred_data = nullptr;
+  }
+}
+
+bool BLO_read_deferred_data_ensure(void **ptr_p)
+{
+  BLI_mutex_lock(&deferred_mutex);
+  const DeferredData *data = deferred_data ? deferred_data->lookup_ptr(ptr_p) : nullptr;
+  if (*ptr_p != nullptr || data == nullptr) {
+    /* Read by another thread, or not deferred. */
+    BLI_mutex_unlock(&deferred_mutex);
+    return *ptr_p != nullptr;
+  }
+
+  /* The file data may still be reading the file, keep its position. */
+  FileReader *file = data->file->file;
+  const off64_t offset_backup = file->offset;
+  void *buf = MEM_mallocN(size_t(data->len), "Data from deferred block");
+  bool success = file->seek(file, data->file_offset, SEEK_SET) != -1 &&
+                 file->read(file, buf, size_t(data->len)) == data->len;
+  if (file->seek(file, offset_backup, SEEK_SET) == -1) {
+    success = false;
+  }
+
+  if (success) {
+    *ptr_p = buf;
+    deferred_stats.read_num++;
+    deferred_stats.read_size += size_t(data->len);
+  }
+  else {
+    MEM_freeN(buf);
+  }
+  read_deferred_file_release_locked(data->file);
+  read_deferred_data_remove_locked(ptr_p);
+  BLI_mutex_unlock(&deferred_mutex);
+
+  return success;
+}
+
+void BLO_read_deferred_data_release(void **ptr_p)
+{
+  BLI_mutex_lock(&deferred_mutex);
+  const DeferredData *data = deferred_data ? deferred_data->lookup_ptr(ptr_p) : nullptr;
+  if (data) {
+    read_deferred_file_release_locked(data->file);
+    read_deferred_data_remove_locked(ptr_p);
+  }
+  BLI_mutex_unlock(&deferred_mutex);
+}
+
+/** \} */
+
 /* -------------------------------------------------------------------- */
 /** \name Read Library Data Block
  * \{ */
@@ -2492,6 +2721,11 @@ static BHead *read_data_into_datamap(FileData *fd, BHead *bhead, const char *all
 {
   bhead = blo_bhead_next(fd, bhead);
 
+  if (fd->deferredmap) {
+    /* Not read by the previous ID, the #BHead data is owned by the file data. */
+    fd->deferredmap->map.clear();
+  }
+
   while (bhead && bhead->code == BLO_CODE_DATA) {
     /* The code below is useful for debugging leaks in data read from the blend file.
      * Without this the messages only tell us what ID-type the memory came from,
@@ -2513,6 +2747,15 @@ static BHead *read_data_into_datamap(FileData *fd, BHead *bhead, const char *all
     }
 #endif
 
+    if (read_data_use_deferred(fd, bhead)) {
+      if (fd->deferredmap == nullptr) {
+        fd->deferredmap = oldnewmap_new();
+      }
+      oldnewmap_insert(fd->deferredmap, bhead->old, bhead, 0);
+      bhead = blo_bhead_next(fd, bhead);
+      continue;
+    }
+
     void *data = read_struct(fd, bhead, allocname);
     if (data) {
       oldnewmap_insert(fd->datamap, bhead->old, data, 0);
@@ -3021,6 +3264,172 @@ static BHead *read_libblock(FileData *fd,
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name Parallel Data-Block Conversion
+ *
+ * Converting the data-blocks of a file written with another DNA or endianness (endian switching
+ * and #DNA_struct_reconstruct) is independent for each block. It's done for all the #BLO_CODE_DATA
+ * blocks of the file in parallel before reading the IDs, #read_struct then takes the converted
+ * blocks from #FileData.convertedmap. Reading the IDs, direct linking and the old/new pointer
+ * mapping stay sequential, the read data is identical to the sequential conversion.
+ * \{ */
+
+static bool read_use_parallel_conversion = true;
+static std::atomic<size_t> read_parallel_converted_num = 0;
+
+void BLO_read_parallel_conversion_set(const bool use_parallel)
+{
+  read_use_parallel_conversion = use_parallel;
+}
+
+size_t BLO_read_parallel_conversion_num_get()
+{
+  return read_parallel_converted_num;
+}
+
+/** Amount of data converted at once, bounding the temporary copies of delayed blocks. */
+#define READ_CONVERT_BATCH_SIZE (64 << 20)
+
+/* Whether #read_struct does more than copying the block. */
+static bool read_data_needs_conversion(const FileData *fd, const BHead *bhead)
+{
+  if (bhead->code != BLO_CODE_DATA || bhead->len == 0 ||
+      fd->compflags[bhead->SDNAnr] == SDNA_CMP_REMOVED)
+  {
+    return false;
+  }
+  return (fd->compflags[bhead->SDNAnr] == SDNA_CMP_NOT_EQUAL) ||
+         (bhead->SDNAnr && (fd->flags & FD_FLAGS_SWITCH_ENDIAN));
+}
+
+static bool read_data_use_parallel_conversion(const FileData *fd)
+{
+  if (!read_use_parallel_conversion || BLI_task_scheduler_num_threads() < 2) {
+    return false;
+  }
+  if (fd->flags & FD_FLAGS_SWITCH_ENDIAN) {
+    return true;
+  }
+  for (int i = 0; i < fd->filesdna->structs_len; i++) {
+    if (fd->compflags[i] == SDNA_CMP_NOT_EQUAL) {
+      return true;
+    }
+  }
+  return false;
+}
+
+struct ReadConvertBlock {
+  /** The block of the file, key of #FileData.convertedmap. */
+  BHead *bhead;
+  /** The block with its data, a temporary copy when reading it was delayed. */
+  BHead *bhead_data;
+  const char *allocname;
+  void *data;
+};
+
+/* Same as #read_struct for a block with its data. */
+static void *read_data_convert(FileData *fd, BHead *bh, const char *blockname)
+{
+  if (bh->SDNAnr && (fd->flags & FD_FLAGS_SWITCH_ENDIAN)) {
+    switch_endian_structs(fd->filesdna, bh);
+  }
+  if (fd->compflags[bh->SDNAnr] == SDNA_CMP_NOT_EQUAL) {
+    return DNA_struct_reconstruct(fd->reconstruct_info, bh->SDNAnr, bh->nr, (bh + 1));
+  }
+  void *temp = MEM_mallocN(bh->len, blockname);
+  memcpy(temp, (bh + 1), bh->len);
+  return temp;
+}
+
+static void read_data_convert_batch(FileData *fd, blender::MutableSpan<ReadConvertBlock> blocks)
+{
+  blender::threading::parallel_for(
+      blocks.index_range(),
+      256,
+      [&](const blender::IndexRange range) {
+        for (ReadConvertBlock &block : blocks.slice(range)) {
+          block.data = read_data_convert(fd, block.bhead_data, block.allocname);
+        }
+      },
+      blender::threading::individual_task_sizes(
+          [&](const int64_t i) { return int64_t(blocks[i].bhead->len); }));
+
+  /* Merge in the order of the file, like #read_data_into_datamap. */
+  for (ReadConvertBlock &block : blocks) {
+#ifdef USE_BHEAD_READ_ON_DEMAND
+    if (block.bhead_data != block.bhead) {
+      MEM_freeN(BHEADN_FROM_BHEAD(block.bhead_data));
+    }
+#endif
+    if (block.data) {
+      oldnewmap_insert(fd->convertedmap, block.bhead, block.data, 0);
+    }
+  }
+  read_parallel_converted_num += size_t(blocks.size());
+}
+
+/**
+ * Convert the data-blocks of the file in parallel, the blocks of which reading was delayed are
+ * read sequentially, in batches to bound the memory used by their temporary copies.
+ */
+static void read_data_convert_parallel(FileData *fd)
+{
+  fd->convertedmap = oldnewmap_new();
+
+  blender::Vector<ReadConvertBlock> blocks;
+  size_t blocks_size = 0;
+  const char *allocname = idtype_alloc_name_get(0);
+  bool is_skipped = false;
+
+  for (BHead *bhead = blo_bhead_first(fd); bhead; bhead = blo_bhead_next(fd, bhead)) {
+    if (bhead->code == BLO_CODE_ENDB) {
+      break;
+    }
+    if (bhead->code != BLO_CODE_DATA) {
+      /* Data-blocks follow the block using them, name them like #read_libblock does. */
+      allocname = idtype_alloc_name_get(blo_bhead_is_id_valid_type(bhead) ? bhead->code : 0);
+      is_skipped = (bhead->code == BLO_CODE_USER) && (fd->skip_flags & BLO_READ_SKIP_USERDEF);
+      continue;
+    }
+    if (is_skipped || !read_data_needs_conversion(fd, bhead)) {
+      continue;
+    }
+
+    BHead *bhead_data = bhead;
+#ifdef USE_BHEAD_READ_ON_DEMAND
+    if (BHEADN_FROM_BHEAD(bhead)->has_data == false) {
+      bhead_data = blo_bhead_read_full(fd, bhead);
+      if (bhead_data == nullptr) {
+        /* Leave the error to #read_struct. */
+        continue;
+      }
+    }
+#endif
+    blocks.append({bhead, bhead_data, allocname, nullptr});
+    blocks_size += size_t(bhead->len);
+
+    if (blocks_size >= READ_CONVERT_BATCH_SIZE) {
+      read_data_convert_batch(fd, blocks);
+      blocks.clear();
+      blocks_size = 0;
+    }
+  }
+
+  read_data_convert_batch(fd, blocks);
+}
+
+/* Free the converted data-blocks that weren't read. */
+static void read_data_convert_end(FileData *fd)
+{
+  if (fd->convertedmap) {
+    oldnewmap_clear(fd->convertedmap);
+    oldnewmap_free(fd->convertedmap);
+    fd->convertedmap = nullptr;
+  }
+}
+
+/** \} */
+
 /* -------------------------------------------------------------------- */
 /** \name Read Asset Data
  * \{ */
@@ -3599,6 +4008,9 @@ BlendFileData *blo_read_file_internal(FileData *fd, const char *filepath)
     /* Copy all 'no undo' local data from old to new bmain. */
     read_undo_reuse_noundo_local_ids(fd);
   }
+  else if ((fd->skip_flags & BLO_READ_SKIP_DATA) == 0 && read_data_use_parallel_conversion(fd)) {
+    read_data_convert_parallel(fd);
+  }
 
   while (bhead) {
     switch (bhead->code) {
@@ -3655,6 +4067,8 @@ BlendFileData *blo_read_file_internal(FileData *fd, const char *filepath)
     }
   }
 
+  read_data_convert_end(fd);
+
   if (is_undo) {
     /* Move the remaining Library IDs and their linked data to the new main.
      *
@@ -4655,7 +5069,7 @@ static FileData *read_library_file_data(FileData *basefd,
                      RPT_("Read packed library: '%s', parent '%s'"),
                      mainptr->curlib->filepath,
                      library_parent_filepath(mainptr->curlib));
-    fd = blo_filedata_from_memory(pf->data, pf->size, basefd->reports);
+    fd = blo_filedata_from_memory(BKE_packedfile_data_get(pf), pf->size, basefd->reports);
 
     /* Needed for library_append and read_libraries. */
     STRNCPY(fd->relabase, mainptr->curlib->runtime.filepath_abs);
@@ -5134,6 +5548,7 @@ BlendFileData *blo_read_blendafterruntime(int file,
   FileData *fd = filedata_new(reports);
   fd->file = BLI_filereader_new_file(file);
   fd->file->seek(fd->file, datastart, SEEK_SET);
+  fd->flags |= FD_FLAGS_IS_FILE;
   /*fd->filedes = file;
   fd->buffersize = actualsize;
   fd->read = fd_read_data_from_file;*/
@@ -26,6 +26,7 @@ struct BlendFileData;
 struct BlendFileReadParams;
 struct BlendFileReadReport;
 struct BLOCacheStorage;
+struct BLODeferredFile;
 struct BHeadSort;
 struct DNA_ReconstructInfo;
 struct IDNameLib_Map;
@@ -45,8 +46,10 @@ enum eFileDataFlag {
   FD_FLAGS_IS_MEMFILE = 1 << 4,
   /* XXX Unused in practice (checked once but never set). */
   FD_FLAGS_NOT_MY_LIBMAP = 1 << 5,
+  /** Reading a file on disk, which can still be read once reading is done. */
+  FD_FLAGS_IS_FILE = 1 << 6,
 };
-ENUM_OPERATORS(eFileDataFlag, FD_FLAGS_NOT_MY_LIBMAP)
+ENUM_OPERATORS(eFileDataFlag, FD_FLAGS_IS_FILE)
 
 /* Disallow since it's 32bit on ms-windows. */
 #ifdef __GNUC__
@@ -112,6 +115,18 @@ struct FileData {
   OldNewMap *libmap;
 
   OldNewMap *packedmap;
+  /**
+   * Data-blocks converted ahead of reading the IDs, from the #BHead pointers.
+   * See #read_data_convert_parallel.
+   */
+  OldNewMap *convertedmap;
+  /**
+   * Data-blocks of the current ID which reading is deferred, from the old addresses to the
+   * #BHead pointers. See #read_data_use_deferred.
+   */
+  OldNewMap *deferredmap;
+  /** The file shared with the deferred data, once some data is deferred. */
+  BLODeferredFile *deferred_file;
   BLOCacheStorage *cache_storage;
 
   BHeadSort *bheadmap;
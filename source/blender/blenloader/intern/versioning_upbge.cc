@@ -424,4 +424,11 @@ void blo_do_versions_upbge(FileData *fd, Library */*lib*/, Main *bmain)
       }
     }
   }
+
+  if (!DNA_struct_member_exists(fd->filesdna, "GameData", "float", "broadphaseWorldSize")) {
+    LISTBASE_FOREACH (Scene *, scene, &bmain->scenes) {
+      scene->gm.broadphaseWorldSize = 10000.0f;
+      scene->gm.broadphaseCellSize = 10.0f;
+    }
+  }
 }
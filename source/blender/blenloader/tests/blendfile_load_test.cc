@@ -3,7 +3,33 @@
  * SPDX-License-Identifier: GPL-2.0-or-later */
 #include "blendfile_loading_base_test.h"
 
+#include <cstring>
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_fileops.h"
+#include "BLI_listbase.h"
 #include "BLI_path_util.h"
+#include "BLI_string.h"
+#include "BLI_task.h"
+#include "BLI_vector.hh"
+
+#include "BKE_appdir.hh"
+#include "BKE_global.hh"
+#include "BKE_idtype.hh"
+#include "BKE_lib_id.hh"
+#include "BKE_main.hh"
+#include "BKE_mesh.hh"
+#include "BKE_packedFile.h"
+
+#include "BLO_readfile.hh"
+#include "BLO_writefile.hh"
+
+#include "DNA_genfile.h"
+#include "DNA_mesh_types.h"
+#include "DNA_packedFile_types.h"
+#include "DNA_sdna_types.h"
+#include "DNA_vfont_types.h"
 
 class BlendfileLoadingTest : public BlendfileLoadingBaseTest {};
 
@@ -16,3 +42,190 @@ TEST_F(BlendfileLoadingTest, CanaryTest)
   depsgraph_create(DAG_EVAL_RENDER);
   EXPECT_NE(nullptr, this->depsgraph);
 }
+
+/* Compare the members of two DNA structs, except pointers and ID headers that differ between two
+ * reads of the same file. */
+static bool dna_struct_equal(const SDNA *sdna, const int struct_nr, const char *a, const char *b)
+{
+  const SDNA_Struct *struct_info = sdna->structs[struct_nr];
+  int offset = 0;
+  for (int i = 0; i < struct_info->members_len; i++) {
+    const SDNA_StructMember &member = struct_info->members[i];
+    const char *name = sdna->names[member.name];
+    const char *type = sdna->types[member.type];
+    const int size = DNA_struct_member_size(sdna, member.type, member.name);
+    const bool is_pointer = (name[0] == '*' || (name[0] == '(' && name[1] == '*'));
+
+    if (!is_pointer && !STREQ(type, "ID")) {
+      const int member_struct_nr = DNA_struct_find_without_alias(sdna, type);
+      if (member_struct_nr != -1) {
+        const int type_size = sdna->types_size[member.type];
+        for (int j = 0; j < sdna->names_array_len[member.name]; j++) {
+          const int member_offset = offset + j * type_size;
+          if (!dna_struct_equal(sdna, member_struct_nr, a + member_offset, b + member_offset)) {
+            return false;
+          }
+        }
+      }
+      else if (memcmp(a + offset, b + offset, size) != 0) {
+        return false;
+      }
+    }
+    offset += size;
+  }
+  return true;
+}
+
+template<typename T>
+static bool spans_equal(const blender::Span<T> a, const blender::Span<T> b)
+{
+  return a.size() == b.size() &&
+         (a.is_empty() || memcmp(a.data(), b.data(), a.size_in_bytes()) == 0);
+}
+
+static void expect_mesh_equal(const Mesh &a, const Mesh &b)
+{
+  EXPECT_TRUE(spans_equal(a.vert_positions(), b.vert_positions())) << a.id.name;
+  EXPECT_TRUE(spans_equal(a.edges(), b.edges())) << a.id.name;
+  EXPECT_TRUE(spans_equal(a.face_offsets(), b.face_offsets())) << a.id.name;
+  EXPECT_TRUE(spans_equal(a.corner_verts(), b.corner_verts())) << a.id.name;
+  EXPECT_TRUE(spans_equal(a.corner_edges(), b.corner_edges())) << a.id.name;
+}
+
+static blender::Vector<ID *> main_ids(Main *bmain)
+{
+  blender::Vector<ID *> ids;
+  ID *id;
+  FOREACH_MAIN_ID_BEGIN (bmain, id) {
+    ids.append(id);
+  }
+  FOREACH_MAIN_ID_END;
+  return ids;
+}
+
+/* Check that the same IDs were read with the same data. */
+static void expect_main_equal(Main *a, Main *b)
+{
+  const SDNA *sdna = DNA_sdna_current_get();
+  const blender::Vector<ID *> ids_a = main_ids(a);
+  const blender::Vector<ID *> ids_b = main_ids(b);
+  ASSERT_EQ(ids_a.size(), ids_b.size());
+
+  for (const int i : ids_a.index_range()) {
+    const ID *id_a = ids_a[i];
+    const ID *id_b = ids_b[i];
+    ASSERT_STREQ(id_a->name, id_b->name);
+
+    const IDTypeInfo *id_type = BKE_idtype_get_info_from_id(id_a);
+    const int struct_nr = DNA_struct_find_without_alias(sdna, id_type->name);
+    if (struct_nr != -1) {
+      EXPECT_TRUE(dna_struct_equal(sdna,
+                                   struct_nr,
+                                   reinterpret_cast<const char *>(id_a),
+                                   reinterpret_cast<const char *>(id_b)))
+          << id_a->name;
+    }
+
+    if (GS(id_a->name) == ID_ME) {
+      expect_mesh_equal(*reinterpret_cast<const Mesh *>(id_a),
+                        *reinterpret_cast<const Mesh *>(id_b));
+    }
+  }
+}
+
+TEST_F(BlendfileLoadingTest, ParallelConversion)
+{
+  /* Written by an older version, the data-blocks are converted when reading. */
+  const char *filepath = "modifier_stack" SEP_STR "array_test.blend";
+
+  if (BLI_task_scheduler_num_threads() < 2) {
+    GTEST_SKIP() << "The parallel conversion needs at least two threads";
+  }
+
+  const size_t converted_num_start = BLO_read_parallel_conversion_num_get();
+  BLO_read_parallel_conversion_set(false);
+  const bool loaded = blendfile_load(filepath);
+  BLO_read_parallel_conversion_set(true);
+  if (!loaded) {
+    return;
+  }
+  EXPECT_EQ(BLO_read_parallel_conversion_num_get(), converted_num_start);
+  BlendFileData *bfile_sequential = bfile;
+  bfile = nullptr;
+
+  if (blendfile_load(filepath)) {
+    EXPECT_GT(BLO_read_parallel_conversion_num_get(), converted_num_start)
+        << "The file was read without converting data-blocks in parallel";
+    expect_main_equal(bfile_sequential->main, bfile->main);
+  }
+  BLO_blendfiledata_free(bfile_sequential);
+}
+
+TEST_F(BlendfileLoadingTest, DeferredPackedData)
+{
+  if (!blendfile_load("modifier_stack" SEP_STR "array_test.blend")) {
+    return;
+  }
+
+  /* Pack data large enough to be deferred, in a compressed file to use the seekable zstd
+   * reader. */
+  const int size = 256 * 1024;
+  blender::Vector<char> data(size);
+  for (int i = 0; i < size; i++) {
+    data[i] = char(i * 7 + i / 1024);
+  }
+  VFont *vfont = static_cast<VFont *>(BKE_id_new(bfile->main, ID_VF, "Deferred"));
+  id_fake_user_set(&vfont->id);
+  vfont->packedfile = BKE_packedfile_new_from_memory(MEM_dupallocN(data.data()), size);
+
+  BKE_tempdir_init(nullptr);
+  char filepath[FILE_MAX];
+  BLI_path_join(filepath, sizeof(filepath), BKE_tempdir_session(), "deferred_packed_data.blend");
+  BlendFileWriteParams params{};
+  ASSERT_TRUE(BLO_write_file(bfile->main, filepath, G_FILE_COMPRESS, &params, nullptr));
+  blendfile_free();
+
+  BLODeferredDataStats stats_start;
+  BLO_read_deferred_data_stats_get(&stats_start);
+
+  /* Data is only read on access. */
+  BLO_read_deferred_packed_data_set(true);
+  BlendFileReadReport reports = {};
+  bfile = BLO_read_from_file(filepath, BLO_READ_SKIP_NONE, &reports);
+  ASSERT_NE(bfile, nullptr);
+
+  vfont = static_cast<VFont *>(
+      BLI_findstring(&bfile->main->fonts, "VFDeferred", offsetof(ID, name)));
+  ASSERT_NE(vfont, nullptr);
+  ASSERT_NE(vfont->packedfile, nullptr);
+  EXPECT_EQ(vfont->packedfile->data, nullptr);
+  EXPECT_EQ(vfont->packedfile->size, size);
+
+  BLODeferredDataStats stats;
+  BLO_read_deferred_data_stats_get(&stats);
+  EXPECT_GE(stats.deferred_num, stats_start.deferred_num + 1);
+  EXPECT_GE(stats.deferred_size, stats_start.deferred_size + size);
+  EXPECT_EQ(stats.read_num, stats_start.read_num);
+
+  const void *read_data = BKE_packedfile_data_get(vfont->packedfile);
+  ASSERT_NE(read_data, nullptr);
+  EXPECT_EQ(memcmp(read_data, data.data(), size), 0);
+
+  BLO_read_deferred_data_stats_get(&stats);
+  EXPECT_EQ(stats.read_num, stats_start.read_num + 1);
+  EXPECT_EQ(stats.read_size, stats_start.read_size + size);
+  blendfile_free();
+
+  /* Freeing data that was never accessed releases the file without reading it. */
+  stats_start = stats;
+  bfile = BLO_read_from_file(filepath, BLO_READ_SKIP_NONE, &reports);
+  BLO_read_deferred_packed_data_set(false);
+  ASSERT_NE(bfile, nullptr);
+  blendfile_free();
+
+  BLO_read_deferred_data_stats_get(&stats);
+  EXPECT_GT(stats.deferred_num, stats_start.deferred_num);
+  EXPECT_EQ(stats.read_num, stats_start.read_num);
+
+  BLI_delete(filepath, false, false);
+}
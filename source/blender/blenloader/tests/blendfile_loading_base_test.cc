@@ -23,6 +23,7 @@
 #include "BLF_api.hh"
 
 #include "BLI_path_util.h"
+#include "BLI_task.h"
 #include "BLI_threads.h"
 
 #include "BLO_readfile.hh"
@@ -54,6 +55,7 @@ void BlendfileLoadingBaseTest::SetUpTestCase()
    * main() in creator.c. */
   CLG_init();
   BLI_threadapi_init();
+  BLI_task_scheduler_init();
 
   DNA_sdna_current_init();
   BKE_blender_globals_init();
@@ -94,6 +96,7 @@ void BlendfileLoadingBaseTest::TearDownTestCase()
   DEG_free_node_types();
   GHOST_DisposeSystemPaths();
   DNA_sdna_current_free();
+  BLI_task_scheduler_exit();
   BLI_threadapi_exit();
 
   BKE_blender_atexit();
@@ -0,0 +1,45 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "blendfile_loading_base_test.h"
+
+#include "BLI_path_util.h"
+#include "BLI_timeit.hh"
+
+#include "BLO_readfile.hh"
+
+/* Compare the read time of files written by older versions with the sequential and the parallel
+ * conversion of their data-blocks. Each file is read several times to hide the disk cache. */
+
+static constexpr int READ_NUM = 10;
+
+static const char *blendfiles[] = {
+    "usd" SEP_STR "usd_hierarchy_export_test.blend",
+    "io_tests" SEP_STR "blend_geometry" SEP_STR "all_quads.blend",
+    "alembic" SEP_STR "visibility.blend",
+};
+
+class BlendfileLoadPerformanceTest : public BlendfileLoadingBaseTest {
+ protected:
+  void read_files(const char *timer_name)
+  {
+    SCOPED_TIMER(timer_name);
+    for (int i = 0; i < READ_NUM; i++) {
+      for (const char *filepath : blendfiles) {
+        if (!blendfile_load(filepath)) {
+          return;
+        }
+        blendfile_free();
+      }
+    }
+  }
+};
+
+TEST_F(BlendfileLoadPerformanceTest, ParallelConversion)
+{
+  BLO_read_parallel_conversion_set(false);
+  read_files("sequential conversion");
+  BLO_read_parallel_conversion_set(true);
+  read_files("parallel conversion");
+}
@@ -118,4 +118,4 @@ void COM_deinitialize();
  * \brief Clear all compositor caches. (Compositor system will still remain available).
  * To deinitialize the compositor use the COM_deinitialize method.
  */
-// void COM_clear_caches(); // NOT YET WRITTEN
+void COM_clear_caches();
@@ -23,6 +23,19 @@ class ProfilerData {
   /* Per-node accumulated execution time. Includes execution time of all operations the node was
    * broken down into. */
   Map<bNodeInstanceKey, timeit::Nanoseconds> per_node_execution_time;
+
+  /* Peak size of the operations output buffers allocated at the same time, in bytes. */
+  int64_t buffers_peak_size = 0;
+  /* Size of the operations output buffers that reused the memory of a released buffer, in
+   * bytes. */
+  int64_t buffers_reused_size = 0;
+
+  /* Number of operations whose result was reused from a previous execution. */
+  int result_cache_hits = 0;
+  /* Number of operations whose result could be cached but had to be rendered. */
+  int result_cache_misses = 0;
+  /* Size of the results kept for the next executions, in bytes. */
+  int64_t result_cache_size = 0;
 };
 
 /* Profiler implementation which is used by the node execution system. */
@@ -36,6 +49,12 @@ class Profiler {
                                     const timeit::TimePoint &start,
                                     const timeit::TimePoint &end);
 
+  /* Store the memory statistics of the operations output buffers. */
+  void set_buffers_memory(int64_t peak_size, int64_t reused_size);
+
+  /* Store the statistics of the operations results cache. */
+  void set_result_cache_stats(int hits, int misses, int64_t size);
+
   void finalize(const bNodeTree &node_tree);
 
   const ProfilerData &get_data() const
@@ -13,6 +13,7 @@ CompositorContext::CompositorContext()
   quality_ = eCompositorQuality::High;
   fast_calculation_ = false;
   bnodetree_ = nullptr;
+  result_cache_ = nullptr;
 }
 
 int CompositorContext::get_framenumber() const
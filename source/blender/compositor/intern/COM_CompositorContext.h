@@ -18,6 +18,8 @@ class RenderContext;
 
 namespace blender::compositor {
 
+class OperationResultCache;
+
 /**
  * \brief Overall context of the compositor
  */
@@ -75,6 +77,12 @@ class CompositorContext {
    */
   realtime_compositor::RenderContext *render_context_;
 
+  /**
+   * \brief Cache of operations results kept across executions. Can be null when results must not
+   * be cached, for example on the fast calculation pass.
+   */
+  OperationResultCache *result_cache_;
+
  public:
   /**
    * \brief constructor initializes the context with default values.
@@ -213,6 +221,22 @@ class CompositorContext {
     view_name_ = view_name;
   }
 
+  /**
+   * \brief get the cache of operations results kept across executions
+   */
+  OperationResultCache *get_result_cache() const
+  {
+    return result_cache_;
+  }
+
+  /**
+   * \brief set the cache of operations results kept across executions
+   */
+  void set_result_cache(OperationResultCache *result_cache)
+  {
+    result_cache_ = result_cache;
+  }
+
   void set_fast_calculation(bool fast_calculation)
   {
     fast_calculation_ = fast_calculation;
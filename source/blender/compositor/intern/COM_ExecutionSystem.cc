@@ -24,7 +24,8 @@ ExecutionSystem::ExecutionSystem(RenderData *rd,
                                  bool fastcalculation,
                                  const char *view_name,
                                  realtime_compositor::RenderContext *render_context,
-                                 ProfilerData &profiler_data)
+                                 ProfilerData &profiler_data,
+                                 OperationResultCache *result_cache)
     : profiler_data_(profiler_data)
 {
   num_work_threads_ = WorkScheduler::get_num_cpu_threads();
@@ -44,6 +45,7 @@ ExecutionSystem::ExecutionSystem(RenderData *rd,
   context_.set_rendering(rendering);
 
   context_.set_render_data(rd);
+  context_.set_result_cache(result_cache);
 
   BLI_mutex_init(&work_mutex_);
   BLI_condition_init(&work_finished_cond_);
@@ -124,7 +126,8 @@ void ExecutionSystem::execute_work(const rcti &work_rect,
       BLI_mutex_lock(&work_mutex_);
       num_sub_works_finished++;
       if (num_sub_works_finished == num_sub_works) {
-        BLI_condition_notify_one(&work_finished_cond_);
+        /* Several operations may be waiting for their works when rendered concurrently. */
+        BLI_condition_notify_all(&work_finished_cond_);
       }
       BLI_mutex_unlock(&work_mutex_);
     };
@@ -139,7 +142,7 @@ void ExecutionSystem::execute_work(const rcti &work_rect,
    * TODO: This a workaround for WorkScheduler::finish() not waiting all works on queue threading
    * model. Sync code should be removed once it's fixed. */
   BLI_mutex_lock(&work_mutex_);
-  if (num_sub_works_finished < num_sub_works) {
+  while (num_sub_works_finished < num_sub_works) {
     BLI_condition_wait(&work_finished_cond_, &work_mutex_);
   }
   BLI_mutex_unlock(&work_mutex_);
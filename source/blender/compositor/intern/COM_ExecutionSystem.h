@@ -26,6 +26,7 @@ class RenderContext;
 
 namespace blender::compositor {
 
+class OperationResultCache;
 class ProfilerData;
 
 /**
@@ -131,6 +132,7 @@ class ExecutionSystem {
    *
    * \param editingtree: [bNodeTree *]
    * \param rendering: [true false]
+   * \param result_cache: Cache of operations results kept across executions, can be null.
    */
   ExecutionSystem(RenderData *rd,
                   Scene *scene,
@@ -139,7 +141,8 @@ class ExecutionSystem {
                   bool fastcalculation,
                   const char *view_name,
                   realtime_compositor::RenderContext *render_context,
-                  ProfilerData &profiler_data);
+                  ProfilerData &profiler_data,
+                  OperationResultCache *result_cache);
 
   /**
    * Destructor
@@ -4,11 +4,21 @@
 
 #include "COM_FullFrameExecutionModel.h"
 
+#include "atomic_ops.h"
+
+#include "BLI_array.hh"
+#include "BLI_map.hh"
+#include "BLI_set.hh"
 #include "BLI_string.h"
+#include "BLI_task.h"
+#include "BLI_utildefines.h"
 
 #include "BLT_translation.hh"
 
+#include "COM_ConstantOperation.h"
 #include "COM_Debug.h"
+#include "COM_MemoryBuffer.h"
+#include "COM_OperationResultCache.h"
 #include "COM_ViewerOperation.h"
 #include "COM_WorkScheduler.h"
 
@@ -25,7 +35,10 @@ FullFrameExecutionModel::FullFrameExecutionModel(CompositorContext &context,
                                                  Span<NodeOperation *> operations)
     : ExecutionModel(context, operations),
       active_buffers_(shared_buffers),
-      num_operations_finished_(0)
+      num_operations_finished_(0),
+      result_cache_(context.get_result_cache()),
+      num_cache_hits_(0),
+      num_cache_misses_(0)
 {
   priorities_.append(eCompositorPriority::High);
   if (!context.is_fast_calculation()) {
@@ -42,12 +55,95 @@ void FullFrameExecutionModel::execute(ExecutionSystem &exec_system)
 
   DebugInfo::graphviz(&exec_system, "compositor_prior_rendering");
 
+  determine_cached_results();
   determine_areas_to_render_and_reads();
+  determine_render_order();
   render_operations();
 
+  profiler_.set_buffers_memory(buffer_pool_.get_peak_size(), buffer_pool_.get_reused_size());
+  if (result_cache_) {
+    profiler_.set_result_cache_stats(num_cache_hits_, num_cache_misses_, result_cache_->get_size());
+  }
   profiler_.finalize(*node_tree);
 }
 
+std::optional<size_t> FullFrameExecutionModel::get_result_hash(
+    NodeOperation *op, Map<NodeOperation *, std::optional<size_t>> &r_hashes)
+{
+  if (const std::optional<size_t> *hash = r_hashes.lookup_ptr(op)) {
+    return *hash;
+  }
+
+  std::optional<size_t> hash;
+  if (op->get_flags().is_constant_operation) {
+    const float *elem = static_cast<ConstantOperation *>(op)->get_constant_elem();
+    const DataType data_type = op->get_output_socket()->get_data_type();
+    hash = get_default_hash(data_type);
+    for (const int i : IndexRange(COM_data_type_num_channels(data_type))) {
+      hash = BLI_ghashutil_combine_hash(*hash, get_default_hash(elem[i]));
+    }
+  }
+  else if (const std::optional<NodeOperationHash> op_hash = op->generate_hash()) {
+    hash = op_hash->get_params_hash();
+    for (int i = 0; i < op->get_number_of_input_sockets(); i++) {
+      const std::optional<size_t> input_hash = get_result_hash(op->get_input_operation(i),
+                                                               r_hashes);
+      if (!input_hash) {
+        hash = std::nullopt;
+        break;
+      }
+      hash = BLI_ghashutil_combine_hash(*hash, *input_hash);
+    }
+  }
+
+  r_hashes.add(op, hash);
+  return hash;
+}
+
+void FullFrameExecutionModel::determine_cached_results()
+{
+  if (result_cache_ == nullptr || !result_cache_->is_enabled()) {
+    return;
+  }
+
+  Map<NodeOperation *, std::optional<size_t>> hashes;
+  for (NodeOperation *op : operations_) {
+    get_result_hash(op, hashes);
+  }
+
+  /* Only cache the results read by operations that aren't hashed. A cached result skips the
+   * rendering of its whole inputs tree, caching results in the middle of it would be redundant. */
+  Set<NodeOperation *> boundary_ops;
+  for (NodeOperation *op : operations_) {
+    if (hashes.lookup(op)) {
+      continue;
+    }
+    for (int i = 0; i < op->get_number_of_input_sockets(); i++) {
+      NodeOperation *input_op = op->get_input_operation(i);
+      const bool has_size = input_op->get_width() > 0 && input_op->get_height() > 0;
+      if (hashes.lookup(input_op) && !input_op->get_flags().is_constant_operation && has_size) {
+        boundary_ops.add(input_op);
+      }
+    }
+  }
+
+  for (NodeOperation *op : boundary_ops) {
+    const size_t hash = *hashes.lookup(op);
+    std::shared_ptr<const MemoryBuffer> result = result_cache_->lookup(hash);
+    if (result) {
+      cached_results_.add_new(op, std::move(result));
+    }
+    else {
+      result_hashes_.add_new(op, hash);
+    }
+  }
+}
+
+int FullFrameExecutionModel::get_num_read_inputs(const NodeOperation *op) const
+{
+  return cached_results_.contains(op) ? 0 : op->get_number_of_input_sockets();
+}
+
 void FullFrameExecutionModel::determine_areas_to_render_and_reads()
 {
   const bool is_rendering = context_.is_rendering();
@@ -66,11 +162,14 @@ void FullFrameExecutionModel::determine_areas_to_render_and_reads()
   }
 }
 
-Vector<MemoryBuffer *> FullFrameExecutionModel::get_input_buffers(NodeOperation *op,
-                                                                  const int output_x,
-                                                                  const int output_y)
+Vector<MemoryBuffer *> FullFrameExecutionModel::get_input_buffers(
+    NodeOperation *op,
+    const int output_x,
+    const int output_y,
+    MutableSpan<std::optional<MemoryBuffer>> r_buffers)
 {
   const int num_inputs = op->get_number_of_input_sockets();
+  BLI_assert(r_buffers.size() == num_inputs);
   Vector<MemoryBuffer *> inputs_buffers(num_inputs);
   for (int i = 0; i < num_inputs; i++) {
     NodeOperation *input = op->get_input_operation(i);
@@ -80,8 +179,9 @@ Vector<MemoryBuffer *> FullFrameExecutionModel::get_input_buffers(NodeOperation
 
     rcti rect = buf->get_rect();
     BLI_rcti_translate(&rect, offset_x, offset_y);
-    inputs_buffers[i] = new MemoryBuffer(
+    r_buffers[i].emplace(
         buf->get_buffer(), buf->get_num_channels(), rect, buf->is_a_single_elem());
+    inputs_buffers[i] = &*r_buffers[i];
   }
   return inputs_buffers;
 }
@@ -94,9 +194,8 @@ MemoryBuffer *FullFrameExecutionModel::create_operation_buffer(NodeOperation *op
   BLI_rcti_init(
       &rect, output_x, output_x + op->get_width(), output_y, output_y + op->get_height());
 
-  const DataType data_type = op->get_output_socket(0)->get_data_type();
   const bool is_a_single_elem = op->get_flags().is_constant_operation;
-  return new MemoryBuffer(data_type, rect, is_a_single_elem);
+  return buffer_pool_.create_buffer(op, rect, is_a_single_elem);
 }
 
 void FullFrameExecutionModel::render_operation(NodeOperation *op)
@@ -108,19 +207,49 @@ void FullFrameExecutionModel::render_operation(NodeOperation *op)
   const timeit::TimePoint time_start = timeit::Clock::now();
 
   const bool has_outputs = op->get_number_of_output_sockets() > 0;
-  MemoryBuffer *op_buf = has_outputs ? create_operation_buffer(op, output_x, output_y) : nullptr;
-  if (op->get_width() > 0 && op->get_height() > 0) {
-    Vector<MemoryBuffer *> input_bufs = get_input_buffers(op, output_x, output_y);
-    const int op_offset_x = output_x - op->get_canvas().xmin;
-    const int op_offset_y = output_y - op->get_canvas().ymin;
-    Vector<rcti> areas = active_buffers_.get_areas_to_render(op, op_offset_x, op_offset_y);
-    op->render(op_buf, areas, input_bufs);
-    DebugInfo::operation_rendered(op, op_buf);
+  const bool has_size = op->get_width() > 0 && op->get_height() > 0;
+  const std::shared_ptr<const MemoryBuffer> *cached_result = cached_results_.lookup_ptr(op);
+  const size_t *result_hash = result_hashes_.lookup_ptr(op);
+
+  /* Input buffers only wrap the rendered buffers with an offset, keep them on the stack. */
+  Array<std::optional<MemoryBuffer>> input_wrappers(op->get_number_of_input_sockets());
+  Vector<MemoryBuffer *> input_bufs;
+  Vector<rcti> areas;
+  MemoryBuffer *op_buf;
+  bool is_fully_rendered = false;
+  {
+    std::scoped_lock lock(mutex_);
+    op_buf = has_outputs ? create_operation_buffer(op, output_x, output_y) : nullptr;
+    if (has_size && !cached_result) {
+      input_bufs = get_input_buffers(op, output_x, output_y, input_wrappers);
+      const int op_offset_x = output_x - op->get_canvas().xmin;
+      const int op_offset_y = output_y - op->get_canvas().ymin;
+      areas = active_buffers_.get_areas_to_render(op, op_offset_x, op_offset_y);
+      is_fully_rendered = active_buffers_.is_area_registered(op, op->get_canvas());
+    }
+  }
 
-    for (MemoryBuffer *buf : input_bufs) {
-      delete buf;
+  if (cached_result) {
+    op_buf->copy_from(cached_result->get(), (*cached_result)->get_rect());
+  }
+  else if (has_size) {
+    op->render(op_buf, areas, input_bufs);
+    /* Only complete results can be reused by later executions. */
+    if (result_hash && is_fully_rendered) {
+      result_cache_->add(*result_hash, std::make_unique<MemoryBuffer>(*op_buf));
     }
   }
+
+  std::scoped_lock lock(mutex_);
+  if (cached_result) {
+    num_cache_hits_++;
+  }
+  else if (result_hash) {
+    num_cache_misses_++;
+  }
+  if (has_size) {
+    DebugInfo::operation_rendered(op, op_buf);
+  }
   /* Even if operation has no resolution set the empty buffer. It will be clipped with a
    * TranslateOperation from convert resolutions if linked to an operation with resolution. */
   active_buffers_.set_rendered_buffer(op, std::unique_ptr<MemoryBuffer>(op_buf));
@@ -135,28 +264,27 @@ void FullFrameExecutionModel::render_operations()
   const bool is_rendering = context_.is_rendering();
 
   WorkScheduler::start();
-  for (eCompositorPriority priority : priorities_) {
-    for (NodeOperation *op : operations_) {
-      const bool has_size = op->get_width() > 0 && op->get_height() > 0;
-      const bool is_priority_output = op->is_output_operation(is_rendering) &&
-                                      op->get_render_priority() == priority;
-      if (is_priority_output && has_size) {
-        render_output_dependencies(op);
+  for (const IndexRange range : priority_ranges_) {
+    if (range.size() > 1 && WorkScheduler::get_num_cpu_threads() > 1) {
+      render_operations_parallel(range);
+    }
+    else {
+      for (NodeOperation *op : render_order_.as_span().slice(range)) {
         render_operation(op);
       }
-      else if (is_priority_output && !has_size && op->is_active_viewer_output()) {
-        static_cast<ViewerOperation *>(op)->clear_display_buffer();
-      }
+    }
+  }
+  for (NodeOperation *op : operations_) {
+    const bool has_size = op->get_width() > 0 && op->get_height() > 0;
+    if (op->is_output_operation(is_rendering) && !has_size && op->is_active_viewer_output()) {
+      static_cast<ViewerOperation *>(op)->clear_display_buffer();
     }
   }
   WorkScheduler::stop();
 }
 
-/**
- * Returns all dependencies from inputs to outputs. A dependency may be repeated when
- * several operations depend on it.
- */
-static Vector<NodeOperation *> get_operation_dependencies(NodeOperation *operation)
+Vector<NodeOperation *> FullFrameExecutionModel::get_operation_dependencies(
+    NodeOperation *operation) const
 {
   /* Get dependencies from outputs to inputs. */
   Vector<NodeOperation *> dependencies;
@@ -166,7 +294,7 @@ static Vector<NodeOperation *> get_operation_dependencies(NodeOperation *operati
     Vector<NodeOperation *> outputs(next_outputs);
     next_outputs.clear();
     for (NodeOperation *output : outputs) {
-      for (int i = 0; i < output->get_number_of_input_sockets(); i++) {
+      for (int i = 0; i < get_num_read_inputs(output); i++) {
         next_outputs.append(output->get_input_operation(i));
       }
     }
@@ -179,15 +307,117 @@ static Vector<NodeOperation *> get_operation_dependencies(NodeOperation *operati
   return dependencies;
 }
 
-void FullFrameExecutionModel::render_output_dependencies(NodeOperation *output_op)
+void FullFrameExecutionModel::determine_render_order()
 {
-  BLI_assert(output_op->is_output_operation(context_.is_rendering()));
-  Vector<NodeOperation *> dependencies = get_operation_dependencies(output_op);
-  for (NodeOperation *op : dependencies) {
-    if (!active_buffers_.is_operation_rendered(op)) {
-      render_operation(op);
+  const bool is_rendering = context_.is_rendering();
+
+  /* Output operations in order of priority, each one preceded by its dependencies. */
+  Set<NodeOperation *> scheduled_ops;
+  for (eCompositorPriority priority : priorities_) {
+    const int priority_start = render_order_.size();
+    for (NodeOperation *op : operations_) {
+      const bool has_size = op->get_width() > 0 && op->get_height() > 0;
+      if (!op->is_output_operation(is_rendering) || op->get_render_priority() != priority ||
+          !has_size)
+      {
+        continue;
+      }
+      for (NodeOperation *dependency : get_operation_dependencies(op)) {
+        if (scheduled_ops.add(dependency)) {
+          render_order_.append(dependency);
+        }
+      }
+      if (scheduled_ops.add(op)) {
+        render_order_.append(op);
+      }
+    }
+    priority_ranges_.append(IndexRange(priority_start, render_order_.size() - priority_start));
+  }
+
+  /* Liveness of the output buffers: last operation in the render order reading each of them. */
+  for (const int i : render_order_.index_range()) {
+    render_indices_.add_new(render_order_[i], i);
+  }
+  Array<int> last_uses(render_order_.size());
+  for (const int i : render_order_.index_range()) {
+    last_uses[i] = i;
+  }
+  render_readers_.reinitialize(render_order_.size());
+  for (const int i : render_order_.index_range()) {
+    NodeOperation *op = render_order_[i];
+    for (int j = 0; j < get_num_read_inputs(op); j++) {
+      const int input_index = render_indices_.lookup(op->get_input_operation(j));
+      last_uses[input_index] = std::max(last_uses[input_index], i);
+      render_readers_[input_index].append(i);
     }
   }
+
+  buffer_pool_.assign_slots(render_order_, last_uses);
+}
+
+struct ParallelRenderData {
+  FullFrameExecutionModel *model;
+  IndexRange range;
+  /** Per operation of the range, operations of the range waiting for it. */
+  Array<Vector<int>> dependents;
+  /** Per operation of the range, number of operations it is still waiting for. */
+  Array<int> pending_dependencies;
+};
+
+void FullFrameExecutionModel::render_operation_task(TaskPool *__restrict pool, void *task_data)
+{
+  ParallelRenderData *data = static_cast<ParallelRenderData *>(BLI_task_pool_user_data(pool));
+  const int index = POINTER_AS_INT(task_data);
+  data->model->render_operation(data->model->render_order_[index]);
+
+  for (const int dependent : data->dependents[index - data->range.start()]) {
+    int *pending = &data->pending_dependencies[dependent - data->range.start()];
+    if (atomic_sub_and_fetch_int32(pending, 1) == 0) {
+      BLI_task_pool_push(pool, render_operation_task, POINTER_FROM_INT(dependent), false, nullptr);
+    }
+  }
+}
+
+void FullFrameExecutionModel::render_operations_parallel(const IndexRange range)
+{
+  ParallelRenderData data;
+  data.model = this;
+  data.range = range;
+  data.dependents.reinitialize(range.size());
+  data.pending_dependencies = Array<int>(range.size(), 0);
+
+  /* Operations of previous ranges are already rendered. */
+  auto add_dependency = [&](const int index, const NodeOperation *dependency) {
+    const int dependency_index = render_indices_.lookup(dependency);
+    if (range.contains(dependency_index)) {
+      data.dependents[dependency_index - range.start()].append(index);
+      data.pending_dependencies[index - range.start()]++;
+    }
+  };
+
+  for (const int index : range) {
+    NodeOperation *op = render_order_[index];
+    for (int i = 0; i < get_num_read_inputs(op); i++) {
+      add_dependency(index, op->get_input_operation(i));
+    }
+    /* The buffer memory of the operation may be used by a previous buffer until all its readers
+     * have finished. */
+    if (const NodeOperation *previous_op = buffer_pool_.get_previous_slot_operation(op)) {
+      add_dependency(index, previous_op);
+      for (const int reader_index : render_readers_[render_indices_.lookup(previous_op)]) {
+        add_dependency(index, render_order_[reader_index]);
+      }
+    }
+  }
+
+  TaskPool *pool = BLI_task_pool_create(&data, TASK_PRIORITY_HIGH);
+  for (const int index : range) {
+    if (data.pending_dependencies[index - range.start()] == 0) {
+      BLI_task_pool_push(pool, render_operation_task, POINTER_FROM_INT(index), false, nullptr);
+    }
+  }
+  BLI_task_pool_work_and_wait(pool);
+  BLI_task_pool_free(pool);
 }
 
 void FullFrameExecutionModel::determine_areas_to_render(NodeOperation *output_op,
@@ -209,7 +439,7 @@ void FullFrameExecutionModel::determine_areas_to_render(NodeOperation *output_op
 
     active_buffers_.register_area(operation, render_area);
 
-    const int num_inputs = operation->get_number_of_input_sockets();
+    const int num_inputs = get_num_read_inputs(operation);
     for (int i = 0; i < num_inputs; i++) {
       NodeOperation *input_op = operation->get_input_operation(i);
       rcti input_area;
@@ -231,7 +461,7 @@ void FullFrameExecutionModel::determine_reads(NodeOperation *output_op)
   stack.append(output_op);
   while (stack.size() > 0) {
     NodeOperation *operation = stack.pop_last();
-    const int num_inputs = operation->get_number_of_input_sockets();
+    const int num_inputs = get_num_read_inputs(operation);
     for (int i = 0; i < num_inputs; i++) {
       NodeOperation *input_op = operation->get_input_operation(i);
       if (!active_buffers_.has_registered_reads(input_op)) {
@@ -271,9 +501,12 @@ void FullFrameExecutionModel::get_output_render_area(NodeOperation *output_op, r
 void FullFrameExecutionModel::operation_finished(NodeOperation *operation)
 {
   /* Report inputs reads so that buffers may be freed/reused. */
-  const int num_inputs = operation->get_number_of_input_sockets();
+  const int num_inputs = get_num_read_inputs(operation);
   for (int i = 0; i < num_inputs; i++) {
-    active_buffers_.read_finished(operation->get_input_operation(i));
+    NodeOperation *input_op = operation->get_input_operation(i);
+    if (active_buffers_.read_finished(input_op)) {
+      buffer_pool_.buffer_released(input_op);
+    }
   }
 
   num_operations_finished_++;
@@ -4,15 +4,25 @@
 
 #pragma once
 
+#include <memory>
+#include <mutex>
+#include <optional>
+
+#include "BLI_array.hh"
+#include "BLI_index_range.hh"
+#include "BLI_map.hh"
 #include "BLI_vector.hh"
 
 #include "COM_Enums.h"
 #include "COM_ExecutionModel.h"
+#include "COM_MemoryBufferPool.h"
 
 #ifdef WITH_CXX_GUARDEDALLOC
 #  include "MEM_guardedalloc.h"
 #endif
 
+struct TaskPool;
+
 namespace blender::compositor {
 
 /* Forward declarations. */
@@ -20,6 +30,7 @@ class CompositorContext;
 class ExecutionSystem;
 class MemoryBuffer;
 class NodeOperation;
+class OperationResultCache;
 class SharedOperationBuffers;
 
 /**
@@ -43,6 +54,56 @@ class FullFrameExecutionModel : public ExecutionModel {
    */
   Vector<eCompositorPriority> priorities_;
 
+  /**
+   * Operations in the order they are rendered.
+   */
+  Vector<NodeOperation *> render_order_;
+
+  /**
+   * Index of each operation in #render_order_.
+   */
+  Map<const NodeOperation *, int> render_indices_;
+
+  /**
+   * Per operation in #render_order_, indices of the operations reading its output.
+   */
+  Array<Vector<int>> render_readers_;
+
+  /**
+   * Ranges of #render_order_ with the operations rendered for each output priority.
+   */
+  Vector<IndexRange> priority_ranges_;
+
+  /**
+   * Guards the shared buffers, the buffer pool, progress and profiling when operations are
+   * rendered concurrently.
+   */
+  std::mutex mutex_;
+
+  /**
+   * Recycles operations output buffers memory.
+   */
+  MemoryBufferPool buffer_pool_;
+
+  /**
+   * Results of operations kept across executions, null when disabled.
+   */
+  OperationResultCache *result_cache_;
+
+  /**
+   * Hash identifying the result across executions of each operation whose result is cached
+   * after rendering.
+   */
+  Map<const NodeOperation *, size_t> result_hashes_;
+
+  /**
+   * Results of previous executions reused by operations, their inputs are not rendered.
+   */
+  Map<const NodeOperation *, std::shared_ptr<const MemoryBuffer>> cached_results_;
+
+  int num_cache_hits_;
+  int num_cache_misses_;
+
  public:
   FullFrameExecutionModel(CompositorContext &context,
                           SharedOperationBuffers &shared_buffers,
@@ -51,17 +112,52 @@ class FullFrameExecutionModel : public ExecutionModel {
   void execute(ExecutionSystem &exec_system) override;
 
  private:
+  /**
+   * Looks up the results of previous executions for the operations at the boundary of the
+   * sub-graphs that can be identified across executions, i.e. whose operations and inputs only
+   * depend on hashed parameters.
+   */
+  void determine_cached_results();
+  /**
+   * Hash identifying the result of the operation across executions, combining its parameters
+   * with the hashes of its inputs. Null when an operation in its inputs tree isn't hashed.
+   */
+  std::optional<size_t> get_result_hash(NodeOperation *op,
+                                        Map<NodeOperation *, std::optional<size_t>> &r_hashes);
+  /**
+   * Number of inputs read by the operation when rendered, none when its result is cached.
+   */
+  int get_num_read_inputs(const NodeOperation *op) const;
   void determine_areas_to_render_and_reads();
+  /**
+   * Determines the order operations are rendered in: output operations in order of priority,
+   * each one after its dependencies. Assigns the output buffers to pool slots from their
+   * liveness in this order.
+   */
+  void determine_render_order();
+  /**
+   * Returns all dependencies from inputs to outputs. A dependency may be repeated when
+   * several operations depend on it.
+   */
+  Vector<NodeOperation *> get_operation_dependencies(NodeOperation *operation) const;
   /**
    * Render output operations in order of priority.
    */
   void render_operations();
-  void render_output_dependencies(NodeOperation *output_op);
+  /**
+   * Renders the operations of a range of the render order, operations not depending on each
+   * other are rendered concurrently.
+   */
+  void render_operations_parallel(IndexRange range);
+  static void render_operation_task(TaskPool *__restrict pool, void *task_data);
   /**
    * Returns input buffers with an offset relative to given output coordinates.
-   * Returned memory buffers must be deleted.
+   * Returned memory buffers are stored in \a r_buffers.
    */
-  Vector<MemoryBuffer *> get_input_buffers(NodeOperation *op, int output_x, int output_y);
+  Vector<MemoryBuffer *> get_input_buffers(NodeOperation *op,
+                                           int output_x,
+                                           int output_y,
+                                           MutableSpan<std::optional<MemoryBuffer>> r_buffers);
   MemoryBuffer *create_operation_buffer(NodeOperation *op, int output_x, int output_y);
   void render_operation(NodeOperation *op);
 
@@ -0,0 +1,123 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "MEM_guardedalloc.h"
+
+#include "COM_MemoryBuffer.h"
+#include "COM_MemoryBufferPool.h"
+#include "COM_NodeOperation.h"
+
+namespace blender::compositor {
+
+MemoryBufferPool::MemoryBufferPool() : allocated_size_(0), peak_size_(0), reused_size_(0) {}
+
+MemoryBufferPool::~MemoryBufferPool()
+{
+  for (Slot &slot : slots_) {
+    free_slot(slot);
+  }
+}
+
+int64_t MemoryBufferPool::get_slot_size(const Slot &slot)
+{
+  return int64_t(slot.width) * slot.height * COM_data_type_bytes_len(slot.data_type);
+}
+
+void MemoryBufferPool::free_slot(Slot &slot)
+{
+  if (slot.data) {
+    MEM_freeN(slot.data);
+    slot.data = nullptr;
+    allocated_size_ -= get_slot_size(slot);
+  }
+}
+
+static bool is_pooled(NodeOperation *op)
+{
+  return op->get_number_of_output_sockets() > 0 && !op->get_flags().is_constant_operation &&
+         op->get_width() > 0 && op->get_height() > 0;
+}
+
+void MemoryBufferPool::assign_slots(Span<NodeOperation *> render_order, Span<int> last_uses)
+{
+  BLI_assert(render_order.size() == last_uses.size());
+  BLI_assert(slots_.is_empty());
+
+  Vector<int> used_slots;
+  Vector<int> free_slots;
+  for (const int i : render_order.index_range()) {
+    /* Slots not read anymore can be reused from here on. */
+    for (int j = used_slots.size() - 1; j >= 0; j--) {
+      if (slots_[used_slots[j]].last_use < i) {
+        free_slots.append(used_slots[j]);
+        used_slots.remove_and_reorder(j);
+      }
+    }
+
+    NodeOperation *op = render_order[i];
+    if (!is_pooled(op)) {
+      continue;
+    }
+
+    const DataType data_type = op->get_output_socket()->get_data_type();
+    const int width = op->get_width();
+    const int height = op->get_height();
+    int slot_index = -1;
+    for (int j = 0; j < free_slots.size(); j++) {
+      const Slot &slot = slots_[free_slots[j]];
+      if (slot.data_type == data_type && slot.width == width && slot.height == height) {
+        slot_index = free_slots[j];
+        free_slots.remove_and_reorder(j);
+        break;
+      }
+    }
+    if (slot_index == -1) {
+      slot_index = slots_.append_and_get_index({data_type, width, height, 0, nullptr, nullptr});
+    }
+
+    Slot &slot = slots_[slot_index];
+    if (slot.last_operation) {
+      previous_slot_operations_.add_new(op, slot.last_operation);
+    }
+    slot.last_use = last_uses[i];
+    slot.last_operation = op;
+    used_slots.append(slot_index);
+    operation_slots_.add_new(op, slot_index);
+  }
+}
+
+MemoryBuffer *MemoryBufferPool::create_buffer(NodeOperation *op,
+                                              const rcti &rect,
+                                              const bool is_a_single_elem)
+{
+  const DataType data_type = op->get_output_socket()->get_data_type();
+  const int *slot_index = operation_slots_.lookup_ptr(op);
+  if (slot_index == nullptr || is_a_single_elem) {
+    return new MemoryBuffer(data_type, rect, is_a_single_elem);
+  }
+
+  Slot &slot = slots_[*slot_index];
+  BLI_assert(slot.data_type == data_type);
+  BLI_assert(slot.width == BLI_rcti_size_x(&rect) && slot.height == BLI_rcti_size_y(&rect));
+  const int64_t size = get_slot_size(slot);
+  if (slot.data) {
+    reused_size_ += size;
+  }
+  else {
+    slot.data = static_cast<float *>(MEM_mallocN_aligned(size, 16, "COM_MemoryBufferPool"));
+    allocated_size_ += size;
+    peak_size_ = std::max(peak_size_, allocated_size_);
+  }
+  return new MemoryBuffer(slot.data, COM_data_type_num_channels(data_type), rect);
+}
+
+void MemoryBufferPool::buffer_released(const NodeOperation *op)
+{
+  const int *slot_index = operation_slots_.lookup_ptr(op);
+  if (slot_index && slots_[*slot_index].last_operation == op) {
+    free_slot(slots_[*slot_index]);
+  }
+}
+
+}  // namespace blender::compositor
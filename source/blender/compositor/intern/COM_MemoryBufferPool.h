@@ -0,0 +1,109 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+#include "BLI_map.hh"
+#include "BLI_vector.hh"
+
+#include "COM_defines.h"
+
+#ifdef WITH_CXX_GUARDEDALLOC
+#  include "MEM_guardedalloc.h"
+#endif
+
+namespace blender::compositor {
+
+class MemoryBuffer;
+class NodeOperation;
+
+/**
+ * Recycles the memory of the operations output buffers during an execution.
+ *
+ * Operations are rendered in a known order, so a liveness analysis gives for each operation
+ * buffer the index of the last operation reading it. Buffers of the same data type and size whose
+ * lifetimes don't overlap are assigned to the same slot, slots memory is allocated on first use
+ * and freed once its last buffer is released.
+ *
+ * When operations are rendered concurrently, an operation must wait for all the readers of the
+ * previous buffer of its slot, see #get_previous_slot_operation.
+ */
+class MemoryBufferPool {
+ private:
+  struct Slot {
+    DataType data_type;
+    int width;
+    int height;
+    /** Index in the render order of the last operation reading the slot. */
+    int last_use;
+    /** Last operation assigned to the slot. */
+    const NodeOperation *last_operation;
+    float *data;
+  };
+
+  Vector<Slot> slots_;
+  /** Slot of each pooled operation output. */
+  Map<const NodeOperation *, int> operation_slots_;
+  /** Operation previously assigned to the slot of each pooled operation output. */
+  Map<const NodeOperation *, const NodeOperation *> previous_slot_operations_;
+
+  int64_t allocated_size_;
+  int64_t peak_size_;
+  int64_t reused_size_;
+
+ public:
+  MemoryBufferPool();
+  ~MemoryBufferPool();
+
+  /**
+   * Assigns the output buffer of each operation to a slot.
+   *
+   * \param render_order: Operations in the order they are rendered.
+   * \param last_uses: For each operation, the index in \a render_order of the last operation
+   * reading its output, or its own index when not read.
+   */
+  void assign_slots(Span<NodeOperation *> render_order, Span<int> last_uses);
+
+  /**
+   * Creates the output buffer of an operation, using the memory of its slot when pooled.
+   */
+  MemoryBuffer *create_buffer(NodeOperation *op, const rcti &rect, bool is_a_single_elem);
+
+  /**
+   * Reports the output buffer of an operation is not read anymore. Frees the memory of its slot
+   * when no other operation is assigned to it afterwards.
+   */
+  void buffer_released(const NodeOperation *op);
+
+  /**
+   * Operation whose buffer used the slot of \a op before it, all its readers must have finished
+   * before \a op is rendered. Null when \a op is not pooled or first in its slot.
+   */
+  const NodeOperation *get_previous_slot_operation(const NodeOperation *op) const
+  {
+    return previous_slot_operations_.lookup_default(op, nullptr);
+  }
+
+  /** Maximum size of the slots allocated at the same time, in bytes. */
+  int64_t get_peak_size() const
+  {
+    return peak_size_;
+  }
+
+  /** Size of the buffers created with the memory of a previous buffer, in bytes. */
+  int64_t get_reused_size() const
+  {
+    return reused_size_;
+  }
+
+ private:
+  static int64_t get_slot_size(const Slot &slot);
+  void free_slot(Slot &slot);
+
+#ifdef WITH_CXX_GUARDEDALLOC
+  MEM_CXX_CLASS_ALLOC_FUNCS("COM:MemoryBufferPool")
+#endif
+};
+
+}  // namespace blender::compositor
@@ -51,6 +51,9 @@ class MultiThreadedOperation : public NodeOperation {
   void update_memory_buffer(MemoryBuffer *output,
                             const rcti &area,
                             Span<MemoryBuffer *> inputs) override;
+
+  /* Evaluates fused operations by calling #update_memory_buffer_partial. */
+  friend class FusedOperation;
 };
 
 }  // namespace blender::compositor
@@ -11,6 +11,11 @@ MultiThreadedRowOperation::PixelCursor::PixelCursor(const int num_inputs)
 {
 }
 
+MultiThreadedRowOperation::MultiThreadedRowOperation()
+{
+  flags_.can_be_fused = true;
+}
+
 void MultiThreadedRowOperation::update_memory_buffer_partial(MemoryBuffer *output,
                                                              const rcti &area,
                                                              Span<MemoryBuffer *> inputs)
@@ -35,6 +35,8 @@ class MultiThreadedRowOperation : public MultiThreadedOperation {
   };
 
  protected:
+  MultiThreadedRowOperation();
+
   virtual void update_memory_buffer_row(PixelCursor &p) = 0;
 
  private:
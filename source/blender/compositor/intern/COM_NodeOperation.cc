@@ -317,6 +317,9 @@ std::ostream &operator<<(std::ostream &os, const NodeOperationFlags &node_operat
   if (node_operation_flags.can_be_constant) {
     os << "can_be_constant,";
   }
+  if (node_operation_flags.can_be_fused) {
+    os << "can_be_fused,";
+  }
 
   return os;
 }
@@ -206,6 +206,13 @@ struct NodeOperationFlags {
    */
   bool can_be_constant : 1;
 
+  /**
+   * Whether output pixels only depend on the input pixels at the same coordinates, so the
+   * operation can be evaluated per row chunk as part of a #FusedOperation. Only set on
+   * #MultiThreadedOperation subclasses without passes or custom areas of interest.
+   */
+  bool can_be_fused : 1;
+
   NodeOperationFlags()
   {
     use_render_border = false;
@@ -217,6 +224,7 @@ struct NodeOperationFlags {
     use_datatype_conversion = true;
     is_constant_operation = false;
     can_be_constant = false;
+    can_be_fused = false;
   }
 };
 
@@ -236,6 +244,15 @@ struct NodeOperationHash {
     return operation_;
   }
 
+  /**
+   * Hash of the operation type and parameters, not depending on its inputs. Unlike the whole hash
+   * it can identify the operation result across executions.
+   */
+  size_t get_params_hash() const
+  {
+    return BLI_ghashutil_combine_hash(type_hash_, params_hash_);
+  }
+
   bool operator==(const NodeOperationHash &other) const
   {
     return type_hash_ == other.type_hash_ && parents_hash_ == other.parents_hash_ &&
@@ -5,12 +5,14 @@
 #include <set>
 
 #include "BLI_multi_value_map.hh"
+#include "BLI_set.hh"
 
 #include "BKE_node_runtime.hh"
 
 #include "COM_Converter.h"
 #include "COM_Debug.h"
 
+#include "COM_FusedOperation.h"
 #include "COM_PreviewOperation.h"
 #include "COM_SetColorOperation.h"
 #include "COM_SetValueOperation.h"
@@ -90,6 +92,9 @@ void NodeOperationBuilder::convert_to_operations(ExecutionSystem *system)
   save_graphviz("compositor_prior_merging");
   merge_equal_operations();
 
+  save_graphviz("compositor_prior_fusing");
+  fuse_operations();
+
   /* links not available from here on */
   /* XXX make links_ a local variable to avoid confusion! */
   links_.clear();
@@ -493,6 +498,107 @@ void NodeOperationBuilder::merge_equal_operations(NodeOperation *from, NodeOpera
   delete from;
 }
 
+static bool is_fusable(NodeOperation *operation, const bool is_rendering)
+{
+  const NodeOperationFlags flags = operation->get_flags();
+  return flags.can_be_fused && !flags.is_constant_operation &&
+         !operation->is_output_operation(is_rendering) &&
+         operation->get_number_of_output_sockets() == 1 && operation->get_width() > 0 &&
+         operation->get_height() > 0;
+}
+
+/** Append \a op and the operations fused into it in evaluation order. */
+static void collect_fused_operations(NodeOperation *op,
+                                     const Set<NodeOperation *> &fused_into_output,
+                                     Vector<NodeOperation *> &r_operations)
+{
+  for (int i = 0; i < op->get_number_of_input_sockets(); i++) {
+    NodeOperation *input_op = op->get_input_operation(i);
+    if (fused_into_output.contains(input_op)) {
+      collect_fused_operations(input_op, fused_into_output, r_operations);
+    }
+  }
+  r_operations.append(op);
+}
+
+void NodeOperationBuilder::fuse_operations()
+{
+  const bool is_rendering = context_->is_rendering();
+
+  Map<NodeOperation *, int> output_links_num;
+  for (const Link &link : links_) {
+    output_links_num.lookup_or_add(&link.from()->get_operation(), 0)++;
+  }
+
+  /* An operation is fused into the operation reading its output when both are pixel-wise, it
+   * has no other readers and both have the same canvas, so that pixels match one to one. */
+  Set<NodeOperation *> fused_into_output;
+  Set<NodeOperation *> fused_roots;
+  for (const Link &link : links_) {
+    NodeOperation *from_op = &link.from()->get_operation();
+    NodeOperation *to_op = &link.to()->get_operation();
+    if (is_fusable(from_op, is_rendering) && is_fusable(to_op, is_rendering) &&
+        output_links_num.lookup(from_op) == 1 &&
+        BLI_rcti_compare(&from_op->get_canvas(), &to_op->get_canvas()))
+    {
+      fused_into_output.add(from_op);
+      fused_roots.add(to_op);
+    }
+  }
+
+  /* Copy as fused operations are replaced while iterating. */
+  const Vector<NodeOperation *> operations = operations_;
+  for (NodeOperation *root : operations) {
+    if (!fused_roots.contains(root) || fused_into_output.contains(root)) {
+      continue;
+    }
+    Vector<NodeOperation *> fused_ops;
+    collect_fused_operations(root, fused_into_output, fused_ops);
+    replace_operations_with_fused(new FusedOperation(fused_ops));
+  }
+}
+
+void NodeOperationBuilder::replace_operations_with_fused(FusedOperation *fused_op)
+{
+  Span<MultiThreadedOperation *> ops = fused_op->get_fused_operations();
+  NodeOperation *root = ops.last();
+
+  Set<const NodeOperation *> ops_set;
+  for (const NodeOperation *op : ops) {
+    ops_set.add(op);
+  }
+  Map<NodeOperationInput *, NodeOperationInput *> fused_inputs;
+  for (int i = 0; i < fused_op->get_number_of_input_sockets(); i++) {
+    fused_inputs.add_new(fused_op->get_fused_input_socket(i), fused_op->get_input_socket(i));
+  }
+
+  int i = 0;
+  while (i < links_.size()) {
+    Link &link = links_[i];
+    if (ops_set.contains(&link.to()->get_operation())) {
+      NodeOperationInput *fused_input = fused_inputs.lookup_default(link.to(), nullptr);
+      link.to()->set_link(nullptr);
+      if (fused_input == nullptr) {
+        /* Link between fused operations. */
+        links_.remove(i);
+        continue;
+      }
+      fused_input->set_link(link.from());
+      links_[i] = Link(link.from(), fused_input);
+    }
+    else if (&link.from()->get_operation() == root) {
+      link.to()->set_link(fused_op->get_output_socket());
+      links_[i] = Link(fused_op->get_output_socket(), link.to());
+    }
+    i++;
+  }
+
+  for (NodeOperation *op : ops) {
+    operations_.remove_first_occurrence_and_reorder(op);
+  }
+  add_operation(fused_op);
+}
+
 Vector<NodeOperationInput *> NodeOperationBuilder::cache_output_links(
     NodeOperationOutput *output) const
 {
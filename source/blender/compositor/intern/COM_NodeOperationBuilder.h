@@ -25,6 +25,7 @@ class NodeOperationOutput;
 class PreviewOperation;
 class ViewerOperation;
 class ConstantOperation;
+class FusedOperation;
 
 class NodeOperationBuilder {
  public:
@@ -143,6 +144,9 @@ class NodeOperationBuilder {
   /** Merge operations with same type, inputs and parameters that produce the same result. */
   void merge_equal_operations();
   void merge_equal_operations(NodeOperation *from, NodeOperation *into);
+  /** Fuse trees of pixel-wise operations into #FusedOperation, see #NodeOperationFlags. */
+  void fuse_operations();
+  void replace_operations_with_fused(FusedOperation *fused_op);
   void save_graphviz(StringRefNull name = "");
 #ifdef WITH_CXX_GUARDEDALLOC
   MEM_CXX_CLASS_ALLOC_FUNCS("COM:NodeCompilerImpl")
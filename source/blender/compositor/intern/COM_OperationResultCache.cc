@@ -0,0 +1,73 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "COM_MemoryBuffer.h"
+#include "COM_OperationResultCache.h"
+
+namespace blender::compositor {
+
+OperationResultCache::OperationResultCache() : size_limit_(0), size_(0), use_counter_(0) {}
+
+static int64_t get_buffer_size(const MemoryBuffer &buffer)
+{
+  return buffer.buffer_len() * buffer.get_num_channels() * sizeof(float);
+}
+
+void OperationResultCache::set_size_limit(const int64_t size_limit)
+{
+  std::scoped_lock lock(mutex_);
+  size_limit_ = std::max(size_limit, int64_t(0));
+  evict(size_limit_);
+}
+
+std::shared_ptr<const MemoryBuffer> OperationResultCache::lookup(const size_t hash)
+{
+  std::scoped_lock lock(mutex_);
+  Entry *entry = entries_.lookup_ptr(hash);
+  if (entry == nullptr) {
+    return nullptr;
+  }
+  entry->last_use = ++use_counter_;
+  return entry->buffer;
+}
+
+void OperationResultCache::add(const size_t hash, std::unique_ptr<MemoryBuffer> buffer)
+{
+  const int64_t size = get_buffer_size(*buffer);
+
+  std::scoped_lock lock(mutex_);
+  if (size > size_limit_ || entries_.contains(hash)) {
+    return;
+  }
+  evict(size_limit_ - size);
+  entries_.add_new(hash, {std::move(buffer), size, ++use_counter_});
+  size_ += size;
+}
+
+void OperationResultCache::clear()
+{
+  std::scoped_lock lock(mutex_);
+  entries_.clear();
+  size_ = 0;
+}
+
+void OperationResultCache::evict(const int64_t max_size)
+{
+  /* Few operations are cached per execution, a linear search of the least recently used buffer
+   * is fast enough. */
+  while (size_ > max_size) {
+    size_t lru_hash = 0;
+    int64_t lru_use = INT64_MAX;
+    for (const auto item : entries_.items()) {
+      if (item.value.last_use < lru_use) {
+        lru_hash = item.key;
+        lru_use = item.value.last_use;
+      }
+    }
+    BLI_assert(lru_use != INT64_MAX);
+    size_ -= entries_.pop(lru_hash).size;
+  }
+}
+
+}  // namespace blender::compositor
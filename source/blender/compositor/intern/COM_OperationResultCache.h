@@ -0,0 +1,92 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+
+#include "BLI_map.hh"
+
+#ifdef WITH_CXX_GUARDEDALLOC
+#  include "MEM_guardedalloc.h"
+#endif
+
+namespace blender::compositor {
+
+class MemoryBuffer;
+
+/**
+ * Keeps operations output buffers across executions, so sub-graphs whose parameters and inputs
+ * didn't change don't need to be rendered again on the next frame.
+ *
+ * Buffers are identified by a hash of the operation parameters combined with the hashes of its
+ * inputs, see #FullFrameExecutionModel. The cache is bounded by a size limit, least recently used
+ * buffers are evicted first. Buffers are shared so that an evicted buffer stays valid for an
+ * execution still using it.
+ */
+class OperationResultCache {
+ private:
+  struct Entry {
+    std::shared_ptr<const MemoryBuffer> buffer;
+    int64_t size;
+    /** Value of #use_counter_ when the buffer was last added or looked up. */
+    int64_t last_use;
+  };
+
+  Map<size_t, Entry> entries_;
+  int64_t size_limit_;
+  int64_t size_;
+  int64_t use_counter_;
+
+  /** Buffers are added by operations rendered concurrently. */
+  std::mutex mutex_;
+
+ public:
+  OperationResultCache();
+
+  /**
+   * Sets the maximum size of the cached buffers in bytes, zero disables the cache. Evicts buffers
+   * when the cache is larger than the new limit.
+   */
+  void set_size_limit(int64_t size_limit);
+  int64_t get_size_limit() const
+  {
+    return size_limit_;
+  }
+
+  bool is_enabled() const
+  {
+    return size_limit_ > 0;
+  }
+
+  /** Total size of the cached buffers in bytes. */
+  int64_t get_size() const
+  {
+    return size_;
+  }
+
+  /**
+   * Returns the buffer cached for the given hash or null when there is none.
+   */
+  std::shared_ptr<const MemoryBuffer> lookup(size_t hash);
+
+  /**
+   * Caches a buffer for the given hash, evicting least recently used buffers to fit it in the
+   * size limit. Buffers larger than the size limit are not cached.
+   */
+  void add(size_t hash, std::unique_ptr<MemoryBuffer> buffer);
+
+  /** Frees all cached buffers. */
+  void clear();
+
+ private:
+  void evict(int64_t max_size);
+
+#ifdef WITH_CXX_GUARDEDALLOC
+  MEM_CXX_CLASS_ALLOC_FUNCS("COM:OperationResultCache")
+#endif
+};
+
+}  // namespace blender::compositor
@@ -75,8 +75,10 @@ class SharedOperationBuffers {
   /**
    * Reports an operation has finished reading given operation. If all given operation dependencies
    * have finished its buffer will be disposed.
+   *
+   * \return Whether the buffer has been disposed.
    */
-  void read_finished(NodeOperation *read_op);
+  bool read_finished(NodeOperation *read_op);
 
  private:
   BufferData &get_buffer_data(NodeOperation *op);
@@ -11,6 +11,7 @@
 #include "BKE_scene.hh"
 
 #include "COM_ExecutionSystem.h"
+#include "COM_OperationResultCache.h"
 #include "COM_WorkScheduler.h"
 #include "COM_compositor.hh"
 
@@ -19,6 +20,8 @@
 static struct {
   bool is_initialized = false;
   ThreadMutex mutex;
+  /** Results of operations kept across executions, created on first execution. */
+  blender::compositor::OperationResultCache *result_cache = nullptr;
 } g_compositor;
 
 /* Make sure node tree has previews.
@@ -89,6 +92,11 @@ void COM_execute(Render *render,
     /* Initialize workscheduler. */
     blender::compositor::WorkScheduler::initialize(BKE_render_num_threads(render_data));
 
+    if (g_compositor.result_cache == nullptr) {
+      g_compositor.result_cache = new blender::compositor::OperationResultCache();
+    }
+    g_compositor.result_cache->set_size_limit(int64_t(node_tree->cache_limit) * 1024 * 1024);
+
     /* Execute. */
     const bool is_rendering = render_context != nullptr;
     const bool twopass = (node_tree->flag & NTREE_TWO_PASS) && !is_rendering;
@@ -100,7 +108,8 @@ void COM_execute(Render *render,
                                                      true,
                                                      view_name,
                                                      render_context,
-                                                     profiler_data);
+                                                     profiler_data,
+                                                     nullptr);
       fast_pass.execute();
 
       if (node_tree->runtime->test_break(node_tree->runtime->tbh)) {
@@ -116,7 +125,8 @@ void COM_execute(Render *render,
                                                 false,
                                                 view_name,
                                                 render_context,
-                                                profiler_data);
+                                                profiler_data,
+                                                g_compositor.result_cache);
     system.execute();
   }
 
@@ -128,8 +138,21 @@ void COM_deinitialize()
   if (g_compositor.is_initialized) {
     BLI_mutex_lock(&g_compositor.mutex);
     blender::compositor::WorkScheduler::deinitialize();
+    delete g_compositor.result_cache;
+    g_compositor.result_cache = nullptr;
     g_compositor.is_initialized = false;
     BLI_mutex_unlock(&g_compositor.mutex);
     BLI_mutex_end(&g_compositor.mutex);
   }
 }
+
+void COM_clear_caches()
+{
+  if (g_compositor.is_initialized) {
+    BLI_mutex_lock(&g_compositor.mutex);
+    if (g_compositor.result_cache) {
+      g_compositor.result_cache->clear();
+    }
+    BLI_mutex_unlock(&g_compositor.mutex);
+  }
+}
@@ -34,6 +34,19 @@ void Profiler::add_execution_time(const bNodeInstanceKey key,
   data_.per_node_execution_time.lookup_or_add(key, timeit::Nanoseconds(0)) += execution_time;
 }
 
+void Profiler::set_buffers_memory(const int64_t peak_size, const int64_t reused_size)
+{
+  data_.buffers_peak_size = peak_size;
+  data_.buffers_reused_size = reused_size;
+}
+
+void Profiler::set_result_cache_stats(const int hits, const int misses, const int64_t size)
+{
+  data_.result_cache_hits = hits;
+  data_.result_cache_misses = misses;
+  data_.result_cache_size = size;
+}
+
 void Profiler::finalize(const bNodeTree &node_tree)
 {
   this->accumulate_node_group_times(node_tree);
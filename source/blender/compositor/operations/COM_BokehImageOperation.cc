@@ -17,6 +17,14 @@ BokehImageOperation::BokehImageOperation()
   delete_data_ = false;
 }
 
+BokehImageOperation::~BokehImageOperation()
+{
+  /* The operation may be merged into an equal one and never executed. */
+  if (delete_data_) {
+    delete data_;
+  }
+}
+
 /* The exterior angle is the angle between each two consecutive vertices of the regular polygon
  * from its center. */
 static float compute_exterior_angle(int sides)
@@ -42,6 +50,12 @@ void BokehImageOperation::init_execution()
   lens_shift_ = data_->lensshift;
 }
 
+void BokehImageOperation::hash_output_params()
+{
+  hash_params(data_->angle, data_->flaps);
+  hash_params(data_->rounding, data_->catadioptric, data_->lensshift);
+}
+
 /* Get the 2D vertex position of the vertex with the given index in the regular polygon
  * representing this bokeh. The polygon is rotated by the rotation amount and have a unit
  * circumradius. The regular polygon is one whose vertices' exterior angles are given by
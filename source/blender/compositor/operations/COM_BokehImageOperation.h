@@ -31,6 +31,7 @@ class BokehImageOperation : public MultiThreadedOperation {
 
  public:
   BokehImageOperation();
+  ~BokehImageOperation();
 
   void init_execution() override;
   void deinit_execution() override;
@@ -62,6 +63,9 @@ class BokehImageOperation : public MultiThreadedOperation {
   void update_memory_buffer_partial(MemoryBuffer *output,
                                     const rcti &area,
                                     Span<MemoryBuffer *> inputs) override;
+
+ protected:
+  void hash_output_params() override;
 };
 
 }  // namespace blender::compositor
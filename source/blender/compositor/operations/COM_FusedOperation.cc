@@ -0,0 +1,131 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include <optional>
+
+#include "BLI_array.hh"
+#include "BLI_map.hh"
+
+#include "COM_FusedOperation.h"
+
+namespace blender::compositor {
+
+static int get_output_num_channels(NodeOperation *operation)
+{
+  return COM_data_type_num_channels(operation->get_output_socket()->get_data_type());
+}
+
+FusedOperation::FusedOperation(Span<NodeOperation *> operations) : scratch_elem_len_(0)
+{
+  BLI_assert(operations.size() > 1);
+
+  Map<const NodeOperation *, int> fused_indices;
+  for (NodeOperation *op : operations) {
+    BLI_assert(op->get_flags().can_be_fused);
+    const int op_index = operations_.append_and_get_index(
+        static_cast<MultiThreadedOperation *>(op));
+
+    operation_inputs_.append({});
+    Vector<InputSource> &sources = operation_inputs_.last();
+    for (int i = 0; i < op->get_number_of_input_sockets(); i++) {
+      NodeOperationInput *socket = op->get_input_socket(i);
+      BLI_assert(socket->is_connected());
+      const int *fused_index = fused_indices.lookup_ptr(&socket->get_link()->get_operation());
+      if (fused_index) {
+        sources.append({true, *fused_index});
+        continue;
+      }
+      sources.append({false, int(fused_input_sockets_.size())});
+      fused_input_sockets_.append(socket);
+      this->add_input_socket(socket->get_data_type(), ResizeMode::None);
+    }
+
+    /* The root writes into the output buffer. */
+    if (op != operations.last()) {
+      scratch_offsets_.append(scratch_elem_len_);
+      scratch_elem_len_ += get_output_num_channels(op);
+    }
+    fused_indices.add_new(op, op_index);
+  }
+
+  NodeOperation *root = operations.last();
+  this->add_output_socket(root->get_output_socket()->get_data_type());
+  this->set_canvas(root->get_canvas());
+  this->set_name(root->get_name());
+  this->set_node_instance_key(root->get_node_instance_key());
+}
+
+FusedOperation::~FusedOperation()
+{
+  for (MultiThreadedOperation *op : operations_) {
+    delete op;
+  }
+}
+
+void FusedOperation::init_data()
+{
+  for (MultiThreadedOperation *op : operations_) {
+    op->init_data();
+  }
+}
+
+void FusedOperation::init_execution()
+{
+  for (MultiThreadedOperation *op : operations_) {
+    op->init_execution();
+  }
+}
+
+void FusedOperation::deinit_execution()
+{
+  for (MultiThreadedOperation *op : operations_) {
+    op->deinit_execution();
+  }
+}
+
+std::unique_ptr<MetaData> FusedOperation::get_meta_data()
+{
+  return operations_.last()->get_meta_data();
+}
+
+void FusedOperation::update_memory_buffer_partial(MemoryBuffer *output,
+                                                  const rcti &area,
+                                                  Span<MemoryBuffer *> inputs)
+{
+  const int chunk_size = std::min(BLI_rcti_size_x(&area), CHUNK_SIZE);
+  if (chunk_size <= 0) {
+    return;
+  }
+
+  const int root_index = operations_.size() - 1;
+  Array<float> scratch(int64_t(scratch_elem_len_) * chunk_size);
+  Array<std::optional<MemoryBuffer>> scratch_buffers(root_index);
+  Vector<MemoryBuffer *> op_inputs;
+
+  for (int y = area.ymin; y < area.ymax; y++) {
+    for (int x = area.xmin; x < area.xmax; x += chunk_size) {
+      rcti chunk;
+      BLI_rcti_init(&chunk, x, std::min(x + chunk_size, area.xmax), y, y + 1);
+
+      for (const int i : operations_.index_range()) {
+        MultiThreadedOperation *op = operations_[i];
+        op_inputs.clear();
+        for (const InputSource &source : operation_inputs_[i]) {
+          op_inputs.append(source.is_fused ? &*scratch_buffers[source.index] :
+                                             inputs[source.index]);
+        }
+
+        MemoryBuffer *op_output = output;
+        if (i != root_index) {
+          float *op_scratch = &scratch[int64_t(scratch_offsets_[i]) * chunk_size];
+          scratch_buffers[i].emplace(op_scratch, get_output_num_channels(op), chunk);
+          op_output = &*scratch_buffers[i];
+        }
+        op->update_memory_buffer_partial(op_output, chunk, op_inputs);
+      }
+    }
+  }
+}
+
+}  // namespace blender::compositor
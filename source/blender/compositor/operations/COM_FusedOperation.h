@@ -0,0 +1,76 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+#include "COM_MultiThreadedOperation.h"
+
+namespace blender::compositor {
+
+/**
+ * Evaluates a tree of pixel-wise operations (flagged with #NodeOperationFlags::can_be_fused) as a
+ * single operation. The rows of an area are evaluated in chunks of at most #CHUNK_SIZE pixels,
+ * the results of the fused operations are written to small scratch buffers that stay in cache
+ * instead of full-size buffers. Only the root operation writes into the output buffer.
+ *
+ * Inputs of fused operations not linked to another fused operation become inputs of this
+ * operation, in the order of #get_fused_input_socket.
+ */
+class FusedOperation : public MultiThreadedOperation {
+ public:
+  /** Maximum number of pixels of a row evaluated at once. */
+  static constexpr int CHUNK_SIZE = 1024;
+
+ private:
+  struct InputSource {
+    /** Whether the input is the result of another fused operation. */
+    bool is_fused;
+    /** Index of the fused operation or of the input of this operation. */
+    int index;
+  };
+
+  /** Owned operations in evaluation order, the last one is the root. */
+  Vector<MultiThreadedOperation *> operations_;
+  /** Sources of the inputs of each fused operation. */
+  Vector<Vector<InputSource>> operation_inputs_;
+  /** Fused operation input sockets linked to the inputs of this operation. */
+  Vector<NodeOperationInput *> fused_input_sockets_;
+  /** Offset of each fused operation in the scratch buffer, per pixel. */
+  Vector<int> scratch_offsets_;
+  /** Number of scratch floats needed per pixel. */
+  int scratch_elem_len_;
+
+ public:
+  /**
+   * \param operations: Operations to fuse, ordered so that each operation comes after the
+   * operations it is linked to. The last operation is the root, its output is the output of
+   * this operation and the other operations must only be linked to fused operations.
+   * Ownership of the operations is transferred.
+   */
+  FusedOperation(Span<NodeOperation *> operations);
+  ~FusedOperation();
+
+  Span<MultiThreadedOperation *> get_fused_operations() const
+  {
+    return operations_;
+  }
+
+  /** Input socket of a fused operation the input \a index of this operation replaces. */
+  NodeOperationInput *get_fused_input_socket(int index) const
+  {
+    return fused_input_sockets_[index];
+  }
+
+  void init_data() override;
+  void init_execution() override;
+  void deinit_execution() override;
+
+  std::unique_ptr<MetaData> get_meta_data() override;
+
+  void update_memory_buffer_partial(MemoryBuffer *output,
+                                    const rcti &area,
+                                    Span<MemoryBuffer *> inputs) override;
+};
+
+}  // namespace blender::compositor
@@ -29,14 +29,37 @@ KeyingScreenOperation::KeyingScreenOperation()
   cached_marker_points_ = nullptr;
 }
 
+KeyingScreenOperation::~KeyingScreenOperation()
+{
+  delete cached_marker_points_;
+}
+
 void KeyingScreenOperation::init_execution()
 {
-  BLI_assert(cached_marker_points_ == nullptr);
-  if (movie_clip_) {
+  /* Points may have been computed already to hash the operation. */
+  if (movie_clip_ && cached_marker_points_ == nullptr) {
     cached_marker_points_ = compute_marker_points();
   }
 }
 
+void KeyingScreenOperation::hash_output_params()
+{
+  /* The result only depends on the marker points, hash their positions and the colors sampled
+   * from the clip so that the same screen is identified across frames. */
+  if (movie_clip_ && cached_marker_points_ == nullptr) {
+    cached_marker_points_ = compute_marker_points();
+  }
+  hash_param(smoothness_);
+  if (cached_marker_points_ == nullptr) {
+    return;
+  }
+  for (const MarkerPoint &marker_point : *cached_marker_points_) {
+    hash_params(marker_point.position.x, marker_point.position.y);
+    hash_params(marker_point.color.x, marker_point.color.y);
+    hash_params(marker_point.color.z, marker_point.color.w);
+  }
+}
+
 void KeyingScreenOperation::deinit_execution()
 {
   delete cached_marker_points_;
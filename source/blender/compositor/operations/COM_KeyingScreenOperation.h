@@ -41,8 +41,11 @@ class KeyingScreenOperation : public MultiThreadedOperation {
 
   Array<MarkerPoint> *compute_marker_points();
 
+  void hash_output_params() override;
+
  public:
   KeyingScreenOperation();
+  ~KeyingScreenOperation();
 
   void init_execution() override;
   void deinit_execution() override;
@@ -0,0 +1,83 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include "COM_FusedOperation.h"
+#include "COM_MathBaseOperation.h"
+#include "COM_SetAlphaReplaceOperation.h"
+#include "COM_SetColorOperation.h"
+#include "COM_SetValueOperation.h"
+
+namespace blender::compositor::tests {
+
+static void link_input(NodeOperation &operation, int index, NodeOperation &input)
+{
+  operation.get_input_socket(index)->set_link(input.get_output_socket());
+}
+
+TEST(FusedOperation, ChainEvaluatedPerChunk)
+{
+  /* Wider than a chunk and not a multiple of it. */
+  const rcti area = {0, FusedOperation::CHUNK_SIZE * 2 + 7, 0, 3};
+  SetValueOperation value_input;
+  SetColorOperation color_input;
+
+  MathAddOperation *add_op = new MathAddOperation();
+  MathMultiplyOperation *multiply_op = new MathMultiplyOperation();
+  SetAlphaReplaceOperation *alpha_op = new SetAlphaReplaceOperation();
+  const Vector<NodeOperation *> operations = {add_op, multiply_op, alpha_op};
+  for (NodeOperation *op : operations) {
+    EXPECT_TRUE(op->get_flags().can_be_fused);
+    op->set_canvas(area);
+  }
+  link_input(*add_op, 0, value_input);
+  link_input(*add_op, 1, value_input);
+  link_input(*add_op, 2, value_input);
+  link_input(*multiply_op, 0, *add_op);
+  link_input(*multiply_op, 1, value_input);
+  link_input(*multiply_op, 2, value_input);
+  link_input(*alpha_op, 0, color_input);
+  link_input(*alpha_op, 1, *multiply_op);
+
+  FusedOperation fused_op(operations);
+  EXPECT_EQ(fused_op.get_number_of_input_sockets(), 6);
+  EXPECT_EQ(fused_op.get_fused_input_socket(3), multiply_op->get_input_socket(1));
+  EXPECT_EQ(fused_op.get_fused_input_socket(5), alpha_op->get_input_socket(0));
+  EXPECT_EQ(fused_op.get_output_socket()->get_data_type(), DataType::Color);
+  EXPECT_TRUE(BLI_rcti_compare(&fused_op.get_canvas(), &area));
+
+  MemoryBuffer x_buf(DataType::Value, area);
+  MemoryBuffer y_buf(DataType::Value, area);
+  for (int y = area.ymin; y < area.ymax; y++) {
+    for (int x = area.xmin; x < area.xmax; x++) {
+      *x_buf.get_elem(x, y) = x;
+      *y_buf.get_elem(x, y) = y;
+    }
+  }
+  const float half = 0.5f;
+  const float color[4] = {0.1f, 0.2f, 0.3f, 1.0f};
+  MemoryBuffer half_buf(DataType::Value, area, true);
+  *half_buf.get_elem(0, 0) = half;
+  MemoryBuffer color_buf(DataType::Color, area, true);
+  copy_v4_v4(color_buf.get_elem(0, 0), color);
+
+  MemoryBuffer output(DataType::Color, area);
+  fused_op.update_memory_buffer_partial(
+      &output,
+      area,
+      Span<MemoryBuffer *>{&x_buf, &y_buf, &half_buf, &half_buf, &half_buf, &color_buf});
+
+  for (int y = area.ymin; y < area.ymax; y++) {
+    for (int x = area.xmin; x < area.xmax; x++) {
+      const float *out = output.get_elem(x, y);
+      EXPECT_FLOAT_EQ(out[0], color[0]);
+      EXPECT_FLOAT_EQ(out[1], color[1]);
+      EXPECT_FLOAT_EQ(out[2], color[2]);
+      EXPECT_FLOAT_EQ(out[3], (x + y) * half);
+    }
+  }
+}
+
+}  // namespace blender::compositor::tests
@@ -0,0 +1,66 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include "COM_MemoryBuffer.h"
+#include "COM_MemoryBufferPool.h"
+#include "COM_NodeOperation.h"
+
+namespace blender::compositor::tests {
+
+class SizedOperation : public NodeOperation {
+ public:
+  SizedOperation(DataType data_type, int width, int height)
+  {
+    add_output_socket(data_type);
+    set_canvas({0, width, 0, height});
+  }
+};
+
+static std::unique_ptr<MemoryBuffer> create_buffer(MemoryBufferPool &pool, NodeOperation &op)
+{
+  const rcti rect = {0, int(op.get_width()), 0, int(op.get_height())};
+  return std::unique_ptr<MemoryBuffer>(pool.create_buffer(&op, rect, false));
+}
+
+TEST(MemoryBufferPool, ReuseReleasedSlots)
+{
+  /* Chain a -> b -> c -> d, d has a different size. */
+  SizedOperation a(DataType::Color, 4, 3);
+  SizedOperation b(DataType::Color, 4, 3);
+  SizedOperation c(DataType::Color, 4, 3);
+  SizedOperation d(DataType::Color, 2, 3);
+  const int64_t size = 4 * 3 * COM_data_type_bytes_len(DataType::Color);
+
+  MemoryBufferPool pool;
+  const Vector<NodeOperation *> render_order = {&a, &b, &c, &d};
+  const Vector<int> last_uses = {1, 2, 3, 3};
+  pool.assign_slots(render_order, last_uses);
+
+  EXPECT_EQ(pool.get_previous_slot_operation(&b), nullptr);
+  EXPECT_EQ(pool.get_previous_slot_operation(&c), &a);
+  EXPECT_EQ(pool.get_previous_slot_operation(&d), nullptr);
+
+  std::unique_ptr<MemoryBuffer> a_buf = create_buffer(pool, a);
+  std::unique_ptr<MemoryBuffer> b_buf = create_buffer(pool, b);
+  pool.buffer_released(&a);
+  EXPECT_EQ(pool.get_reused_size(), 0);
+
+  /* The buffer of a is not read anymore. */
+  std::unique_ptr<MemoryBuffer> c_buf = create_buffer(pool, c);
+  EXPECT_EQ(c_buf->get_buffer(), a_buf->get_buffer());
+  EXPECT_NE(c_buf->get_buffer(), b_buf->get_buffer());
+  EXPECT_EQ(pool.get_reused_size(), size);
+  pool.buffer_released(&b);
+
+  /* Different size than the other slots. */
+  std::unique_ptr<MemoryBuffer> d_buf = create_buffer(pool, d);
+  EXPECT_EQ(pool.get_reused_size(), size);
+  /* The slot of b was freed before allocating d. */
+  EXPECT_EQ(pool.get_peak_size(), size * 2);
+  pool.buffer_released(&c);
+}
+
+}  // namespace blender::compositor::tests
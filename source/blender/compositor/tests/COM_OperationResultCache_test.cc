@@ -0,0 +1,60 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include "COM_MemoryBuffer.h"
+#include "COM_OperationResultCache.h"
+
+namespace blender::compositor::tests {
+
+static std::unique_ptr<MemoryBuffer> create_buffer(const float value)
+{
+  const rcti rect = {0, 4, 0, 3};
+  std::unique_ptr<MemoryBuffer> buffer = std::make_unique<MemoryBuffer>(DataType::Value, rect);
+  buffer->fill(rect, &value);
+  return buffer;
+}
+
+TEST(OperationResultCache, EvictLeastRecentlyUsed)
+{
+  const int64_t size = 4 * 3 * sizeof(float);
+
+  OperationResultCache cache;
+  EXPECT_FALSE(cache.is_enabled());
+  cache.add(1, create_buffer(1.0f));
+  EXPECT_EQ(cache.lookup(1), nullptr);
+
+  cache.set_size_limit(size * 2);
+  cache.add(1, create_buffer(1.0f));
+  cache.add(2, create_buffer(2.0f));
+  EXPECT_EQ(cache.get_size(), size * 2);
+
+  /* Use the first buffer so that the second one is evicted. */
+  std::shared_ptr<const MemoryBuffer> first = cache.lookup(1);
+  ASSERT_NE(first, nullptr);
+  EXPECT_EQ(*first->get_elem(2, 1), 1.0f);
+  std::shared_ptr<const MemoryBuffer> second = cache.lookup(2);
+  ASSERT_NE(second, nullptr);
+  first = cache.lookup(1);
+  cache.add(3, create_buffer(3.0f));
+  EXPECT_EQ(cache.get_size(), size * 2);
+  EXPECT_NE(cache.lookup(1), nullptr);
+  EXPECT_EQ(cache.lookup(2), nullptr);
+  EXPECT_NE(cache.lookup(3), nullptr);
+
+  /* Evicted buffers stay valid while in use. */
+  EXPECT_EQ(*second->get_elem(0, 0), 2.0f);
+
+  cache.set_size_limit(size);
+  EXPECT_EQ(cache.get_size(), size);
+  EXPECT_EQ(cache.lookup(1), nullptr);
+  EXPECT_NE(cache.lookup(3), nullptr);
+
+  cache.clear();
+  EXPECT_EQ(cache.get_size(), 0);
+  EXPECT_EQ(cache.lookup(3), nullptr);
+}
+
+}  // namespace blender::compositor::tests
@@ -690,8 +690,8 @@ typedef struct bNodeTree {
   int execution_mode;
   /** Execution mode to use for compositor engine. */
   int precision;
-
-  char _pad[4];
+  /** Memory limit in megabytes of the compositor results kept across executions, 0 disables. */
+  int cache_limit;
 
   rctf viewer_border;
 
@@ -217,6 +217,8 @@
     .erp = 0.2f, \
     .erp2 = 0.8f, \
     .cfm = 0.0f, \
+    .broadphaseWorldSize = 10000.0f, \
+    .broadphaseCellSize = 10.0f, \
     .obstacleSimulation = OBSTSIMULATION_NONE, \
     .levelHeight = 2.0f, \
     .exitkey = 218, \
@@ -921,7 +921,7 @@ typedef struct GameData {
   short matmode DNA_DEPRECATED;
   short occlusionRes; /* resolution of occlusion Z buffer in pixel */
   short physicsEngine;
-  short solverType, _pad[3];
+  short solverType, broadphaseType, _pad[2];
   short exitkey;
   short pythonkeys[4];
   short vsync; /* Controls vsync: off, on, or adaptive (if supported) */
@@ -936,6 +936,8 @@ typedef struct GameData {
   /* Scene LoD */
   short lodflag, _pad3;
   int scehysteresis;
+  /* Broadphase, world half size for axis sweep and cell size for grid. */
+  float broadphaseWorldSize, broadphaseCellSize;
   void *_pad10;
 } GameData;
 
@@ -961,6 +963,14 @@ typedef struct GameData {
 enum {
   GAME_SOLVER_SEQUENTIAL = 0,
   GAME_SOLVER_NNCG,
+  GAME_SOLVER_PARALLEL,
+};
+
+/* GameData.broadphaseType */
+enum {
+  GAME_BROADPHASE_DBVT = 0,
+  GAME_BROADPHASE_AXIS_SWEEP,
+  GAME_BROADPHASE_GRID,
 };
 
 /* obstacleSimulation */
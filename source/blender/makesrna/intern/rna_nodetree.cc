@@ -10514,6 +10514,16 @@ static void rna_def_composite_nodetree(BlenderRNA *brna)
   RNA_def_property_ui_text(prop, "Execution Mode", "Set how compositing is executed");
   RNA_def_property_update(prop, NC_NODE | ND_DISPLAY, "rna_NodeTree_update");
 
+  prop = RNA_def_property(srna, "cache_limit", PROP_INT, PROP_NONE);
+  RNA_def_property_int_sdna(prop, nullptr, "cache_limit");
+  RNA_def_property_range(prop, 0, INT_MAX);
+  RNA_def_property_ui_range(prop, 0, 16384, 64, -1);
+  RNA_def_property_ui_text(prop,
+                           "Cache Limit",
+                           "Memory limit (in megabytes) of the results of unchanged node "
+                           "sub-trees kept to be reused on the next frames, 0 disables the cache");
+  RNA_def_property_update(prop, NC_NODE | ND_DISPLAY, "rna_NodeTree_update");
+
   prop = RNA_def_property(srna, "render_quality", PROP_ENUM, PROP_NONE);
   RNA_def_property_enum_sdna(prop, nullptr, "render_quality");
   RNA_def_property_enum_items(prop, node_quality_items);
@@ -6136,6 +6136,31 @@ static void rna_def_scene_game_data(BlenderRNA *brna)
        "Sequential",
        "Sequential physics solver, default solver"},
       {GAME_SOLVER_NNCG, "SOLVER_NNGC", 0, "NNGC", "NNGC physics solver"},
+      {GAME_SOLVER_PARALLEL,
+       "SOLVER_PARALLEL",
+       0,
+       "Parallel",
+       "Sequential physics solver solving independent simulation islands on multiple threads"},
+      {0, NULL, 0, NULL, NULL}};
+
+  static const EnumPropertyItem broadphase_items[] = {
+      {GAME_BROADPHASE_DBVT,
+       "DBVT",
+       0,
+       "Dynamic AABB Tree",
+       "Dynamic bounding volume trees, static objects are kept in a tree built once"},
+      {GAME_BROADPHASE_AXIS_SWEEP,
+       "AXIS_SWEEP",
+       0,
+       "Axis Sweep",
+       "Sweep and prune inside fixed world bounds, for worlds with few moving objects "
+       "(limited to 131072 objects)"},
+      {GAME_BROADPHASE_GRID,
+       "GRID",
+       0,
+       "Uniform Grid",
+       "Sparse uniform grid for moving objects, for large worlds with many moving objects "
+       "of similar size"},
       {0, NULL, 0, NULL, NULL}};
 
   static const EnumPropertyItem framing_types_items[] = {
@@ -6342,6 +6367,32 @@ static void rna_def_scene_game_data(BlenderRNA *brna)
   RNA_def_property_ui_text(prop, "Physics Solver", "Physics constraint solver");
   RNA_def_property_update(prop, NC_SCENE, NULL);
 
+  prop = RNA_def_property(srna, "physics_broadphase", PROP_ENUM, PROP_NONE);
+  RNA_def_property_enum_sdna(prop, NULL, "broadphaseType");
+  RNA_def_property_enum_items(prop, broadphase_items);
+  RNA_def_property_ui_text(
+      prop, "Physics Broadphase", "Method used to find the pairs of objects possibly colliding");
+  RNA_def_property_update(prop, NC_SCENE, NULL);
+
+  prop = RNA_def_property(srna, "physics_broadphase_world_size", PROP_FLOAT, PROP_DISTANCE);
+  RNA_def_property_float_sdna(prop, NULL, "broadphaseWorldSize");
+  RNA_def_property_range(prop, 1.0, 1000000.0);
+  RNA_def_property_ui_text(
+      prop,
+      "Broadphase World Size",
+      "Half size of the world bounds used by the axis sweep broadphase, objects outside of the "
+      "bounds collide inefficiently");
+  RNA_def_property_update(prop, NC_SCENE, NULL);
+
+  prop = RNA_def_property(srna, "physics_broadphase_cell_size", PROP_FLOAT, PROP_DISTANCE);
+  RNA_def_property_float_sdna(prop, NULL, "broadphaseCellSize");
+  RNA_def_property_range(prop, 0.01, 10000.0);
+  RNA_def_property_ui_text(prop,
+                           "Broadphase Cell Size",
+                           "Size of the cells used by the grid broadphase, should be close to "
+                           "the size of the moving objects");
+  RNA_def_property_update(prop, NC_SCENE, NULL);
+
   prop = RNA_def_property(srna, "occlusion_culling_resolution", PROP_INT, PROP_PIXEL);
   RNA_def_property_int_sdna(prop, NULL, "occlusionRes");
   RNA_def_property_range(prop, 128.0, 1024.0);
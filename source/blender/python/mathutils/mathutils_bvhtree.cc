@@ -11,14 +11,25 @@
 
 #include <Python.h>
 
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#ifndef WIN32
+#  include <unistd.h>
+#else
+#  include <io.h>
+#endif
+
 #include "MEM_guardedalloc.h"
 
+#include "BLI_fileops.h"
 #include "BLI_ghash.h"
 #include "BLI_kdopbvh.h"
 #include "BLI_math_geom.h"
 #include "BLI_math_matrix.h"
 #include "BLI_math_vector.h"
 #include "BLI_memarena.h"
+#include "BLI_mmap.h"
 #include "BLI_polyfill_2d.h"
 #include "BLI_utildefines.h"
 
@@ -95,6 +106,10 @@ struct PyBVHTree {
   int *orig_index;
   /* aligned with array that 'orig_index' points to */
   float (*orig_normal)[3];
+
+  /* Set when loaded from a file, the arrays and the bounding volumes of the tree are in the
+   * mapped file. */
+  BLI_mmap_file *mmap_file;
 };
 
 /* -------------------------------------------------------------------- */
@@ -126,6 +141,8 @@ static PyObject *bvhtree_CreatePyObject(BVHTree *tree,
   result->orig_index = orig_index;
   result->orig_normal = orig_normal;
 
+  result->mmap_file = nullptr;
+
   return (PyObject *)result;
 }
 
@@ -245,11 +262,16 @@ static void py_bvhtree__tp_dealloc(PyBVHTree *self)
     BLI_bvhtree_free(self->tree);
   }
 
-  MEM_SAFE_FREE(self->coords);
-  MEM_SAFE_FREE(self->tris);
+  if (self->mmap_file) {
+    BLI_mmap_free(self->mmap_file);
+  }
+  else {
+    MEM_SAFE_FREE(self->coords);
+    MEM_SAFE_FREE(self->tris);
 
-  MEM_SAFE_FREE(self->orig_index);
-  MEM_SAFE_FREE(self->orig_normal);
+    MEM_SAFE_FREE(self->orig_index);
+    MEM_SAFE_FREE(self->orig_normal);
+  }
 
   Py_TYPE(self)->tp_free((PyObject *)self);
 }
@@ -630,6 +652,262 @@ static PyObject *py_bvhtree_overlap(PyBVHTree *self, PyBVHTree *other)
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name Save & Load
+ *
+ * A file holds a #PyBVHTreeFileHeader, the coordinates, the triangles, the optional original
+ * indices and normals, then the tree from #BLI_bvhtree_serialize. Each array is aligned to
+ * 8 bytes and stored in the native byte order, so loading maps the file and uses them in place.
+ * \{ */
+
+static const char py_bvhtree_file_magic[8] = {'B', 'P', 'Y', 'B', 'V', 'H', 'T', 'R'};
+static const uint py_bvhtree_file_version = 1;
+
+struct PyBVHTreeFileHeader {
+  char magic[8];
+  uint version;
+  float epsilon;
+  uint coords_len;
+  uint tris_len;
+  /** Zero without original indices, otherwise the number of triangles. */
+  uint orig_index_len;
+  uint orig_normal_len;
+  uint64_t tree_size;
+};
+
+struct PyBVHTreeFileLayout {
+  size_t coords, tris, orig_index, orig_normal, tree, size;
+};
+
+static size_t py_bvhtree_file_align(const size_t size)
+{
+  return (size + 7) & ~size_t(7);
+}
+
+static void py_bvhtree_file_layout(const PyBVHTreeFileHeader *header,
+                                   PyBVHTreeFileLayout *r_layout)
+{
+  size_t ofs = py_bvhtree_file_align(sizeof(*header));
+  r_layout->coords = ofs;
+  ofs = py_bvhtree_file_align(ofs + sizeof(float[3]) * header->coords_len);
+  r_layout->tris = ofs;
+  ofs = py_bvhtree_file_align(ofs + sizeof(uint[3]) * header->tris_len);
+  r_layout->orig_index = ofs;
+  ofs = py_bvhtree_file_align(ofs + sizeof(int) * header->orig_index_len);
+  r_layout->orig_normal = ofs;
+  ofs = py_bvhtree_file_align(ofs + sizeof(float[3]) * header->orig_normal_len);
+  r_layout->tree = ofs;
+  r_layout->size = ofs + size_t(header->tree_size);
+}
+
+/**
+ * Create a tree using the arrays of a mapped file in place.
+ * \return nullptr when the file isn't valid, the caller keeps the ownership of the file.
+ */
+static PyObject *bvhtree_CreatePyObject_from_mmap(BLI_mmap_file *mmap_file)
+{
+  char *data = static_cast<char *>(BLI_mmap_get_pointer(mmap_file));
+  const size_t data_len = BLI_mmap_get_length(mmap_file);
+
+  PyBVHTreeFileHeader header;
+  if (data_len < sizeof(header)) {
+    return nullptr;
+  }
+  memcpy(&header, data, sizeof(header));
+  if (memcmp(header.magic, py_bvhtree_file_magic, sizeof(header.magic)) != 0 ||
+      header.version != py_bvhtree_file_version ||
+      !ELEM(header.orig_index_len, 0, header.tris_len) || header.tree_size > data_len)
+  {
+    return nullptr;
+  }
+
+  PyBVHTreeFileLayout layout;
+  py_bvhtree_file_layout(&header, &layout);
+  if (layout.size > data_len) {
+    return nullptr;
+  }
+
+  float(*coords)[3] = reinterpret_cast<float(*)[3]>(data + layout.coords);
+  uint(*tris)[3] = reinterpret_cast<uint(*)[3]>(data + layout.tris);
+  int *orig_index = header.orig_index_len ? reinterpret_cast<int *>(data + layout.orig_index) :
+                                            nullptr;
+  float(*orig_normal)[3] = header.orig_normal_len ?
+                               reinterpret_cast<float(*)[3]>(data + layout.orig_normal) :
+                               nullptr;
+
+  /* The queries use the indices without checks. */
+  for (uint i = 0; i < header.tris_len; i++) {
+    if (tris[i][0] >= header.coords_len || tris[i][1] >= header.coords_len ||
+        tris[i][2] >= header.coords_len)
+    {
+      return nullptr;
+    }
+  }
+  if (orig_index) {
+    for (uint i = 0; i < header.tris_len; i++) {
+      if (orig_index[i] < 0 || (orig_normal && uint(orig_index[i]) >= header.orig_normal_len)) {
+        return nullptr;
+      }
+    }
+  }
+  else if (orig_normal && header.orig_normal_len < header.tris_len) {
+    return nullptr;
+  }
+
+  int index_range[2];
+  BVHTree *tree = BLI_bvhtree_new_from_buffer(
+      data + layout.tree, size_t(header.tree_size), index_range);
+  if (tree == nullptr) {
+    return nullptr;
+  }
+  if (index_range[0] < 0 || index_range[1] >= int(header.tris_len)) {
+    BLI_bvhtree_free(tree);
+    return nullptr;
+  }
+
+  return bvhtree_CreatePyObject(tree,
+                                header.epsilon,
+                                coords,
+                                header.coords_len,
+                                tris,
+                                header.tris_len,
+                                orig_index,
+                                orig_normal);
+}
+
+PyDoc_STRVAR(
+    /* Wrap. */
+    py_bvhtree_save_doc,
+    ".. method:: save(filepath)\n"
+    "\n"
+    "   Write the tree and its geometry to a file, loading it with :class:`BVHTree.load` is\n"
+    "   much faster than building the tree again.\n"
+    "\n"
+    "   :arg filepath: The file to write.\n"
+    "   :type filepath: str\n"
+    "\n"
+    "   .. note::\n"
+    "\n"
+    "      The file is in the byte order of the machine, it can't be loaded on a machine of\n"
+    "      another byte order.\n");
+static PyObject *py_bvhtree_save(PyBVHTree *self, PyObject *args)
+{
+  PyC_UnicodeAsBytesAndSize_Data filepath_data = {nullptr};
+  if (!PyArg_ParseTuple(args, "O&:save", PyC_ParseUnicodeAsBytesAndSize, &filepath_data)) {
+    return nullptr;
+  }
+
+  PyBVHTreeFileHeader header = {};
+  memcpy(header.magic, py_bvhtree_file_magic, sizeof(header.magic));
+  header.version = py_bvhtree_file_version;
+  header.epsilon = self->epsilon;
+  header.coords_len = self->coords_len;
+  header.tris_len = self->tris_len;
+  header.orig_index_len = self->orig_index ? self->tris_len : 0;
+  if (self->orig_normal) {
+    /* The normals are indexed by the original indices, only keep the ones in use. */
+    header.orig_normal_len = self->tris_len;
+    if (self->orig_index) {
+      header.orig_normal_len = 0;
+      for (uint i = 0; i < self->tris_len; i++) {
+        header.orig_normal_len = max_uu(header.orig_normal_len, uint(self->orig_index[i]) + 1);
+      }
+    }
+  }
+  header.tree_size = BLI_bvhtree_serialize_size(self->tree);
+
+  PyBVHTreeFileLayout layout;
+  py_bvhtree_file_layout(&header, &layout);
+
+  char *buffer = static_cast<char *>(MEM_callocN(layout.size, __func__));
+  memcpy(buffer, &header, sizeof(header));
+  memcpy(buffer + layout.coords, self->coords, sizeof(float[3]) * header.coords_len);
+  memcpy(buffer + layout.tris, self->tris, sizeof(uint[3]) * header.tris_len);
+  if (header.orig_index_len) {
+    memcpy(buffer + layout.orig_index, self->orig_index, sizeof(int) * header.orig_index_len);
+  }
+  if (header.orig_normal_len) {
+    memcpy(
+        buffer + layout.orig_normal, self->orig_normal, sizeof(float[3]) * header.orig_normal_len);
+  }
+  BLI_bvhtree_serialize(self->tree, buffer + layout.tree);
+
+  bool ok = false;
+  FILE *file = BLI_fopen(filepath_data.value, "wb");
+  if (file) {
+    ok = fwrite(buffer, 1, layout.size, file) == layout.size;
+    if (fclose(file) != 0) {
+      ok = false;
+    }
+  }
+  MEM_freeN(buffer);
+
+  if (!ok) {
+    PyErr_Format(PyExc_IOError,
+                 "save: unable to write \"%s\": %s",
+                 filepath_data.value,
+                 strerror(errno));
+  }
+  Py_XDECREF(filepath_data.value_coerce);
+
+  if (!ok) {
+    return nullptr;
+  }
+  Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(
+    /* Wrap. */
+    C_BVHTree_load_doc,
+    ".. classmethod:: load(filepath)\n"
+    "\n"
+    "   BVH tree read from a file written by :class:`BVHTree.save`. The file is memory mapped\n"
+    "   and used in place, the tree isn't built again.\n"
+    "\n"
+    "   :arg filepath: The file to read.\n"
+    "   :type filepath: str\n"
+    "   :return: The tree of the file.\n"
+    "   :rtype: :class:`BVHTree`\n");
+static PyObject *C_BVHTree_load(PyObject * /*cls*/, PyObject *args)
+{
+  PyC_UnicodeAsBytesAndSize_Data filepath_data = {nullptr};
+  if (!PyArg_ParseTuple(args, "O&:load", PyC_ParseUnicodeAsBytesAndSize, &filepath_data)) {
+    return nullptr;
+  }
+
+  BLI_mmap_file *mmap_file = nullptr;
+  const int file = BLI_open(filepath_data.value, O_BINARY | O_RDONLY, 0);
+  if (file != -1) {
+    /* The mapping stays valid after closing the file. */
+    mmap_file = BLI_mmap_open(file);
+    close(file);
+  }
+
+  PyObject *ret = nullptr;
+  if (mmap_file == nullptr) {
+    PyErr_Format(PyExc_IOError,
+                 "load: unable to read \"%s\": %s",
+                 filepath_data.value,
+                 strerror(errno));
+  }
+  else {
+    ret = bvhtree_CreatePyObject_from_mmap(mmap_file);
+    if (ret) {
+      reinterpret_cast<PyBVHTree *>(ret)->mmap_file = mmap_file;
+    }
+    else {
+      BLI_mmap_free(mmap_file);
+      PyErr_Format(
+          PyExc_ValueError, "load: \"%s\" is not a valid BVHTree file", filepath_data.value);
+    }
+  }
+  Py_XDECREF(filepath_data.value_coerce);
+
+  return ret;
+}
+
+/** \} */
+
 /* -------------------------------------------------------------------- */
 /** \name Class Methods
  * \{ */
@@ -1239,12 +1517,17 @@ static PyMethodDef py_bvhtree_methods[] = {
      METH_VARARGS,
      py_bvhtree_find_nearest_range_doc},
     {"overlap", reinterpret_cast<PyCFunction>(py_bvhtree_overlap), METH_O, py_bvhtree_overlap_doc},
+    {"save", reinterpret_cast<PyCFunction>(py_bvhtree_save), METH_VARARGS, py_bvhtree_save_doc},
 
     /* class methods */
     {"FromPolygons",
      reinterpret_cast<PyCFunction>(C_BVHTree_FromPolygons),
      METH_VARARGS | METH_KEYWORDS | METH_CLASS,
      C_BVHTree_FromPolygons_doc},
+    {"load",
+     reinterpret_cast<PyCFunction>(C_BVHTree_load),
+     METH_VARARGS | METH_CLASS,
+     C_BVHTree_load_doc},
 #ifndef MATH_STANDALONE
     {"FromBMesh",
      reinterpret_cast<PyCFunction>(C_BVHTree_FromBMesh),
@@ -11,10 +11,26 @@
 
 #include <Python.h>
 
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#ifndef WIN32
+#  include <unistd.h>
+#else
+#  include <io.h>
+#endif
+
 #include "MEM_guardedalloc.h"
 
+#include "BLI_array.hh"
+#include "BLI_fileops.h"
 #include "BLI_kdtree.h"
+#include "BLI_mmap.h"
+#include "BLI_task.hh"
 #include "BLI_utildefines.h"
+#include "BLI_vector.hh"
 
 #include "../generic/py_capi_utils.h"
 #include "../generic/python_utildefines.h"
@@ -30,6 +46,8 @@ struct PyKDTree {
   uint maxsize;
   uint count;
   uint count_balance; /* size when we last balanced */
+  /* Set when loaded from a file, the nodes of the tree are in the mapped file. */
+  BLI_mmap_file *mmap_file;
 };
 
 /* -------------------------------------------------------------------- */
@@ -97,6 +115,7 @@ static int PyKDTree__tp_init(PyKDTree *self, PyObject *args, PyObject *kwargs)
   self->maxsize = maxsize;
   self->count = 0;
   self->count_balance = 0;
+  self->mmap_file = nullptr;
 
   return 0;
 }
@@ -104,6 +123,9 @@ static int PyKDTree__tp_init(PyKDTree *self, PyObject *args, PyObject *kwargs)
 static void PyKDTree__tp_dealloc(PyKDTree *self)
 {
   BLI_kdtree_3d_free(self->obj);
+  if (self->mmap_file) {
+    BLI_mmap_free(self->mmap_file);
+  }
   Py_TYPE(self)->tp_free((PyObject *)self);
 }
 
@@ -161,7 +183,10 @@ PyDoc_STRVAR(
     "   This builds the entire tree, avoid calling after each insertion.\n");
 static PyObject *py_kdtree_balance(PyKDTree *self)
 {
-  BLI_kdtree_3d_balance(self->obj);
+  /* A loaded tree is balanced and read-only. */
+  if (self->mmap_file == nullptr) {
+    BLI_kdtree_3d_balance(self->obj);
+  }
   self->count_balance = self->count;
   Py_RETURN_NONE;
 }
@@ -367,6 +392,584 @@ static PyObject *py_kdtree_find_range(PyKDTree *self, PyObject *args, PyObject *
   return py_list;
 }
 
+/* -------------------------------------------------------------------- */
+/* Batched Queries
+ *
+ * The query points are read from a float buffer (e.g. a numpy array) or a sequence of vectors,
+ * searched in parallel and the results returned as packed arrays, so the Python overhead is
+ * paid once per batch instead of once per point. */
+
+/** Number of queries of a task of the batched searches. */
+#define KDTREE_BATCH_GRAIN_SIZE 256
+
+/**
+ * Parse the query points of a batch.
+ * \return The number of points or -1 on error, free `r_co` with `PyMem_Free`.
+ */
+static int py_kdtree_batch_co_parse(PyObject *value, float (**r_co)[3], const char *error_prefix)
+{
+  *r_co = nullptr;
+
+  if (PyObject_CheckBuffer(value)) {
+    Py_buffer buf;
+    if (PyObject_GetBuffer(value, &buf, PyBUF_ND | PyBUF_FORMAT) == -1) {
+      /* Fall back to accessing as a sequence. */
+      PyErr_Clear();
+    }
+    else {
+      const char format = buf.format ? PyC_StructFmt_type_from_str(buf.format) : 'B';
+      if (ELEM(format, 'f', 'd') && buf.itemsize == (format == 'f' ? 4 : 8)) {
+        if (buf.ndim != 2 || buf.shape[1] != 3 || buf.shape[0] > INT_MAX) {
+          if (buf.ndim == 2) {
+            PyErr_Format(PyExc_ValueError,
+                         "%s: expected a buffer of shape (n, 3), got (%zd, %zd)",
+                         error_prefix,
+                         buf.shape[0],
+                         buf.shape[1]);
+          }
+          else {
+            PyErr_Format(PyExc_ValueError,
+                         "%s: expected a buffer of shape (n, 3), got %d dimension(s)",
+                         error_prefix,
+                         buf.ndim);
+          }
+          PyBuffer_Release(&buf);
+          return -1;
+        }
+
+        const int num = int(buf.shape[0]);
+        const Py_ssize_t values_num = Py_ssize_t(num) * 3;
+        float *co = static_cast<float *>(
+            PyMem_Malloc(sizeof(float[3]) * size_t(std::max(num, 1))));
+        if (format == 'f') {
+          memcpy(co, buf.buf, sizeof(float) * size_t(values_num));
+        }
+        else {
+          const double *co_src = static_cast<const double *>(buf.buf);
+          for (Py_ssize_t i = 0; i < values_num; i++) {
+            co[i] = float(co_src[i]);
+          }
+        }
+        PyBuffer_Release(&buf);
+
+        *r_co = reinterpret_cast<float(*)[3]>(co);
+        return num;
+      }
+      PyBuffer_Release(&buf);
+    }
+  }
+
+  float *co = nullptr;
+  const int num = mathutils_array_parse_alloc_v(&co, 3, value, error_prefix);
+  *r_co = reinterpret_cast<float(*)[3]>(co);
+  return num;
+}
+
+/**
+ * Bytes of a packed array of \a num items, filled through \a r_data then wrapped with
+ * #py_kdtree_batch_array_finish.
+ */
+static PyObject *py_kdtree_batch_array_new(const size_t num,
+                                           const size_t item_size,
+                                           void **r_data)
+{
+  PyObject *bytes = PyBytes_FromStringAndSize(nullptr, Py_ssize_t(num * item_size));
+  *r_data = bytes ? PyBytes_AS_STRING(bytes) : nullptr;
+  return bytes;
+}
+
+/** Wrap the bytes of #py_kdtree_batch_array_new once filled in a typed `memoryview`. */
+static PyObject *py_kdtree_batch_array_finish(PyObject *bytes, const char *format)
+{
+  PyObject *view = PyMemoryView_FromObject(bytes);
+  Py_DECREF(bytes);
+  if (view == nullptr) {
+    return nullptr;
+  }
+  PyObject *ret = PyObject_CallMethod(view, "cast", "s", format);
+  Py_DECREF(view);
+  return ret;
+}
+
+/**
+ * Wrap the filled arrays of #py_kdtree_batch_array_new in a tuple of typed `memoryview`,
+ * steals the references to \a arrays.
+ * \return The tuple or null with the error set.
+ */
+static PyObject *py_kdtree_batch_result(PyObject **arrays, const char **formats, const int num)
+{
+  PyObject *py_retval = PyTuple_New(num);
+  int i = 0;
+  for (; py_retval && i < num; i++) {
+    PyObject *item = py_kdtree_batch_array_finish(arrays[i], formats[i]);
+    if (item == nullptr) {
+      Py_CLEAR(py_retval);
+    }
+    else {
+      PyTuple_SET_ITEM(py_retval, i, item);
+    }
+  }
+  /* Arrays left after an error. */
+  for (; i < num; i++) {
+    Py_DECREF(arrays[i]);
+  }
+  return py_retval;
+}
+
+PyDoc_STRVAR(
+    /* Wrap. */
+    py_kdtree_find_batch_doc,
+    ".. method:: find_batch(co_array)\n"
+    "\n"
+    "   Find the nearest point to each point of ``co_array``, the points are searched in\n"
+    "   parallel.\n"
+    "\n"
+    "   :arg co_array: 3d coordinates, a float buffer of shape (n, 3) (e.g. a numpy array) or a\n"
+    "      sequence.\n"
+    "   :type co_array: buffer | Sequence[Sequence[float]]\n"
+    "   :return: Returns (indices, distances), an index of -1 and a distance of ``inf`` when\n"
+    "      the tree is empty.\n"
+    "   :rtype: tuple[memoryview, memoryview]\n");
+static PyObject *py_kdtree_find_batch(PyKDTree *self, PyObject *args, PyObject *kwargs)
+{
+  PyObject *py_co_array;
+  const char *keywords[] = {"co_array", nullptr};
+
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwargs, "O:find_batch", (char **)keywords, &py_co_array))
+  {
+    return nullptr;
+  }
+
+  if (self->count != self->count_balance) {
+    PyErr_SetString(PyExc_RuntimeError, "KDTree must be balanced before calling find_batch()");
+    return nullptr;
+  }
+
+  float(*co_array)[3];
+  const int co_num = py_kdtree_batch_co_parse(py_co_array, &co_array, "find_batch");
+  if (co_num == -1) {
+    return nullptr;
+  }
+
+  int *r_index;
+  float *r_dist;
+  PyObject *py_index = py_kdtree_batch_array_new(size_t(co_num), sizeof(int), (void **)&r_index);
+  PyObject *py_dist = py_kdtree_batch_array_new(size_t(co_num), sizeof(float), (void **)&r_dist);
+  if (py_index == nullptr || py_dist == nullptr) {
+    Py_XDECREF(py_index);
+    Py_XDECREF(py_dist);
+    PyMem_Free(co_array);
+    return nullptr;
+  }
+
+  const KDTree_3d *tree = self->obj;
+  blender::threading::parallel_for(
+      blender::IndexRange(co_num), KDTREE_BATCH_GRAIN_SIZE, [&](const blender::IndexRange range) {
+        for (const int64_t i : range) {
+          KDTreeNearest_3d nearest;
+          if (BLI_kdtree_3d_find_nearest(tree, co_array[i], &nearest) != -1) {
+            r_index[i] = nearest.index;
+            r_dist[i] = nearest.dist;
+          }
+          else {
+            r_index[i] = -1;
+            r_dist[i] = INFINITY;
+          }
+        }
+      });
+
+  PyMem_Free(co_array);
+
+  PyObject *arrays[] = {py_index, py_dist};
+  const char *formats[] = {"i", "f"};
+  return py_kdtree_batch_result(arrays, formats, int(ARRAY_SIZE(arrays)));
+}
+
+PyDoc_STRVAR(
+    /* Wrap. */
+    py_kdtree_find_n_batch_doc,
+    ".. method:: find_n_batch(co_array, n)\n"
+    "\n"
+    "   Find the nearest ``n`` points to each point of ``co_array``, the points are searched\n"
+    "   in parallel.\n"
+    "\n"
+    "   :arg co_array: 3d coordinates, a float buffer of shape (n, 3) (e.g. a numpy array) or a\n"
+    "      sequence.\n"
+    "   :type co_array: buffer | Sequence[Sequence[float]]\n"
+    "   :arg n: Number of points to find.\n"
+    "   :type n: int\n"
+    "   :return: Returns (indices, distances) of ``n`` items per point sorted by distance,\n"
+    "      padded with an index of -1 and a distance of ``inf`` when the tree has fewer\n"
+    "      points.\n"
+    "   :rtype: tuple[memoryview, memoryview]\n");
+static PyObject *py_kdtree_find_n_batch(PyKDTree *self, PyObject *args, PyObject *kwargs)
+{
+  PyObject *py_co_array;
+  uint n;
+  const char *keywords[] = {"co_array", "n", nullptr};
+
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwargs, "OI:find_n_batch", (char **)keywords, &py_co_array, &n))
+  {
+    return nullptr;
+  }
+
+  if (UINT_IS_NEG(n)) {
+    PyErr_SetString(PyExc_RuntimeError, "negative 'n' given");
+    return nullptr;
+  }
+
+  if (self->count != self->count_balance) {
+    PyErr_SetString(PyExc_RuntimeError, "KDTree must be balanced before calling find_n_batch()");
+    return nullptr;
+  }
+
+  float(*co_array)[3];
+  const int co_num = py_kdtree_batch_co_parse(py_co_array, &co_array, "find_n_batch");
+  if (co_num == -1) {
+    return nullptr;
+  }
+
+  /* Items past the tree size are always padding. */
+  const uint n_found_max = std::min(n, self->count);
+
+  int *r_index;
+  float *r_dist;
+  const size_t result_num = size_t(co_num) * n;
+  PyObject *py_index = py_kdtree_batch_array_new(result_num, sizeof(int), (void **)&r_index);
+  PyObject *py_dist = py_kdtree_batch_array_new(result_num, sizeof(float), (void **)&r_dist);
+  if (py_index == nullptr || py_dist == nullptr) {
+    Py_XDECREF(py_index);
+    Py_XDECREF(py_dist);
+    PyMem_Free(co_array);
+    return nullptr;
+  }
+
+  const KDTree_3d *tree = self->obj;
+  blender::threading::parallel_for(
+      blender::IndexRange(co_num), KDTREE_BATCH_GRAIN_SIZE, [&](const blender::IndexRange range) {
+        /* Reused by all the queries of the task. */
+        blender::Array<KDTreeNearest_3d> nearest(int64_t(std::max(n_found_max, 1u)));
+        for (const int64_t i : range) {
+          const size_t offset = size_t(i) * n;
+          const uint found = uint(
+              BLI_kdtree_3d_find_nearest_n(tree, co_array[i], nearest.data(), n_found_max));
+          for (uint j = 0; j < found; j++) {
+            r_index[offset + j] = nearest[j].index;
+            r_dist[offset + j] = nearest[j].dist;
+          }
+          for (uint j = found; j < n; j++) {
+            r_index[offset + j] = -1;
+            r_dist[offset + j] = INFINITY;
+          }
+        }
+      });
+
+  PyMem_Free(co_array);
+
+  PyObject *arrays[] = {py_index, py_dist};
+  const char *formats[] = {"i", "f"};
+  return py_kdtree_batch_result(arrays, formats, int(ARRAY_SIZE(arrays)));
+}
+
+PyDoc_STRVAR(
+    /* Wrap. */
+    py_kdtree_find_range_batch_doc,
+    ".. method:: find_range_batch(co_array, radius)\n"
+    "\n"
+    "   Find all points within ``radius`` of each point of ``co_array``, the points are\n"
+    "   searched in parallel.\n"
+    "\n"
+    "   :arg co_array: 3d coordinates, a float buffer of shape (n, 3) (e.g. a numpy array) or a\n"
+    "      sequence.\n"
+    "   :type co_array: buffer | Sequence[Sequence[float]]\n"
+    "   :arg radius: Distance to search for points.\n"
+    "   :type radius: float\n"
+    "   :return: Returns (offsets, indices, distances), the results of the point ``i`` are\n"
+    "      the items ``offsets[i]`` to ``offsets[i + 1]`` of indices and distances, sorted by\n"
+    "      distance.\n"
+    "   :rtype: tuple[memoryview, memoryview, memoryview]\n");
+static PyObject *py_kdtree_find_range_batch(PyKDTree *self, PyObject *args, PyObject *kwargs)
+{
+  PyObject *py_co_array;
+  float radius;
+  const char *keywords[] = {"co_array", "radius", nullptr};
+
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwargs, "Of:find_range_batch", (char **)keywords, &py_co_array, &radius))
+  {
+    return nullptr;
+  }
+
+  if (radius < 0.0f) {
+    PyErr_SetString(PyExc_RuntimeError, "negative radius given");
+    return nullptr;
+  }
+
+  if (self->count != self->count_balance) {
+    PyErr_SetString(PyExc_RuntimeError,
+                    "KDTree must be balanced before calling find_range_batch()");
+    return nullptr;
+  }
+
+  float(*co_array)[3];
+  const int co_num = py_kdtree_batch_co_parse(py_co_array, &co_array, "find_range_batch");
+  if (co_num == -1) {
+    return nullptr;
+  }
+
+  /* The results of each chunk of queries are gathered in its own array then packed, the
+   * number of results isn't known before the search. */
+  const int64_t chunks_num = (int64_t(co_num) + KDTREE_BATCH_GRAIN_SIZE - 1) /
+                             KDTREE_BATCH_GRAIN_SIZE;
+  blender::Array<blender::Vector<KDTreeNearest_3d>> chunks(chunks_num);
+  blender::Array<int64_t> offsets(int64_t(co_num) + 1);
+
+  const KDTree_3d *tree = self->obj;
+  blender::threading::parallel_for(
+      blender::IndexRange(chunks_num), 1, [&](const blender::IndexRange chunk_range) {
+        for (const int64_t chunk : chunk_range) {
+          blender::Vector<KDTreeNearest_3d> &nearest = chunks[chunk];
+          const blender::IndexRange range = blender::IndexRange(co_num).slice(
+              chunk * KDTREE_BATCH_GRAIN_SIZE,
+              std::min<int64_t>(KDTREE_BATCH_GRAIN_SIZE,
+                                co_num - chunk * KDTREE_BATCH_GRAIN_SIZE));
+          for (const int64_t i : range) {
+            const int64_t start = nearest.size();
+            BLI_kdtree_3d_range_search_cb_cpp(
+                tree,
+                co_array[i],
+                radius,
+                [&](const int index, const float * /*co*/, const float dist_sq) {
+                  KDTreeNearest_3d item;
+                  item.index = index;
+                  item.dist = sqrtf(dist_sq);
+                  nearest.append(item);
+                  return true;
+                });
+            std::sort(nearest.begin() + start,
+                      nearest.end(),
+                      [](const KDTreeNearest_3d &a, const KDTreeNearest_3d &b) {
+                        return a.dist < b.dist;
+                      });
+            offsets[i] = nearest.size() - start;
+          }
+        }
+      });
+
+  PyMem_Free(co_array);
+
+  /* Accumulate the counts into offsets. */
+  int64_t result_num = 0;
+  for (const int64_t i : blender::IndexRange(co_num)) {
+    const int64_t count = offsets[i];
+    offsets[i] = result_num;
+    result_num += count;
+  }
+  offsets[co_num] = result_num;
+
+  int64_t *r_offsets;
+  int *r_index;
+  float *r_dist;
+  PyObject *py_offsets = py_kdtree_batch_array_new(
+      size_t(co_num) + 1, sizeof(int64_t), (void **)&r_offsets);
+  PyObject *py_index = py_kdtree_batch_array_new(
+      size_t(result_num), sizeof(int), (void **)&r_index);
+  PyObject *py_dist = py_kdtree_batch_array_new(
+      size_t(result_num), sizeof(float), (void **)&r_dist);
+  if (py_offsets == nullptr || py_index == nullptr || py_dist == nullptr) {
+    Py_XDECREF(py_offsets);
+    Py_XDECREF(py_index);
+    Py_XDECREF(py_dist);
+    return nullptr;
+  }
+
+  memcpy(r_offsets, offsets.data(), sizeof(int64_t) * size_t(offsets.size()));
+  blender::threading::parallel_for(
+      blender::IndexRange(chunks_num), 1, [&](const blender::IndexRange chunk_range) {
+        for (const int64_t chunk : chunk_range) {
+          const blender::Vector<KDTreeNearest_3d> &nearest = chunks[chunk];
+          const int64_t offset = offsets[chunk * KDTREE_BATCH_GRAIN_SIZE];
+          for (const int64_t j : nearest.index_range()) {
+            r_index[offset + j] = nearest[j].index;
+            r_dist[offset + j] = nearest[j].dist;
+          }
+        }
+      });
+
+  PyObject *arrays[] = {py_offsets, py_index, py_dist};
+  const char *formats[] = {"q", "i", "f"};
+  return py_kdtree_batch_result(arrays, formats, int(ARRAY_SIZE(arrays)));
+}
+
+/* -------------------------------------------------------------------- */
+/* Save & Load
+ *
+ * A file holds a #PyKDTreeFileHeader then the tree from #BLI_kdtree_3d_serialize, aligned to
+ * 8 bytes and in the native byte order, so loading maps the file and searches it in place. */
+
+static const char py_kdtree_file_magic[8] = {'B', 'P', 'Y', 'K', 'D', 'T', 'R', '3'};
+static const uint py_kdtree_file_version = 1;
+
+struct PyKDTreeFileHeader {
+  char magic[8];
+  uint version;
+  uint count;
+  uint64_t tree_size;
+};
+
+PyDoc_STRVAR(
+    /* Wrap. */
+    py_kdtree_save_doc,
+    ".. method:: save(filepath)\n"
+    "\n"
+    "   Write the balanced tree to a file, loading it with :class:`KDTree.load` is much faster\n"
+    "   than inserting and balancing the points again.\n"
+    "\n"
+    "   :arg filepath: The file to write.\n"
+    "   :type filepath: str\n"
+    "\n"
+    "   .. note::\n"
+    "\n"
+    "      The file is in the byte order of the machine, it can't be loaded on a machine of\n"
+    "      another byte order.\n");
+static PyObject *py_kdtree_save(PyKDTree *self, PyObject *args)
+{
+  PyC_UnicodeAsBytesAndSize_Data filepath_data = {nullptr};
+  if (!PyArg_ParseTuple(args, "O&:save", PyC_ParseUnicodeAsBytesAndSize, &filepath_data)) {
+    return nullptr;
+  }
+
+  if (self->count != self->count_balance) {
+    Py_XDECREF(filepath_data.value_coerce);
+    PyErr_SetString(PyExc_RuntimeError, "KDTree must be balanced before calling save()");
+    return nullptr;
+  }
+
+  PyKDTreeFileHeader header = {};
+  memcpy(header.magic, py_kdtree_file_magic, sizeof(header.magic));
+  header.version = py_kdtree_file_version;
+  header.count = self->count;
+  header.tree_size = BLI_kdtree_3d_serialize_size(self->obj);
+
+  const size_t size = sizeof(header) + size_t(header.tree_size);
+  char *buffer = static_cast<char *>(MEM_mallocN(size, __func__));
+  memcpy(buffer, &header, sizeof(header));
+  BLI_kdtree_3d_serialize(self->obj, buffer + sizeof(header));
+
+  bool ok = false;
+  FILE *file = BLI_fopen(filepath_data.value, "wb");
+  if (file) {
+    ok = fwrite(buffer, 1, size, file) == size;
+    if (fclose(file) != 0) {
+      ok = false;
+    }
+  }
+  MEM_freeN(buffer);
+
+  if (!ok) {
+    PyErr_Format(PyExc_IOError,
+                 "save: unable to write \"%s\": %s",
+                 filepath_data.value,
+                 strerror(errno));
+  }
+  Py_XDECREF(filepath_data.value_coerce);
+
+  if (!ok) {
+    return nullptr;
+  }
+  Py_RETURN_NONE;
+}
+
+/**
+ * Create a tree using the nodes of a mapped file in place.
+ * \return nullptr when the file isn't valid, the caller keeps the ownership of the file.
+ */
+static KDTree_3d *kdtree_new_from_mmap(BLI_mmap_file *mmap_file, uint *r_count)
+{
+  const char *data = static_cast<const char *>(BLI_mmap_get_pointer(mmap_file));
+  const size_t data_len = BLI_mmap_get_length(mmap_file);
+
+  PyKDTreeFileHeader header;
+  if (data_len < sizeof(header)) {
+    return nullptr;
+  }
+  memcpy(&header, data, sizeof(header));
+  if (memcmp(header.magic, py_kdtree_file_magic, sizeof(header.magic)) != 0 ||
+      header.version != py_kdtree_file_version || UINT_IS_NEG(header.count) ||
+      header.tree_size > data_len - sizeof(header))
+  {
+    return nullptr;
+  }
+
+  *r_count = header.count;
+  return BLI_kdtree_3d_new_from_buffer(data + sizeof(header), size_t(header.tree_size));
+}
+
+PyDoc_STRVAR(
+    /* Wrap. */
+    py_kdtree_load_doc,
+    ".. classmethod:: load(filepath)\n"
+    "\n"
+    "   Balanced kd-tree read from a file written by :class:`KDTree.save`. The file is memory\n"
+    "   mapped and searched in place, no points can be inserted in the tree.\n"
+    "\n"
+    "   :arg filepath: The file to read.\n"
+    "   :type filepath: str\n"
+    "   :return: The tree of the file.\n"
+    "   :rtype: :class:`KDTree`\n");
+static PyObject *py_kdtree_load(PyObject * /*cls*/, PyObject *args)
+{
+  PyC_UnicodeAsBytesAndSize_Data filepath_data = {nullptr};
+  if (!PyArg_ParseTuple(args, "O&:load", PyC_ParseUnicodeAsBytesAndSize, &filepath_data)) {
+    return nullptr;
+  }
+
+  BLI_mmap_file *mmap_file = nullptr;
+  const int file = BLI_open(filepath_data.value, O_BINARY | O_RDONLY, 0);
+  if (file != -1) {
+    /* The mapping stays valid after closing the file. */
+    mmap_file = BLI_mmap_open(file);
+    close(file);
+  }
+
+  PyKDTree *ret = nullptr;
+  if (mmap_file == nullptr) {
+    PyErr_Format(PyExc_IOError,
+                 "load: unable to read \"%s\": %s",
+                 filepath_data.value,
+                 strerror(errno));
+  }
+  else {
+    uint count;
+    KDTree_3d *obj = kdtree_new_from_mmap(mmap_file, &count);
+    if (obj) {
+      ret = PyObject_New(PyKDTree, &PyKDTree_Type);
+    }
+    if (ret) {
+      ret->obj = obj;
+      ret->maxsize = count;
+      ret->count = count;
+      ret->count_balance = count;
+      ret->mmap_file = mmap_file;
+    }
+    else {
+      if (obj) {
+        BLI_kdtree_3d_free(obj);
+      }
+      else {
+        PyErr_Format(
+            PyExc_ValueError, "load: \"%s\" is not a valid KDTree file", filepath_data.value);
+      }
+      BLI_mmap_free(mmap_file);
+    }
+  }
+  Py_XDECREF(filepath_data.value_coerce);
+
+  return (PyObject *)ret;
+}
+
 #if (defined(__GNUC__) && !defined(__clang__))
 #  pragma GCC diagnostic push
 #  pragma GCC diagnostic ignored "-Wcast-function-type"
@@ -381,6 +984,20 @@ static PyMethodDef PyKDTree_methods[] = {
      (PyCFunction)py_kdtree_find_range,
      METH_VARARGS | METH_KEYWORDS,
      py_kdtree_find_range_doc},
+    {"find_batch",
+     (PyCFunction)py_kdtree_find_batch,
+     METH_VARARGS | METH_KEYWORDS,
+     py_kdtree_find_batch_doc},
+    {"find_n_batch",
+     (PyCFunction)py_kdtree_find_n_batch,
+     METH_VARARGS | METH_KEYWORDS,
+     py_kdtree_find_n_batch_doc},
+    {"find_range_batch",
+     (PyCFunction)py_kdtree_find_range_batch,
+     METH_VARARGS | METH_KEYWORDS,
+     py_kdtree_find_range_batch_doc},
+    {"save", (PyCFunction)py_kdtree_save, METH_VARARGS, py_kdtree_save_doc},
+    {"load", (PyCFunction)py_kdtree_load, METH_VARARGS | METH_CLASS, py_kdtree_load_doc},
     {nullptr, nullptr, 0, nullptr},
 };
 
@@ -118,6 +118,10 @@
 /* Only to report a missing engine. */
 #include "RE_engine.h"
 
+#ifdef WITH_COMPOSITOR_CPU
+#  include "COM_compositor.hh"
+#endif
+
 #ifdef WITH_PYTHON
 #  include "BPY_extern_python.h"
 #  include "BPY_extern_run.h"
@@ -643,6 +647,10 @@ static void wm_file_read_pre(bool use_data, bool /*use_userdef*/)
 {
   if (use_data) {
     BLI_timer_on_file_load();
+#ifdef WITH_COMPOSITOR_CPU
+    /* Results of the previous file node trees can't be reused. */
+    COM_clear_caches();
+#endif
   }
 
   /* Always do this as both startup and preferences may have loaded in many font's
@@ -2008,7 +2008,14 @@ static const char arg_handle_ge_parameters_set_doc[] =
     "\t\tUse Vertex Arrays for rendering (usually faster).\n"
     "\t\tNo Texture Mipmapping.\n"
     "\t'linearmipmap'\n"
-    "\t\tLinear Texture Mipmapping instead of Nearest (default).";
+    "\t\tLinear Texture Mipmapping instead of Nearest (default).\n"
+    "\t'record_input = <path>'\n"
+    "\t\tRecord the input events of each logic frame to a file.\n"
+    "\t'replay_input = <path>'\n"
+    "\t\tReplay a recorded input file with the recorded frame times.\n"
+    "\t'frame_pacing = <policy>'\n"
+    "\t\tWait for the next frame in fixed framerate: 0 polls the clock, 1 sleeps and spins\n"
+    "\t\tshortly (default), 2 only sleeps for the lowest CPU usage.";
 static int arg_handle_ge_parameters_set(int argc, const char **argv, void *data)
 {
   int a = 0;
@@ -0,0 +1,304 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Common/CM_Logger.cpp
+ *  \ingroup common
+ */
+
+#include "CM_Logger.h"
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+#include "termcolor.hpp"
+
+/// Number of queued messages, must be a power of two.
+static const size_t queueSize = 4096;
+/// Duration of a rate limiting window in seconds.
+static const double rateWindow = 1.0;
+
+static double get_time()
+{
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+CM_Logger::CM_Logger()
+    : m_cells(new Cell[queueSize]),
+      m_mask(queueSize - 1),
+      m_enqueuePos(0),
+      m_dequeuePos(0),
+      m_processed(0),
+      m_dropped(0),
+      m_sinks(SINK_CONSOLE),
+      m_rateLimit(10),
+      m_fileChanged(false),
+      m_ringSize(256),
+      m_stop(false)
+{
+  for (size_t i = 0; i < queueSize; ++i) {
+    m_cells[i].sequence.store(i, std::memory_order_relaxed);
+  }
+
+  m_thread = std::thread(&CM_Logger::Run, this);
+}
+
+CM_Logger::~CM_Logger()
+{
+  m_stop = true;
+  m_wakeCondition.notify_one();
+  m_thread.join();
+}
+
+CM_Logger &CM_Logger::Get()
+{
+  static CM_Logger logger;
+  return logger;
+}
+
+void CM_Logger::Push(std::string &&message)
+{
+  size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+  Cell *cell;
+  for (;;) {
+    cell = &m_cells[pos & m_mask];
+    const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+    const std::ptrdiff_t diff = (std::ptrdiff_t)sequence - (std::ptrdiff_t)pos;
+    if (diff == 0) {
+      if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+        break;
+      }
+    }
+    else if (diff < 0) {
+      // The queue is full, the background thread can't keep up.
+      ++m_dropped;
+      return;
+    }
+    else {
+      pos = m_enqueuePos.load(std::memory_order_relaxed);
+    }
+  }
+
+  cell->message = std::move(message);
+  cell->sequence.store(pos + 1, std::memory_order_release);
+
+  m_wakeCondition.notify_one();
+}
+
+bool CM_Logger::Pop(std::string &message)
+{
+  Cell &cell = m_cells[m_dequeuePos & m_mask];
+  const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+  if ((std::ptrdiff_t)sequence - (std::ptrdiff_t)(m_dequeuePos + 1) < 0) {
+    return false;
+  }
+
+  message = std::move(cell.message);
+  cell.message.clear();
+  cell.sequence.store(m_dequeuePos + m_mask + 1, std::memory_order_release);
+  ++m_dequeuePos;
+  return true;
+}
+
+void CM_Logger::Flush()
+{
+  const size_t target = m_enqueuePos.load(std::memory_order_acquire);
+  while (m_processed.load(std::memory_order_acquire) < target && m_thread.joinable()) {
+    m_wakeCondition.notify_one();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+}
+
+void CM_Logger::Run()
+{
+  std::string message;
+  while (true) {
+    const double time = get_time();
+    while (Pop(message)) {
+      Process(message, time);
+      m_processed.fetch_add(1, std::memory_order_release);
+    }
+
+    const unsigned int dropped = m_dropped.exchange(0);
+    if (dropped > 0) {
+      Write("Warning: " + std::to_string(dropped) + " messages dropped, the log queue is full");
+    }
+
+    const bool stop = m_stop;
+    ExpireEntries(time, stop);
+
+    if (m_file.is_open()) {
+      m_file.flush();
+    }
+    if (m_sinks & SINK_CONSOLE) {
+      std::cout.flush();
+    }
+
+    if (stop) {
+      break;
+    }
+
+    std::unique_lock<std::mutex> lock(m_wakeMutex);
+    m_wakeCondition.wait_for(lock, std::chrono::milliseconds(50));
+  }
+}
+
+void CM_Logger::Process(const std::string &message, double time)
+{
+  const unsigned int limit = m_rateLimit;
+  if (limit == 0) {
+    Write(message);
+    return;
+  }
+
+  std::unordered_map<std::string, Entry>::iterator it = m_entries.find(message);
+  if (it == m_entries.end()) {
+    m_entries.emplace(message, Entry{time, 1, 0});
+    Write(message);
+    return;
+  }
+
+  Entry &entry = it->second;
+  if ((time - entry.windowStart) >= rateWindow) {
+    if (entry.suppressed > 0) {
+      Write(message + " (repeated " + std::to_string(entry.suppressed) + " more times)");
+    }
+    entry = Entry{time, 0, 0};
+  }
+
+  if (entry.emitted < limit) {
+    ++entry.emitted;
+    Write(message);
+  }
+  else {
+    ++entry.suppressed;
+  }
+}
+
+void CM_Logger::ExpireEntries(double time, bool all)
+{
+  for (std::unordered_map<std::string, Entry>::iterator it = m_entries.begin();
+       it != m_entries.end();) {
+    const Entry &entry = it->second;
+    if (!all && (time - entry.windowStart) < rateWindow) {
+      ++it;
+      continue;
+    }
+
+    if (entry.suppressed > 0) {
+      Write(it->first + " (repeated " + std::to_string(entry.suppressed) + " more times)");
+    }
+    it = m_entries.erase(it);
+  }
+}
+
+void CM_Logger::Write(const std::string &message)
+{
+  const int sinks = m_sinks;
+
+  if (sinks & SINK_CONSOLE) {
+    // The messages are formatted without colors, only highlight the level.
+    static const struct {
+      const char *name;
+      std::ostream &(*color)(std::ostream &);
+    } levels[] = {{"Warning", termcolor::yellow}, {"Error", termcolor::red}, {"Debug", nullptr}};
+
+    bool highlighted = false;
+    for (const auto &level : levels) {
+      const size_t size = strlen(level.name);
+      if (message.compare(0, size, level.name) == 0 && message.compare(size, 2, ": ") == 0) {
+        if (level.color) {
+          std::cout << level.color;
+        }
+        std::cout << termcolor::bold << level.name << termcolor::reset << message.substr(size)
+                  << "\n";
+        highlighted = true;
+        break;
+      }
+    }
+
+    if (!highlighted) {
+      std::cout << message << "\n";
+    }
+  }
+
+  if (sinks & SINK_FILE) {
+    {
+      std::lock_guard<std::mutex> lock(m_fileMutex);
+      if (m_fileChanged) {
+        m_file.close();
+        if (!m_filePath.empty()) {
+          m_file.open(m_filePath, std::ios::out | std::ios::app);
+        }
+        m_fileChanged = false;
+      }
+    }
+
+    if (m_file.is_open()) {
+      m_file << message << "\n";
+    }
+  }
+
+  if (sinks & SINK_RING) {
+    std::lock_guard<std::mutex> lock(m_ringMutex);
+    m_ring.push_back(message);
+    while (m_ring.size() > m_ringSize) {
+      m_ring.pop_front();
+    }
+  }
+}
+
+int CM_Logger::GetSinks() const
+{
+  return m_sinks;
+}
+
+void CM_Logger::SetSinks(int sinks)
+{
+  m_sinks = sinks;
+}
+
+void CM_Logger::SetFilePath(const std::string &path)
+{
+  std::lock_guard<std::mutex> lock(m_fileMutex);
+  m_filePath = path;
+  m_fileChanged = true;
+}
+
+void CM_Logger::SetRateLimit(unsigned int limit)
+{
+  m_rateLimit = limit;
+}
+
+void CM_Logger::SetRingSize(unsigned int size)
+{
+  std::lock_guard<std::mutex> lock(m_ringMutex);
+  m_ringSize = size;
+  while (m_ring.size() > m_ringSize) {
+    m_ring.pop_front();
+  }
+}
+
+std::vector<std::string> CM_Logger::GetRecentMessages()
+{
+  std::lock_guard<std::mutex> lock(m_ringMutex);
+  return std::vector<std::string>(m_ring.begin(), m_ring.end());
+}
@@ -0,0 +1,129 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file CM_Logger.h
+ *  \ingroup common
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/** Asynchronous backend of the CM_Message macros.
+ * Messages are pushed from any thread in a bounded lock-free queue and written by a
+ * background thread, so that printing never blocks the game loop. Identical messages
+ * are rate-limited per second and the number of suppressed messages is reported once
+ * the rate window expires. When the queue is full new messages are dropped and counted.
+ */
+class CM_Logger {
+ public:
+  enum Sink {
+    /// Print to the standard output.
+    SINK_CONSOLE = (1 << 0),
+    /// Append to the log file, see SetFilePath.
+    SINK_FILE = (1 << 1),
+    /// Keep the last messages in memory, see GetRecentMessages.
+    SINK_RING = (1 << 2)
+  };
+
+ private:
+  struct Cell {
+    std::atomic<size_t> sequence;
+    std::string message;
+  };
+
+  /// Rate limiting state of a distinct message.
+  struct Entry {
+    double windowStart;
+    unsigned int emitted;
+    unsigned int suppressed;
+  };
+
+  /// Bounded multi producer single consumer queue.
+  std::unique_ptr<Cell[]> m_cells;
+  size_t m_mask;
+  std::atomic<size_t> m_enqueuePos;
+  /// Only accessed by the background thread.
+  size_t m_dequeuePos;
+  /// Number of messages fully written, used by Flush.
+  std::atomic<size_t> m_processed;
+  std::atomic<unsigned int> m_dropped;
+
+  std::atomic<int> m_sinks;
+  std::atomic<unsigned int> m_rateLimit;
+
+  std::mutex m_fileMutex;
+  std::string m_filePath;
+  bool m_fileChanged;
+  /// Only accessed by the background thread.
+  std::ofstream m_file;
+
+  std::mutex m_ringMutex;
+  std::deque<std::string> m_ring;
+  unsigned int m_ringSize;
+
+  /// Only accessed by the background thread.
+  std::unordered_map<std::string, Entry> m_entries;
+
+  std::mutex m_wakeMutex;
+  std::condition_variable m_wakeCondition;
+  std::atomic<bool> m_stop;
+  std::thread m_thread;
+
+  CM_Logger();
+  ~CM_Logger();
+
+  bool Pop(std::string &message);
+  void Run();
+  /// Apply the rate limit and write the message to the sinks.
+  void Process(const std::string &message, double time);
+  /// Report the suppressed messages of the expired rate windows.
+  void ExpireEntries(double time, bool all);
+  void Write(const std::string &message);
+
+ public:
+  static CM_Logger &Get();
+
+  /// Queue a message, never blocks.
+  void Push(std::string &&message);
+  /// Wait until all the queued messages are written.
+  void Flush();
+
+  int GetSinks() const;
+  void SetSinks(int sinks);
+  void SetFilePath(const std::string &path);
+  /** Set the maximum number of identical messages written per second.
+   * \param limit The limit, 0 to disable rate limiting.
+   */
+  void SetRateLimit(unsigned int limit);
+  void SetRingSize(unsigned int size);
+
+  /// Return the messages kept by the ring sink, oldest first.
+  std::vector<std::string> GetRecentMessages();
+};
@@ -25,6 +25,7 @@
  */
 
 #include "CM_Message.h"
+#include "CM_Logger.h"
 
 #include "BLI_path_util.h"
 #include "termcolor.hpp"
@@ -38,6 +39,16 @@
 
 #endif  // WITH_PYTHON
 
+_CM_MessageLine::~_CM_MessageLine()
+{
+  CM_Logger::Get().Push(m_stream.str());
+}
+
+std::ostream &_CM_MessageLine::Stream()
+{
+  return m_stream;
+}
+
 std::ostream &_CM_PrefixWarning(std::ostream &stream)
 {
   stream << termcolor::yellow << termcolor::bold << "Warning" << termcolor::reset << ": ";
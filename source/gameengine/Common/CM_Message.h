@@ -27,6 +27,7 @@
 #pragma once
 
 #include <iostream>
+#include <sstream>
 #include <string>
 
 class SCA_ILogicBrick;
@@ -92,22 +93,37 @@ class _CM_FunctionPrefix {
 
 std::ostream &operator<<(std::ostream &stream, const _CM_FunctionPrefix &prefix);
 
-#define CM_Message(msg) std::cout << msg << std::endl;
+/** Stream of a message line, queued to the asynchronous logger once the full
+ * expression streaming the message is evaluated, see CM_Logger.
+ */
+class _CM_MessageLine {
+ private:
+  std::ostringstream m_stream;
+
+ public:
+  ~_CM_MessageLine();
+
+  std::ostream &Stream();
+};
+
+#define _CM_MessageStream _CM_MessageLine().Stream()
+
+#define CM_Message(msg) _CM_MessageStream << msg;
 
 /** Format message:
  * Warning: msg
  */
-#define CM_Warning(msg) std::cout << _CM_PrefixWarning << msg << std::endl;
+#define CM_Warning(msg) _CM_MessageStream << _CM_PrefixWarning << msg;
 
 /** Format message:
  * Error: msg
  */
-#define CM_Error(msg) std::cout << _CM_PrefixError << msg << std::endl;
+#define CM_Error(msg) _CM_MessageStream << _CM_PrefixError << msg;
 
 /** Format message:
  * Debug: msg
  */
-#define CM_Debug(msg) std::cout << _CM_PrefixDebug << msg << std::endl;
+#define CM_Debug(msg) _CM_MessageStream << _CM_PrefixDebug << msg;
 
 #ifdef _MSC_VER
 #  define CM_FunctionName __FUNCSIG__
@@ -119,26 +135,26 @@ std::ostream &operator<<(std::ostream &stream, const _CM_FunctionPrefix &prefix)
  * Warning: class::function(...) msg
  */
 #define CM_FunctionWarning(msg) \
-  std::cout << _CM_PrefixWarning << _CM_FunctionPrefix(CM_FunctionName) << msg << std::endl;
+  _CM_MessageStream << _CM_PrefixWarning << _CM_FunctionPrefix(CM_FunctionName) << msg;
 
 /** Format message:
  * Error: class::function(...) msg
  */
 #define CM_FunctionError(msg) \
-  std::cout << _CM_PrefixError << _CM_FunctionPrefix(CM_FunctionName) << msg << std::endl;
+  _CM_MessageStream << _CM_PrefixError << _CM_FunctionPrefix(CM_FunctionName) << msg;
 
 /** Format message:
  * Debug: class::function(...) msg
  */
 #define CM_FunctionDebug(msg) \
-  std::cout << _CM_PrefixDebug << _CM_FunctionPrefix(CM_FunctionName) << msg << std::endl;
+  _CM_MessageStream << _CM_PrefixDebug << _CM_FunctionPrefix(CM_FunctionName) << msg;
 
 #ifdef WITH_PYTHON
 
 /** Format message:
  * prefix: script(line), msg
  */
-#  define _CM_PythonMsg(prefix, msg) std::cout << prefix << _CM_PythonPrefix << msg << std::endl;
+#  define _CM_PythonMsg(prefix, msg) _CM_MessageStream << prefix << _CM_PythonPrefix << msg;
 
 /** Format message:
  * Warning: script(line), msg
@@ -154,8 +170,8 @@ std::ostream &operator<<(std::ostream &stream, const _CM_FunctionPrefix &prefix)
  * prefix: script(line), class.attribut, msg
  */
 #  define _CM_PythonAttributMsg(prefix, class, attribut, msg) \
-    std::cout << prefix << _CM_PythonPrefix << _CM_PythonAttributPrefix(class, attribut) << msg \
-              << std::endl;
+    _CM_MessageStream << prefix << _CM_PythonPrefix << _CM_PythonAttributPrefix(class, attribut) \
+                      << msg;
 
 /** Format message:
  * Warning: script(line), class.attribut, msg
@@ -173,8 +189,8 @@ std::ostream &operator<<(std::ostream &stream, const _CM_FunctionPrefix &prefix)
  * prefix: script(line), class.function(...), msg
  */
 #  define _CM_PythonFunctionMsg(prefix, class, function, msg) \
-    std::cout << prefix << _CM_PythonPrefix << _CM_PythonFunctionPrefix(class, function) << msg \
-              << std::endl;
+    _CM_MessageStream << prefix << _CM_PythonPrefix << _CM_PythonFunctionPrefix(class, function) \
+                      << msg;
 
 /** Format message:
  * Warning: script(line), class.function(...), msg
@@ -194,7 +210,7 @@ std::ostream &operator<<(std::ostream &stream, const _CM_FunctionPrefix &prefix)
  * prefix: brick(object), msg
  */
 #define _CM_LogicBrickMsg(prefix, brick, msg) \
-  std::cout << prefix << _CM_LogicBrickPrefix(brick) << msg << std::endl;
+  _CM_MessageStream << prefix << _CM_LogicBrickPrefix(brick) << msg;
 
 /** Format message:
  * Warning: brick(object), msg
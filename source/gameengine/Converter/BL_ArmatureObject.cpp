@@ -32,12 +32,17 @@
 #include "BL_ArmatureObject.h"
 
 #include "BKE_action.h"
+#include "BKE_animsys.h"
 #include "BKE_armature.hh"
 #include "BKE_constraint.h"
 #include "BKE_context.hh"
+#include "BKE_fcurve.hh"
 #include "BKE_object_types.hh"
-#include "BLI_math_rotation.h"
+#include "BLI_listbase.h"
+#include "BLI_string.h"
+#include "DNA_anim_types.h"
 #include "DNA_armature_types.h"
+#include "DNA_constraint_types.h"
 #include "RNA_access.hh"
 
 #include "BL_Action.h"
@@ -122,73 +127,12 @@
 //  *dst = out;
 //}
 
-// Only allowed for Poses with identical channels.
-static void game_blend_poses(bPose *dst, bPose *src, float srcweight, short mode)
-{
-  float dstweight;
-
-  if (mode == BL_Action::ACT_BLEND_BLEND) {
-    dstweight = 1.0f - srcweight;
-  }
-  else if (mode == BL_Action::ACT_BLEND_ADD) {
-    dstweight = 1.0f;
-  }
-  else {
-    dstweight = 1.0f;
-  }
-
-  bPoseChannel *schan = (bPoseChannel *)src->chanbase.first;
-  for (bPoseChannel *dchan = (bPoseChannel *)dst->chanbase.first; dchan;
-       dchan = (bPoseChannel *)dchan->next, schan = (bPoseChannel *)schan->next) {
-    // always blend on all channels since we don't know which one has been set
-    /* quat interpolation done separate */
-    if (schan->rotmode == ROT_MODE_QUAT) {
-      float dquat[4], squat[4];
-
-      copy_qt_qt(dquat, dchan->quat);
-      copy_qt_qt(squat, schan->quat);
-      // Normalize quaternions so that interpolation/multiplication result is correct.
-      normalize_qt(dquat);
-      normalize_qt(squat);
-
-      if (mode == BL_Action::ACT_BLEND_BLEND) {
-        interp_qt_qtqt(dchan->quat, dquat, squat, srcweight);
-      }
-      else {
-        pow_qt_fl_normalized(squat, srcweight);
-        mul_qt_qtqt(dchan->quat, dquat, squat);
-      }
-
-      normalize_qt(dchan->quat);
-    }
-
-    for (unsigned short i = 0; i < 3; i++) {
-      /* blending for loc and scale are pretty self-explanatory... */
-      dchan->loc[i] = (dchan->loc[i] * dstweight) + (schan->loc[i] * srcweight);
-      dchan->size[i] = 1.0f + ((dchan->size[i] - 1.0f) * dstweight) +
-                       ((schan->size[i] - 1.0f) * srcweight);
-
-      /* euler-rotation interpolation done here instead... */
-      // FIXME: are these results decent?
-      if (schan->rotmode) {
-        dchan->eul[i] = (dchan->eul[i] * dstweight) + (schan->eul[i] * srcweight);
-      }
-    }
-    for (bConstraint *dcon = (bConstraint *)dchan->constraints.first,
-                     *scon = (bConstraint *)schan->constraints.first;
-         dcon && scon;
-         dcon = dcon->next, scon = scon->next) {
-      /* no 'add' option for constraint blending */
-      dcon->enforce = dcon->enforce * (1.0f - srcweight) + scon->enforce * srcweight;
-    }
-  }
-
-  /* this pose is now in src time */
-  dst->ctime = src->ctime;
-}
-
 BL_ArmatureObject::BL_ArmatureObject()
-    : KX_GameObject(), m_lastframe(0.0), m_drawDebug(false), m_lastapplyframe(0.0)
+    : KX_GameObject(),
+      m_lastframe(0.0),
+      m_drawDebug(false),
+      m_poseEdited(false),
+      m_lastapplyframe(0.0)
 {
   m_controlledConstraints = new EXP_ListValue<BL_ArmatureConstraint>();
 }
@@ -334,10 +278,19 @@ BL_ArmatureConstraint *BL_ArmatureObject::GetConstraint(int index)
 void BL_ArmatureObject::LoadChannels()
 {
   m_poseChannels = new EXP_ListValue<BL_ArmatureChannel>();
+  m_channels.clear();
+  m_channelIndices.clear();
   for (bPoseChannel *pchan = (bPoseChannel *)m_objArma->pose->chanbase.first; pchan; pchan = (bPoseChannel *)pchan->next) {
     BL_ArmatureChannel *channel = new BL_ArmatureChannel(this, pchan);
     m_poseChannels->Add(channel);
+
+    m_channelIndices[pchan] = m_channels.size();
+    m_channels.push_back(pchan);
   }
+
+  // Allocate the flat pose arrays.
+  m_pose.Read(m_channels, m_objArma->pose);
+  m_poseEdited = false;
 }
 
 size_t BL_ArmatureObject::GetChannelNumber() const
@@ -415,6 +368,8 @@ bool BL_ArmatureObject::UnlinkObject(SCA_IObject *clientobj)
 
 void BL_ArmatureObject::ApplyPose()
 {
+  FlushPose();
+
   if (m_lastapplyframe != m_lastframe) {
     // update the constraint if any, first put them all off so that only the active ones will be
     // updated
@@ -432,16 +387,123 @@ void BL_ArmatureObject::ApplyPose()
   }
 }
 
-void BL_ArmatureObject::SetPoseByAction(bAction *action, AnimationEvalContext *evalCtx)
+void BL_ArmatureObject::BeginPoseEdit()
 {
-  PointerRNA ptrrna = RNA_id_pointer_create(&m_objArma->id);
+  if (!m_poseEdited) {
+    m_pose.Read(m_channels, m_objArma->pose);
+    m_poseEdited = true;
+  }
+}
+
+void BL_ArmatureObject::FlushPose()
+{
+  if (m_poseEdited) {
+    m_pose.Write(m_channels, m_objArma->pose);
+    m_poseEdited = false;
+  }
+}
+
+/// Return the index of a channel constraint in the influences of the whole pose, or -1.
+static int get_constraint_index(const std::vector<bPoseChannel *> &channels,
+                                unsigned int channelIndex,
+                                const char *name)
+{
+  const int index = BLI_findstringindex(
+      &channels[channelIndex]->constraints, name, offsetof(bConstraint, name));
+  if (index == -1) {
+    return -1;
+  }
 
-  animsys_evaluate_action(&ptrrna, action, evalCtx, false);
+  int offset = 0;
+  for (unsigned int i = 0; i < channelIndex; ++i) {
+    offset += BLI_listbase_count(&channels[i]->constraints);
+  }
+  return offset + index;
 }
 
-void BL_ArmatureObject::BlendInPose(bPose *blend_pose, float weight, short mode)
+void BL_ArmatureObject::BindAction(bAction *action, BL_ArmaturePose::ActionBinding &binding) const
 {
-  game_blend_poses(m_objArma->pose, blend_pose, weight, mode);
+  static const char *properties[BL_ArmaturePose::TARGET_ENFORCE] = {
+      "location", "rotation_quaternion", "rotation_euler", "scale"};
+
+  binding.action = action;
+  binding.curves.clear();
+  binding.unbound.clear();
+
+  LISTBASE_FOREACH (FCurve *, fcu, &action->curves) {
+    if ((fcu->flag & (FCURVE_MUTED | FCURVE_DISABLED)) ||
+        (fcu->grp && (fcu->grp->flag & AGRP_MUTED)) || BKE_fcurve_is_empty(fcu) ||
+        !fcu->rna_path) {
+      continue;
+    }
+
+    /* Look for a path of the form: pose.bones["name"].property
+     * or pose.bones["name"].constraints["name"].influence */
+    bPoseChannel *pchan = nullptr;
+    char name[sizeof(pchan->name)];
+    const char *property = strrchr(fcu->rna_path, '.');
+    if (!fcu->driver && property && property[-1] == ']' &&
+        BLI_str_quoted_substr(fcu->rna_path, "pose.bones[", name, sizeof(name))) {
+      pchan = BKE_pose_channel_find_name(m_objArma->pose, name);
+    }
+
+    bool bound = false;
+    if (pchan && STREQ(property + 1, "influence")) {
+      char constraintName[sizeof(bConstraint::name)];
+      if (BLI_str_quoted_substr(
+              fcu->rna_path, ".constraints[", constraintName, sizeof(constraintName))) {
+        const int index = get_constraint_index(
+            m_channels, m_channelIndices.at(pchan), constraintName);
+        if (index != -1) {
+          binding.curves.push_back({fcu, BL_ArmaturePose::TARGET_ENFORCE, (unsigned int)index});
+          bound = true;
+        }
+      }
+    }
+    else if (pchan) {
+      const unsigned int channelIndex = m_channelIndices.at(pchan);
+      for (unsigned short i = 0; i < BL_ArmaturePose::TARGET_ENFORCE; ++i) {
+        const BL_ArmaturePose::Target target = (BL_ArmaturePose::Target)i;
+        const unsigned short stride = BL_ArmaturePose::GetStride(target);
+        if (STREQ(property + 1, properties[i]) && fcu->array_index >= 0 &&
+            fcu->array_index < stride) {
+          binding.curves.push_back({fcu, target, channelIndex * stride + fcu->array_index});
+          bound = true;
+          break;
+        }
+      }
+    }
+
+    if (!bound) {
+      binding.unbound.push_back(fcu);
+    }
+  }
+}
+
+void BL_ArmatureObject::SetPoseByAction(const BL_ArmaturePose::ActionBinding &binding,
+                                        AnimationEvalContext *evalCtx)
+{
+  BeginPoseEdit();
+  m_pose.Evaluate(binding, evalCtx->eval_time);
+
+  if (binding.unbound.empty()) {
+    return;
+  }
+
+  // Other animated properties are written directly.
+  PointerRNA ptrrna = RNA_id_pointer_create(&m_objArma->id);
+  for (FCurve *fcu : binding.unbound) {
+    PathResolvedRNA anim_rna;
+    if (BKE_animsys_rna_path_resolve(&ptrrna, fcu->rna_path, fcu->array_index, &anim_rna)) {
+      BKE_animsys_write_to_rna_path(&anim_rna, calculate_fcurve(&anim_rna, fcu, evalCtx));
+    }
+  }
+}
+
+void BL_ArmatureObject::BlendInPose(const BL_ArmaturePose &blendPose, float weight, short mode)
+{
+  BeginPoseEdit();
+  m_pose.Blend(blendPose, weight, mode);
 }
 
 bool BL_ArmatureObject::UpdateTimestep(double curtime)
@@ -451,6 +513,9 @@ bool BL_ArmatureObject::UpdateTimestep(double curtime)
      * in the GE, we use ctime to store the timestep.
      */
     m_objArma->pose->ctime = (float)(curtime - m_lastframe);
+    if (m_poseEdited) {
+      m_pose.SetCTime(m_objArma->pose->ctime);
+    }
     m_lastframe = curtime;
   }
 
@@ -466,26 +531,13 @@ Object *BL_ArmatureObject::GetOrigArmatureObject()
   return m_origObjArma;
 }
 
-void BL_ArmatureObject::GetPose(bPose **pose) const
+void BL_ArmatureObject::GetPose(BL_ArmaturePose &pose) const
 {
-  /* If the caller supplies a null pose, create a new one. */
-  /* Otherwise, copy the armature's pose channels into the caller-supplied pose */
-
-  if (!*pose) {
-    /* probably not to good of an idea to
-     * duplicate everything, but it clears up
-     * a crash and memory leakage when
-     * &SCA_ActionActuator::m_pose is freed
-     */
-    BKE_pose_copy_data(pose, m_objArma->pose, 1);
+  if (m_poseEdited) {
+    pose = m_pose;
   }
   else {
-    if (*pose == m_objArma->pose) {
-      // no need to copy if the pointers are the same
-      return;
-    }
-
-    extract_pose_from_pose(*pose, m_objArma->pose);
+    pose.Read(m_channels, m_objArma->pose);
   }
 }
 
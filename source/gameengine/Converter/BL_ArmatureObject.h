@@ -31,8 +31,11 @@
 
 #pragma once
 
+#include <unordered_map>
+
 #include "BL_ArmatureChannel.h"
 #include "BL_ArmatureConstraint.h"
+#include "BL_ArmaturePose.h"
 #include "KX_GameObject.h"
 
 struct AnimationEvalContext;
@@ -62,6 +65,17 @@ class BL_ArmatureObject : public KX_GameObject {
   /// Set to true to allow draw debug info for one frame, reset in DrawDebugArmature.
   bool m_drawDebug;
 
+  /// Pose channels in the order of the pose channel list, indexing the flat pose.
+  std::vector<bPoseChannel *> m_channels;
+  std::unordered_map<bPoseChannel *, unsigned int> m_channelIndices;
+  /// Flat pose edited by the actions, written to the Blender pose in FlushPose.
+  BL_ArmaturePose m_pose;
+  /// True when m_pose contains changes not yet written to the Blender pose.
+  bool m_poseEdited;
+
+  /// Copy the Blender pose into the flat pose if it is not already edited.
+  void BeginPoseEdit();
+
   double m_lastapplyframe;
 
  public:
@@ -77,12 +91,18 @@ class BL_ArmatureObject : public KX_GameObject {
 
   double GetLastFrame();
 
-  void GetPose(bPose **pose) const;
+  /// Copy the current pose, including the changes of the actions not yet flushed.
+  void GetPose(BL_ArmaturePose &pose) const;
   /// Never edit this, only for accessing names.
   bPose *GetPose() const;
   void ApplyPose();
-  void SetPoseByAction(bAction *action, AnimationEvalContext *evalCtx);
-  void BlendInPose(bPose *blend_pose, float weight, short mode);
+  /// Resolve the f-curves of an action against the pose channels.
+  void BindAction(bAction *action, BL_ArmaturePose::ActionBinding &binding) const;
+  void SetPoseByAction(const BL_ArmaturePose::ActionBinding &binding,
+                       AnimationEvalContext *evalCtx);
+  void BlendInPose(const BL_ArmaturePose &blendPose, float weight, short mode);
+  /// Write the pose evaluated by the actions into the Blender pose.
+  void FlushPose();
 
   bool UpdateTimestep(double curtime);
 
@@ -0,0 +1,201 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Converter/BL_ArmaturePose.cpp
+ *  \ingroup bgeconv
+ */
+
+#include "BL_ArmaturePose.h"
+
+#include "BKE_fcurve.hh"
+#include "BLI_listbase.h"
+#include "BLI_math_rotation.h"
+#include "BLI_math_vector.h"
+#include "DNA_action_types.h"
+#include "DNA_constraint_types.h"
+
+#include "BL_Action.h"
+
+BL_ArmaturePose::BL_ArmaturePose() : m_ctime(0.0f)
+{
+}
+
+unsigned short BL_ArmaturePose::GetStride(Target target)
+{
+  switch (target) {
+    case TARGET_QUATERNION:
+      return 4;
+    case TARGET_ENFORCE:
+      return 1;
+    default:
+      return 3;
+  }
+}
+
+bool BL_ArmaturePose::IsEmpty() const
+{
+  return m_location.empty();
+}
+
+void BL_ArmaturePose::Read(const std::vector<bPoseChannel *> &channels, const bPose *pose)
+{
+  const unsigned int count = channels.size();
+  m_location.resize(count * 3);
+  m_quaternion.resize(count * 4);
+  m_euler.resize(count * 3);
+  m_scale.resize(count * 3);
+  m_enforce.clear();
+  m_quaternionChannels.clear();
+  m_eulerChannels.clear();
+
+  for (unsigned int i = 0; i < count; ++i) {
+    const bPoseChannel *pchan = channels[i];
+    copy_v3_v3(&m_location[i * 3], pchan->loc);
+    copy_qt_qt(&m_quaternion[i * 4], pchan->quat);
+    copy_v3_v3(&m_euler[i * 3], pchan->eul);
+    copy_v3_v3(&m_scale[i * 3], pchan->size);
+
+    if (pchan->rotmode == ROT_MODE_QUAT) {
+      m_quaternionChannels.push_back(i);
+    }
+    else {
+      m_eulerChannels.push_back(i);
+    }
+
+    LISTBASE_FOREACH (const bConstraint *, con, &pchan->constraints) {
+      m_enforce.push_back(con->enforce);
+    }
+  }
+
+  m_ctime = pose->ctime;
+}
+
+void BL_ArmaturePose::Write(const std::vector<bPoseChannel *> &channels, bPose *pose) const
+{
+  const unsigned int count = channels.size();
+  unsigned int constraintIndex = 0;
+  for (unsigned int i = 0; i < count; ++i) {
+    bPoseChannel *pchan = channels[i];
+    copy_v3_v3(pchan->loc, &m_location[i * 3]);
+    copy_qt_qt(pchan->quat, &m_quaternion[i * 4]);
+    copy_v3_v3(pchan->eul, &m_euler[i * 3]);
+    copy_v3_v3(pchan->size, &m_scale[i * 3]);
+
+    LISTBASE_FOREACH (bConstraint *, con, &pchan->constraints) {
+      if (constraintIndex == m_enforce.size()) {
+        break;
+      }
+      con->enforce = m_enforce[constraintIndex++];
+    }
+  }
+
+  pose->ctime = m_ctime;
+}
+
+void BL_ArmaturePose::Evaluate(const ActionBinding &binding, float time)
+{
+  float *arrays[TARGET_MAX] = {
+      m_location.data(), m_quaternion.data(), m_euler.data(), m_scale.data(), m_enforce.data()};
+
+  for (const CurveBinding &curve : binding.curves) {
+    // The constraints could be changed since the binding.
+    if (curve.target == TARGET_ENFORCE && curve.index >= m_enforce.size()) {
+      continue;
+    }
+    arrays[curve.target][curve.index] = evaluate_fcurve(curve.fcurve, time);
+  }
+}
+
+/// Blend two arrays of the same size, vectorized by the compiler.
+static void blend_values(float *__restrict dst,
+                         const float *__restrict src,
+                         unsigned int size,
+                         float dstweight,
+                         float srcweight)
+{
+  for (unsigned int i = 0; i < size; ++i) {
+    dst[i] = dst[i] * dstweight + src[i] * srcweight;
+  }
+}
+
+/// Blend scales around the identity, vectorized by the compiler.
+static void blend_scales(float *__restrict dst,
+                         const float *__restrict src,
+                         unsigned int size,
+                         float dstweight,
+                         float srcweight)
+{
+  for (unsigned int i = 0; i < size; ++i) {
+    dst[i] = 1.0f + (dst[i] - 1.0f) * dstweight + (src[i] - 1.0f) * srcweight;
+  }
+}
+
+void BL_ArmaturePose::Blend(const BL_ArmaturePose &other, float weight, short mode)
+{
+  // Only allowed for poses of the same armature.
+  if (other.m_location.size() != m_location.size()) {
+    return;
+  }
+
+  const float dstweight = (mode == BL_Action::ACT_BLEND_BLEND) ? 1.0f - weight : 1.0f;
+
+  // Always blend on all channels since we don't know which one has been set.
+  blend_values(m_location.data(), other.m_location.data(), m_location.size(), dstweight, weight);
+  blend_scales(m_scale.data(), other.m_scale.data(), m_scale.size(), dstweight, weight);
+
+  for (unsigned int i : m_eulerChannels) {
+    blend_values(&m_euler[i * 3], &other.m_euler[i * 3], 3, dstweight, weight);
+  }
+
+  // Quaternion interpolation done separately.
+  for (unsigned int i : m_quaternionChannels) {
+    float *quat = &m_quaternion[i * 4];
+    float dquat[4], squat[4];
+
+    copy_qt_qt(dquat, quat);
+    copy_qt_qt(squat, &other.m_quaternion[i * 4]);
+    // Normalize quaternions so that interpolation/multiplication result is correct.
+    normalize_qt(dquat);
+    normalize_qt(squat);
+
+    if (mode == BL_Action::ACT_BLEND_BLEND) {
+      interp_qt_qtqt(quat, dquat, squat, weight);
+    }
+    else {
+      pow_qt_fl_normalized(squat, weight);
+      mul_qt_qtqt(quat, dquat, squat);
+    }
+
+    normalize_qt(quat);
+  }
+
+  // No 'add' option for constraint blending.
+  if (other.m_enforce.size() == m_enforce.size()) {
+    blend_values(m_enforce.data(), other.m_enforce.data(), m_enforce.size(), 1.0f - weight, weight);
+  }
+
+  // This pose is now in source time.
+  m_ctime = other.m_ctime;
+}
+
+void BL_ArmaturePose::SetCTime(float ctime)
+{
+  m_ctime = ctime;
+}
@@ -0,0 +1,102 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file BL_ArmaturePose.h
+ *  \ingroup bgeconv
+ */
+
+#pragma once
+
+#include <vector>
+
+struct bAction;
+struct bPose;
+struct bPoseChannel;
+struct FCurve;
+
+/** Flat pose of an armature.
+ * The transform of each pose channel is stored in contiguous arrays indexed by the channel
+ * index in the armature, actions are evaluated and blended in these arrays and the result
+ * is written back in the armature bPose once per frame.
+ */
+class BL_ArmaturePose {
+ public:
+  enum Target {
+    TARGET_LOCATION = 0,
+    TARGET_QUATERNION,
+    TARGET_EULER,
+    TARGET_SCALE,
+    /// Constraint influence, indexed by the constraint index in the whole armature.
+    TARGET_ENFORCE,
+    TARGET_MAX
+  };
+
+  /// A f-curve animating one component of a pose channel transform or a constraint influence.
+  struct CurveBinding {
+    FCurve *fcurve;
+    Target target;
+    /// Index of the animated value in the array of the target.
+    unsigned int index;
+  };
+
+  /// The f-curves of an action resolved against the pose channels of an armature.
+  struct ActionBinding {
+    bAction *action = nullptr;
+    std::vector<CurveBinding> curves;
+    /// F-curves not animating a pose channel transform, evaluated through RNA.
+    std::vector<FCurve *> unbound;
+  };
+
+ private:
+  std::vector<float> m_location;
+  std::vector<float> m_quaternion;
+  std::vector<float> m_euler;
+  std::vector<float> m_scale;
+  /// Influence of the constraints of all the channels.
+  std::vector<float> m_enforce;
+  /// Index of the channels using a quaternion rotation and other rotation modes.
+  std::vector<unsigned int> m_quaternionChannels;
+  std::vector<unsigned int> m_eulerChannels;
+  /// Pose time step used by the IK solvers.
+  float m_ctime;
+
+ public:
+  BL_ArmaturePose();
+
+  /// Return the number of floats per channel of a target.
+  static unsigned short GetStride(Target target);
+
+  bool IsEmpty() const;
+
+  /// Copy the channel transforms of a pose, arrays are only reallocated when growing.
+  void Read(const std::vector<bPoseChannel *> &channels, const bPose *pose);
+  /// Write the channel transforms into a pose with the same channels.
+  void Write(const std::vector<bPoseChannel *> &channels, bPose *pose) const;
+
+  /// Evaluate the bound f-curves of an action at the given action frame.
+  void Evaluate(const ActionBinding &binding, float time);
+
+  /** Blend an other pose of the same armature into this pose.
+   * \param mode The blending mode, BL_Action::ACT_BLEND_BLEND or BL_Action::ACT_BLEND_ADD.
+   */
+  void Blend(const BL_ArmaturePose &other, float weight, short mode);
+
+  void SetCTime(float ctime);
+};
@@ -84,6 +84,7 @@
 #include "BL_ConvertControllers.h"
 #include "BL_ConvertProperties.h"
 #include "BL_ConvertSensors.h"
+#include "KX_ActivityCullingManager.h"
 #include "KX_BlenderMaterial.h"
 #include "KX_BoneParentNodeRelationship.h"
 #include "KX_Camera.h"
@@ -1153,7 +1154,10 @@ static void bl_ConvertBlenderObject_Single(BL_SceneConverter *converter,
 
   BL_ConvertProperties(blenderobject, gameobj, timemgr, kxscene, isInActiveLayer);
 
+  const std::string oldname = gameobj->GetName();
   gameobj->SetName(blenderobject->id.name + 2);
+  // Lights, cameras and texts are already in the scene lists.
+  kxscene->UpdateObjectName(gameobj, oldname);
 
   // Update children/parent hierarchy
   if (blenderobject->parent != 0) {
@@ -1223,6 +1227,7 @@ static void bl_ConvertBlenderObject_Single(BL_SceneConverter *converter,
     // tf.Add(gameobj->GetSGNode());
 
     gameobj->NodeUpdateGS(0);
+    kxscene->GetActivityCullingManager()->RegisterObject(gameobj);
   }
   else {
     // we must store this object otherwise it will be deleted
@@ -28,7 +28,10 @@
 
 #include "GHOST_Types.h"
 
-DEV_InputDevice::DEV_InputDevice()
+#include "DEV_InputRecorder.h"
+#include "DEV_InputReplay.h"
+
+DEV_InputDevice::DEV_InputDevice() : m_recorder(nullptr), m_replay(nullptr), m_logicFrame(0)
 {
   m_reverseKeyTranslateTable[GHOST_kKeyA] = AKEY;
   m_reverseKeyTranslateTable[GHOST_kKeyB] = BKEY;
@@ -172,17 +175,36 @@ DEV_InputDevice::~DEV_InputDevice()
 
 void DEV_InputDevice::ConvertKeyEvent(int incode, int val, unsigned int unicode)
 {
-  ConvertEvent(m_reverseKeyTranslateTable[incode], val, unicode);
+  if (m_replay) {
+    return;
+  }
+  ApplyEvent(m_reverseKeyTranslateTable[incode], val, unicode);
 }
 
 void DEV_InputDevice::ConvertButtonEvent(int incode, int val)
 {
-  ConvertEvent(m_reverseButtonTranslateTable[incode], val, 0);
+  if (m_replay) {
+    return;
+  }
+  ApplyEvent(m_reverseButtonTranslateTable[incode], val, 0);
 }
 
 void DEV_InputDevice::ConvertWindowEvent(int incode)
 {
-  ConvertEvent(m_reverseWindowTranslateTable[incode], 1, 0);
+  if (m_replay) {
+    return;
+  }
+  ApplyEvent(m_reverseWindowTranslateTable[incode], 1, 0);
+}
+
+void DEV_InputDevice::ApplyEvent(SCA_IInputDevice::SCA_EnumInputs type,
+                                 int val,
+                                 unsigned int unicode)
+{
+  if (m_recorder) {
+    m_recorder->AddEvent(DEV_InputRecordEvent::EVENT_INPUT, type, val, unicode);
+  }
+  ConvertEvent(type, val, unicode);
 }
 
 void DEV_InputDevice::ConvertEvent(SCA_IInputDevice::SCA_EnumInputs type,
@@ -208,6 +230,18 @@ void DEV_InputDevice::ConvertEvent(SCA_IInputDevice::SCA_EnumInputs type,
 
 void DEV_InputDevice::ConvertMoveEvent(int x, int y)
 {
+  if (m_replay) {
+    return;
+  }
+  ApplyMoveEvent(x, y);
+}
+
+void DEV_InputDevice::ApplyMoveEvent(int x, int y)
+{
+  if (m_recorder) {
+    m_recorder->AddEvent(DEV_InputRecordEvent::EVENT_MOVE, 0, x, y);
+  }
+
   SCA_InputEvent &xevent = m_inputsTable[MOUSEX];
   xevent.m_values.push_back(x);
   if (xevent.m_status[xevent.m_status.size() - 1] != SCA_InputEvent::ACTIVE) {
@@ -225,6 +259,18 @@ void DEV_InputDevice::ConvertMoveEvent(int x, int y)
 
 void DEV_InputDevice::ConvertWheelEvent(int z)
 {
+  if (m_replay) {
+    return;
+  }
+  ApplyWheelEvent(z);
+}
+
+void DEV_InputDevice::ApplyWheelEvent(int z)
+{
+  if (m_recorder) {
+    m_recorder->AddEvent(DEV_InputRecordEvent::EVENT_WHEEL, 0, z, 0);
+  }
+
   SCA_InputEvent &event = m_inputsTable[(z > 0) ? WHEELUPMOUSE : WHEELDOWNMOUSE];
   event.m_values.push_back(z);
   if (event.m_status[event.m_status.size() - 1] != SCA_InputEvent::ACTIVE) {
@@ -232,3 +278,44 @@ void DEV_InputDevice::ConvertWheelEvent(int z)
     event.m_queue.push_back(SCA_InputEvent::JUSTACTIVATED);
   }
 }
+
+void DEV_InputDevice::SetRecorder(DEV_InputRecorder *recorder)
+{
+  m_recorder = recorder;
+}
+
+void DEV_InputDevice::SetReplay(DEV_InputReplay *replay)
+{
+  m_replay = replay;
+}
+
+void DEV_InputDevice::BeginLogicFrame(double time)
+{
+  if (m_recorder) {
+    // Write the events the logic will read in this frame.
+    m_recorder->WriteFrame(m_logicFrame, time);
+  }
+  else if (m_replay) {
+    const std::vector<DEV_InputRecordEvent> *events = m_replay->GetFrameEvents(m_logicFrame);
+    if (events) {
+      for (const DEV_InputRecordEvent &event : *events) {
+        switch (event.kind) {
+          case DEV_InputRecordEvent::EVENT_INPUT: {
+            ConvertEvent((SCA_EnumInputs)event.input, event.values[0], event.values[1]);
+            break;
+          }
+          case DEV_InputRecordEvent::EVENT_MOVE: {
+            ApplyMoveEvent(event.values[0], event.values[1]);
+            break;
+          }
+          case DEV_InputRecordEvent::EVENT_WHEEL: {
+            ApplyWheelEvent(event.values[0]);
+            break;
+          }
+        }
+      }
+    }
+  }
+
+  ++m_logicFrame;
+}
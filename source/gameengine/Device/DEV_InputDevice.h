@@ -30,6 +30,9 @@
 
 #include "SCA_IInputDevice.h"
 
+class DEV_InputRecorder;
+class DEV_InputReplay;
+
 class DEV_InputDevice : public SCA_IInputDevice {
  protected:
   /// These maps converts GHOST input number to SCA input enum.
@@ -37,6 +40,18 @@ class DEV_InputDevice : public SCA_IInputDevice {
   std::map<int, SCA_EnumInputs> m_reverseButtonTranslateTable;
   std::map<int, SCA_EnumInputs> m_reverseWindowTranslateTable;
 
+  /// Record the converted events, not owned.
+  DEV_InputRecorder *m_recorder;
+  /// Replace the user events by recorded events, not owned.
+  DEV_InputReplay *m_replay;
+  /// Number of logic frames since the game start.
+  unsigned int m_logicFrame;
+
+  /// Record and apply an event of the user.
+  void ApplyEvent(SCA_IInputDevice::SCA_EnumInputs type, int val, unsigned int unicode);
+  void ApplyMoveEvent(int x, int y);
+  void ApplyWheelEvent(int z);
+
  public:
   DEV_InputDevice();
   virtual ~DEV_InputDevice();
@@ -46,5 +61,14 @@ class DEV_InputDevice : public SCA_IInputDevice {
   void ConvertWindowEvent(int incode);
   void ConvertMoveEvent(int x, int y);
   void ConvertWheelEvent(int z);
+  /** Apply an event synthesized by the engine, e.g. the release of the exit key.
+   * These events are not recorded as they are synthesized again on replay.
+   */
   void ConvertEvent(SCA_IInputDevice::SCA_EnumInputs type, int val, unsigned int unicode);
+
+  void SetRecorder(DEV_InputRecorder *recorder);
+  /// Ignore the key, button, mouse and window events of the user and use the replay events.
+  void SetReplay(DEV_InputReplay *replay);
+
+  virtual void BeginLogicFrame(double time);
 };
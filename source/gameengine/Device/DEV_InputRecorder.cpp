@@ -0,0 +1,92 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Device/DEV_InputRecorder.cpp
+ *  \ingroup device
+ */
+
+#include "DEV_InputRecorder.h"
+
+#include "CM_Message.h"
+
+template <class T> static void write_value(std::ofstream &file, const T &value)
+{
+  file.write((const char *)&value, sizeof(T));
+}
+
+DEV_InputRecorder::DEV_InputRecorder(const std::string &path)
+    : m_file(path, std::ios::out | std::ios::binary | std::ios::trunc)
+{
+  if (!m_file) {
+    CM_Error("failed to open input record file: " << path);
+    return;
+  }
+
+  m_file.write(DEV_InputRecordMagic, sizeof(DEV_InputRecordMagic));
+  write_value(m_file, DEV_InputRecordVersion);
+}
+
+DEV_InputRecorder::~DEV_InputRecorder()
+{
+}
+
+bool DEV_InputRecorder::IsValid() const
+{
+  return m_file.is_open() && m_file.good();
+}
+
+void DEV_InputRecorder::AddEvent(DEV_InputRecordEvent::Kind kind,
+                                 int input,
+                                 int value0,
+                                 int value1)
+{
+  m_events.push_back({kind, (int16_t)input, {value0, value1}});
+}
+
+void DEV_InputRecorder::WriteFrame(unsigned int frame, double time)
+{
+  if (m_events.empty() || !IsValid()) {
+    m_events.clear();
+    return;
+  }
+
+  write_value(m_file, 'F');
+  write_value(m_file, (uint32_t)frame);
+  write_value(m_file, time);
+  write_value(m_file, (uint32_t)m_events.size());
+  for (const DEV_InputRecordEvent &event : m_events) {
+    write_value(m_file, event.kind);
+    write_value(m_file, event.input);
+    write_value(m_file, event.values[0]);
+    write_value(m_file, event.values[1]);
+  }
+
+  m_events.clear();
+}
+
+void DEV_InputRecorder::WriteClock(double clockTime)
+{
+  if (!IsValid()) {
+    return;
+  }
+
+  write_value(m_file, 'C');
+  write_value(m_file, clockTime);
+}
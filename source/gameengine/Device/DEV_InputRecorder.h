@@ -0,0 +1,81 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file DEV_InputRecorder.h
+ *  \ingroup device
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/** Input record file layout, all values are stored in native byte order:
+ * - Header: "BGIR" then uint32 version.
+ * - Clock record: 'C' then double engine clock time, one per engine frame.
+ * - Frame record: 'F' then uint32 logic frame, double frame time, uint32 event count and
+ *   the events, only for logic frames receiving events.
+ * - Event: uint8 kind, int16 input, int32 values[2].
+ */
+struct DEV_InputRecordEvent {
+  enum Kind : uint8_t {
+    /// Key, button or window event: input, value, unicode.
+    EVENT_INPUT = 0,
+    /// Mouse move: x, y.
+    EVENT_MOVE,
+    /// Mouse wheel: z.
+    EVENT_WHEEL
+  };
+
+  uint8_t kind;
+  int16_t input;
+  int32_t values[2];
+};
+
+struct DEV_InputRecordFrame {
+  unsigned int frame;
+  double time;
+  std::vector<DEV_InputRecordEvent> events;
+};
+
+static const char DEV_InputRecordMagic[4] = {'B', 'G', 'I', 'R'};
+static const uint32_t DEV_InputRecordVersion = 1;
+
+/// Write the converted input events of each logic frame in a binary file.
+class DEV_InputRecorder {
+ private:
+  std::ofstream m_file;
+  /// Events received since the last logic frame.
+  std::vector<DEV_InputRecordEvent> m_events;
+
+ public:
+  DEV_InputRecorder(const std::string &path);
+  ~DEV_InputRecorder();
+
+  bool IsValid() const;
+
+  void AddEvent(DEV_InputRecordEvent::Kind kind, int input, int value0, int value1);
+  /// Write the events received since the previous logic frame.
+  void WriteFrame(unsigned int frame, double time);
+  /// Write the clock time used by an engine frame.
+  void WriteClock(double clockTime);
+};
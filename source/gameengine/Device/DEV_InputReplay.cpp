@@ -0,0 +1,131 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Device/DEV_InputReplay.cpp
+ *  \ingroup device
+ */
+
+#include "DEV_InputReplay.h"
+
+#include <cstring>
+
+#include "CM_Message.h"
+
+/// Sanity limit to detect corrupted files.
+static const uint32_t maxFrameEvents = (1 << 20);
+
+template <class T> static bool read_value(std::ifstream &file, T &value)
+{
+  return (bool)file.read((char *)&value, sizeof(T));
+}
+
+DEV_InputReplay::DEV_InputReplay(const std::string &path)
+    : m_clockIndex(0), m_frameIndex(0), m_valid(false)
+{
+  std::ifstream file(path, std::ios::in | std::ios::binary);
+  if (!file) {
+    CM_Error("failed to open input record file: " << path);
+    return;
+  }
+
+  char magic[sizeof(DEV_InputRecordMagic)];
+  uint32_t version;
+  if (!file.read(magic, sizeof(magic)) || !read_value(file, version) ||
+      memcmp(magic, DEV_InputRecordMagic, sizeof(magic)) != 0 ||
+      version != DEV_InputRecordVersion) {
+    CM_Error("invalid input record file: " << path);
+    return;
+  }
+
+  char tag;
+  while (read_value(file, tag)) {
+    if (tag == 'C') {
+      double clockTime;
+      if (!read_value(file, clockTime)) {
+        break;
+      }
+      m_clockTimes.push_back(clockTime);
+    }
+    else if (tag == 'F') {
+      uint32_t frame;
+      uint32_t count;
+      DEV_InputRecordFrame record;
+      if (!read_value(file, frame) || !read_value(file, record.time) ||
+          !read_value(file, count) || count > maxFrameEvents) {
+        break;
+      }
+
+      record.frame = frame;
+      record.events.resize(count);
+      for (DEV_InputRecordEvent &event : record.events) {
+        if (!read_value(file, event.kind) || !read_value(file, event.input) ||
+            !read_value(file, event.values[0]) || !read_value(file, event.values[1])) {
+          break;
+        }
+      }
+
+      if (!file) {
+        break;
+      }
+      m_frames.push_back(std::move(record));
+    }
+    else {
+      CM_Error("corrupted input record file: " << path);
+      break;
+    }
+  }
+
+  // A truncated record is still usable until the last complete engine frame.
+  m_valid = true;
+  CM_Debug("input replay of " << m_clockTimes.size() << " frames from: " << path);
+}
+
+DEV_InputReplay::~DEV_InputReplay()
+{
+}
+
+bool DEV_InputReplay::IsValid() const
+{
+  return m_valid;
+}
+
+bool DEV_InputReplay::NextClockTime(double &clockTime)
+{
+  if (m_clockIndex >= m_clockTimes.size()) {
+    return false;
+  }
+
+  clockTime = m_clockTimes[m_clockIndex++];
+  return true;
+}
+
+const std::vector<DEV_InputRecordEvent> *DEV_InputReplay::GetFrameEvents(unsigned int frame)
+{
+  // Frames are recorded in increasing order.
+  while (m_frameIndex < m_frames.size() && m_frames[m_frameIndex].frame < frame) {
+    ++m_frameIndex;
+  }
+
+  if (m_frameIndex < m_frames.size() && m_frames[m_frameIndex].frame == frame) {
+    return &m_frames[m_frameIndex++].events;
+  }
+
+  return nullptr;
+}
@@ -0,0 +1,52 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file DEV_InputReplay.h
+ *  \ingroup device
+ */
+
+#pragma once
+
+#include "DEV_InputRecorder.h"
+
+/** Read an input record file written by DEV_InputRecorder, the engine is driven by the
+ * recorded clock times and the recorded events are returned for the same logic frames.
+ */
+class DEV_InputReplay {
+ private:
+  std::vector<double> m_clockTimes;
+  std::vector<DEV_InputRecordFrame> m_frames;
+  unsigned int m_clockIndex;
+  unsigned int m_frameIndex;
+  bool m_valid;
+
+ public:
+  DEV_InputReplay(const std::string &path);
+  ~DEV_InputReplay();
+
+  bool IsValid() const;
+
+  /** Get the clock time of the next engine frame.
+   * \return False when the record is finished.
+   */
+  bool NextClockTime(double &clockTime);
+  /// Return the events of a logic frame or nullptr if the frame has no event.
+  const std::vector<DEV_InputRecordEvent> *GetFrameEvents(unsigned int frame);
+};
@@ -18,6 +18,8 @@
 
 #pragma once
 
+#include <unordered_map>
+
 #include "EXP_Value.h"
 
 class EXP_BaseListValue : public EXP_PropValue {
@@ -28,10 +30,48 @@ class EXP_BaseListValue : public EXP_PropValue {
   typedef VectorType::iterator VectorTypeIterator;
   typedef VectorType::const_iterator VectorTypeConstIterator;
 
+  /// Lookup acceleration of the list, see SetIndexMode.
+  enum IndexMode {
+    /// Linear name and value lookup.
+    INDEX_NONE = 0,
+    /// Hashed name and value lookup, removal keeps the order of the items.
+    INDEX_ORDERED,
+    /// Hashed name and value lookup, removal moves the last item in place of the removed one.
+    INDEX_UNORDERED
+  };
+
  protected:
   VectorType m_pValueArray;
   bool m_bReleaseContents;
 
+  static const unsigned int NAME_INDEX_UNKNOWN = (unsigned int)-1;
+
+  /// Items sharing a name in the index.
+  struct NameIndexEntry {
+    /// Index of the first item of this name, NAME_INDEX_UNKNOWN once this item is removed.
+    unsigned int index;
+    /// Number of items of this name.
+    unsigned int count;
+  };
+
+  IndexMode m_indexMode;
+  /// Items per name and index per item, rebuilt lazily when dirty.
+  mutable std::unordered_map<std::string, NameIndexEntry> m_nameIndex;
+  mutable std::unordered_map<EXP_Value *, unsigned int> m_valueIndex;
+  mutable bool m_indexDirty;
+  /// An item is present multiple times, value removal falls back to a linear scan.
+  mutable bool m_duplicateValues;
+
+  void InvalidateIndex();
+  void BuildIndex() const;
+  void AddNameToIndex(const std::string &name, unsigned int i) const;
+  void RemoveNameFromIndex(const std::string &name, unsigned int i);
+  void AddToIndex(EXP_Value *val, unsigned int i) const;
+  /// Remove the item at index i from the index, the following items are not updated.
+  void RemoveFromIndex(EXP_Value *val, unsigned int i);
+  /// Update the index of an item moved from an other index.
+  void MoveInIndex(EXP_Value *val, unsigned int from, unsigned int to);
+
   void SetValue(int i, EXP_Value *val);
   EXP_Value *GetValue(int i);
   EXP_Value *FindValue(const std::string &name) const;
@@ -50,6 +90,13 @@ class EXP_BaseListValue : public EXP_PropValue {
   virtual std::string GetText();
 
   void SetReleaseOnDestruct(bool bReleaseContents);
+  /** Enable hashed lookup by name and value, and constant time removal for
+   * INDEX_UNORDERED. The names of the items are indexed when they are added,
+   * renaming an item requires a call to UpdateValueName.
+   */
+  void SetIndexMode(IndexMode mode);
+  /// Update the name index after an item was renamed.
+  void UpdateValueName(EXP_Value *val, const std::string &oldname);
 
   void Remove(int i);
   void Resize(int num);
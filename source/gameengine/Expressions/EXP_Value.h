@@ -176,9 +176,21 @@ class EXP_Value : public EXP_PyObjectPlus, public CM_RefCount<EXP_Value> {
  * normal classes should derive from EXP_PropValue, real lightweight classes straight from
  * EXP_Value
  */
+class EXP_PropValue;
+
+/// Receiver of the in place modifications of a property value, see EXP_PropValue::SetListener.
+class EXP_PropValueListener {
+ public:
+  virtual ~EXP_PropValueListener()
+  {
+  }
+
+  virtual void PropertyModified(EXP_PropValue *prop) = 0;
+};
+
 class EXP_PropValue : public EXP_Value {
  public:
-  EXP_PropValue()
+  EXP_PropValue() : m_listener(nullptr)
   {
   }
 
@@ -196,6 +208,34 @@ class EXP_PropValue : public EXP_Value {
     return m_strNewName;
   }
 
+  virtual void ProcessReplica()
+  {
+    EXP_Value::ProcessReplica();
+    // The listener is bound to the original value.
+    m_listener = nullptr;
+  }
+
+  /** Set the only object notified when the value is modified in place with SetValue, the
+   * replacement or the removal of the property must be tracked by the property owner.
+   */
+  void SetListener(EXP_PropValueListener *listener)
+  {
+    m_listener = listener;
+  }
+
+  EXP_PropValueListener *GetListener() const
+  {
+    return m_listener;
+  }
+
  protected:
+  void NotifyModified()
+  {
+    if (m_listener) {
+      m_listener->PropertyModified(this);
+    }
+  }
+
   std::string m_strNewName;
+  EXP_PropValueListener *m_listener;
 };
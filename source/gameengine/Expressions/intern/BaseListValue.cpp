@@ -21,7 +21,11 @@
 
 #include "EXP_ListValue.h"
 
-EXP_BaseListValue::EXP_BaseListValue() : m_bReleaseContents(true)
+EXP_BaseListValue::EXP_BaseListValue()
+    : m_bReleaseContents(true),
+      m_indexMode(INDEX_NONE),
+      m_indexDirty(false),
+      m_duplicateValues(false)
 {
 }
 
@@ -34,9 +38,130 @@ EXP_BaseListValue::~EXP_BaseListValue()
   }
 }
 
+void EXP_BaseListValue::InvalidateIndex()
+{
+  if (m_indexMode != INDEX_NONE) {
+    m_indexDirty = true;
+  }
+}
+
+void EXP_BaseListValue::AddNameToIndex(const std::string &name, unsigned int i) const
+{
+  const std::pair<std::unordered_map<std::string, NameIndexEntry>::iterator, bool> result =
+      m_nameIndex.emplace(name, NameIndexEntry{i, 1});
+  if (!result.second) {
+    NameIndexEntry &entry = result.first->second;
+    ++entry.count;
+    // Keep the first item of a name as the linear lookup does.
+    if (entry.index != NAME_INDEX_UNKNOWN && i < entry.index) {
+      entry.index = i;
+    }
+  }
+}
+
+void EXP_BaseListValue::RemoveNameFromIndex(const std::string &name, unsigned int i)
+{
+  const std::unordered_map<std::string, NameIndexEntry>::iterator it = m_nameIndex.find(name);
+  BLI_assert(it != m_nameIndex.end());
+
+  NameIndexEntry &entry = it->second;
+  if (--entry.count == 0) {
+    m_nameIndex.erase(it);
+  }
+  else if (entry.index == i) {
+    // Other items share the name, the next one is looked for on the next lookup.
+    entry.index = NAME_INDEX_UNKNOWN;
+  }
+}
+
+void EXP_BaseListValue::AddToIndex(EXP_Value *val, unsigned int i) const
+{
+  AddNameToIndex(val->GetName(), i);
+  if (!m_valueIndex.emplace(val, i).second) {
+    m_duplicateValues = true;
+  }
+}
+
+void EXP_BaseListValue::RemoveFromIndex(EXP_Value *val, unsigned int i)
+{
+  // The index of the other occurrences is unknown.
+  if (m_duplicateValues) {
+    m_indexDirty = true;
+    return;
+  }
+
+  m_valueIndex.erase(val);
+  RemoveNameFromIndex(val->GetName(), i);
+}
+
+void EXP_BaseListValue::MoveInIndex(EXP_Value *val, unsigned int from, unsigned int to)
+{
+  m_valueIndex[val] = to;
+
+  NameIndexEntry &entry = m_nameIndex[val->GetName()];
+  if (entry.index == from) {
+    entry.index = to;
+  }
+}
+
+void EXP_BaseListValue::BuildIndex() const
+{
+  m_nameIndex.clear();
+  m_valueIndex.clear();
+  m_duplicateValues = false;
+
+  for (unsigned int i = 0, size = m_pValueArray.size(); i < size; ++i) {
+    // Resized lists contain null items until they are set.
+    if (m_pValueArray[i]) {
+      AddToIndex(m_pValueArray[i], i);
+    }
+  }
+
+  m_indexDirty = false;
+}
+
+void EXP_BaseListValue::SetIndexMode(IndexMode mode)
+{
+  m_indexMode = mode;
+  m_nameIndex.clear();
+  m_valueIndex.clear();
+  m_indexDirty = (mode != INDEX_NONE);
+}
+
+void EXP_BaseListValue::UpdateValueName(EXP_Value *val, const std::string &oldname)
+{
+  if (m_indexMode == INDEX_NONE || m_indexDirty) {
+    return;
+  }
+
+  const std::unordered_map<EXP_Value *, unsigned int>::const_iterator it = m_valueIndex.find(val);
+  if (it == m_valueIndex.end()) {
+    return;
+  }
+
+  if (m_duplicateValues) {
+    m_indexDirty = true;
+    return;
+  }
+
+  const unsigned int i = it->second;
+  RemoveNameFromIndex(oldname, i);
+  AddNameToIndex(val->GetName(), i);
+}
+
 void EXP_BaseListValue::SetValue(int i, EXP_Value *val)
 {
+  EXP_Value *oldval = m_pValueArray[i];
   m_pValueArray[i] = val;
+
+  if (m_indexMode != INDEX_NONE && !m_indexDirty) {
+    if (oldval) {
+      RemoveFromIndex(oldval, i);
+    }
+    if (val && !m_indexDirty) {
+      AddToIndex(val, i);
+    }
+  }
 }
 
 EXP_Value *EXP_BaseListValue::GetValue(int i)
@@ -46,6 +171,30 @@ EXP_Value *EXP_BaseListValue::GetValue(int i)
 
 EXP_Value *EXP_BaseListValue::FindValue(const std::string &name) const
 {
+  if (m_indexMode != INDEX_NONE) {
+    if (m_indexDirty) {
+      BuildIndex();
+    }
+
+    const std::unordered_map<std::string, NameIndexEntry>::iterator it = m_nameIndex.find(name);
+    if (it == m_nameIndex.end()) {
+      return nullptr;
+    }
+
+    NameIndexEntry &entry = it->second;
+    if (entry.index == NAME_INDEX_UNKNOWN) {
+      // The first item of this name was removed, look for the next one.
+      const VectorTypeConstIterator itemit = std::find_if(
+          m_pValueArray.begin(), m_pValueArray.end(), [&name](EXP_Value *item) {
+            return item && item->GetName() == name;
+          });
+      BLI_assert(itemit != m_pValueArray.end());
+      entry.index = itemit - m_pValueArray.begin();
+    }
+
+    return m_pValueArray[entry.index];
+  }
+
   const VectorTypeConstIterator it = std::find_if(
       m_pValueArray.begin(), m_pValueArray.end(), [&name](EXP_Value *item) {
         return item->GetName() == name;
@@ -59,21 +208,69 @@ EXP_Value *EXP_BaseListValue::FindValue(const std::string &name) const
 
 bool EXP_BaseListValue::SearchValue(EXP_Value *val) const
 {
+  if (m_indexMode != INDEX_NONE) {
+    if (m_indexDirty) {
+      BuildIndex();
+    }
+    return (m_valueIndex.find(val) != m_valueIndex.end());
+  }
+
   return (std::find(m_pValueArray.begin(), m_pValueArray.end(), val) != m_pValueArray.end());
 }
 
 void EXP_BaseListValue::Add(EXP_Value *value)
 {
   m_pValueArray.push_back(value);
+  if (m_indexMode != INDEX_NONE && !m_indexDirty) {
+    AddToIndex(value, m_pValueArray.size() - 1);
+  }
 }
 
 void EXP_BaseListValue::Insert(unsigned int i, EXP_Value *value)
 {
   m_pValueArray.insert(m_pValueArray.begin() + i, value);
+  InvalidateIndex();
 }
 
 bool EXP_BaseListValue::RemoveValue(EXP_Value *val)
 {
+  if (m_indexMode != INDEX_NONE) {
+    if (m_indexDirty) {
+      BuildIndex();
+    }
+
+    const std::unordered_map<EXP_Value *, unsigned int>::iterator it = m_valueIndex.find(val);
+    if (it == m_valueIndex.end()) {
+      return false;
+    }
+
+    // All the occurrences must be removed.
+    if (!m_duplicateValues) {
+      const unsigned int index = it->second;
+      const unsigned int last = m_pValueArray.size() - 1;
+      // The value is still in the list and so still alive.
+      RemoveFromIndex(val, index);
+
+      if (m_indexMode == INDEX_UNORDERED || index == last) {
+        if (index != last) {
+          EXP_Value *lastval = m_pValueArray[last];
+          m_pValueArray[index] = lastval;
+          MoveInIndex(lastval, last, index);
+        }
+        m_pValueArray.pop_back();
+      }
+      else {
+        m_pValueArray.erase(m_pValueArray.begin() + index);
+        // Following items were shifted.
+        m_indexDirty = true;
+      }
+
+      return true;
+    }
+
+    m_indexDirty = true;
+  }
+
   bool result = false;
   for (VectorTypeIterator it = m_pValueArray.begin(); it != m_pValueArray.end();) {
     if (*it == val) {
@@ -129,11 +326,27 @@ void EXP_BaseListValue::SetReleaseOnDestruct(bool bReleaseContents)
 
 void EXP_BaseListValue::Remove(int i)
 {
+  if (m_indexMode != INDEX_NONE && !m_indexDirty) {
+    if (i == (int)m_pValueArray.size() - 1) {
+      RemoveFromIndex(m_pValueArray[i], i);
+    }
+    else {
+      // Following items are shifted.
+      m_indexDirty = true;
+    }
+  }
   m_pValueArray.erase(m_pValueArray.begin() + i);
 }
 
 void EXP_BaseListValue::Resize(int num)
 {
+  if (m_indexMode != INDEX_NONE && !m_indexDirty) {
+    for (int i = m_pValueArray.size() - 1; i >= num && !m_indexDirty; --i) {
+      if (m_pValueArray[i]) {
+        RemoveFromIndex(m_pValueArray[i], i);
+      }
+    }
+  }
   m_pValueArray.resize(num);
 }
 
@@ -143,6 +356,10 @@ void EXP_BaseListValue::ReleaseAndRemoveAll()
     item->Release();
   }
   m_pValueArray.clear();
+  m_nameIndex.clear();
+  m_valueIndex.clear();
+  m_duplicateValues = false;
+  m_indexDirty = false;
 }
 
 int EXP_BaseListValue::GetCount() const
@@ -470,6 +687,7 @@ PyObject *EXP_BaseListValue::Pyreverse()
   }
 
   std::reverse(m_pValueArray.begin(), m_pValueArray.end());
+  InvalidateIndex();
   Py_RETURN_NONE;
 }
 
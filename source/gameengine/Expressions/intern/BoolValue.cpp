@@ -40,7 +40,11 @@ EXP_BoolValue::EXP_BoolValue(bool innie, const std::string &name) : m_bool(innie
 
 void EXP_BoolValue::SetValue(EXP_Value *newval)
 {
-  m_bool = (newval->GetNumber() != 0);
+  const bool value = (newval->GetNumber() != 0);
+  if (value != m_bool) {
+    m_bool = value;
+    NotifyModified();
+  }
 }
 
 EXP_Value *EXP_BoolValue::Calc(VALUE_OPERATOR op, EXP_Value *val)
@@ -245,7 +245,10 @@ EXP_Value *EXP_FloatValue::CalcFinal(VALUE_DATA_TYPE dtype, VALUE_OPERATOR op, E
 
 void EXP_FloatValue::SetFloat(float fl)
 {
-  m_float = fl;
+  if (fl != m_float) {
+    m_float = fl;
+    NotifyModified();
+  }
 }
 
 float EXP_FloatValue::GetFloat()
@@ -265,7 +268,7 @@ int EXP_FloatValue::GetValueType()
 
 void EXP_FloatValue::SetValue(EXP_Value *newval)
 {
-  m_float = (float)newval->GetNumber();
+  SetFloat((float)newval->GetNumber());
 }
 
 std::string EXP_FloatValue::GetText()
@@ -283,7 +283,11 @@ EXP_Value *EXP_IntValue::GetReplica()
 
 void EXP_IntValue::SetValue(EXP_Value *newval)
 {
-  m_int = (cInt)newval->GetNumber();
+  const cInt value = (cInt)newval->GetNumber();
+  if (value != m_int) {
+    m_int = value;
+    NotifyModified();
+  }
 }
 
 #ifdef WITH_PYTHON
@@ -90,7 +90,11 @@ EXP_Value *EXP_StringValue::CalcFinal(VALUE_DATA_TYPE dtype, VALUE_OPERATOR op,
 
 void EXP_StringValue::SetValue(EXP_Value *newval)
 {
-  m_strString = newval->GetText();
+  const std::string text = newval->GetText();
+  if (text != m_strString) {
+    m_strString = text;
+    NotifyModified();
+  }
 }
 
 double EXP_StringValue::GetNumber()
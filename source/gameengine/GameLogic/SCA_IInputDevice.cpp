@@ -143,6 +143,10 @@ void SCA_IInputDevice::ClearInputs()
   m_text.clear();
 }
 
+void SCA_IInputDevice::BeginLogicFrame(double time)
+{
+}
+
 void SCA_IInputDevice::ReleaseMoveEvent()
 {
   /* We raise the release mouse move event if:
@@ -231,6 +231,12 @@ class SCA_IInputDevice {
    */
   virtual void ClearInputs();
 
+  /** Called at the beginning of each logic frame before the move events are released
+   * and the sensors read the inputs.
+   * \param time The engine frame time.
+   */
+  virtual void BeginLogicFrame(double time);
+
   /** Manage move event like mouse by releasing if possible.
    * These kind of events are precise of one frame.
    */
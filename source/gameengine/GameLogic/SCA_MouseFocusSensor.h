@@ -39,9 +39,6 @@
 
 class KX_Camera;
 class KX_KetsjiEngine;
-class KX_RayCast;
-
-struct KX_ClientObjectInfo;
 
 /**
  * The mouse focus sensor extends the basic SCA_MouseSensor. It has
@@ -100,11 +97,6 @@ class SCA_MouseFocusSensor : public SCA_MouseSensor {
     return result;
   };
 
-  /// \see KX_RayCast
-  bool RayHit(KX_ClientObjectInfo *client, KX_RayCast *result, void */*data*/);
-  /// \see KX_RayCast
-  bool NeedRayCast(KX_ClientObjectInfo *client, void */*data*/);
-
   const MT_Vector3 &RaySource() const;
   const MT_Vector3 &RayTarget() const;
   const MT_Vector3 &HitPosition() const;
@@ -41,6 +41,15 @@
 
 #include "SCA_MouseManager.h"
 
+#include "CM_Message.h"
+#include "KX_Camera.h"
+#include "KX_ClientObjectInfo.h"
+#include "KX_GameObject.h"
+#include "KX_KetsjiEngine.h"
+#include "KX_RayCast.h"
+#include "KX_Scene.h"
+#include "RAS_ICanvas.h"
+#include "RAS_MeshObject.h"
 #include "SCA_MouseSensor.h"
 
 SCA_MouseManager::SCA_MouseManager(SCA_LogicManager *logicmgr, SCA_IInputDevice *mousedev)
@@ -59,6 +68,9 @@ SCA_IInputDevice *SCA_MouseManager::GetInputDevice()
 
 void SCA_MouseManager::NextFrame()
 {
+  // Objects and cameras may have moved since the last frame.
+  m_pickRays.clear();
+
   if (m_mousedevice) {
     for (SCA_ISensor *sensor : m_sensors) {
       SCA_MouseSensor *mousesensor = static_cast<SCA_MouseSensor *>(sensor);
@@ -79,3 +91,171 @@ void SCA_MouseManager::NextFrame()
     }
   }
 }
+
+bool SCA_MouseManager::PickFilter::operator==(const PickFilter &other) const
+{
+  return m_mask == other.m_mask && m_xrayName == other.m_xrayName &&
+         m_xrayMaterial == other.m_xrayMaterial;
+}
+
+const SCA_MouseManager::PickRay &SCA_MouseManager::GetPickRay(KX_Scene *scene,
+                                                              KX_Camera *cam,
+                                                              KX_KetsjiEngine *engine,
+                                                              int x,
+                                                              int y,
+                                                              const PickFilter &filter)
+{
+  for (const PickRay &ray : m_pickRays) {
+    if (ray.m_camera == cam && ray.m_x == x && ray.m_y == y && ray.m_filter == filter) {
+      return ray;
+    }
+  }
+
+  m_pickRays.emplace_back();
+  PickRay &ray = m_pickRays.back();
+  ray.m_camera = cam;
+  ray.m_x = x;
+  ray.m_y = y;
+  ray.m_filter = filter;
+  ray.m_hit.m_object = nullptr;
+  ComputePickRay(ray, scene, engine);
+
+  return ray;
+}
+
+void SCA_MouseManager::ComputePickRay(PickRay &ray, KX_Scene *scene, KX_KetsjiEngine *engine)
+{
+  /* All screen handling in the gameengine is done by GL,
+   * specifically the model/view and projection parts. The viewport
+   * part is in the creator.
+   *
+   * The theory is this:
+   * WCS - world coordinates
+   * -> wcs_camcs_trafo ->
+   * camCS - camera coordinates
+   * -> camcs_clip_trafo ->
+   * clipCS - normalized device coordinates?
+   * -> normview_win_trafo
+   * winCS - window coordinates
+   *
+   * The first two transforms are respectively the model/view and
+   * the projection matrix. These are passed to the rasterizer, and
+   * we store them in the camera for easy access.
+   *
+   * For normalized device coords (xn = x/w, yn = y/w/zw) the
+   * windows coords become (lb = left bottom)
+   *
+   * xwin = [(xn + 1.0) * width]/2 + x_lb
+   * ywin = [(yn + 1.0) * height]/2 + y_lb
+   *
+   * Inverting (blender y is flipped!):
+   *
+   * xn = 2(xwin - x_lb)/width - 1.0
+   * yn = 2(ywin - y_lb)/height - 1.0
+   *    = 2(height - y_blender - y_lb)/height - 1.0
+   *    = 1.0 - 2(y_blender - y_lb)/height
+   *
+   * */
+
+  RAS_Rect area, viewport;
+  RAS_ICanvas *canvas = engine->GetCanvas();
+  short y_inv = canvas->GetHeight() - ray.m_y;
+
+  const RAS_Rect displayArea = engine->GetRasterizer()->GetRenderArea(
+      canvas, RAS_Rasterizer::RAS_STEREO_LEFTEYE);
+  engine->GetSceneViewport(scene, ray.m_camera, displayArea, area, viewport);
+
+  /* Check if the mouse is in the viewport */
+  ray.m_valid = (ray.m_x < viewport.GetRight() && ray.m_x > viewport.GetLeft() &&
+                 y_inv < viewport.GetTop() && y_inv > viewport.GetBottom());
+  if (!ray.m_valid) {
+    return;
+  }
+
+  float height = float(viewport.GetTop() - viewport.GetBottom() + 1);
+  float width = float(viewport.GetRight() - viewport.GetLeft() + 1);
+
+  float x_lb = float(viewport.GetLeft());
+  float y_lb = float(viewport.GetBottom());
+
+  /* y_inv - inverting for a bounds check is only part of it, now make relative to view bounds */
+  y_inv = (viewport.GetTop() - y_inv) + viewport.GetBottom();
+
+  // Build the from and to point in normalized device coordinates.
+  const float xn = (2 * (ray.m_x - x_lb) / width) - 1.0f;
+  const float yn = 1.0f - (2 * (y_inv - y_lb) / height);
+  MT_Vector4 frompoint;
+  MT_Vector4 topoint;
+  frompoint.setValue(xn, yn, -1.0f, 1.0f);
+  topoint.setValue(xn, yn, 1.0f, 1.0f);
+
+  MT_Matrix4x4 camcs_wcs_matrix = MT_Matrix4x4(ray.m_camera->GetCameraToWorld());
+  MT_Matrix4x4 clip_camcs_matrix = MT_Matrix4x4(ray.m_camera->GetProjectionMatrix());
+  clip_camcs_matrix.invert();
+
+  // Clip to camera to world coordinates.
+  frompoint = camcs_wcs_matrix * (clip_camcs_matrix * frompoint);
+  topoint = camcs_wcs_matrix * (clip_camcs_matrix * topoint);
+
+  ray.m_source.setValue(
+      frompoint[0] / frompoint[3], frompoint[1] / frompoint[3], frompoint[2] / frompoint[3]);
+  ray.m_target.setValue(topoint[0] / topoint[3], topoint[1] / topoint[3], topoint[2] / topoint[3]);
+
+  // The filter is applied before casting on the objects, so that filtered objects never occlude.
+  KX_RayCast::Callback<SCA_MouseManager, PickRay> callback(
+      this, ray.m_camera->GetPhysicsController(), &ray, false, true);
+
+  KX_RayCast::RayTest(scene->GetPhysicsEnvironment(), ray.m_source, ray.m_target, callback);
+}
+
+bool SCA_MouseManager::HasPropertyOrMaterial(KX_GameObject *gameobj,
+                                             const std::string &name,
+                                             bool material)
+{
+  if (material) {
+    for (unsigned int i = 0; i < gameobj->GetMeshCount(); ++i) {
+      RAS_MeshObject *meshObj = gameobj->GetMesh(i);
+      for (unsigned int j = 0; j < meshObj->NumMaterials(); ++j) {
+        if (name == std::string(meshObj->GetMaterialName(j), 2)) {
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  return gameobj->GetProperty(name) != nullptr;
+}
+
+bool SCA_MouseManager::RayHit(KX_ClientObjectInfo *client, KX_RayCast *result, PickRay *ray)
+{
+  // The first object hit occludes the next ones.
+  ray->m_hit = {client->m_gameobject, result->m_hitPoint, result->m_hitNormal, result->m_hitUV};
+  return true;
+}
+
+bool SCA_MouseManager::NeedRayCast(KX_ClientObjectInfo *client, PickRay *ray)
+{
+  if (client->m_type > KX_ClientObjectInfo::ACTOR) {
+    // Unknown type of object, skip it.
+    // Should not occur as the sensor objects are filtered in RayTest()
+    CM_Error("invalid client type " << client->m_type << " found ray casting");
+    return false;
+  }
+
+  KX_GameObject *gameobj = client->m_gameobject;
+  const PickFilter &filter = ray->m_filter;
+
+  // The current object is not in the proper layer.
+  if (!(gameobj->GetCollisionGroup() & filter.m_mask)) {
+    return false;
+  }
+
+  // "X-Ray" option, see "through" the objects without the property or material.
+  if (!filter.m_xrayName.empty() &&
+      !HasPropertyOrMaterial(gameobj, filter.m_xrayName, filter.m_xrayMaterial)) {
+    return false;
+  }
+
+  return true;
+}
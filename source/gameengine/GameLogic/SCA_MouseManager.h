@@ -33,16 +33,90 @@
 
 #pragma once
 
+#include <string>
+#include <vector>
+
+#include "MT_Vector2.h"
+#include "MT_Vector3.h"
 #include "SCA_EventManager.h"
 #include "SCA_IInputDevice.h"
 
+class KX_Camera;
+class KX_GameObject;
+class KX_KetsjiEngine;
+class KX_RayCast;
+class KX_Scene;
+struct KX_ClientObjectInfo;
+
 class SCA_MouseManager : public SCA_EventManager {
+ public:
+  /// An object hit by a pick ray.
+  struct PickHit {
+    KX_GameObject *m_object;
+    MT_Vector3 m_position;
+    MT_Vector3 m_normal;
+    MT_Vector2 m_uv;
+  };
+
+  /// Objects a pick ray can hit, the other objects are seen through.
+  struct PickFilter {
+    /// Collision groups of the objects.
+    int m_mask;
+    /// Property or material name the objects must own, empty to not see through any object.
+    std::string m_xrayName;
+    bool m_xrayMaterial;
+
+    bool operator==(const PickFilter &other) const;
+  };
+
+  /** Ray shot from a camera through the mouse position, shared by all the mouse focus sensors
+   * using the same filter.
+   */
+  struct PickRay {
+    KX_Camera *m_camera;
+    int m_x;
+    int m_y;
+    PickFilter m_filter;
+    /// False if the mouse is outside of the camera viewport, no ray is shot then.
+    bool m_valid;
+    MT_Vector3 m_source;
+    MT_Vector3 m_target;
+    /// First object hit passing the filter, m_object is nullptr if none.
+    PickHit m_hit;
+  };
+
+ private:
   class SCA_IInputDevice *m_mousedevice;
 
+  /// Pick rays computed during the current frame.
+  std::vector<PickRay> m_pickRays;
+
+  void ComputePickRay(PickRay &ray, KX_Scene *scene, KX_KetsjiEngine *engine);
+
  public:
   SCA_MouseManager(class SCA_LogicManager *logicmgr, class SCA_IInputDevice *mousedev);
   virtual ~SCA_MouseManager();
 
   virtual void NextFrame();
   SCA_IInputDevice *GetInputDevice();
+
+  /** Return the pick ray of a camera through a mouse position, the ray is
+   * shot at the first request of the frame and reused by the next ones with the same filter.
+   */
+  const PickRay &GetPickRay(KX_Scene *scene,
+                            KX_Camera *cam,
+                            KX_KetsjiEngine *engine,
+                            int x,
+                            int y,
+                            const PickFilter &filter);
+
+  /// Tests whether the object owns the property or a material of the given name.
+  static bool HasPropertyOrMaterial(KX_GameObject *gameobj,
+                                    const std::string &name,
+                                    bool material);
+
+  /// \see KX_RayCast
+  bool RayHit(KX_ClientObjectInfo *client, KX_RayCast *result, PickRay *ray);
+  /// \see KX_RayCast
+  bool NeedRayCast(KX_ClientObjectInfo *client, PickRay *ray);
 };
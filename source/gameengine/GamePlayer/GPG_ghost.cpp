@@ -539,6 +539,9 @@ static void usage(const std::string &program, bool isBlenderPlayer)
   CM_Message("       fixedtime                      0         \"Enable all frames\"");
   CM_Message("       wireframe                      0         Wireframe render");
   CM_Message("       show_framerate                 0         Show the frame rate");
+  CM_Message(
+      "       frame_pacing                   1         Frame wait: 0 poll, 1 sleep and spin, "
+      "2 sleep");
   CM_Message("       show_properties                0         Show debug properties");
   CM_Message("       show_profile                   0         Show profiling information");
   CM_Message("       show_bounding_box              0         Show debug bounding box volume");
@@ -546,7 +549,10 @@ static void usage(const std::string &program, bool isBlenderPlayer)
   CM_Message("       show_camera_frustum            0         Show debug camera frustum volume");
   CM_Message(
       "       show_shadow_frustum            0         Show debug light shadow frustum volume");
-  CM_Message("       ignore_deprecation_warnings    1         Ignore deprecation warnings"
+  CM_Message("       ignore_deprecation_warnings    1         Ignore deprecation warnings");
+  CM_Message("       lazy_load                      0         Read packed data when first used");
+  CM_Message("       record_input                             Record input events to a file");
+  CM_Message("       replay_input                             Replay input events from a file"
              << std::endl);
   CM_Message("  -p: override python main loop script");
   CM_Message(std::endl);
@@ -1408,6 +1414,10 @@ int main(int argc,
         /* We don't want to use other windows than the one where is the 3D view */
         std::vector<wmWindow *> unused_windows = {};
 
+        /* Read the packed data (images, sounds, fonts) of the game files when first used. */
+        const bool lazyLoad = (SYS_GetCommandLineInt(syshandle, "lazy_load", 0) != 0);
+        BLO_read_deferred_packed_data_set(lazyLoad);
+
         do {
           // Read the Blender file
 
@@ -1765,6 +1775,15 @@ int main(int argc,
           }
         } while (!quitGame(exitcode));
 
+        if (lazyLoad) {
+          BLODeferredDataStats stats;
+          BLO_read_deferred_data_stats_get(&stats);
+          CM_Message("Lazy loading: deferred " << stats.deferred_num << " blocks ("
+                                               << stats.deferred_size / 1024 << " KiB), read "
+                                               << stats.read_num << " blocks ("
+                                               << stats.read_size / 1024 << " KiB)");
+        }
+
         /* Restore the windows we disabled during standalone runtime to free it
          * (normally) in standalone exit pipeline */
         for (wmWindow *tmp_win : unused_windows) {
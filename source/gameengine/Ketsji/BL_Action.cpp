@@ -43,8 +43,6 @@
 
 BL_Action::BL_Action(class KX_GameObject *gameobj)
     : m_action(nullptr),
-      m_blendpose(nullptr),
-      m_blendinpose(nullptr),
       m_obj(gameobj),
       m_startframe(0.f),
       m_endframe(0.f),
@@ -77,10 +75,6 @@ BL_Action::BL_Action(class KX_GameObject *gameobj)
 
 BL_Action::~BL_Action()
 {
-  if (m_blendpose)
-    BKE_pose_free(m_blendpose);
-  if (m_blendinpose)
-    BKE_pose_free(m_blendinpose);
   ClearControllerList();
 
   Object *ob = m_obj->GetBlenderObject();
@@ -142,6 +136,8 @@ bool BL_Action::Play(const std::string &name,
 
   // First get rid of any old controllers
   ClearControllerList();
+  // Resolve the f-curves again at next update, the action could be reloaded.
+  m_poseBinding.action = nullptr;
 
   // Create an SG_Controller
   SG_Controller *sg_contr = BL_CreateIPO(m_action, m_obj, kxscene);
@@ -177,7 +173,7 @@ bool BL_Action::Play(const std::string &name,
   // Setup blendin shapes/poses
   if (m_obj->GetGameObjectType() == SCA_IObject::OBJ_ARMATURE) {
     BL_ArmatureObject *obj = (BL_ArmatureObject *)m_obj;
-    obj->GetPose(&m_blendinpose);
+    obj->GetPose(m_blendinpose);
   }
   else {
   }
@@ -428,10 +424,14 @@ void BL_Action::Update(float curtime, bool applyToObject)
     BL_ArmatureObject *obj = (BL_ArmatureObject *)m_obj;
 
     if (m_layer_weight >= 0)
-      obj->GetPose(&m_blendpose);
+      obj->GetPose(m_blendpose);
+
+    if (m_poseBinding.action != m_action) {
+      obj->BindAction(m_action, m_poseBinding);
+    }
 
     // Extract the pose from the action
-    obj->SetPoseByAction(m_action, &animEvalContext);
+    obj->SetPoseByAction(m_poseBinding, &animEvalContext);
 
     m_obj->ForceIgnoreParentTx();
 
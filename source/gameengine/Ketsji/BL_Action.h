@@ -31,11 +31,16 @@
 
 #include "BKE_animsys.h"
 
+#include "BL_ArmaturePose.h"
+
 class BL_Action {
  private:
   struct bAction *m_action;
-  struct bPose *m_blendpose;
-  struct bPose *m_blendinpose;
+  /// Poses of the armature before the action for layer blending and at play for blend in.
+  BL_ArmaturePose m_blendpose;
+  BL_ArmaturePose m_blendinpose;
+  /// F-curves of m_action resolved against the armature pose channels.
+  BL_ArmaturePose::ActionBinding m_poseBinding;
   std::vector<class SG_Controller *> m_sg_contr_list;
   class KX_GameObject *m_obj;
   std::vector<float> m_blendshape;
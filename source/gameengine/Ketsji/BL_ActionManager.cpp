@@ -27,6 +27,7 @@
 #include "BL_ActionManager.h"
 
 #include "BL_Action.h"
+#include "BL_ArmatureObject.h"
 #include "DNA_ID.h"
 
 #define IS_TAGGED(_id) ((_id) && (((ID *)_id)->tag & LIB_TAG_DOIT))
@@ -172,6 +173,10 @@ void BL_ActionManager::Update(float curtime, bool applyToObject)
   for (const auto &pair : m_layers) {
     pair.second->Update(curtime, applyToObject);
   }
+  /* Write the pose of all the layers once */
+  if (applyToObject && m_obj->GetGameObjectType() == SCA_IObject::OBJ_ARMATURE) {
+    static_cast<BL_ArmatureObject *>(m_obj)->FlushPose();
+  }
   /* It's to sync children with parent SGNode after fcurve update */
   for (const auto &pair : m_layers) {
     pair.second->UpdateIPOs();
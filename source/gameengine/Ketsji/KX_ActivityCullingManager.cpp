@@ -0,0 +1,459 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Ketsji/KX_ActivityCullingManager.cpp
+ *  \ingroup ketsji
+ */
+
+#include "KX_ActivityCullingManager.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#include "KX_GameObject.h"
+
+/// Minimum grid cell size, avoid tiny cells for objects with null culling radius.
+static const float minCellSize = 1.0f;
+/// Bound of the cell coordinates, cells beyond are merged.
+static const float maxCellCoord = 1.0e6f;
+/// Culled state of an object not evaluated yet, its suspended activities are unknown.
+static const uint8_t unknownCulled = 0xFF;
+
+using ActivityCullingInfo = KX_GameObject::ActivityCullingInfo;
+
+KX_ActivityCullingManager::KX_ActivityCullingManager()
+    : m_cellSize(minCellSize), m_maxRadius(0.0f), m_frame(0)
+{
+}
+
+KX_ActivityCullingManager::~KX_ActivityCullingManager()
+{
+  for (KX_GameObject *gameobj : m_objects) {
+    gameobj->SetActivityCullingIndex(-1);
+  }
+}
+
+uint64_t KX_ActivityCullingManager::ComputeCell(int x, int y, int z) const
+{
+  // 21 bits per axis, distant cells wrapping on the same key only add candidates.
+  return ((uint64_t)(x & 0x1FFFFF) << 42) | ((uint64_t)(y & 0x1FFFFF) << 21) |
+         (uint64_t)(z & 0x1FFFFF);
+}
+
+uint64_t KX_ActivityCullingManager::ComputeCell(float x, float y, float z) const
+{
+  const float inv = 1.0f / m_cellSize;
+  return ComputeCell((int)std::clamp(std::floor(x * inv), -maxCellCoord, maxCellCoord),
+                     (int)std::clamp(std::floor(y * inv), -maxCellCoord, maxCellCoord),
+                     (int)std::clamp(std::floor(z * inv), -maxCellCoord, maxCellCoord));
+}
+
+void KX_ActivityCullingManager::AddToGrid(int index)
+{
+  const uint64_t key = ComputeCell(m_posX[index], m_posY[index], m_posZ[index]);
+  std::vector<int> &cell = m_grid[key];
+  m_cell[index] = key;
+  m_cellSlot[index] = cell.size();
+  cell.push_back(index);
+}
+
+void KX_ActivityCullingManager::RemoveFromGrid(int index)
+{
+  const int slot = m_cellSlot[index];
+  if (slot == -1) {
+    return;
+  }
+
+  std::unordered_map<uint64_t, std::vector<int>>::iterator it = m_grid.find(m_cell[index]);
+  std::vector<int> &cell = it->second;
+  const int last = cell.back();
+  cell[slot] = last;
+  m_cellSlot[last] = slot;
+  cell.pop_back();
+  if (cell.empty()) {
+    m_grid.erase(it);
+  }
+
+  m_cellSlot[index] = -1;
+}
+
+void KX_ActivityCullingManager::AddToAwake(int index)
+{
+  if (m_awakeSlot[index] != -1) {
+    return;
+  }
+
+  m_awakeSlot[index] = m_awake.size();
+  m_awake.push_back(index);
+}
+
+void KX_ActivityCullingManager::RemoveFromAwake(int index)
+{
+  const int slot = m_awakeSlot[index];
+  if (slot == -1) {
+    return;
+  }
+
+  const int last = m_awake.back();
+  m_awake[slot] = last;
+  m_awakeSlot[last] = slot;
+  m_awake.pop_back();
+
+  m_awakeSlot[index] = -1;
+}
+
+void KX_ActivityCullingManager::MoveIndex(int from, int to)
+{
+  m_posX[to] = m_posX[from];
+  m_posY[to] = m_posY[from];
+  m_posZ[to] = m_posZ[from];
+  m_physicsRadius[to] = m_physicsRadius[from];
+  m_logicRadius[to] = m_logicRadius[from];
+  m_flags[to] = m_flags[from];
+  m_culled[to] = m_culled[from];
+  m_pending[to] = m_pending[from];
+  m_evaluatedFrame[to] = m_evaluatedFrame[from];
+  m_cell[to] = m_cell[from];
+  m_cellSlot[to] = m_cellSlot[from];
+  m_awakeSlot[to] = m_awakeSlot[from];
+  m_objects[to] = m_objects[from];
+
+  // Update the references to the moved index.
+  if (m_cellSlot[to] != -1) {
+    m_grid[m_cell[to]][m_cellSlot[to]] = to;
+  }
+  if (m_awakeSlot[to] != -1) {
+    m_awake[m_awakeSlot[to]] = to;
+  }
+  if (m_pending[to]) {
+    m_pendingList.push_back(to);
+  }
+
+  m_objects[to]->SetActivityCullingIndex(to);
+}
+
+void KX_ActivityCullingManager::SetPending(int index, uint8_t flag)
+{
+  if (!m_pending[index]) {
+    m_pendingList.push_back(index);
+  }
+  m_pending[index] |= flag;
+}
+
+void KX_ActivityCullingManager::UpdateSettings(int index)
+{
+  const ActivityCullingInfo &info = m_objects[index]->GetActivityCullingInfo();
+  const uint8_t flags = info.m_flags & (ActivityCullingInfo::ACTIVITY_PHYSICS |
+                                        ActivityCullingInfo::ACTIVITY_LOGIC);
+
+  m_flags[index] = flags;
+  m_physicsRadius[index] = info.m_physicsRadius;
+  m_logicRadius[index] = info.m_logicRadius;
+  // Activities not culled anymore are restored by KX_GameObject::SetActivityCulling.
+  if (m_culled[index] != unknownCulled) {
+    m_culled[index] &= flags;
+  }
+
+  if (flags == ActivityCullingInfo::ACTIVITY_NONE) {
+    RemoveFromGrid(index);
+    RemoveFromAwake(index);
+    return;
+  }
+
+  float radius2 = 0.0f;
+  if (flags & ActivityCullingInfo::ACTIVITY_PHYSICS) {
+    radius2 = std::max(radius2, info.m_physicsRadius);
+  }
+  if (flags & ActivityCullingInfo::ACTIVITY_LOGIC) {
+    radius2 = std::max(radius2, info.m_logicRadius);
+  }
+
+  const float radius = std::sqrt(radius2);
+  if (radius > m_maxRadius) {
+    m_maxRadius = radius;
+  }
+
+  if (m_maxRadius > m_cellSize) {
+    // Keep some margin to not rebuild the grid for every slightly larger radius.
+    m_cellSize = m_maxRadius * 2.0f;
+    RebuildGrid();
+  }
+  else if (m_cellSlot[index] == -1) {
+    AddToGrid(index);
+  }
+
+  if (flags & ~m_culled[index]) {
+    AddToAwake(index);
+  }
+  else {
+    RemoveFromAwake(index);
+  }
+}
+
+void KX_ActivityCullingManager::RebuildGrid()
+{
+  m_grid.clear();
+
+  for (unsigned int i = 0, size = m_objects.size(); i < size; ++i) {
+    m_cellSlot[i] = -1;
+    if (m_flags[i] != ActivityCullingInfo::ACTIVITY_NONE) {
+      AddToGrid(i);
+    }
+  }
+}
+
+void KX_ActivityCullingManager::FlushPending()
+{
+  const int size = m_objects.size();
+  for (int index : m_pendingList) {
+    // The list can contain indices of removed objects.
+    if (index >= size) {
+      continue;
+    }
+
+    const uint8_t pending = m_pending[index];
+    if (!pending) {
+      continue;
+    }
+    m_pending[index] = 0;
+
+    if ((pending & PENDING_MOVED) && m_cellSlot[index] != -1) {
+      const uint64_t key = ComputeCell(m_posX[index], m_posY[index], m_posZ[index]);
+      if (key != m_cell[index]) {
+        RemoveFromGrid(index);
+        AddToGrid(index);
+      }
+    }
+
+    if ((pending & PENDING_EVALUATE) && m_flags[index] != ActivityCullingInfo::ACTIVITY_NONE) {
+      AddCandidate(index);
+    }
+  }
+
+  m_pendingList.clear();
+}
+
+void KX_ActivityCullingManager::AddCandidate(int index)
+{
+  if (m_evaluatedFrame[index] == m_frame) {
+    return;
+  }
+
+  m_evaluatedFrame[index] = m_frame;
+  m_candidates.push_back(index);
+}
+
+void KX_ActivityCullingManager::Evaluate(int index, const std::vector<MT_Vector3> &cameraPositions)
+{
+  const float x = m_posX[index];
+  const float y = m_posY[index];
+  const float z = m_posZ[index];
+
+  // Keep the minimum squared distance to the cameras.
+  float distance = FLT_MAX;
+  for (const MT_Vector3 &campos : cameraPositions) {
+    const float dx = x - campos.x();
+    const float dy = y - campos.y();
+    const float dz = z - campos.z();
+    distance = std::min(distance, dx * dx + dy * dy + dz * dz);
+  }
+
+  const uint8_t flags = m_flags[index];
+  uint8_t culled = 0;
+  if ((flags & ActivityCullingInfo::ACTIVITY_PHYSICS) && distance > m_physicsRadius[index]) {
+    culled |= ActivityCullingInfo::ACTIVITY_PHYSICS;
+  }
+  if ((flags & ActivityCullingInfo::ACTIVITY_LOGIC) && distance > m_logicRadius[index]) {
+    culled |= ActivityCullingInfo::ACTIVITY_LOGIC;
+  }
+
+  // Apply all the activities of an object in unknown state.
+  const uint8_t changed = (m_culled[index] == unknownCulled) ? flags : culled ^ m_culled[index];
+  if (!changed) {
+    return;
+  }
+
+  m_culled[index] = culled;
+
+  KX_GameObject *gameobj = m_objects[index];
+  if (changed & ActivityCullingInfo::ACTIVITY_PHYSICS) {
+    if (culled & ActivityCullingInfo::ACTIVITY_PHYSICS) {
+      gameobj->SuspendPhysics(false, false);
+    }
+    else {
+      gameobj->RestorePhysics(false);
+    }
+  }
+  if (changed & ActivityCullingInfo::ACTIVITY_LOGIC) {
+    if (culled & ActivityCullingInfo::ACTIVITY_LOGIC) {
+      gameobj->SuspendLogicAndActions(false);
+    }
+    else {
+      gameobj->RestoreLogicAndActions(false);
+    }
+  }
+
+  if (flags & ~culled) {
+    AddToAwake(index);
+  }
+  else {
+    RemoveFromAwake(index);
+  }
+}
+
+void KX_ActivityCullingManager::RegisterObject(KX_GameObject *gameobj)
+{
+  if (gameobj->GetActivityCullingIndex() != -1) {
+    return;
+  }
+
+  const int index = m_objects.size();
+  const MT_Vector3 &position = gameobj->NodeGetWorldPosition();
+
+  m_posX.push_back(position.x());
+  m_posY.push_back(position.y());
+  m_posZ.push_back(position.z());
+  m_physicsRadius.push_back(0.0f);
+  m_logicRadius.push_back(0.0f);
+  m_flags.push_back(ActivityCullingInfo::ACTIVITY_NONE);
+  /* The object can come from a merged scene with suspended activities,
+   * its state is set at its first evaluation. */
+  m_culled.push_back(unknownCulled);
+  m_pending.push_back(0);
+  m_evaluatedFrame.push_back(0);
+  m_cell.push_back(0);
+  m_cellSlot.push_back(-1);
+  m_awakeSlot.push_back(-1);
+  m_objects.push_back(gameobj);
+
+  gameobj->SetActivityCullingIndex(index);
+
+  UpdateSettings(index);
+  SetPending(index, PENDING_EVALUATE);
+}
+
+void KX_ActivityCullingManager::UnregisterObject(KX_GameObject *gameobj)
+{
+  const int index = gameobj->GetActivityCullingIndex();
+  if (index == -1 || index >= (int)m_objects.size() || m_objects[index] != gameobj) {
+    return;
+  }
+
+  RemoveFromGrid(index);
+  RemoveFromAwake(index);
+
+  const int last = m_objects.size() - 1;
+  if (index != last) {
+    MoveIndex(last, index);
+  }
+
+  m_posX.pop_back();
+  m_posY.pop_back();
+  m_posZ.pop_back();
+  m_physicsRadius.pop_back();
+  m_logicRadius.pop_back();
+  m_flags.pop_back();
+  m_culled.pop_back();
+  m_pending.pop_back();
+  m_evaluatedFrame.pop_back();
+  m_cell.pop_back();
+  m_cellSlot.pop_back();
+  m_awakeSlot.pop_back();
+  m_objects.pop_back();
+
+  gameobj->SetActivityCullingIndex(-1);
+}
+
+void KX_ActivityCullingManager::ObjectMoved(KX_GameObject *gameobj, const MT_Vector3 &position)
+{
+  const int index = gameobj->GetActivityCullingIndex();
+  if (index == -1 || index >= (int)m_objects.size() || m_objects[index] != gameobj) {
+    return;
+  }
+
+  m_posX[index] = position.x();
+  m_posY[index] = position.y();
+  m_posZ[index] = position.z();
+
+  if (m_flags[index] != ActivityCullingInfo::ACTIVITY_NONE) {
+    SetPending(index, PENDING_MOVED);
+  }
+}
+
+void KX_ActivityCullingManager::ObjectChanged(KX_GameObject *gameobj)
+{
+  const int index = gameobj->GetActivityCullingIndex();
+  if (index == -1 || index >= (int)m_objects.size() || m_objects[index] != gameobj) {
+    return;
+  }
+
+  UpdateSettings(index);
+  SetPending(index, PENDING_EVALUATE);
+}
+
+void KX_ActivityCullingManager::Update(const std::vector<MT_Vector3> &cameraPositions)
+{
+  ++m_frame;
+  m_candidates.clear();
+
+  // Update the grid cells of the moved objects and evaluate the changed objects.
+  FlushPending();
+
+  if (!m_grid.empty()) {
+    // Objects in the cells overlapped by the largest culling radius around a camera.
+    const float inv = 1.0f / m_cellSize;
+    for (const MT_Vector3 &campos : cameraPositions) {
+      int min[3];
+      int max[3];
+      for (unsigned short axis = 0; axis < 3; ++axis) {
+        min[axis] = (int)std::clamp(
+            std::floor(((float)campos[axis] - m_maxRadius) * inv), -maxCellCoord, maxCellCoord);
+        max[axis] = (int)std::clamp(
+            std::floor(((float)campos[axis] + m_maxRadius) * inv), -maxCellCoord, maxCellCoord);
+      }
+
+      for (int x = min[0]; x <= max[0]; ++x) {
+        for (int y = min[1]; y <= max[1]; ++y) {
+          for (int z = min[2]; z <= max[2]; ++z) {
+            std::unordered_map<uint64_t, std::vector<int>>::const_iterator it = m_grid.find(
+                ComputeCell(x, y, z));
+            if (it == m_grid.end()) {
+              continue;
+            }
+            for (int index : it->second) {
+              AddCandidate(index);
+            }
+          }
+        }
+      }
+    }
+  }
+
+  /* Objects outside these cells are beyond any culling radius, only the ones
+   * which still have an activity running can flip. */
+  for (int index : m_awake) {
+    AddCandidate(index);
+  }
+
+  for (int index : m_candidates) {
+    Evaluate(index, cameraPositions);
+  }
+}
@@ -0,0 +1,128 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file KX_ActivityCullingManager.h
+ *  \ingroup ketsji
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "MT_Vector3.h"
+
+class KX_GameObject;
+
+/** Object activity culling of a scene.
+ * The world positions of the objects are stored in contiguous arrays updated by the
+ * transform callback of the scene graph, and the objects using activity culling are
+ * sorted in a coarse hashed grid. Each frame only the objects of the cells around the
+ * culling cameras, the objects not yet fully culled and the objects whose settings
+ * changed are evaluated, and only the objects whose physics or logic activity state
+ * flips are suspended or restored.
+ */
+class KX_ActivityCullingManager {
+ private:
+  enum PendingFlag : uint8_t {
+    /// The object moved, its grid cell must be updated.
+    PENDING_MOVED = (1 << 0),
+    /// The object settings changed, its activity must be evaluated.
+    PENDING_EVALUATE = (1 << 1)
+  };
+
+  /// Object world positions.
+  std::vector<float> m_posX;
+  std::vector<float> m_posY;
+  std::vector<float> m_posZ;
+  /// Squared physics and logic culling radius.
+  std::vector<float> m_physicsRadius;
+  std::vector<float> m_logicRadius;
+  /// Activity culling flags of the object, see KX_GameObject::ActivityCullingInfo::Flag.
+  std::vector<uint8_t> m_flags;
+  /// Activity culling flags for which the object is currently suspended, all bits set until
+  /// the first evaluation.
+  std::vector<uint8_t> m_culled;
+  /// Combination of PendingFlag.
+  std::vector<uint8_t> m_pending;
+  /// Last frame the object was evaluated, used to skip duplicated candidates.
+  std::vector<unsigned int> m_evaluatedFrame;
+  /// Grid cell of the object and index in the cell, -1 if the object is not in the grid.
+  std::vector<uint64_t> m_cell;
+  std::vector<int> m_cellSlot;
+  /// Index in m_awake, -1 if all the culled activities of the object are suspended.
+  std::vector<int> m_awakeSlot;
+  std::vector<KX_GameObject *> m_objects;
+
+  /// Objects using activity culling sorted per cell.
+  std::unordered_map<uint64_t, std::vector<int>> m_grid;
+  /// Objects with at least one culled activity not suspended.
+  std::vector<int> m_awake;
+  /// Objects with a PendingFlag set.
+  std::vector<int> m_pendingList;
+  /// Objects to evaluate in the current frame.
+  std::vector<int> m_candidates;
+
+  /// Grid cell size, always greater or equal to the largest culling radius.
+  float m_cellSize;
+  /// Largest non-squared culling radius.
+  float m_maxRadius;
+  unsigned int m_frame;
+
+  uint64_t ComputeCell(float x, float y, float z) const;
+  uint64_t ComputeCell(int x, int y, int z) const;
+
+  void AddToGrid(int index);
+  void RemoveFromGrid(int index);
+  void AddToAwake(int index);
+  void RemoveFromAwake(int index);
+  /// Move the object at index from into index to, used for swap removal.
+  void MoveIndex(int from, int to);
+  void SetPending(int index, uint8_t flag);
+  /// Copy the activity culling settings of the object at index.
+  void UpdateSettings(int index);
+  /// Recreate the grid with a cell size large enough for m_maxRadius.
+  void RebuildGrid();
+  /// Flush the pending object moves and settings changes.
+  void FlushPending();
+  void AddCandidate(int index);
+  void Evaluate(int index, const std::vector<MT_Vector3> &cameraPositions);
+
+ public:
+  KX_ActivityCullingManager();
+  ~KX_ActivityCullingManager();
+
+  /// Start to manage the activity of an object in the scene object list.
+  void RegisterObject(KX_GameObject *gameobj);
+  /// Stop to manage the activity of an object removed from the scene object list.
+  void UnregisterObject(KX_GameObject *gameobj);
+
+  /// Update the stored position of an object, called from the scene graph transform callback.
+  void ObjectMoved(KX_GameObject *gameobj, const MT_Vector3 &position);
+  /// Notify that the activity culling settings of an object changed.
+  void ObjectChanged(KX_GameObject *gameobj);
+
+  /** Suspend or restore the physics and logic of the objects crossing the culling
+   * radius of the nearest camera.
+   * \param cameraPositions The world position of the cameras using activity culling.
+   */
+  void Update(const std::vector<MT_Vector3> &cameraPositions);
+};
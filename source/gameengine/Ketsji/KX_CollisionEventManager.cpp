@@ -37,7 +37,9 @@
 
 KX_CollisionEventManager::KX_CollisionEventManager(class SCA_LogicManager *logicmgr,
                                                    PHY_IPhysicsEnvironment *physEnv)
-    : SCA_EventManager(logicmgr, TOUCH_EVENTMGR), m_physEnv(physEnv)
+    : SCA_EventManager(logicmgr, TOUCH_EVENTMGR),
+      m_physEnv(physEnv),
+      m_stepCount(physEnv->GetStepCount())
 {
   m_physEnv->AddCollisionCallback(
       PHY_OBJECT_RESPONSE, KX_CollisionEventManager::newCollisionResponse, this);
@@ -166,15 +168,19 @@ bool KX_CollisionEventManager::RemoveSensor(SCA_ISensor *sensor)
   return false;
 }
 
-void KX_CollisionEventManager::EndFrame()
+void KX_CollisionEventManager::NextFrame()
 {
-  for (SCA_ISensor *sensor : m_sensors) {
-    static_cast<SCA_CollisionSensor *>(sensor)->EndFrame();
+  /* The contacts are only reported by a physics step, with a physics rate lower than the logic
+   * rate the sensors keep the contacts of the last step instead of losing them every other
+   * frame. */
+  const unsigned int stepCount = m_physEnv->GetStepCount();
+  if (stepCount != m_stepCount) {
+    m_stepCount = stepCount;
+    for (SCA_ISensor *sensor : m_sensors) {
+      static_cast<SCA_CollisionSensor *>(sensor)->EndFrame();
+    }
   }
-}
 
-void KX_CollisionEventManager::NextFrame()
-{
   for (SCA_ISensor *sensor : m_sensors) {
     static_cast<SCA_CollisionSensor *>(sensor)->SynchronizeTransform();
   }
@@ -68,6 +68,8 @@ class KX_CollisionEventManager : public SCA_EventManager {
   };
 
   PHY_IPhysicsEnvironment *m_physEnv;
+  /// Physics step of the contacts of the sensors.
+  unsigned int m_stepCount;
 
   std::set<NewCollision> m_newCollisions;
 
@@ -95,7 +97,6 @@ class KX_CollisionEventManager : public SCA_EventManager {
   virtual ~KX_CollisionEventManager();
 
   virtual void NextFrame();
-  virtual void EndFrame();
   virtual bool RegisterSensor(SCA_ISensor *sensor);
   virtual bool RemoveSensor(SCA_ISensor *sensor);
 
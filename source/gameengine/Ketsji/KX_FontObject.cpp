@@ -54,12 +54,19 @@ static std::vector<std::string> split_string(std::string str)
   return text;
 }
 
-KX_FontObject::KX_FontObject() : KX_GameObject(), m_object(nullptr), m_rasterizer(nullptr)
+KX_FontObject::KX_FontObject()
+    : KX_GameObject(),
+      m_textProperty(nullptr),
+      m_textModified(false),
+      m_object(nullptr),
+      m_rasterizer(nullptr)
 {
 }
 
 KX_FontObject::~KX_FontObject()
 {
+  UnbindTextProperty();
+
   // remove font from the scene list
   // it's handled in KX_Scene::NewRemoveObject
   UpdateCurveText(m_backupText);  // eevee
@@ -73,6 +80,11 @@ KX_PythonProxy *KX_FontObject::NewInstance()
 void KX_FontObject::ProcessReplica()
 {
   KX_GameObject::ProcessReplica();
+
+  // The properties were replicated, the replica is registered when added to the scene.
+  m_textProperty = nullptr;
+  m_textModified = false;
+  BindTextProperty();
 }
 
 void KX_FontObject::SetText(const std::string &text)
@@ -106,11 +118,99 @@ void KX_FontObject::UpdateCurveText(std::string newText)  // eevee
 
 void KX_FontObject::UpdateTextFromProperty()
 {
+  if (!m_textModified) {
+    return;
+  }
+  m_textModified = false;
+
   // Allow for some logic brick control
-  EXP_Value *prop = GetProperty("Text");
-  if (prop && prop->GetText() != m_text) {
-    SetText(prop->GetText());
-    UpdateCurveText(m_text);  // eevee
+  if (m_textProperty) {
+    const std::string text = m_textProperty->GetText();
+    if (text != m_text) {
+      SetText(text);
+      UpdateCurveText(m_text);  // eevee
+    }
+  }
+}
+
+bool KX_FontObject::IsTextModified() const
+{
+  return m_textModified;
+}
+
+void KX_FontObject::SetProperty(const std::string &name, EXP_Value *ioProperty)
+{
+  if (name != "Text") {
+    KX_GameObject::SetProperty(name, ioProperty);
+    return;
+  }
+
+  // The previous value is released when replaced, unbind it before.
+  UnbindTextProperty();
+  KX_GameObject::SetProperty(name, ioProperty);
+  BindTextProperty();
+}
+
+bool KX_FontObject::RemoveProperty(const std::string &inName)
+{
+  if (inName == "Text") {
+    UnbindTextProperty();
+  }
+
+  return KX_GameObject::RemoveProperty(inName);
+}
+
+void KX_FontObject::ClearProperties()
+{
+  UnbindTextProperty();
+  KX_GameObject::ClearProperties();
+}
+
+void KX_FontObject::PropertyModified(EXP_PropValue *prop)
+{
+  MarkTextModified();
+}
+
+void KX_FontObject::BindTextProperty()
+{
+  UnbindTextProperty();
+
+  m_textProperty = GetProperty("Text");
+  if (!m_textProperty) {
+    return;
+  }
+
+  EXP_PropValue *propval = dynamic_cast<EXP_PropValue *>(m_textProperty);
+  if (propval) {
+    propval->SetListener(this);
+  }
+
+  MarkTextModified();
+}
+
+void KX_FontObject::UnbindTextProperty()
+{
+  EXP_PropValue *propval = dynamic_cast<EXP_PropValue *>(m_textProperty);
+  // The value could be shared and bound to another font.
+  if (propval && propval->GetListener() == this) {
+    propval->SetListener(nullptr);
+  }
+  m_textProperty = nullptr;
+}
+
+void KX_FontObject::MarkTextModified()
+{
+  if (m_textModified) {
+    return;
+  }
+  m_textModified = true;
+
+  // Fonts without scene are registered when added to the scene.
+  if (m_pSGNode) {
+    KX_Scene *scene = GetScene();
+    if (scene) {
+      scene->AddModifiedFont(this);
+    }
   }
 }
 
@@ -33,7 +33,7 @@
 
 #include "KX_GameObject.h"
 
-class KX_FontObject : public KX_GameObject {
+class KX_FontObject : public KX_GameObject, public EXP_PropValueListener {
   Py_Header
 
       public : KX_FontObject();
@@ -50,8 +50,18 @@ class KX_FontObject : public KX_GameObject {
 
   // Update text and bounding box.
   void SetText(const std::string &text);
-  /// Update text from property.
+  /// Update text from property, called once per frame for modified fonts.
   void UpdateTextFromProperty();
+  /// Return true if the "Text" property changed since the last UpdateTextFromProperty.
+  bool IsTextModified() const;
+
+  /// Track the replacement and removal of the "Text" property.
+  virtual void SetProperty(const std::string &name, EXP_Value *ioProperty);
+  virtual bool RemoveProperty(const std::string &inName);
+  virtual void ClearProperties();
+
+  /// Notification of an in place modification of the "Text" property.
+  virtual void PropertyModified(EXP_PropValue *prop);
 
   void SetRasterizer(RAS_Rasterizer *rasterizer);
 
@@ -66,7 +76,16 @@ class KX_FontObject : public KX_GameObject {
 #endif
 
  protected:
+  /// Bind the listener to the current "Text" property and request an update.
+  void BindTextProperty();
+  void UnbindTextProperty();
+  /// Register the font in the scene list of modified fonts.
+  void MarkTextModified();
+
   std::string m_text;
+  /// The "Text" property, owned by the property map.
+  EXP_Value *m_textProperty;
+  bool m_textModified;
   std::vector<std::string> m_texts;
   Object *m_object;
 
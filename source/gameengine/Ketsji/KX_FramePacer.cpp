@@ -0,0 +1,148 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Ketsji/KX_FramePacer.cpp
+ *  \ingroup ketsji
+ */
+
+#include "KX_FramePacer.h"
+
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+#include "BLI_math_base.h"
+
+#include "CM_Clock.h"
+
+/// Bounds of the spin margin, the lower bound covers the sleep call itself.
+static const double minSpinMargin = 0.25e-3;
+static const double maxSpinMargin = 4.0e-3;
+/// Margin before the first calibration, the usual scheduler granularity.
+static const double defaultSpinMargin = 1.0e-3;
+/// Weight of a new oversleep measure in the exponential averages.
+static const double oversleepWeight = 0.1;
+/// Number of waits of a statistics window.
+static const unsigned int statsWindow = 60;
+
+KX_FramePacer::KX_FramePacer(const CM_Clock &clock)
+    : m_clock(clock),
+      m_policy(POLICY_LOW_LATENCY),
+      m_oversleepMean(defaultSpinMargin),
+      m_oversleepVariance(0.0),
+      m_jitterSum(0.0),
+      m_jitterSquareSum(0.0),
+      m_jitterMax(0.0),
+      m_sleepSum(0.0),
+      m_spinSum(0.0),
+      m_count(0)
+{
+  m_stats.spinMargin = GetSpinMargin();
+}
+
+KX_FramePacer::Policy KX_FramePacer::GetPolicy() const
+{
+  return m_policy;
+}
+
+void KX_FramePacer::SetPolicy(Policy policy)
+{
+  m_policy = policy;
+}
+
+double KX_FramePacer::GetSpinMargin() const
+{
+  // Most of the oversleeps are covered by three deviations.
+  const double margin = m_oversleepMean + 3.0 * std::sqrt(m_oversleepVariance);
+  return min_dd(max_dd(margin, minSpinMargin), maxSpinMargin);
+}
+
+void KX_FramePacer::Sleep(double duration)
+{
+  const double start = m_clock.GetTimeSecond();
+  std::this_thread::sleep_for(std::chrono::nanoseconds((long long)(duration * 1.0e9)));
+  const double oversleep = m_clock.GetTimeSecond() - start - duration;
+
+  // Calibrate the spin margin on the measured scheduler latency.
+  const double delta = oversleep - m_oversleepMean;
+  m_oversleepMean += oversleepWeight * delta;
+  m_oversleepVariance = (1.0 - oversleepWeight) *
+                        (m_oversleepVariance + oversleepWeight * delta * delta);
+}
+
+void KX_FramePacer::Wait(double deadline)
+{
+  if (m_policy == POLICY_NONE) {
+    return;
+  }
+
+  const double start = m_clock.GetTimeSecond();
+  if (start >= deadline) {
+    return;
+  }
+
+  const double sleepEnd = (m_policy == POLICY_LOW_CPU) ? deadline : deadline - GetSpinMargin();
+  double time = start;
+  // A sleep can end early on some platforms, sleep again for the remaining time.
+  while (sleepEnd - time > 0.0) {
+    Sleep(sleepEnd - time);
+    time = m_clock.GetTimeSecond();
+  }
+
+  const double spinStart = time;
+  while (time < deadline) {
+    time = m_clock.GetTimeSecond();
+  }
+
+  AddMeasure(time - deadline, spinStart - start, time - spinStart);
+}
+
+void KX_FramePacer::AddMeasure(double jitter, double sleep, double spin)
+{
+  m_jitterSum += jitter;
+  m_jitterSquareSum += jitter * jitter;
+  m_jitterMax = max_dd(m_jitterMax, jitter);
+  m_sleepSum += sleep;
+  m_spinSum += spin;
+
+  if (++m_count < statsWindow) {
+    return;
+  }
+
+  const double mean = m_jitterSum / m_count;
+  m_stats.jitterMean = mean;
+  m_stats.jitterMax = m_jitterMax;
+  m_stats.jitterDeviation = std::sqrt(max_dd(m_jitterSquareSum / m_count - mean * mean, 0.0));
+  m_stats.sleepMean = m_sleepSum / m_count;
+  m_stats.spinMean = m_spinSum / m_count;
+  m_stats.spinMargin = GetSpinMargin();
+
+  m_jitterSum = 0.0;
+  m_jitterSquareSum = 0.0;
+  m_jitterMax = 0.0;
+  m_sleepSum = 0.0;
+  m_spinSum = 0.0;
+  m_count = 0;
+}
+
+const KX_FramePacer::Stats &KX_FramePacer::GetStats() const
+{
+  return m_stats;
+}
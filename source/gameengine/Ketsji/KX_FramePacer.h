@@ -0,0 +1,91 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file KX_FramePacer.h
+ *  \ingroup ketsji
+ */
+
+#pragma once
+
+class CM_Clock;
+
+/** Wait for the next fixed framerate frame without polling the clock at full CPU.
+ * The thread sleeps until a margin before the deadline and spins the remaining time, the
+ * margin is calibrated from the measured oversleep of the OS. The delay between the deadline
+ * and the wake up is measured as the pacing jitter.
+ */
+class KX_FramePacer {
+ public:
+  enum Policy {
+    /// Return immediately, the main loop polls the clock.
+    POLICY_NONE = 0,
+    /// Sleep until the calibrated margin before the deadline, then spin.
+    POLICY_LOW_LATENCY,
+    /// Only sleep, the wake up can be late by the OS scheduling latency.
+    POLICY_LOW_CPU
+  };
+
+  /// Statistics of the last measurement window, in seconds.
+  struct Stats {
+    double jitterMean = 0.0;
+    double jitterMax = 0.0;
+    double jitterDeviation = 0.0;
+    /// Average time spent in sleep and spin per wait.
+    double sleepMean = 0.0;
+    double spinMean = 0.0;
+    /// Spin margin used at the end of the window.
+    double spinMargin = 0.0;
+  };
+
+ private:
+  const CM_Clock &m_clock;
+  Policy m_policy;
+
+  /// Exponential average and variance of the OS oversleep.
+  double m_oversleepMean;
+  double m_oversleepVariance;
+
+  /// Accumulation of the current measurement window.
+  double m_jitterSum;
+  double m_jitterSquareSum;
+  double m_jitterMax;
+  double m_sleepSum;
+  double m_spinSum;
+  unsigned int m_count;
+
+  Stats m_stats;
+
+  void Sleep(double duration);
+  void AddMeasure(double jitter, double sleep, double spin);
+
+ public:
+  KX_FramePacer(const CM_Clock &clock);
+
+  Policy GetPolicy() const;
+  void SetPolicy(Policy policy);
+
+  /// Margin before the deadline where the thread stops sleeping and spins.
+  double GetSpinMargin() const;
+
+  /// Wait until the clock reaches the deadline, in seconds.
+  void Wait(double deadline);
+
+  const Stats &GetStats() const;
+};
@@ -49,6 +49,7 @@
 #include "BL_Action.h"
 #include "BL_ActionManager.h"
 #include "BL_SceneConverter.h"
+#include "KX_ActivityCullingManager.h"
 #include "KX_ClientObjectInfo.h"
 #include "KX_CollisionContactPoints.h"
 #include "KX_Globals.h"
@@ -89,12 +90,14 @@ KX_GameObject::KX_GameObject()
       m_layer(0),
       m_lodManager(nullptr),
       m_currentLodLevel(0),
+      m_lodSelectorIndex(-1),
       m_pBlenderObject(nullptr),
       m_pBlenderGroupObject(nullptr),
       m_bIsNegativeScaling(false),
       m_objectColor(1.0f, 1.0f, 1.0f, 1.0f),
       m_bVisible(true),
       m_bOccluder(false),
+      m_activityCullingIndex(-1),
       m_pPhysicsController(nullptr),
       m_pSGNode(nullptr),
       m_pInstanceObjects(nullptr),
@@ -570,6 +573,7 @@ KX_GameObject::ActivityCullingInfo &KX_GameObject::GetActivityCullingInfo()
 void KX_GameObject::SetActivityCullingInfo(const ActivityCullingInfo &cullingInfo)
 {
   m_activityCullingInfo = cullingInfo;
+  ActivityCullingChanged();
 }
 
 void KX_GameObject::SetActivityCulling(ActivityCullingInfo::Flag flag, bool enable)
@@ -590,6 +594,26 @@ void KX_GameObject::SetActivityCulling(ActivityCullingInfo::Flag flag, bool enab
       RestoreLogicAndActions(false);
     }
   }
+
+  ActivityCullingChanged();
+}
+
+void KX_GameObject::ActivityCullingChanged()
+{
+  // The index is only valid when the object is in a scene object list.
+  if (m_activityCullingIndex != -1) {
+    GetScene()->GetActivityCullingManager()->ObjectChanged(this);
+  }
+}
+
+int KX_GameObject::GetActivityCullingIndex() const
+{
+  return m_activityCullingIndex;
+}
+
+void KX_GameObject::SetActivityCullingIndex(int index)
+{
+  m_activityCullingIndex = index;
 }
 
 void KX_GameObject::AddDummyLodManager(RAS_MeshObject *meshObj, Object *ob)
@@ -913,6 +937,8 @@ void KX_GameObject::ProcessReplica()
   ReplicateBlenderObject();
   GetScene()->GetBlenderSceneConverter()->RegisterGameObject(this, m_pBlenderObject);
 
+  // The replica isn't registered in the lod selector of the original.
+  m_lodSelectorIndex = -1;
   if (m_lodManager) {
     m_lodManager->AddRef();
     GetScene()->AddObjToLodObjList(this);
@@ -920,6 +946,7 @@ void KX_GameObject::ProcessReplica()
 
   m_pPhysicsController = nullptr;
   m_pSGNode = nullptr;
+  m_activityCullingIndex = -1;
 
   /* Dupli group and instance list are set later in replication.
    * See KX_Scene::DupliGroupRecurse. */
@@ -1124,30 +1151,20 @@ KX_LodManager *KX_GameObject::GetLodManager() const
   return m_lodManager;
 }
 
-void KX_GameObject::UpdateLod(const MT_Vector3 &cam_pos, float lodfactor)
+short KX_GameObject::GetCurrentLodLevel() const
+{
+  return m_currentLodLevel;
+}
+
+void KX_GameObject::UpdateLod(float distance2)
 {
   if (!m_lodManager) {
     return;
   }
 
   KX_Scene *scene = GetScene();
-  const float distance2 = NodeGetWorldPosition().distance2(cam_pos) * (lodfactor * lodfactor);
   KX_LodLevel *lodLevel = m_lodManager->GetLevel(scene, m_currentLodLevel, distance2);
 
-  bool updatePhysicsShape = false;
-  if (GetBlenderObject()->gameflag & OB_LOD_UPDATE_PHYSICS) {
-    if (GetPhysicsController()) {
-      /* As m_previousLodLevel is initialized to -1,
-       * the physics shape will be ensured on first frame
-       * to match the lodLevel or the absence of lodLevel
-       */
-      if (m_currentLodLevel != m_previousLodLevel) {
-        updatePhysicsShape = true;
-        m_previousLodLevel = m_currentLodLevel;
-      }
-    }
-  }
-
   if (lodLevel) {
     RAS_MeshObject *mesh = lodLevel->GetMesh();
     if (mesh != m_meshes[0]) {
@@ -1156,12 +1173,27 @@ void KX_GameObject::UpdateLod(const MT_Vector3 &cam_pos, float lodfactor)
     m_currentLodLevel = lodLevel->GetLevel();
   }
 
+  if (GetBlenderObject()->gameflag & OB_LOD_UPDATE_PHYSICS) {
+    /* As m_previousLodLevel is initialized to -1,
+     * the physics shape will be ensured on first update
+     * to match the lodLevel or the absence of lodLevel
+     */
+    if (GetPhysicsController() && m_currentLodLevel != m_previousLodLevel) {
+      m_previousLodLevel = m_currentLodLevel;
+      GetPhysicsController()->ReinstancePhysicsShape(this, nullptr, false, true);
+    }
+  }
+}
+
+void KX_GameObject::UpdateLodObject(Depsgraph *depsgraph)
+{
+  if (!m_lodManager) {
+    return;
+  }
+
   KX_LodLevel *currentLodLevel = m_lodManager->GetLevel(m_currentLodLevel);
 
   if (currentLodLevel) {
-    bContext *C = KX_GetActiveEngine()->GetContext();
-    Depsgraph *depsgraph = CTX_data_expect_evaluated_depsgraph(C);
-
     /* Here we want to change the object which will be rendered, then the evaluated object by the
      * depsgraph */
     Object *ob_eval = DEG_get_evaluated_object(depsgraph, GetBlenderObject());
@@ -1170,33 +1202,16 @@ void KX_GameObject::UpdateLod(const MT_Vector3 &cam_pos, float lodfactor)
     /* Try to get the object with all modifiers applied */
     ob_eval->data = eval_lod_ob->data;
   }
-
-  if (updatePhysicsShape) {
-    GetPhysicsController()->ReinstancePhysicsShape(this, nullptr, false, true);
-  }
 }
 
-void KX_GameObject::UpdateActivity(float distance)
+int KX_GameObject::GetLodSelectorIndex() const
 {
-  // Manage physics culling.
-  if (m_activityCullingInfo.m_flags & ActivityCullingInfo::ACTIVITY_PHYSICS) {
-    if (distance > m_activityCullingInfo.m_physicsRadius) {
-      SuspendPhysics(false, false);
-    }
-    else {
-      RestorePhysics(false);
-    }
-  }
+  return m_lodSelectorIndex;
+}
 
-  // Manage logic culling.
-  if (m_activityCullingInfo.m_flags & ActivityCullingInfo::ACTIVITY_LOGIC) {
-    if (distance > m_activityCullingInfo.m_logicRadius) {
-      SuspendLogicAndActions(false);
-    }
-    else {
-      RestoreLogicAndActions(false);
-    }
-  }
+void KX_GameObject::SetLodSelectorIndex(int index)
+{
+  m_lodSelectorIndex = index;
 }
 
 void KX_GameObject::UpdateTransform()
@@ -1208,7 +1223,16 @@ void KX_GameObject::UpdateTransform()
 
 void KX_GameObject::UpdateTransformFunc(SG_Node *node, void *gameobj, void *scene)
 {
-  ((KX_GameObject *)gameobj)->UpdateTransform();
+  KX_GameObject *obj = (KX_GameObject *)gameobj;
+  obj->UpdateTransform();
+
+  // Keep the activity culling positions up to date only for moved objects.
+  if (obj->m_activityCullingIndex != -1) {
+    ((KX_Scene *)scene)->GetActivityCullingManager()->ObjectMoved(obj, node->GetWorldPosition());
+  }
+  if (obj->m_lodSelectorIndex != -1) {
+    ((KX_Scene *)scene)->GetLodSelector()->ObjectMoved(obj);
+  }
 }
 
 void KX_GameObject::SynchronizeTransform()
@@ -2724,6 +2748,7 @@ int KX_GameObject::pyattr_set_name(EXP_PyObjectPlus *self_v,
 
   // Change the name
   self->SetName(newname);
+  self->GetScene()->UpdateObjectName(self, oldname);
 
   return PY_SET_ATTR_SUCCESS;
 }
@@ -3238,6 +3263,7 @@ int KX_GameObject::pyattr_set_physicsCullingRadius(EXP_PyObjectPlus *self_v,
   }
 
   self->GetActivityCullingInfo().m_physicsRadius = val * val;
+  self->ActivityCullingChanged();
 
   return PY_SET_ATTR_SUCCESS;
 }
@@ -3263,6 +3289,7 @@ int KX_GameObject::pyattr_set_logicCullingRadius(EXP_PyObjectPlus *self_v,
   }
 
   self->GetActivityCullingInfo().m_logicRadius = val * val;
+  self->ActivityCullingChanged();
 
   return PY_SET_ATTR_SUCCESS;
 }
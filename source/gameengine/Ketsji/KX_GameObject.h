@@ -63,6 +63,7 @@ struct Object;
 class KX_CollisionContactPointList;
 struct bAction;
 
+struct Depsgraph;
 struct Mesh;
 
 #ifdef WITH_PYTHON
@@ -117,6 +118,8 @@ class KX_GameObject : public SCA_IObject {
   std::vector<RAS_MeshObject *> m_meshes;
   KX_LodManager *m_lodManager;
   short m_currentLodLevel;
+  /// Index in the scene lod selector, -1 if not registered.
+  int m_lodSelectorIndex;
   struct Object *m_pBlenderObject;
   struct Object *m_pBlenderGroupObject;
 
@@ -130,6 +133,8 @@ class KX_GameObject : public SCA_IObject {
 
   // Object activity culling settings converted from blender objects.
   ActivityCullingInfo m_activityCullingInfo;
+  /// Index of the object in the scene activity culling manager, -1 if not managed.
+  int m_activityCullingIndex;
 
   PHY_IPhysicsController *m_pPhysicsController;
   SG_Node *m_pSGNode;
@@ -652,15 +657,20 @@ class KX_GameObject : public SCA_IObject {
   /// Get current lod manager.
   KX_LodManager *GetLodManager() const;
 
-  /**
-   * Updates the current lod level based on distance from camera.
-   */
-  void UpdateLod(const MT_Vector3 &cam_pos, float lodfactor);
+  /// Get the current lod level index.
+  short GetCurrentLodLevel() const;
 
-  /** Update the activity culling of the object.
-   * \param distance Squared nearest distance to the cameras of this object.
+  /** Updates the current lod level based on distance from camera.
+   * \param distance2 Squared distance to the camera, scaled by the camera and the lod metric.
    */
-  void UpdateActivity(float distance);
+  void UpdateLod(float distance2);
+  /** Render the evaluated object of the current lod level, the evaluated object is restored by
+   * each depsgraph update.
+   */
+  void UpdateLodObject(Depsgraph *depsgraph);
+
+  int GetLodSelectorIndex() const;
+  void SetLodSelectorIndex(int index);
 
   /**
    * Pick out a mesh associated with the integer 'num'.
@@ -729,6 +739,10 @@ class KX_GameObject : public SCA_IObject {
   void SetActivityCullingInfo(const ActivityCullingInfo &cullingInfo);
   /// Enable or disable a category of object activity culling.
   void SetActivityCulling(ActivityCullingInfo::Flag flag, bool enable);
+  /// Notify the scene activity culling manager that the culling settings changed.
+  void ActivityCullingChanged();
+  int GetActivityCullingIndex() const;
+  void SetActivityCullingIndex(int index);
 
   /**
    * \section Logic bubbling methods.
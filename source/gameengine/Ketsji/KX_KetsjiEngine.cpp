@@ -36,6 +36,8 @@
 
 #include "KX_KetsjiEngine.h"
 
+#include <cmath>
+
 #include <boost/format.hpp>
 
 #include "BLI_rect.h"
@@ -47,7 +49,9 @@
 
 #include "BL_Converter.h"
 #include "BL_SceneConverter.h"
+#include "CM_Logger.h"
 #include "DEV_Joystick.h"  // for DEV_Joystick::HandleEvents
+#include "KX_ActivityCullingManager.h"
 #include "KX_Camera.h"
 #include "KX_Globals.h"
 #include "KX_NetworkMessageScene.h"
@@ -114,7 +118,8 @@ const std::string KX_KetsjiEngine::m_profileLabels[tc_numCategories] = {
     "Services:",    // tc_services
     "Overhead:",    // tc_overhead
     "Outside:",     // tc_outside
-    "GPU Latency:"  // tc_latency
+    "GPU Latency:",  // tc_latency
+    "Pacing:"        // tc_pacing
 };
 
 /**
@@ -132,6 +137,7 @@ KX_KetsjiEngine::KX_KetsjiEngine(KX_ISystem *system,
       m_kxsystem(system),
       m_converter(nullptr),
       m_inputDevice(nullptr),
+      m_framePacer(m_clock),
       m_bInitialized(false),
       m_flags(AUTO_ADD_DEBUG_PROPERTIES),
       m_frameTime(0.0f),
@@ -144,6 +150,8 @@ KX_KetsjiEngine::KX_KetsjiEngine(KX_ISystem *system,
       m_maxLogicFrame(5),
       m_maxPhysicsFrame(5),
       m_ticrate(DEFAULT_LOGIC_TIC_RATE),
+      m_physicsTicrate(0.0),
+      m_physicsTime(0.0),
       m_anim_framerate(25.0),
       m_doRender(true),
       m_exitkey(130),
@@ -247,6 +255,27 @@ PyObject *KX_KetsjiEngine::GetPyProfileDict()
   Py_INCREF(m_pyprofiledict);
   return m_pyprofiledict;
 }
+
+void KX_KetsjiEngine::UpdatePyProfilePacing()
+{
+  const KX_FramePacer::Stats &stats = m_framePacer.GetStats();
+
+  PyObject *pacing = PyDict_New();
+  const std::pair<const char *, double> items[] = {{"jitter_mean", stats.jitterMean},
+                                                   {"jitter_max", stats.jitterMax},
+                                                   {"jitter_deviation", stats.jitterDeviation},
+                                                   {"sleep_mean", stats.sleepMean},
+                                                   {"spin_mean", stats.spinMean},
+                                                   {"spin_margin", stats.spinMargin}};
+  for (const std::pair<const char *, double> &item : items) {
+    PyObject *val = PyFloat_FromDouble(item.second * 1000.0);
+    PyDict_SetItemString(pacing, item.first, val);
+    Py_DECREF(val);
+  }
+
+  PyDict_SetItemString(m_pyprofiledict, "Frame Pacing", pacing);
+  Py_DECREF(pacing);
+}
 #endif
 
 void KX_KetsjiEngine::SetConverter(BL_Converter *converter)
@@ -294,6 +323,7 @@ void KX_KetsjiEngine::EndFrame()
     PyDict_SetItemString(m_pyprofiledict, m_profileLabels[i].c_str(), val);
     Py_DECREF(val);
   }
+  UpdatePyProfilePacing();
 #endif
 
   m_average_framerate = 1.0 / tottime;
@@ -339,6 +369,7 @@ void KX_KetsjiEngine::EndFrameViewportRender()
     PyDict_SetItemString(m_pyprofiledict, m_profileLabels[i].c_str(), val);
     Py_DECREF(val);
   }
+  UpdatePyProfilePacing();
 #endif
 
   m_average_framerate = 1.0 / tottime;
@@ -435,7 +466,9 @@ KX_KetsjiEngine::FrameTimes KX_KetsjiEngine::GetFrameTimes()
   }
 
   // Fix timestep to not exceed max physics and logic frames.
-  int maxFrames = max_ii(m_maxLogicFrame, m_maxPhysicsFrame);
+  // When the physics runs at its own rate its steps are limited separately in NextFrame.
+  int maxFrames = (m_physicsTicrate > 0.0) ? m_maxLogicFrame :
+                                             max_ii(m_maxLogicFrame, m_maxPhysicsFrame);
   if (frames > maxFrames) {
     timestep = dt / maxFrames;
     frames = maxFrames;
@@ -445,16 +478,6 @@ KX_KetsjiEngine::FrameTimes KX_KetsjiEngine::GetFrameTimes()
   if (frames > 0) {
     m_previousRealTime = m_clockTime;
   }
-  //// Else in case of fixed framerate, try to sleep until the next frame.
-  // else if (m_flags & FIXED_FRAMERATE) {
-  //  const double sleeptime = timestep - dt - 1.0e-3;
-  //  /* If the remaining time is greather than 1ms (sleep resolution) sleep this thread.
-  //   * The other 1ms will be busy wait.
-  //   */
-  //  if (sleeptime > 0.0) {
-  //    std::this_thread::sleep_for(std::chrono::nanoseconds((long)(sleeptime * 1.0e9)));
-  //  }
-  //}
 
   // Frame time with time scale.
   const double framestep = timestep * m_timescale;
@@ -475,17 +498,55 @@ bool KX_KetsjiEngine::NextFrame()
 
   // Exit if zero frame is sheduled.
   if (times.frames == 0) {
+    /* In fixed framerate wait until the next frame is due, else the main loop
+     * would poll the clock at full CPU. */
+    if ((m_flags & FIXED_FRAMERATE) && !(m_flags & USE_EXTERNAL_CLOCK)) {
+      m_logger.StartLog(tc_pacing);
+      m_framePacer.Wait(m_previousRealTime + 1.0 / m_ticrate);
+    }
+
     // Start logging time spent outside main loop
     m_logger.StartLog(tc_outside);
 
     return false;
   }
 
+  const bool physicsDecoupled = (m_physicsTicrate > 0.0);
+  const double physicsStep = physicsDecoupled ? 1.0 / m_physicsTicrate : 0.0;
+
+  if (physicsDecoupled) {
+    // The logic must see the physics state and not the rendered interpolation.
+    m_logger.StartLog(tc_physics);
+    for (KX_Scene *scene : m_scenes) {
+      scene->GetPhysicsEnvironment()->RestoreMotionStates();
+    }
+    m_logger.StartLog(tc_scenegraph);
+    for (KX_Scene *scene : m_scenes) {
+      scene->UpdateParents(m_frameTime);
+    }
+    m_logger.StartLog(tc_services);
+  }
+
   for (unsigned short i = 0; i < times.frames; ++i) {
     m_frameTime += times.framestep;
 
+    // Number of fixed physics steps to proceed after this logic frame.
+    int physicsSteps = 0;
+    if (physicsDecoupled) {
+      m_physicsTime += times.framestep;
+      while (m_physicsTime >= physicsStep && physicsSteps < m_maxPhysicsFrame) {
+        m_physicsTime -= physicsStep;
+        ++physicsSteps;
+      }
+      // Drop the time the physics can't catch up instead of accumulating a delay.
+      if (m_physicsTime >= physicsStep) {
+        m_physicsTime = std::fmod(m_physicsTime, physicsStep);
+      }
+    }
+
     m_converter->MergeAsyncLoads();
 
+    m_inputDevice->BeginLogicFrame(m_frameTime);
     m_inputDevice->ReleaseMoveEvent();
 
 #ifdef WITH_SDL
@@ -548,8 +609,15 @@ bool KX_KetsjiEngine::NextFrame()
 
       // Perform physics calculations on the scene. This can involve
       // many iterations of the physics solver.
-      scene->GetPhysicsEnvironment()->ProceedDeltaTime(
-          m_frameTime, times.timestep, times.framestep);  // m_deltatimerealDeltaTime);
+      if (physicsDecoupled) {
+        for (int j = 0; j < physicsSteps; ++j) {
+          scene->GetPhysicsEnvironment()->ProceedDeltaTime(m_frameTime, physicsStep, physicsStep);
+        }
+      }
+      else {
+        scene->GetPhysicsEnvironment()->ProceedDeltaTime(
+            m_frameTime, times.timestep, times.framestep);  // m_deltatimerealDeltaTime);
+      }
 
       /* No need to call sofbody update more than 1 time */
       if (i == times.frames - 1) {
@@ -573,6 +641,19 @@ bool KX_KetsjiEngine::NextFrame()
     ProcessScheduledScenes();
   }
 
+  if (physicsDecoupled) {
+    // Render the dynamic objects at the game time between the two last physics steps.
+    const float alpha = m_physicsTime / physicsStep;
+    m_logger.StartLog(tc_physics);
+    for (KX_Scene *scene : m_scenes) {
+      scene->GetPhysicsEnvironment()->InterpolateMotionStates(alpha);
+    }
+    m_logger.StartLog(tc_scenegraph);
+    for (KX_Scene *scene : m_scenes) {
+      scene->UpdateParents(m_frameTime);
+    }
+  }
+
   // Start logging time spent outside main loop
   m_logger.StartLog(tc_outside);
 
@@ -1155,6 +1236,9 @@ void KX_KetsjiEngine::StopEngine()
     // cleanup all the stuff
     m_rasterizer->Exit();
   }
+
+  // Print the pending messages before leaving the game.
+  CM_Logger::Get().Flush();
 }
 
 // Scene Management is able to switch between scenes
@@ -1207,6 +1291,7 @@ void KX_KetsjiEngine::PostProcessScene(KX_Scene *scene)
     scene->GetCameraList()->Add(CM_AddRef(activecam));
     scene->SetActiveCamera(activecam);
     scene->GetObjectList()->Add(CM_AddRef(activecam));
+    scene->GetActivityCullingManager()->RegisterObject(activecam);
     scene->GetRootParentList()->Add(CM_AddRef(activecam));
     // done with activecam
     activecam->Release();
@@ -1495,6 +1580,23 @@ void KX_KetsjiEngine::SetTicRate(double ticrate)
   m_ticrate = ticrate;
 }
 
+double KX_KetsjiEngine::GetPhysicsTicRate() const
+{
+  return m_physicsTicrate;
+}
+
+void KX_KetsjiEngine::SetPhysicsTicRate(double ticrate)
+{
+  m_physicsTicrate = max_dd(ticrate, 0.0);
+  m_physicsTime = 0.0;
+
+  // Don't keep the interpolated transforms if the physics now follows the logic.
+  for (KX_Scene *scene : m_scenes) {
+    scene->GetPhysicsEnvironment()->RestoreMotionStates();
+    scene->UpdateParents(m_frameTime);
+  }
+}
+
 double KX_KetsjiEngine::GetTimeScale() const
 {
   return m_timescale;
@@ -1525,6 +1627,16 @@ void KX_KetsjiEngine::SetMaxPhysicsFrame(int frame)
   m_maxPhysicsFrame = frame;
 }
 
+KX_FramePacer::Policy KX_KetsjiEngine::GetFramePacing() const
+{
+  return m_framePacer.GetPolicy();
+}
+
+void KX_KetsjiEngine::SetFramePacing(KX_FramePacer::Policy policy)
+{
+  m_framePacer.SetPolicy(policy);
+}
+
 double KX_KetsjiEngine::GetAnimFrameRate()
 {
   return m_anim_framerate;
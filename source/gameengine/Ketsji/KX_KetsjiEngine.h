@@ -37,6 +37,7 @@
 
 #include "CM_Clock.h"
 #include "EXP_Python.h"
+#include "KX_FramePacer.h"
 #include "KX_ISystem.h"
 #include "KX_Scene.h"
 #include "KX_TimeCategoryLogger.h"
@@ -155,6 +156,8 @@ class KX_KetsjiEngine {
   };
 
   CM_Clock m_clock;
+  /// Wait for the next frame in fixed framerate.
+  KX_FramePacer m_framePacer;
 
   /// Lists of scenes scheduled to be removed at the end of the frame.
   std::vector<std::string> m_removingScenes;
@@ -189,6 +192,10 @@ class KX_KetsjiEngine {
   /// maximum number of consecutive physics frame
   int m_maxPhysicsFrame;
   double m_ticrate;
+  /// Number of physics updates per second, 0 to update the physics at each logic frame.
+  double m_physicsTicrate;
+  /// Game time not yet simulated by the physics when running at its own rate.
+  double m_physicsTime;
   /// for animation playback only - ipo and action
   double m_anim_framerate;
 
@@ -223,6 +230,7 @@ class KX_KetsjiEngine {
     tc_overhead,  // profile info drawing overhead
     tc_outside,   // time spent outside main loop
     tc_latency,   // time spent waiting on the gpu
+    tc_pacing,    // time spent waiting for the next frame
     tc_numCategories
   } KX_TimeCategory;
 
@@ -264,6 +272,10 @@ class KX_KetsjiEngine {
   /// EEVEE scene rendering
   void RenderCamera(KX_Scene *scene, class RAS_FrameBuffer *background_fb, const CameraRenderData &cameraFrameData, unsigned short pass);
   void RenderDebugProperties();
+#ifdef WITH_PYTHON
+  /// Store the frame pacing statistics in the profile dictionary.
+  void UpdatePyProfilePacing();
+#endif
   /// Debug draw cameras frustum of a scene.
   void DrawDebugCameraFrustum(KX_Scene *scene,
                               RAS_DebugDraw &debugDraw,
@@ -417,6 +429,16 @@ class KX_KetsjiEngine {
    * Sets the number of logic updates per second.
    */
   void SetTicRate(double ticrate);
+  /**
+   * Gets the number of physics updates per second, 0 if the physics follows the logic.
+   */
+  double GetPhysicsTicRate() const;
+  /**
+   * Sets the number of physics updates per second, 0 to update the physics at each logic frame.
+   * Otherwise the physics runs with a fixed time step and the dynamic objects are rendered
+   * interpolated between the two last physics steps.
+   */
+  void SetPhysicsTicRate(double ticrate);
   /**
    * Gets the maximum number of logic frame before render frame
    */
@@ -433,6 +455,14 @@ class KX_KetsjiEngine {
    * Sets the maximum number of physics frame before render frame
    */
   void SetMaxPhysicsFrame(int frame);
+  /**
+   * Gets the policy used to wait for the next frame in fixed framerate.
+   */
+  KX_FramePacer::Policy GetFramePacing() const;
+  /**
+   * Sets the policy used to wait for the next frame in fixed framerate.
+   */
+  void SetFramePacing(KX_FramePacer::Policy policy);
 
   /**
    * Gets the framerate for playing animations. (actions and ipos)
@@ -26,6 +26,8 @@
 
 #include "KX_LodManager.h"
 
+#include <cfloat>
+
 #include "BLI_listbase.h"
 #include "BLI_math_vector.h"
 #include "DNA_object_types.h"
@@ -86,14 +88,30 @@ inline bool KX_LodManager::LodLevelIterator::operator<=(float distance2) const
     return false;
   }
 
-  return square_f(m_levels[m_index + 1]->GetDistance() + GetHysteresis(m_index + 1)) <= distance2;
+  return GetMaxDistance2() <= distance2;
 }
 
 inline bool KX_LodManager::LodLevelIterator::operator>(float distance2) const
 {
-  return square_f(m_levels[m_index]->GetDistance() - GetHysteresis(m_index)) > distance2;
+  return GetMinDistance2() > distance2;
+}
+
+inline float KX_LodManager::LodLevelIterator::GetMinDistance2() const
+{
+  return square_f(m_levels[m_index]->GetDistance() - GetHysteresis(m_index));
+}
+
+inline float KX_LodManager::LodLevelIterator::GetMaxDistance2() const
+{
+  if (m_index == (m_levels.size() - 1)) {
+    return FLT_MAX;
+  }
+
+  return square_f(m_levels[m_index + 1]->GetDistance() + GetHysteresis(m_index + 1));
 }
 
+unsigned int KX_LodManager::m_settingsRevision = 0;
+
 KX_LodManager::KX_LodManager(Object *ob,
                              KX_Scene *scene,
                              RAS_Rasterizer *rasty,
@@ -194,6 +212,30 @@ KX_LodLevel *KX_LodManager::GetLevel(KX_Scene *scene, short previouslod, float d
   return (level == previouslod) ? nullptr : m_levels[level];
 }
 
+void KX_LodManager::GetLevelRange(KX_Scene *scene, short level, float &min2, float &max2) const
+{
+  // A single level or an invalid level is never left by GetLevel.
+  if (m_levels.size() == 1 || level < 0 || level >= (short)m_levels.size()) {
+    min2 = -FLT_MAX;
+    max2 = FLT_MAX;
+    return;
+  }
+
+  const LodLevelIterator it(m_levels, level, scene);
+  min2 = it.GetMinDistance2();
+  max2 = it.GetMaxDistance2();
+}
+
+float KX_LodManager::GetDistanceFactor() const
+{
+  return m_distanceFactor;
+}
+
+unsigned int KX_LodManager::GetSettingsRevision()
+{
+  return m_settingsRevision;
+}
+
 #ifdef WITH_PYTHON
 
 PyTypeObject KX_LodManager::Type = {PyVarObject_HEAD_INIT(nullptr, 0) "KX_LodManager",
@@ -240,7 +282,10 @@ PyMethodDef KX_LodManager::Methods[] = {
 
 PyAttributeDef KX_LodManager::Attributes[] = {
     EXP_PYATTRIBUTE_RO_FUNCTION("levels", KX_LodManager, pyattr_get_levels),
-    EXP_PYATTRIBUTE_FLOAT_RW("distanceFactor", 0.0f, FLT_MAX, KX_LodManager, m_distanceFactor),
+    EXP_PYATTRIBUTE_RW_FUNCTION("distanceFactor",
+                                KX_LodManager,
+                                pyattr_get_distanceFactor,
+                                pyattr_set_distanceFactor),
     EXP_PYATTRIBUTE_NULL};
 
 static int kx_lod_manager_get_levels_size_cb(void *self_v)
@@ -266,6 +311,36 @@ PyObject *KX_LodManager::pyattr_get_levels(EXP_PyObjectPlus *self_v,
       ->NewProxy(true);
 }
 
+PyObject *KX_LodManager::pyattr_get_distanceFactor(EXP_PyObjectPlus *self_v,
+                                                   const EXP_PYATTRIBUTE_DEF *attrdef)
+{
+  return PyFloat_FromDouble(((KX_LodManager *)self_v)->m_distanceFactor);
+}
+
+int KX_LodManager::pyattr_set_distanceFactor(EXP_PyObjectPlus *self_v,
+                                             const EXP_PYATTRIBUTE_DEF *attrdef,
+                                             PyObject *value)
+{
+  KX_LodManager *self = static_cast<KX_LodManager *>(self_v);
+  const float factor = PyFloat_AsDouble(value);
+  if (factor == -1.0f && PyErr_Occurred()) {
+    PyErr_SetString(PyExc_TypeError,
+                    "lodManager.distanceFactor = float: KX_LodManager, expected a float");
+    return PY_SET_ATTR_FAIL;
+  }
+  if (factor < 0.0f) {
+    PyErr_SetString(PyExc_ValueError,
+                    "lodManager.distanceFactor = float: KX_LodManager, expected a positive float");
+    return PY_SET_ATTR_FAIL;
+  }
+
+  self->m_distanceFactor = factor;
+  // The lod level ranges cached by the scenes must be updated.
+  ++m_settingsRevision;
+
+  return PY_SET_ATTR_SUCCESS;
+}
+
 bool ConvertPythonToLodManager(PyObject *value,
                                KX_LodManager **object,
                                bool py_none_ok,
@@ -63,6 +63,11 @@ class KX_LodManager : public EXP_Value {
     bool operator<=(float distance2) const;
     /// Compare the current lod level distance less hysteresis with current distance.
     bool operator>(float distance2) const;
+
+    /// Squared current lod level distance less hysteresis.
+    float GetMinDistance2() const;
+    /// Squared next level distance more hysteresis, FLT_MAX for the last level.
+    float GetMaxDistance2() const;
   };
 
   std::vector<KX_LodLevel *> m_levels;
@@ -78,6 +83,9 @@ class KX_LodManager : public EXP_Value {
   /// Factor applied to the distance from the camera to the object.
   float m_distanceFactor;
 
+  /// Incremented when the distance factor of any lod manager changes.
+  static unsigned int m_settingsRevision;
+
  public:
   KX_LodManager(Object *ob,
                 KX_Scene *scene,
@@ -106,9 +114,27 @@ class KX_LodManager : public EXP_Value {
    */
   KX_LodLevel *GetLevel(KX_Scene *scene, short previouslod, float distance);
 
+  /** Get the range of squared distances keeping a lod level selected, the distance factor
+   * is not applied.
+   * \param scene Scene used to get default hysteresis.
+   * \param level The current lod level.
+   * \param min2 The lod level is left for a lower level below this squared distance.
+   * \param max2 The lod level is left for an higher level from this squared distance.
+   */
+  void GetLevelRange(KX_Scene *scene, short level, float &min2, float &max2) const;
+
+  float GetDistanceFactor() const;
+  /// Revision of the lod manager settings used by the cached lod level ranges.
+  static unsigned int GetSettingsRevision();
+
 #ifdef WITH_PYTHON
 
   static PyObject *pyattr_get_levels(EXP_PyObjectPlus *self_v, const EXP_PYATTRIBUTE_DEF *attrdef);
+  static PyObject *pyattr_get_distanceFactor(EXP_PyObjectPlus *self_v,
+                                             const EXP_PYATTRIBUTE_DEF *attrdef);
+  static int pyattr_set_distanceFactor(EXP_PyObjectPlus *self_v,
+                                       const EXP_PYATTRIBUTE_DEF *attrdef,
+                                       PyObject *value);
 
 #endif  // WITH_PYTHON
 };
@@ -0,0 +1,379 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Ketsji/KX_LodSelector.cpp
+ *  \ingroup ketsji
+ */
+
+#include "KX_LodSelector.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#include "BKE_context.h"
+#include "BLI_task.hh"
+
+#include "KX_Camera.h"
+#include "KX_Globals.h"
+#include "KX_KetsjiEngine.h"
+#include "KX_LodLevel.h"
+#include "KX_LodManager.h"
+#include "KX_Scene.h"
+
+/// Number of objects evaluated per task.
+static const int64_t evaluateGrainSize = 4096;
+/// Reference camera of the screen size metric, the default camera of Blender.
+static const float referenceLens = 50.0f;
+static const float referenceSensor = 36.0f;
+/// Smallest object scale used by the screen size metric.
+static const float minScale = 1.0e-6f;
+
+enum PendingFlag : uint8_t {
+  /// The object moved, its position and scale must be updated.
+  PENDING_MOVED = (1 << 0),
+  /// The object lod settings changed, its lod level must be selected again.
+  PENDING_EVALUATE = (1 << 1)
+};
+
+KX_LodSelector::KX_LodSelector()
+    : m_metric(METRIC_DISTANCE),
+      m_camera(nullptr),
+      m_cameraPosition(0.0f, 0.0f, 0.0f),
+      m_distanceScale(0.0f),
+      m_distanceOffset(0.0f),
+      m_settingsRevision(KX_LodManager::GetSettingsRevision()),
+      m_invalid(false)
+{
+}
+
+KX_LodSelector::~KX_LodSelector()
+{
+  for (KX_GameObject *gameobj : m_objects) {
+    gameobj->SetLodSelectorIndex(-1);
+  }
+}
+
+void KX_LodSelector::MoveIndex(int from, int to)
+{
+  m_posX[to] = m_posX[from];
+  m_posY[to] = m_posY[from];
+  m_posZ[to] = m_posZ[from];
+  m_invScale2[to] = m_invScale2[from];
+  m_factor2[to] = m_factor2[from];
+  m_min2[to] = m_min2[from];
+  m_max2[to] = m_max2[from];
+  m_distance2[to] = m_distance2[from];
+  m_changed[to] = m_changed[from];
+  m_pending[to] = m_pending[from];
+  m_replaceObject[to] = m_replaceObject[from];
+  m_objects[to] = m_objects[from];
+
+  if (m_pending[to]) {
+    m_pendingList.push_back(to);
+  }
+
+  m_objects[to]->SetLodSelectorIndex(to);
+}
+
+void KX_LodSelector::SetPending(int index, uint8_t flag)
+{
+  if (!m_pending[index]) {
+    m_pendingList.push_back(index);
+  }
+  m_pending[index] |= flag;
+}
+
+void KX_LodSelector::UpdateObject(int index)
+{
+  KX_GameObject *gameobj = m_objects[index];
+
+  const MT_Vector3 &position = gameobj->NodeGetWorldPosition();
+  m_posX[index] = position.x();
+  m_posY[index] = position.y();
+  m_posZ[index] = position.z();
+
+  if (m_metric == METRIC_SCREEN_SIZE) {
+    const MT_Vector3 &scale = gameobj->NodeGetWorldScaling();
+    const float maxScale = std::max(
+        {std::fabs(scale.x()), std::fabs(scale.y()), std::fabs(scale.z()), minScale});
+    m_invScale2[index] = 1.0f / (maxScale * maxScale);
+  }
+  else {
+    m_invScale2[index] = 1.0f;
+  }
+}
+
+void KX_LodSelector::UpdateRange(KX_Scene *scene, int index)
+{
+  KX_GameObject *gameobj = m_objects[index];
+  KX_LodManager *lodManager = gameobj->GetLodManager();
+
+  if (!lodManager) {
+    m_factor2[index] = 1.0f;
+    m_min2[index] = -FLT_MAX;
+    m_max2[index] = FLT_MAX;
+    m_replaceObject[index] = 0;
+    return;
+  }
+
+  const float factor = lodManager->GetDistanceFactor();
+  const short level = gameobj->GetCurrentLodLevel();
+  m_factor2[index] = factor * factor;
+  lodManager->GetLevelRange(scene, level, m_min2[index], m_max2[index]);
+
+  KX_LodLevel *lodLevel = (level >= 0 && level < (short)lodManager->GetLevelCount()) ?
+                              lodManager->GetLevel(level) :
+                              nullptr;
+  m_replaceObject[index] = (lodLevel && lodLevel->GetObject() != gameobj->GetBlenderObject());
+}
+
+void KX_LodSelector::FlushPending(KX_Scene *scene)
+{
+  const int size = m_objects.size();
+  for (int index : m_pendingList) {
+    // The list can contain indices of removed objects.
+    if (index >= size) {
+      continue;
+    }
+
+    const uint8_t pending = m_pending[index];
+    // Objects are registered during the conversion before their scene graph node exists.
+    if (!pending || !m_objects[index]->GetSGNode()) {
+      continue;
+    }
+    m_pending[index] = 0;
+
+    UpdateObject(index);
+
+    if (pending & PENDING_EVALUATE) {
+      UpdateRange(scene, index);
+      // Force the selection of the lod level.
+      m_min2[index] = FLT_MAX;
+      m_max2[index] = -FLT_MAX;
+    }
+  }
+
+  // Keep the objects without scene graph node for the next update.
+  m_pendingList.erase(std::remove_if(m_pendingList.begin(),
+                                     m_pendingList.end(),
+                                     [this, size](int index) {
+                                       return index >= size || !m_pending[index];
+                                     }),
+                      m_pendingList.end());
+}
+
+void KX_LodSelector::RegisterObject(KX_GameObject *gameobj)
+{
+  int index = gameobj->GetLodSelectorIndex();
+  if (index == -1) {
+    index = m_objects.size();
+
+    m_posX.push_back(0.0f);
+    m_posY.push_back(0.0f);
+    m_posZ.push_back(0.0f);
+    m_invScale2.push_back(1.0f);
+    m_factor2.push_back(1.0f);
+    m_min2.push_back(FLT_MAX);
+    m_max2.push_back(-FLT_MAX);
+    m_distance2.push_back(0.0f);
+    m_changed.push_back(0);
+    m_pending.push_back(0);
+    m_replaceObject.push_back(0);
+    m_objects.push_back(gameobj);
+
+    gameobj->SetLodSelectorIndex(index);
+  }
+
+  SetPending(index, PENDING_MOVED | PENDING_EVALUATE);
+}
+
+void KX_LodSelector::UnregisterObject(KX_GameObject *gameobj)
+{
+  const int index = gameobj->GetLodSelectorIndex();
+  if (index == -1 || index >= (int)m_objects.size() || m_objects[index] != gameobj) {
+    return;
+  }
+
+  const int last = m_objects.size() - 1;
+  if (index != last) {
+    MoveIndex(last, index);
+  }
+
+  m_posX.pop_back();
+  m_posY.pop_back();
+  m_posZ.pop_back();
+  m_invScale2.pop_back();
+  m_factor2.pop_back();
+  m_min2.pop_back();
+  m_max2.pop_back();
+  m_distance2.pop_back();
+  m_changed.pop_back();
+  m_pending.pop_back();
+  m_replaceObject.pop_back();
+  m_objects.pop_back();
+
+  gameobj->SetLodSelectorIndex(-1);
+}
+
+void KX_LodSelector::MergeSelector(KX_LodSelector *other)
+{
+  const std::vector<KX_GameObject *> objects = other->m_objects;
+  for (KX_GameObject *gameobj : objects) {
+    other->UnregisterObject(gameobj);
+    RegisterObject(gameobj);
+  }
+}
+
+void KX_LodSelector::ObjectMoved(KX_GameObject *gameobj)
+{
+  const int index = gameobj->GetLodSelectorIndex();
+  if (index == -1 || index >= (int)m_objects.size() || m_objects[index] != gameobj) {
+    return;
+  }
+
+  SetPending(index, PENDING_MOVED);
+}
+
+void KX_LodSelector::Invalidate()
+{
+  m_invalid = true;
+}
+
+KX_LodSelector::Metric KX_LodSelector::GetMetric() const
+{
+  return m_metric;
+}
+
+void KX_LodSelector::SetMetric(Metric metric)
+{
+  if (metric != m_metric) {
+    m_metric = metric;
+    Invalidate();
+  }
+}
+
+void KX_LodSelector::Update(KX_Scene *scene, KX_Camera *cam)
+{
+  if (m_objects.empty()) {
+    return;
+  }
+
+  if (m_settingsRevision != KX_LodManager::GetSettingsRevision()) {
+    m_settingsRevision = KX_LodManager::GetSettingsRevision();
+    m_invalid = true;
+  }
+
+  if (m_invalid) {
+    for (unsigned int i = 0, size = m_objects.size(); i < size; ++i) {
+      SetPending(i, PENDING_MOVED | PENDING_EVALUATE);
+    }
+    m_invalid = false;
+  }
+
+  const bool pending = !m_pendingList.empty();
+  FlushPending(scene);
+
+  /* The squared distance used to select the level is:
+   * (distance2 * distanceScale + distanceOffset) * invScale2. */
+  const MT_Vector3 &campos = cam->NodeGetWorldPosition();
+  const float lodfactor = cam->GetLodDistanceFactor();
+  float distanceScale = lodfactor * lodfactor;
+  float distanceOffset = 0.0f;
+  if (m_metric == METRIC_SCREEN_SIZE) {
+    const RAS_CameraData *camdata = cam->GetCameraData();
+    // The width of the view at the object distance compared to the reference camera.
+    if (camdata->m_perspective) {
+      const float factor = lodfactor * (camdata->m_sensor_x / camdata->m_lens) *
+                           (referenceLens / referenceSensor);
+      distanceScale = factor * factor;
+    }
+    else {
+      const float factor = lodfactor * camdata->m_scale * (referenceLens / referenceSensor);
+      distanceScale = 0.0f;
+      distanceOffset = factor * factor;
+    }
+  }
+
+  const bool cameraChanged = (cam != m_camera || campos.x() != m_cameraPosition.x() ||
+                              campos.y() != m_cameraPosition.y() ||
+                              campos.z() != m_cameraPosition.z() ||
+                              distanceScale != m_distanceScale ||
+                              distanceOffset != m_distanceOffset);
+
+  // Frame coherence: nothing can leave its range if nothing moved.
+  if (pending || cameraChanged) {
+    m_camera = cam;
+    m_cameraPosition = campos;
+    m_distanceScale = distanceScale;
+    m_distanceOffset = distanceOffset;
+
+    const float cx = campos.x();
+    const float cy = campos.y();
+    const float cz = campos.z();
+    const float *__restrict posX = m_posX.data();
+    const float *__restrict posY = m_posY.data();
+    const float *__restrict posZ = m_posZ.data();
+    const float *__restrict invScale2 = m_invScale2.data();
+    const float *__restrict factor2 = m_factor2.data();
+    const float *__restrict min2 = m_min2.data();
+    const float *__restrict max2 = m_max2.data();
+    float *__restrict distance2 = m_distance2.data();
+    uint8_t *__restrict changed = m_changed.data();
+
+    blender::threading::parallel_for(
+        blender::IndexRange(m_objects.size()),
+        evaluateGrainSize,
+        [&](const blender::IndexRange range) {
+          // Branchless loop to let the compiler vectorize it.
+          for (int64_t i = range.start(), end = range.one_after_last(); i < end; ++i) {
+            const float dx = posX[i] - cx;
+            const float dy = posY[i] - cy;
+            const float dz = posZ[i] - cz;
+            const float dist2 = ((dx * dx + dy * dy + dz * dz) * distanceScale +
+                                 distanceOffset) *
+                                invScale2[i];
+            const float lod2 = dist2 * factor2[i];
+            distance2[i] = dist2;
+            changed[i] = (uint8_t)((lod2 < min2[i]) | (lod2 >= max2[i]));
+          }
+        });
+
+    // Mesh replacement isn't thread safe, apply the changes sequentially.
+    for (unsigned int i = 0, size = m_objects.size(); i < size; ++i) {
+      if (m_changed[i]) {
+        m_objects[i]->UpdateLod(m_distance2[i]);
+        UpdateRange(scene, i);
+      }
+    }
+  }
+
+  // The evaluated objects are restored by each depsgraph update.
+  Depsgraph *depsgraph = nullptr;
+  for (unsigned int i = 0, size = m_objects.size(); i < size; ++i) {
+    if (m_replaceObject[i]) {
+      if (!depsgraph) {
+        bContext *C = KX_GetActiveEngine()->GetContext();
+        depsgraph = CTX_data_expect_evaluated_depsgraph(C);
+      }
+      m_objects[i]->UpdateLodObject(depsgraph);
+    }
+  }
+}
@@ -0,0 +1,123 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file KX_LodSelector.h
+ *  \ingroup ketsji
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "MT_Vector3.h"
+
+class KX_Camera;
+class KX_GameObject;
+class KX_Scene;
+
+/** Level of detail selection of the objects of a scene.
+ * The world positions, scales and the squared distance range keeping the current lod level
+ * of the objects are stored in contiguous arrays. Each camera render, the distance of all
+ * the objects is compared to their range in a vectorized and parallel loop, and only the
+ * objects leaving their range select a new lod level. The positions are updated from the
+ * scene graph transform callback, when neither the camera nor the objects moved the
+ * selection is skipped.
+ */
+class KX_LodSelector {
+ public:
+  enum Metric {
+    /// Distance from the camera to the object.
+    METRIC_DISTANCE = 0,
+    /** Distance corrected by the camera field of view, orthographic scale and the object
+     * scale, the level follows the projected size of the object on screen. The lod distances
+     * are the distances for an object of scale one and a camera of 50mm lens and 36mm sensor.
+     */
+    METRIC_SCREEN_SIZE
+  };
+
+ private:
+  /// Object world positions.
+  std::vector<float> m_posX;
+  std::vector<float> m_posY;
+  std::vector<float> m_posZ;
+  /// Inverse squared world scale of the objects, used by the screen size metric.
+  std::vector<float> m_invScale2;
+  /// Squared distance factor of the lod manager.
+  std::vector<float> m_factor2;
+  /// Range keeping the current lod level, compared to the squared distance with all factors.
+  std::vector<float> m_min2;
+  std::vector<float> m_max2;
+  /// Squared distance of the last evaluation, lod manager factor not applied.
+  std::vector<float> m_distance2;
+  /// Non-zero if the object left its range in the current evaluation.
+  std::vector<uint8_t> m_changed;
+  /// Non-zero if the object is pending for a position and range update.
+  std::vector<uint8_t> m_pending;
+  /// Non-zero if the current lod level renders another object than the game object.
+  std::vector<uint8_t> m_replaceObject;
+  std::vector<KX_GameObject *> m_objects;
+
+  /// Objects with m_pending set.
+  std::vector<int> m_pendingList;
+
+  Metric m_metric;
+  /// Camera and parameters of the last evaluation.
+  KX_Camera *m_camera;
+  MT_Vector3 m_cameraPosition;
+  float m_distanceScale;
+  float m_distanceOffset;
+  /// Revision of the lod managers used by the cached ranges.
+  unsigned int m_settingsRevision;
+  /// Force the evaluation of all the objects.
+  bool m_invalid;
+
+  /// Move the object at index from into index to, used for swap removal.
+  void MoveIndex(int from, int to);
+  /// Set a combination of PendingFlag.
+  void SetPending(int index, uint8_t flag);
+  /// Update the positions, scales and ranges of the pending objects.
+  void FlushPending(KX_Scene *scene);
+  /// Read the world position and scale of an object.
+  void UpdateObject(int index);
+  /// Cache the range of the current lod level of an object.
+  void UpdateRange(KX_Scene *scene, int index);
+
+ public:
+  KX_LodSelector();
+  ~KX_LodSelector();
+
+  /// Start to select the lod level of an object, or update the settings of a registered object.
+  void RegisterObject(KX_GameObject *gameobj);
+  void UnregisterObject(KX_GameObject *gameobj);
+  /// Move all the objects of another selector, used when merging scenes.
+  void MergeSelector(KX_LodSelector *other);
+
+  /// Notify that an object moved, called from the scene graph transform callback.
+  void ObjectMoved(KX_GameObject *gameobj);
+  /// Force the evaluation of all the objects, used when the scene hysteresis changes.
+  void Invalidate();
+
+  Metric GetMetric() const;
+  void SetMetric(Metric metric);
+
+  /// Select the lod level of all the objects for the camera being rendered.
+  void Update(KX_Scene *scene, KX_Camera *cam);
+};
@@ -33,7 +33,13 @@
 
 #include "SG_Node.h"
 
-KX_MotionState::KX_MotionState(SG_Node *node) : m_node(node)
+KX_MotionState::KX_MotionState(SG_Node *node)
+    : m_node(node),
+      m_prevPosition(node->GetLocalPosition()),
+      m_prevOrientation(node->GetLocalOrientation()),
+      m_position(m_prevPosition),
+      m_orientation(m_prevOrientation),
+      m_interpolated(false)
 {
 }
 
@@ -58,17 +64,21 @@ MT_Matrix3x3 KX_MotionState::GetWorldOrientation() const
 
 void KX_MotionState::SetWorldOrientation(const MT_Matrix3x3 &ori)
 {
+  m_orientation = ori;
+  m_interpolated = false;
   m_node->SetLocalOrientation(ori);
 }
 
 void KX_MotionState::SetWorldPosition(const MT_Vector3 &pos)
 {
+  m_position = pos;
+  m_interpolated = false;
   m_node->SetLocalPosition(pos);
 }
 
 void KX_MotionState::SetWorldOrientation(const MT_Quaternion &quat)
 {
-  m_node->SetLocalOrientation(MT_Matrix3x3(quat));
+  SetWorldOrientation(MT_Matrix3x3(quat));
 }
 
 void KX_MotionState::CalculateWorldTransformations()
@@ -77,3 +87,43 @@ void KX_MotionState::CalculateWorldTransformations()
   // bool parentUpdated = false;
   // m_node->ComputeWorldTransforms(nullptr, parentUpdated);
 }
+
+void KX_MotionState::BeginInterpolationStep()
+{
+  m_prevPosition = m_position;
+  m_prevOrientation = m_orientation;
+}
+
+void KX_MotionState::InterpolateWorldTransform(float alpha,
+                                               const MT_Vector3 &pos,
+                                               const MT_Matrix3x3 &ori)
+{
+  /* The logic moved the object without any physics step since, the last step transforms are
+   * stale and would undo this move. */
+  if (!(pos - m_position).fuzzyZero() || !(ori[0] - m_orientation[0]).fuzzyZero() ||
+      !(ori[1] - m_orientation[1]).fuzzyZero() || !(ori[2] - m_orientation[2]).fuzzyZero())
+  {
+    m_prevPosition = m_position = pos;
+    m_prevOrientation = m_orientation = ori;
+  }
+
+  const MT_Vector3 position = m_prevPosition + (m_position - m_prevPosition) * alpha;
+  const MT_Quaternion quat = m_prevOrientation.getRotation().slerp(m_orientation.getRotation(),
+                                                                   alpha);
+
+  m_node->SetLocalPosition(position);
+  m_node->SetLocalOrientation(MT_Matrix3x3(quat));
+  m_interpolated = true;
+}
+
+void KX_MotionState::RestoreWorldTransform()
+{
+  // The transform was changed since the interpolation, by the physics or the logic.
+  if (!m_interpolated) {
+    return;
+  }
+
+  m_node->SetLocalPosition(m_position);
+  m_node->SetLocalOrientation(m_orientation);
+  m_interpolated = false;
+}
@@ -38,6 +38,15 @@ class SG_Node;
 class KX_MotionState : public PHY_IMotionState {
   SG_Node *m_node;
 
+  /// Transform at the beginning of the last physics step.
+  MT_Vector3 m_prevPosition;
+  MT_Matrix3x3 m_prevOrientation;
+  /// Transform set by the last physics synchronization.
+  MT_Vector3 m_position;
+  MT_Matrix3x3 m_orientation;
+  /// True when the node holds an interpolated transform.
+  bool m_interpolated;
+
  public:
   KX_MotionState(SG_Node *spatial);
   virtual ~KX_MotionState();
@@ -51,4 +60,10 @@ class KX_MotionState : public PHY_IMotionState {
   virtual void SetWorldOrientation(const MT_Quaternion &quat);
 
   virtual void CalculateWorldTransformations();
+
+  virtual void BeginInterpolationStep();
+  virtual void InterpolateWorldTransform(float alpha,
+                                         const MT_Vector3 &pos,
+                                         const MT_Matrix3x3 &ori);
+  virtual void RestoreWorldTransform();
 };
@@ -0,0 +1,175 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Ketsji/KX_PhysicsSnapshot.cpp
+ *  \ingroup ketsji
+ */
+
+#include "KX_PhysicsSnapshot.h"
+
+#include "KX_Globals.h"
+#include "PHY_IPhysicsEnvironment.h"
+#include "PHY_ISnapshot.h"
+
+KX_PhysicsSnapshot::KX_PhysicsSnapshot(PHY_ISnapshot *snapshot) : m_snapshot(snapshot)
+{
+}
+
+KX_PhysicsSnapshot::~KX_PhysicsSnapshot()
+{
+  delete m_snapshot;
+}
+
+std::string KX_PhysicsSnapshot::GetName()
+{
+  return "KX_PhysicsSnapshot";
+}
+
+#ifdef WITH_PYTHON
+
+PHY_IPhysicsEnvironment *KX_PhysicsSnapshot::CheckEnvironment(const char *funcName) const
+{
+  PHY_IPhysicsEnvironment *physicsEnv = m_snapshot->GetPhysicsEnvironment();
+  if (!physicsEnv) {
+    PyErr_Format(PyExc_RuntimeError,
+                 "%s, the physics environment of the snapshot was freed",
+                 funcName);
+    return nullptr;
+  }
+  if (KX_GetPhysicsEnvironment() != physicsEnv) {
+    PyErr_Format(PyExc_RuntimeError,
+                 "%s, snapshot was created by the physics environment of an other scene",
+                 funcName);
+    return nullptr;
+  }
+  return physicsEnv;
+}
+
+PyTypeObject KX_PhysicsSnapshot::Type = {
+    PyVarObject_HEAD_INIT(nullptr, 0) "KX_PhysicsSnapshot",
+    sizeof(EXP_PyObjectPlus_Proxy),
+    0,
+    py_base_dealloc,
+    0,
+    0,
+    0,
+    0,
+    py_base_repr,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    Methods,
+    0,
+    0,
+    &EXP_PyObjectPlus::Type,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    py_base_new};
+
+PyMethodDef KX_PhysicsSnapshot::Methods[] = {
+    EXP_PYMETHODTABLE_NOARGS(KX_PhysicsSnapshot, save),
+    EXP_PYMETHODTABLE_NOARGS(KX_PhysicsSnapshot, restore),
+    {nullptr, nullptr}  // Sentinel
+};
+
+PyAttributeDef KX_PhysicsSnapshot::Attributes[] = {
+    EXP_PYATTRIBUTE_RO_FUNCTION("bodyCount", KX_PhysicsSnapshot, pyattr_get_body_count),
+    EXP_PYATTRIBUTE_RO_FUNCTION(
+        "constraintCount", KX_PhysicsSnapshot, pyattr_get_constraint_count),
+    EXP_PYATTRIBUTE_RO_FUNCTION("size", KX_PhysicsSnapshot, pyattr_get_size),
+    EXP_PYATTRIBUTE_NULL  // Sentinel
+};
+
+EXP_PYMETHODDEF_DOC_NOARGS(KX_PhysicsSnapshot,
+                           save,
+                           "save()\n"
+                           "store the current state of the physics world.\n")
+{
+  PHY_IPhysicsEnvironment *physicsEnv = CheckEnvironment("snapshot.save()");
+  if (!physicsEnv) {
+    return nullptr;
+  }
+
+  if (!physicsEnv->SaveSnapshot(m_snapshot)) {
+    PyErr_SetString(PyExc_RuntimeError, "snapshot.save(), failed to save the physics world");
+    return nullptr;
+  }
+
+  Py_RETURN_NONE;
+}
+
+EXP_PYMETHODDEF_DOC_NOARGS(KX_PhysicsSnapshot,
+                           restore,
+                           "restore()\n"
+                           "apply back the physics world state stored by the last save.\n")
+{
+  PHY_IPhysicsEnvironment *physicsEnv = CheckEnvironment("snapshot.restore()");
+  if (!physicsEnv) {
+    return nullptr;
+  }
+
+  if (!physicsEnv->RestoreSnapshot(m_snapshot)) {
+    PyErr_SetString(PyExc_RuntimeError, "snapshot.restore(), snapshot was never saved");
+    return nullptr;
+  }
+
+  Py_RETURN_NONE;
+}
+
+PyObject *KX_PhysicsSnapshot::pyattr_get_body_count(EXP_PyObjectPlus *self_v,
+                                                    const EXP_PYATTRIBUTE_DEF *attrdef)
+{
+  KX_PhysicsSnapshot *self = static_cast<KX_PhysicsSnapshot *>(self_v);
+  return PyLong_FromLong(self->m_snapshot->GetNumBodies());
+}
+
+PyObject *KX_PhysicsSnapshot::pyattr_get_constraint_count(EXP_PyObjectPlus *self_v,
+                                                          const EXP_PYATTRIBUTE_DEF *attrdef)
+{
+  KX_PhysicsSnapshot *self = static_cast<KX_PhysicsSnapshot *>(self_v);
+  return PyLong_FromLong(self->m_snapshot->GetNumConstraints());
+}
+
+PyObject *KX_PhysicsSnapshot::pyattr_get_size(EXP_PyObjectPlus *self_v,
+                                              const EXP_PYATTRIBUTE_DEF *attrdef)
+{
+  KX_PhysicsSnapshot *self = static_cast<KX_PhysicsSnapshot *>(self_v);
+  return PyLong_FromSize_t(self->m_snapshot->GetSize());
+}
+
+#endif  // WITH_PYTHON
@@ -0,0 +1,60 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file KX_PhysicsSnapshot.h
+ *  \ingroup ketsji
+ */
+
+
+#pragma once
+
+#include "EXP_Value.h"
+
+class PHY_IPhysicsEnvironment;
+class PHY_ISnapshot;
+
+/// Python wrapper of a physics snapshot, owns the snapshot.
+class KX_PhysicsSnapshot : public EXP_Value {
+  Py_Header
+
+ public:
+  KX_PhysicsSnapshot(PHY_ISnapshot *snapshot);
+  virtual ~KX_PhysicsSnapshot();
+
+  virtual std::string GetName();
+
+#ifdef WITH_PYTHON
+  EXP_PYMETHOD_DOC_NOARGS(KX_PhysicsSnapshot, save);
+  EXP_PYMETHOD_DOC_NOARGS(KX_PhysicsSnapshot, restore);
+
+  static PyObject *pyattr_get_body_count(EXP_PyObjectPlus *self_v,
+                                         const EXP_PYATTRIBUTE_DEF *attrdef);
+  static PyObject *pyattr_get_constraint_count(EXP_PyObjectPlus *self_v,
+                                               const EXP_PYATTRIBUTE_DEF *attrdef);
+  static PyObject *pyattr_get_size(EXP_PyObjectPlus *self_v, const EXP_PYATTRIBUTE_DEF *attrdef);
+
+  /** Return the environment which created the snapshot if it is still the active one, else
+   * raise an error and return nullptr. */
+  PHY_IPhysicsEnvironment *CheckEnvironment(const char *funcName) const;
+#endif
+
+ private:
+  PHY_ISnapshot *m_snapshot;
+};
@@ -35,6 +35,7 @@
 #include "KX_ConstraintWrapper.h"
 #include "KX_GameObject.h"  // ConvertPythonToGameObject()
 #include "KX_Globals.h"
+#include "KX_PhysicsSnapshot.h"
 #include "KX_VehicleWrapper.h"
 #include "PHY_IConstraint.h"
 #include "PHY_IPhysicsEnvironment.h"
@@ -122,6 +123,9 @@ PyDoc_STRVAR(gPyRemoveConstraint__doc__,
 PyDoc_STRVAR(gPyGetAppliedImpulse__doc__,
              "getAppliedImpulse(int constraintId)\n"
              "");
+PyDoc_STRVAR(gPyCreateSnapshot__doc__,
+             "createSnapshot()\n"
+             "create a snapshot to save and restore the state of the physics world");
 
 static PyObject *gPySetGravity(PyObject *self, PyObject *args, PyObject *kwds)
 {
@@ -357,6 +361,10 @@ static PyObject *gPySetSolverType(PyObject *self, PyObject *args, PyObject *kwds
 {
   int solverType;
   if (PyArg_ParseTuple(args, "i", &solverType)) {
+    if (solverType < PHY_SOLVER_SEQUENTIAL || solverType > PHY_SOLVER_PARALLEL) {
+      PyErr_Format(PyExc_ValueError, "setSolverType(type): invalid solver type %d", solverType);
+      return nullptr;
+    }
     if (KX_GetPhysicsEnvironment()) {
       KX_GetPhysicsEnvironment()->SetSolverType((PHY_SolverType)solverType);
     }
@@ -600,6 +608,22 @@ static PyObject *gPyExportBulletFile(PyObject *, PyObject *args)
   Py_RETURN_NONE;
 }
 
+static PyObject *gPyCreateSnapshot(PyObject *self)
+{
+  PHY_IPhysicsEnvironment *physicsEnv = KX_GetPhysicsEnvironment();
+  if (!physicsEnv) {
+    Py_RETURN_NONE;
+  }
+
+  PHY_ISnapshot *snapshot = physicsEnv->CreateSnapshot();
+  if (!snapshot) {
+    Py_RETURN_NONE;
+  }
+
+  KX_PhysicsSnapshot *wrap = new KX_PhysicsSnapshot(snapshot);
+  return wrap->NewProxy(true);
+}
+
 static struct PyMethodDef physicsconstraints_methods[] = {
     {"setGravity", (PyCFunction)gPySetGravity, METH_VARARGS, (const char *)gPySetGravity__doc__},
     {"setDebugMode",
@@ -694,6 +718,11 @@ static struct PyMethodDef physicsconstraints_methods[] = {
 
     {"exportBulletFile", (PyCFunction)gPyExportBulletFile, METH_VARARGS, "export a .bullet file"},
 
+    {"createSnapshot",
+     (PyCFunction)gPyCreateSnapshot,
+     METH_NOARGS,
+     (const char *)gPyCreateSnapshot__doc__},
+
     // sentinel
     {nullptr, (PyCFunction) nullptr, 0, nullptr}};
 
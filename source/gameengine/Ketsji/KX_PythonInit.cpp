@@ -102,9 +102,11 @@
 #include "BL_Action.h"
 #include "BL_Converter.h"
 #include "BL_Shader.h"
+#include "CM_Logger.h"
 #include "CM_Message.h"
 #include "KX_Globals.h"
 #include "KX_LibLoadStatus.h"
+#include "KX_LodSelector.h"
 #include "KX_MeshProxy.h" /* for creating a new library of mesh objects */
 #include "KX_NavMeshObject.h"
 #include "KX_NetworkMessageScene.h"  //Needed for sendMessage()
@@ -282,6 +284,69 @@ static PyObject *gPyGetProfileInfo(PyObject *)
   return KX_GetActiveEngine()->GetPyProfileDict();
 }
 
+PyDoc_STRVAR(gPySetLogSinks_doc,
+             "setLogSinks(sinks, filepath=\"\")\n"
+             "Sets the outputs of the engine messages, a combination of KX_LOG_CONSOLE,\n"
+             "KX_LOG_FILE and KX_LOG_RING");
+static PyObject *gPySetLogSinks(PyObject *, PyObject *args)
+{
+  int sinks;
+  const char *filepath = nullptr;
+  if (!PyArg_ParseTuple(args, "i|s:setLogSinks", &sinks, &filepath))
+    return nullptr;
+
+  CM_Logger &logger = CM_Logger::Get();
+  if (filepath) {
+    logger.SetFilePath(filepath);
+  }
+  logger.SetSinks(sinks);
+  Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(gPyGetLogSinks_doc,
+             "getLogSinks()\n"
+             "Gets the outputs of the engine messages");
+static PyObject *gPyGetLogSinks(PyObject *)
+{
+  return PyLong_FromLong(CM_Logger::Get().GetSinks());
+}
+
+PyDoc_STRVAR(gPySetLogRateLimit_doc,
+             "setLogRateLimit(limit)\n"
+             "Sets the maximum number of identical messages printed per second, 0 to disable");
+static PyObject *gPySetLogRateLimit(PyObject *, PyObject *args)
+{
+  int limit;
+  if (!PyArg_ParseTuple(args, "i:setLogRateLimit", &limit))
+    return nullptr;
+
+  if (limit < 0) {
+    PyErr_SetString(PyExc_ValueError, "setLogRateLimit(limit): expected a positive integer");
+    return nullptr;
+  }
+
+  CM_Logger::Get().SetRateLimit(limit);
+  Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(gPyGetLogMessages_doc,
+             "getLogMessages()\n"
+             "Gets the last engine messages kept when KX_LOG_RING is enabled");
+static PyObject *gPyGetLogMessages(PyObject *)
+{
+  // Make sure the messages sent until now are written.
+  CM_Logger &logger = CM_Logger::Get();
+  logger.Flush();
+
+  const std::vector<std::string> messages = logger.GetRecentMessages();
+  PyObject *list = PyList_New(messages.size());
+  for (unsigned int i = 0, size = messages.size(); i < size; ++i) {
+    PyList_SET_ITEM(list, i, PyUnicode_FromStdString(messages[i]));
+  }
+
+  return list;
+}
+
 PyDoc_STRVAR(gPySendMessage_doc,
              "sendMessage(subject, [body, to, from])\n"
              "sends a message in same manner as a message actuator"
@@ -399,13 +464,42 @@ static PyObject *gPyGetMaxPhysicsFrame(PyObject *)
   return PyLong_FromLong(KX_GetActiveEngine()->GetMaxPhysicsFrame());
 }
 
+PyDoc_STRVAR(gPySetFramePacing_doc,
+             "setFramePacing(policy)\n"
+             "Sets how the engine waits for the next frame in fixed framerate, one of\n"
+             "KX_FRAME_PACING_NONE, KX_FRAME_PACING_LOW_LATENCY and KX_FRAME_PACING_LOW_CPU");
+static PyObject *gPySetFramePacing(PyObject *, PyObject *args)
+{
+  int policy;
+  if (!PyArg_ParseTuple(args, "i:setFramePacing", &policy))
+    return nullptr;
+
+  if (policy < KX_FramePacer::POLICY_NONE || policy > KX_FramePacer::POLICY_LOW_CPU) {
+    PyErr_SetString(PyExc_ValueError,
+                    "setFramePacing(policy): expected KX_FRAME_PACING_NONE, "
+                    "KX_FRAME_PACING_LOW_LATENCY or KX_FRAME_PACING_LOW_CPU");
+    return nullptr;
+  }
+
+  KX_GetActiveEngine()->SetFramePacing((KX_FramePacer::Policy)policy);
+  Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(gPyGetFramePacing_doc,
+             "getFramePacing()\n"
+             "Gets how the engine waits for the next frame in fixed framerate");
+static PyObject *gPyGetFramePacing(PyObject *)
+{
+  return PyLong_FromLong(KX_GetActiveEngine()->GetFramePacing());
+}
+
 static PyObject *gPySetPhysicsTicRate(PyObject *, PyObject *args)
 {
   float ticrate;
   if (!PyArg_ParseTuple(args, "f:setPhysicsTicRate", &ticrate))
     return nullptr;
 
-  KX_GetPhysicsEnvironment()->SetFixedTimeStep(true, ticrate);
+  KX_GetActiveEngine()->SetPhysicsTicRate(ticrate);
   Py_RETURN_NONE;
 }
 #  if 0  // unused
@@ -422,7 +516,7 @@ static PyObject *gPySetPhysicsDebug(PyObject *, PyObject *args)
 
 static PyObject *gPyGetPhysicsTicRate(PyObject *)
 {
-  return PyFloat_FromDouble(KX_GetPhysicsEnvironment()->GetFixedTimeStep());
+  return PyFloat_FromDouble(KX_GetActiveEngine()->GetPhysicsTicRate());
 }
 
 static PyObject *gPyGetAverageFrameRate(PyObject *)
@@ -917,6 +1011,12 @@ static struct PyMethodDef game_methods[] = {
      METH_NOARGS,
      (const char *)"Render next frame (if Python has control)"},
     {"getProfileInfo", (PyCFunction)gPyGetProfileInfo, METH_NOARGS, gPyGetProfileInfo_doc},
+    {"setFramePacing", (PyCFunction)gPySetFramePacing, METH_VARARGS, gPySetFramePacing_doc},
+    {"getFramePacing", (PyCFunction)gPyGetFramePacing, METH_NOARGS, gPyGetFramePacing_doc},
+    {"setLogSinks", (PyCFunction)gPySetLogSinks, METH_VARARGS, gPySetLogSinks_doc},
+    {"getLogSinks", (PyCFunction)gPyGetLogSinks, METH_NOARGS, gPyGetLogSinks_doc},
+    {"setLogRateLimit", (PyCFunction)gPySetLogRateLimit, METH_VARARGS, gPySetLogRateLimit_doc},
+    {"getLogMessages", (PyCFunction)gPyGetLogMessages, METH_NOARGS, gPyGetLogMessages_doc},
     /* library functions */
     {"LibLoad", (PyCFunction)gLibLoad, METH_VARARGS | METH_KEYWORDS, (const char *)""},
     {"LibNew", (PyCFunction)gLibNew, METH_VARARGS, (const char *)""},
@@ -1680,6 +1780,20 @@ PyMODINIT_FUNC initGameLogicPythonBinding()
       d, KX_DYN_DISABLE_RIGID_BODY, SCA_DynamicActuator::KX_DYN_DISABLE_RIGID_BODY);
   KX_MACRO_addTypesToDict(d, KX_DYN_SET_MASS, SCA_DynamicActuator::KX_DYN_SET_MASS);
 
+  /* Log sinks */
+  KX_MACRO_addTypesToDict(d, KX_LOG_CONSOLE, CM_Logger::SINK_CONSOLE);
+  KX_MACRO_addTypesToDict(d, KX_LOG_FILE, CM_Logger::SINK_FILE);
+  KX_MACRO_addTypesToDict(d, KX_LOG_RING, CM_Logger::SINK_RING);
+
+  /* Frame pacing policies */
+  KX_MACRO_addTypesToDict(d, KX_FRAME_PACING_NONE, KX_FramePacer::POLICY_NONE);
+  KX_MACRO_addTypesToDict(d, KX_FRAME_PACING_LOW_LATENCY, KX_FramePacer::POLICY_LOW_LATENCY);
+  KX_MACRO_addTypesToDict(d, KX_FRAME_PACING_LOW_CPU, KX_FramePacer::POLICY_LOW_CPU);
+
+  /* Lod metrics */
+  KX_MACRO_addTypesToDict(d, KX_LOD_METRIC_DISTANCE, KX_LodSelector::METRIC_DISTANCE);
+  KX_MACRO_addTypesToDict(d, KX_LOD_METRIC_SCREEN_SIZE, KX_LodSelector::METRIC_SCREEN_SIZE);
+
   /* Input & Mouse Sensor */
   KX_MACRO_addTypesToDict(d, KX_INPUT_NONE, SCA_InputEvent::NONE);
   KX_MACRO_addTypesToDict(d, KX_INPUT_JUST_ACTIVATED, SCA_InputEvent::JUSTACTIVATED);
@@ -36,6 +36,10 @@
 
 #include "KX_Scene.h"
 
+#include <cfloat>
+#include <cstring>
+#include <unordered_set>
+
 #include "BKE_lib_id.hh"
 #include "BKE_mball.hh"
 #include "BKE_modifier.hh"
@@ -66,6 +70,7 @@
 #include "CM_List.h"
 #include "EXP_FloatValue.h"
 #include "KX_2DFilterManager.h"
+#include "KX_ActivityCullingManager.h"
 #include "KX_BlenderCanvas.h"
 #include "KX_Camera.h"
 #include "KX_CollisionEventManager.h"
@@ -73,6 +78,7 @@
 #include "KX_Globals.h"
 #include "KX_Light.h"
 #include "KX_LodManager.h"
+#include "KX_LodSelector.h"
 #include "KX_MotionState.h"
 #include "KX_NetworkMessageScene.h"
 #include "KX_NodeRelationships.h"
@@ -159,6 +165,8 @@ KX_Scene::KX_Scene(SCA_IInputDevice *inputDevice,
   m_dbvt_culling = false;
   m_dbvt_occlusion_res = 0;
   m_activityCulling = false;
+  m_activityCullingManager = new KX_ActivityCullingManager();
+  m_lodSelector = new KX_LodSelector();
   m_objectlist = new EXP_ListValue<KX_GameObject>();
   m_parentlist = new EXP_ListValue<KX_GameObject>();
   m_lightlist = new EXP_ListValue<KX_LightObject>();
@@ -166,6 +174,15 @@ KX_Scene::KX_Scene(SCA_IInputDevice *inputDevice,
   m_cameralist = new EXP_ListValue<KX_Camera>();
   m_fontlist = new EXP_ListValue<KX_FontObject>();
 
+  /* Objects are looked up by name from scripts and removed from all these lists
+   * at once, keep the order only where it matters (cameras and lights). */
+  m_objectlist->SetIndexMode(EXP_BaseListValue::INDEX_UNORDERED);
+  m_parentlist->SetIndexMode(EXP_BaseListValue::INDEX_UNORDERED);
+  m_inactivelist->SetIndexMode(EXP_BaseListValue::INDEX_UNORDERED);
+  m_fontlist->SetIndexMode(EXP_BaseListValue::INDEX_UNORDERED);
+  m_lightlist->SetIndexMode(EXP_BaseListValue::INDEX_ORDERED);
+  m_cameralist->SetIndexMode(EXP_BaseListValue::INDEX_ORDERED);
+
   m_filterManager = new KX_2DFilterManager();
   m_logicmgr = new SCA_LogicManager();
 
@@ -224,7 +241,6 @@ KX_Scene::KX_Scene(SCA_IInputDevice *inputDevice,
    */
   scene->lay = 1;
 
-  m_kxobWithLod = {};
   m_obRestrictFlags = {};
   m_backupOverlayFlag = -1;
   m_backupOverlayGameFlag = -1;
@@ -389,6 +405,11 @@ KX_Scene::~KX_Scene()
     BLI_task_pool_free(m_animationPool);
   }
 
+  // Delete before the remaining objects are freed, it resets their culling index.
+  delete m_activityCullingManager;
+  delete m_lodSelector;
+  m_lodSelector = nullptr;
+
   if (m_objectlist)
     m_objectlist->Release();
 
@@ -1191,19 +1212,15 @@ void KX_Scene::SetIsPythonMainLoop(bool isPythonMainLoop)
 
 void KX_Scene::AddObjToLodObjList(KX_GameObject *gameobj)
 {
-  std::vector<KX_GameObject *>::iterator it = std::find(
-      m_kxobWithLod.begin(), m_kxobWithLod.end(), gameobj);
-  if (it == m_kxobWithLod.end()) {
-    m_kxobWithLod.push_back(gameobj);
-  }
+  // Also used to notify a change of lod manager of a registered object.
+  m_lodSelector->RegisterObject(gameobj);
 }
 
 void KX_Scene::RemoveObjFromLodObjList(KX_GameObject *gameobj)
 {
-  std::vector<KX_GameObject *>::iterator it = std::find(
-      m_kxobWithLod.begin(), m_kxobWithLod.end(), gameobj);
-  if (it != m_kxobWithLod.end()) {
-    m_kxobWithLod.erase(it);
+  // The remaining objects are freed after the selector in the scene destructor.
+  if (m_lodSelector) {
+    m_lodSelector->UnregisterObject(gameobj);
   }
 }
 
@@ -1662,13 +1679,18 @@ KX_GameObject *KX_Scene::AddNodeReplicaObject(SG_Node *node, KX_GameObject *game
 
   // this is the list of object that are send to the graphics pipeline
   m_objectlist->Add(CM_AddRef(newobj));
+  m_activityCullingManager->RegisterObject(newobj);
   switch (newobj->GetGameObjectType()) {
     case SCA_IObject::OBJ_LIGHT: {
       m_lightlist->Add(CM_AddRef(static_cast<KX_LightObject *>(newobj)));
       break;
     }
     case SCA_IObject::OBJ_TEXT: {
-      m_fontlist->Add(CM_AddRef(static_cast<KX_FontObject *>(newobj)));
+      KX_FontObject *font = static_cast<KX_FontObject *>(newobj);
+      m_fontlist->Add(CM_AddRef(font));
+      if (font->IsTextModified()) {
+        AddModifiedFont(font);
+      }
       break;
     }
     case SCA_IObject::OBJ_CAMERA: {
@@ -2204,6 +2226,7 @@ bool KX_Scene::NewRemoveObject(KX_GameObject *gameobj)
   if (m_lightlist->RemoveValue(gameobj)) {
     ret = (gameobj->Release() != nullptr);
   }
+  m_activityCullingManager->UnregisterObject(gameobj);
   if (m_objectlist->RemoveValue(gameobj)) {
     ret = (gameobj->Release() != nullptr);
   }
@@ -2222,6 +2245,7 @@ bool KX_Scene::NewRemoveObject(KX_GameObject *gameobj)
 
   // WARNING: 'gameobj' maybe be freed now, only compare, don't access.
   CM_ListRemoveIfFound(m_animatedlist, gameobj);
+  CM_ListRemoveIfFound(m_modifiedFonts, gameobj);
   CM_ListRemoveIfFound(m_euthanasyobjects, gameobj);
   CM_ListRemoveIfFound(m_tempObjectList, gameobj);
 
@@ -2399,6 +2423,21 @@ void KX_Scene::AddAnimatedObject(KX_GameObject *gameobj)
   CM_ListAddIfNotFound(m_animatedlist, gameobj);
 }
 
+void KX_Scene::AddModifiedFont(KX_FontObject *font)
+{
+  m_modifiedFonts.push_back(font);
+}
+
+void KX_Scene::UpdateObjectName(KX_GameObject *gameobj, const std::string &oldname)
+{
+  m_objectlist->UpdateValueName(gameobj, oldname);
+  m_parentlist->UpdateValueName(gameobj, oldname);
+  m_inactivelist->UpdateValueName(gameobj, oldname);
+  m_lightlist->UpdateValueName(gameobj, oldname);
+  m_cameralist->UpdateValueName(gameobj, oldname);
+  m_fontlist->UpdateValueName(gameobj, oldname);
+}
+
 // static void update_anim_thread_func(TaskPool *pool, void *taskdata, int UNUSED(threadid))
 //{
 //  KX_GameObject *gameobj, *parent;
@@ -2488,9 +2527,11 @@ void KX_Scene::LogicEndFrame()
   if (m_obstacleSimulation)
     m_obstacleSimulation->UpdateObstacles();
 
-  for (KX_FontObject *font : m_fontlist) {
+  // Only the fonts with a modified "Text" property since the last frame.
+  for (KX_FontObject *font : m_modifiedFonts) {
     font->UpdateTextFromProperty();
   }
+  m_modifiedFonts.clear();
 }
 
 /**
@@ -2520,17 +2561,13 @@ RAS_MaterialBucket *KX_Scene::FindBucket(class RAS_IPolyMaterial *polymat, bool
 
 void KX_Scene::UpdateObjectLods(KX_Camera *cam)
 {
-  const MT_Vector3 &cam_pos = cam->NodeGetWorldPosition();
-  const float lodfactor = cam->GetLodDistanceFactor();
-
-  for (KX_GameObject *gameobj : m_kxobWithLod) {
-    gameobj->UpdateLod(cam_pos, lodfactor);
-  }
+  m_lodSelector->Update(this, cam);
 }
 
 void KX_Scene::SetLodHysteresis(bool active)
 {
   m_isActivedHysteresis = active;
+  m_lodSelector->Invalidate();
 }
 
 bool KX_Scene::IsActivedLodHysteresis(void)
@@ -2541,6 +2578,7 @@ bool KX_Scene::IsActivedLodHysteresis(void)
 void KX_Scene::SetLodHysteresisValue(int hysteresisvalue)
 {
   m_lodHysteresisValue = hysteresisvalue;
+  m_lodSelector->Invalidate();
 }
 
 int KX_Scene::GetLodHysteresisValue(void)
@@ -2567,22 +2605,7 @@ void KX_Scene::UpdateObjectActivity(void)
     return;
   }
 
-  for (KX_GameObject *gameobj : m_objectlist) {
-    // If the object doesn't manage activity culling we don't compute distance.
-    if (gameobj->GetActivityCullingInfo().m_flags ==
-        KX_GameObject::ActivityCullingInfo::ACTIVITY_NONE) {
-      continue;
-    }
-
-    // For each camera compute the distance to objects and keep the minimum distance.
-    const MT_Vector3 &obpos = gameobj->NodeGetWorldPosition();
-    float dist = FLT_MAX;
-    for (const MT_Vector3 &campos : camPositions) {
-      // Keep the minimum distance.
-      dist = min_ff((obpos - campos).length2(), dist);
-    }
-    gameobj->UpdateActivity(dist);
-  }
+  m_activityCullingManager->Update(camPositions);
 }
 
 KX_NetworkMessageScene *KX_Scene::GetNetworkMessageScene()
@@ -2609,6 +2632,248 @@ MT_Vector3 KX_Scene::GetGravity()
   return gravity;
 }
 
+unsigned short KX_Scene::GetObjectArrayStride(ObjectArrayAttribute attribute)
+{
+  switch (attribute) {
+    case OBJECT_ARRAY_WORLD_ORIENTATION:
+    case OBJECT_ARRAY_LOCAL_ORIENTATION: {
+      return 9;
+    }
+    default: {
+      return 3;
+    }
+  }
+}
+
+static void object_array_set_matrix(float *data, const MT_Matrix3x3 &mat)
+{
+  for (unsigned short row = 0; row < 3; ++row) {
+    for (unsigned short col = 0; col < 3; ++col) {
+      data[row * 3 + col] = mat[row][col];
+    }
+  }
+}
+
+/// Return false if the parent has a null scale.
+static bool object_array_inverse_scale(SG_Node *parent, MT_Vector3 &invscale)
+{
+  const MT_Vector3 &scale = parent->GetWorldScaling();
+  if (fabs(scale[0]) < (MT_Scalar)FLT_EPSILON || fabs(scale[1]) < (MT_Scalar)FLT_EPSILON ||
+      fabs(scale[2]) < (MT_Scalar)FLT_EPSILON) {
+    return false;
+  }
+
+  invscale.setValue(1.0f / scale[0], 1.0f / scale[1], 1.0f / scale[2]);
+  return true;
+}
+
+static MT_Matrix3x3 object_array_get_matrix(const float *data)
+{
+  return MT_Matrix3x3(
+      data[0], data[1], data[2], data[3], data[4], data[5], data[6], data[7], data[8]);
+}
+
+void KX_Scene::GetObjectsArray(const std::vector<KX_GameObject *> &objects,
+                               ObjectArrayAttribute attribute,
+                               float *data)
+{
+  const unsigned short stride = GetObjectArrayStride(attribute);
+
+  for (KX_GameObject *gameobj : objects) {
+    SG_Node *node = gameobj->GetSGNode();
+    switch (attribute) {
+      case OBJECT_ARRAY_WORLD_POSITION: {
+        node->GetWorldPosition().getValue(data);
+        break;
+      }
+      case OBJECT_ARRAY_WORLD_ORIENTATION: {
+        object_array_set_matrix(data, node->GetWorldOrientation());
+        break;
+      }
+      case OBJECT_ARRAY_WORLD_SCALE: {
+        node->GetWorldScaling().getValue(data);
+        break;
+      }
+      case OBJECT_ARRAY_LOCAL_POSITION: {
+        node->GetLocalPosition().getValue(data);
+        break;
+      }
+      case OBJECT_ARRAY_LOCAL_ORIENTATION: {
+        object_array_set_matrix(data, node->GetLocalOrientation());
+        break;
+      }
+      case OBJECT_ARRAY_LOCAL_SCALE: {
+        node->GetLocalScale().getValue(data);
+        break;
+      }
+      case OBJECT_ARRAY_LINEAR_VELOCITY: {
+        gameobj->GetLinearVelocity(false).getValue(data);
+        break;
+      }
+      case OBJECT_ARRAY_ANGULAR_VELOCITY: {
+        gameobj->GetAngularVelocity(false).getValue(data);
+        break;
+      }
+      case OBJECT_ARRAY_MAX: {
+        BLI_assert(false);
+        break;
+      }
+    }
+    data += stride;
+  }
+}
+
+void KX_Scene::SetObjectsArray(const std::vector<KX_GameObject *> &objects,
+                               ObjectArrayAttribute attribute,
+                               const float *data)
+{
+  const unsigned short stride = GetObjectArrayStride(attribute);
+
+  // Velocities don't touch the scene graph.
+  if (attribute == OBJECT_ARRAY_LINEAR_VELOCITY || attribute == OBJECT_ARRAY_ANGULAR_VELOCITY) {
+    for (KX_GameObject *gameobj : objects) {
+      const MT_Vector3 vel(data);
+      if (attribute == OBJECT_ARRAY_LINEAR_VELOCITY) {
+        gameobj->setLinearVelocity(vel, false);
+      }
+      else {
+        gameobj->setAngularVelocity(vel, false);
+      }
+      data += stride;
+    }
+    return;
+  }
+
+  const bool worldSpace = (attribute == OBJECT_ARRAY_WORLD_POSITION ||
+                           attribute == OBJECT_ARRAY_WORLD_ORIENTATION ||
+                           attribute == OBJECT_ARRAY_WORLD_SCALE);
+  const bool scaling = (attribute == OBJECT_ARRAY_WORLD_SCALE ||
+                        attribute == OBJECT_ARRAY_LOCAL_SCALE);
+
+  // Nodes modified and not yet updated in world space.
+  std::vector<SG_Node *> modifiedNodes;
+  std::unordered_set<SG_Node *> pendingNodes;
+
+  for (KX_GameObject *gameobj : objects) {
+    SG_Node *node = gameobj->GetSGNode();
+    SG_Node *parent = node->GetSGParent();
+
+    /* World space values of a child need the world transform of its parent,
+     * update first the highest parent modified in this batch. */
+    if (parent && worldSpace) {
+      SG_Node *pendingParent = nullptr;
+      for (SG_Node *ancestor = parent; ancestor; ancestor = ancestor->GetSGParent()) {
+        if (pendingNodes.find(ancestor) != pendingNodes.end()) {
+          pendingParent = ancestor;
+        }
+      }
+      if (pendingParent) {
+        pendingParent->UpdateWorldData(0.0);
+        pendingNodes.erase(pendingParent);
+      }
+    }
+
+    switch (attribute) {
+      case OBJECT_ARRAY_WORLD_POSITION: {
+        MT_Vector3 pos(data);
+        if (parent) {
+          MT_Vector3 invscale;
+          if (!object_array_inverse_scale(parent, invscale)) {
+            break;
+          }
+          pos = parent->GetWorldOrientation().inverse() * (pos - parent->GetWorldPosition()) *
+                invscale;
+        }
+        node->SetLocalPosition(pos);
+        break;
+      }
+      case OBJECT_ARRAY_WORLD_ORIENTATION: {
+        const MT_Matrix3x3 rot = object_array_get_matrix(data);
+        node->SetLocalOrientation(parent ? parent->GetWorldOrientation().inverse() * rot : rot);
+        break;
+      }
+      case OBJECT_ARRAY_WORLD_SCALE: {
+        MT_Vector3 scale(data);
+        if (parent) {
+          MT_Vector3 invscale;
+          if (!object_array_inverse_scale(parent, invscale)) {
+            break;
+          }
+          scale = scale * invscale;
+        }
+        node->SetLocalScale(scale);
+        break;
+      }
+      case OBJECT_ARRAY_LOCAL_POSITION: {
+        node->SetLocalPosition(MT_Vector3(data));
+        break;
+      }
+      case OBJECT_ARRAY_LOCAL_ORIENTATION: {
+        node->SetLocalOrientation(object_array_get_matrix(data));
+        break;
+      }
+      case OBJECT_ARRAY_LOCAL_SCALE: {
+        node->SetLocalScale(MT_Vector3(data));
+        break;
+      }
+      default: {
+        BLI_assert(false);
+        break;
+      }
+    }
+
+    if (pendingNodes.insert(node).second) {
+      modifiedNodes.push_back(node);
+    }
+    data += stride;
+  }
+
+  /* Update the world transform once per modified hierarchy, the transform
+   * callback synchronizes the non dynamic physics controllers. */
+  for (SG_Node *node : modifiedNodes) {
+    if (pendingNodes.find(node) == pendingNodes.end()) {
+      continue;
+    }
+    bool pendingParent = false;
+    for (SG_Node *ancestor = node->GetSGParent(); ancestor; ancestor = ancestor->GetSGParent()) {
+      if (pendingNodes.find(ancestor) != pendingNodes.end()) {
+        pendingParent = true;
+        break;
+      }
+    }
+    if (!pendingParent) {
+      node->UpdateWorldData(0.0);
+    }
+  }
+
+  /* Dynamic objects are not synchronized by the transform callback, see
+   * KX_GameObject::UpdateTransform. They are moved as KX_GameObject::NodeSetLocalPosition
+   * does, which also wakes up the body. */
+  const bool position = (attribute == OBJECT_ARRAY_WORLD_POSITION ||
+                         attribute == OBJECT_ARRAY_LOCAL_POSITION);
+  for (KX_GameObject *gameobj : objects) {
+    PHY_IPhysicsController *ctrl = gameobj->GetPhysicsController();
+    SG_Node *node = gameobj->GetSGNode();
+    // Children physics controllers are updated from the kinematic synchronization.
+    if (!ctrl || node->GetSGParent()) {
+      continue;
+    }
+
+    if (scaling) {
+      ctrl->SetScaling(node->GetLocalScale());
+    }
+    else if (!ctrl->IsDynamic()) {
+      continue;
+    }
+    else if (position) {
+      ctrl->SetPosition(node->GetLocalPosition());
+    }
+    else {
+      ctrl->SetOrientation(node->GetLocalOrientation());
+    }
+  }
+}
+
 void KX_Scene::SetPhysicsEnvironment(class PHY_IPhysicsEnvironment *physEnv)
 {
   m_physicsEnvironment = physEnv;
@@ -2686,6 +2951,14 @@ static void MergeScene_GameObject(KX_GameObject *gameobj, KX_Scene *to, KX_Scene
   if (gameobj->GetGameObjectType() == SCA_IObject::OBJ_ARMATURE)
     to->AddAnimatedObject(gameobj);
 
+  // Pending text updates are done by the new scene.
+  if (gameobj->GetGameObjectType() == SCA_IObject::OBJ_TEXT) {
+    KX_FontObject *font = static_cast<KX_FontObject *>(gameobj);
+    if (font->IsTextModified()) {
+      to->AddModifiedFont(font);
+    }
+  }
+
   /* Add the object to the scene's logic manager */
   to->GetLogicManager()->RegisterGameObjectName(gameobj->GetName(), gameobj);
   to->GetLogicManager()->RegisterGameObj(gameobj->GetBlenderObject(), gameobj);
@@ -2718,6 +2991,9 @@ bool KX_Scene::MergeScene(KX_Scene *other)
   for (KX_GameObject *gameobj : *other->GetObjectList()) {
     MergeScene_GameObject(gameobj, this, other);
 
+    other->GetActivityCullingManager()->UnregisterObject(gameobj);
+    m_activityCullingManager->RegisterObject(gameobj);
+
     /* add properties to debug list for LibLoad objects */
     if (KX_GetActiveEngine()->GetFlag(KX_KetsjiEngine::AUTO_ADD_DEBUG_PROPERTIES)) {
       AddObjectDebugProperties(gameobj);
@@ -2728,6 +3004,8 @@ bool KX_Scene::MergeScene(KX_Scene *other)
     MergeScene_GameObject(gameobj, this, other);
   }
 
+  m_lodSelector->MergeSelector(other->GetLodSelector());
+
   if (env) {
     env->MergeEnvironment(env_other);
     EXP_ListValue<KX_GameObject> *otherObjects = other->GetObjectList();
@@ -2765,6 +3043,7 @@ bool KX_Scene::MergeScene(KX_Scene *other)
 
   GetFontList()->MergeList(other->GetFontList());
   other->GetFontList()->ReleaseAndRemoveAll();
+  other->m_modifiedFonts.clear();
 
   /* move materials across, assume they both use the same scene-converters
    * Do this after lights are merged so materials can use the lights in shaders
@@ -2908,6 +3187,8 @@ PyMethodDef KX_Scene::Methods[] = {
     EXP_PYMETHODTABLE(KX_Scene, addOverlayCollection),
     EXP_PYMETHODTABLE(KX_Scene, removeOverlayCollection),
     EXP_PYMETHODTABLE(KX_Scene, getGameObjectFromObject),
+    EXP_PYMETHODTABLE(KX_Scene, getObjectsArray),
+    EXP_PYMETHODTABLE(KX_Scene, setObjectsArray),
 
     /* dict style access */
     EXP_PYMETHODTABLE(KX_Scene, get),
@@ -3226,6 +3507,36 @@ int KX_Scene::pyattr_set_gravity(EXP_PyObjectPlus *self_v,
   return PY_SET_ATTR_SUCCESS;
 }
 
+PyObject *KX_Scene::pyattr_get_lod_metric(EXP_PyObjectPlus *self_v,
+                                          const EXP_PYATTRIBUTE_DEF *attrdef)
+{
+  KX_Scene *self = static_cast<KX_Scene *>(self_v);
+
+  return PyLong_FromLong(self->m_lodSelector->GetMetric());
+}
+
+int KX_Scene::pyattr_set_lod_metric(EXP_PyObjectPlus *self_v,
+                                    const EXP_PYATTRIBUTE_DEF *attrdef,
+                                    PyObject *value)
+{
+  KX_Scene *self = static_cast<KX_Scene *>(self_v);
+
+  const long metric = PyLong_AsLong(value);
+  if (metric == -1 && PyErr_Occurred()) {
+    return PY_SET_ATTR_FAIL;
+  }
+
+  if (metric !=KX_LodSelector::METRIC_DISTANCE && metric != KX_LodSelector::METRIC_SCREEN_SIZE) {
+    PyErr_SetString(PyExc_ValueError,
+                    "scene.lodMetric = int: KX_Scene, expected KX_LOD_METRIC_DISTANCE or "
+                    "KX_LOD_METRIC_SCREEN_SIZE");
+    return PY_SET_ATTR_FAIL;
+  }
+
+  self->m_lodSelector->SetMetric((KX_LodSelector::Metric)metric);
+  return PY_SET_ATTR_SUCCESS;
+}
+
 PyAttributeDef KX_Scene::Attributes[] = {
     EXP_PYATTRIBUTE_RO_FUNCTION("name", KX_Scene, pyattr_get_name),
     EXP_PYATTRIBUTE_RO_FUNCTION("objects", KX_Scene, pyattr_get_objects),
@@ -3249,6 +3560,8 @@ PyAttributeDef KX_Scene::Attributes[] = {
     EXP_PYATTRIBUTE_RW_FUNCTION(
         "pre_draw_setup", KX_Scene, pyattr_get_drawing_callback, pyattr_set_drawing_callback),
     EXP_PYATTRIBUTE_RW_FUNCTION("gravity", KX_Scene, pyattr_get_gravity, pyattr_set_gravity),
+    EXP_PYATTRIBUTE_RW_FUNCTION(
+        "lodMetric", KX_Scene, pyattr_get_lod_metric, pyattr_set_lod_metric),
     EXP_PYATTRIBUTE_BOOL_RO("activityCulling", KX_Scene, m_activityCulling),
     EXP_PYATTRIBUTE_BOOL_RO("dbvt_culling", KX_Scene, m_dbvt_culling),
     EXP_PYATTRIBUTE_RO_FUNCTION("logger", KX_Scene, KX_PythonProxy::pyattr_get_logger),
@@ -3602,6 +3915,176 @@ EXP_PYMETHODDEF_DOC(KX_Scene,
   Py_RETURN_NONE;
 }
 
+static const char *objectArrayAttributeNames[KX_Scene::OBJECT_ARRAY_MAX] = {
+    "worldPosition",
+    "worldOrientation",
+    "worldScale",
+    "localPosition",
+    "localOrientation",
+    "localScale",
+    "worldLinearVelocity",
+    "worldAngularVelocity"};
+
+/// Convert the objects and attribute name arguments of getObjectsArray and setObjectsArray.
+static bool object_array_parse_args(SCA_LogicManager *logicmgr,
+                                    PyObject *pyobjects,
+                                    const char *name,
+                                    std::vector<KX_GameObject *> &objects,
+                                    KX_Scene::ObjectArrayAttribute &attribute,
+                                    const char *error_prefix)
+{
+  attribute = KX_Scene::OBJECT_ARRAY_MAX;
+  for (unsigned short i = 0; i < KX_Scene::OBJECT_ARRAY_MAX; ++i) {
+    if (strcmp(name, objectArrayAttributeNames[i]) == 0) {
+      attribute = (KX_Scene::ObjectArrayAttribute)i;
+      break;
+    }
+  }
+
+  if (attribute == KX_Scene::OBJECT_ARRAY_MAX) {
+    PyErr_Format(PyExc_ValueError, "%s: unknown attribute \"%s\"", error_prefix, name);
+    return false;
+  }
+
+  PyObject *fast = PySequence_Fast(pyobjects, error_prefix);
+  if (!fast) {
+    return false;
+  }
+
+  const Py_ssize_t size = PySequence_Fast_GET_SIZE(fast);
+  objects.resize(size);
+  for (Py_ssize_t i = 0; i < size; ++i) {
+    if (!ConvertPythonToGameObject(
+            logicmgr, PySequence_Fast_GET_ITEM(fast, i), &objects[i], false, error_prefix)) {
+      Py_DECREF(fast);
+      return false;
+    }
+  }
+
+  Py_DECREF(fast);
+  return true;
+}
+
+/// Get a contiguous buffer of the expected size, made of bytes or 32 bits floats.
+static bool object_array_get_buffer(PyObject *pybuffer,
+                                    Py_buffer &view,
+                                    Py_ssize_t size,
+                                    bool writable,
+                                    const char *error_prefix)
+{
+  const int flags = PyBUF_C_CONTIGUOUS | PyBUF_FORMAT | (writable ? PyBUF_WRITABLE : 0);
+  if (PyObject_GetBuffer(pybuffer, &view, flags) == -1) {
+    return false;
+  }
+
+  const bool isfloat = (view.itemsize == sizeof(float) && view.format &&
+                        view.format[strlen(view.format) - 1] == 'f');
+  if (view.itemsize != 1 && !isfloat) {
+    PyErr_Format(PyExc_TypeError, "%s: expected a buffer of bytes or 32 bits floats", error_prefix);
+    PyBuffer_Release(&view);
+    return false;
+  }
+
+  if (view.len != size) {
+    PyErr_Format(PyExc_ValueError,
+                 "%s: expected a buffer of %zd bytes, got %zd",
+                 error_prefix,
+                 size,
+                 view.len);
+    PyBuffer_Release(&view);
+    return false;
+  }
+
+  return true;
+}
+
+EXP_PYMETHODDEF_DOC(KX_Scene,
+                    getObjectsArray,
+                    "getObjectsArray(objects, attribute, buffer=None)\n"
+                    "Copy an attribute of each object into a packed float buffer.\n")
+{
+  PyObject *pyobjects;
+  const char *name;
+  PyObject *pybuffer = Py_None;
+
+  if (!PyArg_ParseTuple(args, "Os|O:getObjectsArray", &pyobjects, &name, &pybuffer)) {
+    return nullptr;
+  }
+
+  std::vector<KX_GameObject *> objects;
+  ObjectArrayAttribute attribute;
+  if (!object_array_parse_args(m_logicmgr,
+                               pyobjects,
+                               name,
+                               objects,
+                               attribute,
+                               "scene.getObjectsArray(objects, attribute, buffer)")) {
+    return nullptr;
+  }
+
+  std::vector<float> data(objects.size() * GetObjectArrayStride(attribute));
+  GetObjectsArray(objects, attribute, data.data());
+  const Py_ssize_t size = data.size() * sizeof(float);
+
+  if (pybuffer == Py_None) {
+    return PyByteArray_FromStringAndSize((const char *)data.data(), size);
+  }
+
+  Py_buffer view;
+  if (!object_array_get_buffer(
+          pybuffer, view, size, true, "scene.getObjectsArray(objects, attribute, buffer)")) {
+    return nullptr;
+  }
+
+  memcpy(view.buf, data.data(), size);
+  PyBuffer_Release(&view);
+
+  Py_INCREF(pybuffer);
+  return pybuffer;
+}
+
+EXP_PYMETHODDEF_DOC(KX_Scene,
+                    setObjectsArray,
+                    "setObjectsArray(objects, attribute, buffer)\n"
+                    "Set an attribute of each object from a packed float buffer.\n")
+{
+  PyObject *pyobjects;
+  const char *name;
+  PyObject *pybuffer;
+
+  if (!PyArg_ParseTuple(args, "OsO:setObjectsArray", &pyobjects, &name, &pybuffer)) {
+    return nullptr;
+  }
+
+  std::vector<KX_GameObject *> objects;
+  ObjectArrayAttribute attribute;
+  if (!object_array_parse_args(m_logicmgr,
+                               pyobjects,
+                               name,
+                               objects,
+                               attribute,
+                               "scene.setObjectsArray(objects, attribute, buffer)")) {
+    return nullptr;
+  }
+
+  std::vector<float> data(objects.size() * GetObjectArrayStride(attribute));
+  const Py_ssize_t size = data.size() * sizeof(float);
+
+  Py_buffer view;
+  if (!object_array_get_buffer(
+          pybuffer, view, size, false, "scene.setObjectsArray(objects, attribute, buffer)")) {
+    return nullptr;
+  }
+
+  // Copy to an aligned array, the buffer could be made of bytes.
+  memcpy(data.data(), view.buf, size);
+  PyBuffer_Release(&view);
+
+  SetObjectsArray(objects, attribute, data.data());
+
+  Py_RETURN_NONE;
+}
+
 bool ConvertPythonToScene(PyObject *value,
                           KX_Scene **scene,
                           bool py_none_ok,
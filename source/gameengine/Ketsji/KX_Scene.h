@@ -83,6 +83,8 @@ class KX_2DFilterManager;
 class BL_SceneConverter;
 struct KX_ClientObjectInfo;
 class KX_ObstacleSimulation;
+class KX_ActivityCullingManager;
+class KX_LodSelector;
 struct TaskPool;
 
 /*********EEVEE INTEGRATION************/
@@ -134,7 +136,8 @@ class KX_Scene : public KX_PythonProxy, public SCA_IScene {
   std::vector<KX_Camera *> m_imageRenderCameraList;
   BL_SceneConverter *m_sceneConverter;
   bool m_isPythonMainLoop;
-  std::vector<KX_GameObject *> m_kxobWithLod;
+  /// Lod level selection of the objects with a lod manager.
+  KX_LodSelector *m_lodSelector;
   std::map<Object *, char> m_obRestrictFlags;
   bool m_collectionRemap;
   std::vector<BackupObj *> m_backupObList;
@@ -174,6 +177,8 @@ class KX_Scene : public KX_PythonProxy, public SCA_IScene {
   EXP_ListValue<KX_Camera> *m_cameralist;
   /// The set of fonts for this scene
   EXP_ListValue<KX_FontObject> *m_fontlist;
+  /// Fonts with a modified "Text" property, updated at the end of the logic frame.
+  std::vector<KX_FontObject *> m_modifiedFonts;
 
   SG_QList m_sghead;  // list of nodes that needs scenegraph update
                       // the Dlist is not object that must be updated
@@ -300,6 +305,9 @@ class KX_Scene : public KX_PythonProxy, public SCA_IScene {
 
   KX_ObstacleSimulation *m_obstacleSimulation;
 
+  /// Object positions and grid used by the activity culling.
+  KX_ActivityCullingManager *m_activityCullingManager;
+
   AnimationPoolData m_animationPoolData;
   TaskPool *m_animationPool;
 
@@ -409,6 +417,10 @@ class KX_Scene : public KX_PythonProxy, public SCA_IScene {
   void ReplaceMesh(KX_GameObject *gameobj, RAS_MeshObject *mesh, bool use_gfx, bool use_phys);
 
   void AddAnimatedObject(KX_GameObject *gameobj);
+  /// Request the update of the font text at the end of the logic frame.
+  void AddModifiedFont(KX_FontObject *font);
+  /// Update the name lookup of the object lists after a game object was renamed.
+  void UpdateObjectName(KX_GameObject *gameobj, const std::string &oldname);
 
   /**
    * \section Logic stuff
@@ -536,6 +548,32 @@ class KX_Scene : public KX_PythonProxy, public SCA_IScene {
   void SetGravity(const MT_Vector3 &gravity);
   MT_Vector3 GetGravity();
 
+  /// Game object attributes read and written in bulk as packed float arrays.
+  enum ObjectArrayAttribute {
+    OBJECT_ARRAY_WORLD_POSITION = 0,
+    OBJECT_ARRAY_WORLD_ORIENTATION,
+    OBJECT_ARRAY_WORLD_SCALE,
+    OBJECT_ARRAY_LOCAL_POSITION,
+    OBJECT_ARRAY_LOCAL_ORIENTATION,
+    OBJECT_ARRAY_LOCAL_SCALE,
+    OBJECT_ARRAY_LINEAR_VELOCITY,
+    OBJECT_ARRAY_ANGULAR_VELOCITY,
+    OBJECT_ARRAY_MAX
+  };
+
+  /// Number of floats per object of an attribute, orientations are 3x3 row major matrices.
+  static unsigned short GetObjectArrayStride(ObjectArrayAttribute attribute);
+  /// Copy an attribute of each object into data.
+  void GetObjectsArray(const std::vector<KX_GameObject *> &objects,
+                       ObjectArrayAttribute attribute,
+                       float *data);
+  /** Set an attribute of each object from data, the scene graph and physics
+   * transforms are updated once for the whole batch.
+   */
+  void SetObjectsArray(const std::vector<KX_GameObject *> &objects,
+                       ObjectArrayAttribute attribute,
+                       const float *data);
+
   short GetAnimationFPS();
 
   /**
@@ -552,6 +590,16 @@ class KX_Scene : public KX_PythonProxy, public SCA_IScene {
     return m_obstacleSimulation;
   }
 
+  KX_ActivityCullingManager *GetActivityCullingManager()
+  {
+    return m_activityCullingManager;
+  }
+
+  KX_LodSelector *GetLodSelector()
+  {
+    return m_lodSelector;
+  }
+
   /**  Inherited from EXP_Value -- returns the name of this object. */
   virtual std::string GetName();
 
@@ -579,6 +627,8 @@ class KX_Scene : public KX_PythonProxy, public SCA_IScene {
   EXP_PYMETHOD_DOC(KX_Scene, addOverlayCollection);
   EXP_PYMETHOD_DOC(KX_Scene, removeOverlayCollection);
   EXP_PYMETHOD_DOC(KX_Scene, getGameObjectFromObject);
+  EXP_PYMETHOD_DOC(KX_Scene, getObjectsArray);
+  EXP_PYMETHOD_DOC(KX_Scene, setObjectsArray);
 
   /* attributes */
   static PyObject *pyattr_get_name(EXP_PyObjectPlus *self_v, const EXP_PYATTRIBUTE_DEF *attrdef);
@@ -617,6 +667,11 @@ class KX_Scene : public KX_PythonProxy, public SCA_IScene {
   static int pyattr_set_gravity(EXP_PyObjectPlus *self_v,
                                 const EXP_PYATTRIBUTE_DEF *attrdef,
                                 PyObject *value);
+  static PyObject *pyattr_get_lod_metric(EXP_PyObjectPlus *self_v,
+                                         const EXP_PYATTRIBUTE_DEF *attrdef);
+  static int pyattr_set_lod_metric(EXP_PyObjectPlus *self_v,
+                                   const EXP_PYATTRIBUTE_DEF *attrdef,
+                                   PyObject *value);
 
   /* getitem/setitem */
   static PyMappingMethods Mapping;
@@ -40,6 +40,8 @@
 #include "CM_Message.h"
 #include "DEV_EventConsumer.h"
 #include "DEV_InputDevice.h"
+#include "DEV_InputRecorder.h"
+#include "DEV_InputReplay.h"
 #include "DEV_Joystick.h"
 #include "GHOST_C-api.h"
 #include "GHOST_ISystem.hh"
@@ -81,6 +83,8 @@ LA_Launcher::LA_Launcher(GHOST_ISystem *system,
       m_kxsystem(nullptr),
       m_inputDevice(nullptr),
       m_eventConsumer(nullptr),
+      m_inputRecorder(nullptr),
+      m_inputReplay(nullptr),
       m_canvas(nullptr),
       m_rasterizer(nullptr),
       m_converter(nullptr),
@@ -141,6 +145,10 @@ void LA_Launcher::InitEngine()
   bool frameRate = (SYS_GetCommandLineInt(syshandle, "show_framerate", 0) != 0);
   bool nodepwarnings = (SYS_GetCommandLineInt(syshandle, "ignore_deprecation_warnings", 1) != 0);
   bool restrictAnimFPS = (gm.flag & GAME_RESTRICT_ANIM_UPDATES) != 0;
+  const std::string recordInput = SYS_GetCommandLineString(syshandle, "record_input", "");
+  const std::string replayInput = SYS_GetCommandLineString(syshandle, "replay_input", "");
+  const int framePacing = SYS_GetCommandLineInt(
+      syshandle, "frame_pacing", KX_FramePacer::POLICY_LOW_LATENCY);
 
   // Setup python console keys used as shortcut.
   for (unsigned short i = 0; i < 4; ++i) {
@@ -194,6 +202,22 @@ void LA_Launcher::InitEngine()
 
   // Create the inputdevices.
   m_inputDevice = new DEV_InputDevice();
+
+  if (!replayInput.empty()) {
+    m_inputReplay = new DEV_InputReplay(replayInput);
+    if (m_inputReplay->IsValid()) {
+      m_inputDevice->SetReplay(m_inputReplay);
+    }
+    else {
+      delete m_inputReplay;
+      m_inputReplay = nullptr;
+    }
+  }
+  else if (!recordInput.empty()) {
+    m_inputRecorder = new DEV_InputRecorder(recordInput);
+    m_inputDevice->SetRecorder(m_inputRecorder);
+  }
+
   m_eventConsumer = new DEV_EventConsumer(m_system, m_inputDevice, m_canvas);
   m_system->addEventConsumer(m_eventConsumer);
 
@@ -223,11 +247,18 @@ void LA_Launcher::InitEngine()
 #endif
 
   m_ketsjiEngine->SetFlag(flags, true);
+  if (m_inputReplay) {
+    // The replay drives the engine with the recorded clock times.
+    m_ketsjiEngine->SetFlag(KX_KetsjiEngine::USE_EXTERNAL_CLOCK, true);
+  }
   m_ketsjiEngine->SetRender(true);
 
   m_ketsjiEngine->SetTicRate(gm.ticrate);
   m_ketsjiEngine->SetMaxLogicFrame(gm.maxlogicstep);
   m_ketsjiEngine->SetMaxPhysicsFrame(gm.maxphystep);
+  if (framePacing >= KX_FramePacer::POLICY_NONE && framePacing <= KX_FramePacer::POLICY_LOW_CPU) {
+    m_ketsjiEngine->SetFramePacing((KX_FramePacer::Policy)framePacing);
+  }
   m_ketsjiEngine->SetTimeScale(gm.timeScale);
 
   // Set the global settings (carried over if restart/load new files).
@@ -338,6 +369,14 @@ void LA_Launcher::ExitEngine()
     delete m_inputDevice;
     m_inputDevice = nullptr;
   }
+  if (m_inputRecorder) {
+    delete m_inputRecorder;
+    m_inputRecorder = nullptr;
+  }
+  if (m_inputReplay) {
+    delete m_inputReplay;
+    m_inputReplay = nullptr;
+  }
   if (m_eventConsumer) {
     m_system->removeEventConsumer(m_eventConsumer);
     delete m_eventConsumer;
@@ -468,9 +507,23 @@ bool LA_Launcher::EngineNextFrame()
   // Check if we can create a python console debugging.
   HandlePythonConsole();
 #endif
+  if (m_inputReplay) {
+    double clockTime;
+    if (!m_inputReplay->NextClockTime(clockTime)) {
+      CM_Message("Input replay finished");
+      m_exitRequested = KX_ExitRequest::QUIT_GAME;
+      return false;
+    }
+    m_ketsjiEngine->SetClockTime(clockTime);
+  }
+
   // Kick the engine.
   bool renderFrame = m_ketsjiEngine->NextFrame();
 
+  if (m_inputRecorder) {
+    m_inputRecorder->WriteClock(m_ketsjiEngine->GetClockTime());
+  }
+
   // First check if we want to exit.
   m_exitRequested = m_ketsjiEngine->GetExitCode();
   m_exitString = m_ketsjiEngine->GetExitString();
@@ -40,6 +40,8 @@ class KX_NetworkMessageManager;
 class RAS_ICanvas;
 class DEV_EventConsumer;
 class DEV_InputDevice;
+class DEV_InputRecorder;
+class DEV_InputReplay;
 class GHOST_ISystem;
 struct Scene;
 struct Main;
@@ -70,6 +72,9 @@ class LA_Launcher {
   /// The game engine's input device abstraction.
   DEV_InputDevice *m_inputDevice;
   DEV_EventConsumer *m_eventConsumer;
+  /// Input events recording and replay enabled from the command line.
+  DEV_InputRecorder *m_inputRecorder;
+  DEV_InputReplay *m_inputReplay;
   /// The game engine's canvas abstraction.
   RAS_ICanvas *m_canvas;
   /// The rasterizer.
@@ -0,0 +1,655 @@
+#include "CcdBroadphase.h"
+
+#include <algorithm>
+
+#include "BulletCollision/BroadphaseCollision/btOverlappingPairCache.h"
+#include "BulletCollision/CollisionDispatch/btCollisionObject.h"
+#include "LinearMath/btAabbUtil2.h"
+
+/// Grid cell coordinates are packed on 21 bits each.
+static const int gridCoordMax = (1 << 20) - 1;
+/// Above this number of cells a proxy is not stored in the grid.
+static const int gridMaxCells = 512;
+
+static bool IsStaticProxy(void *userPtr)
+{
+  const btCollisionObject *object = static_cast<const btCollisionObject *>(userPtr);
+  return object && object->isStaticObject();
+}
+
+/// Register pairs between a proxy and the leaves of a tree.
+struct CcdTreePairCollider : btDbvt::ICollide {
+  btOverlappingPairCache *m_pairCache;
+  btBroadphaseProxy *m_proxy;
+
+  CcdTreePairCollider(btOverlappingPairCache *pairCache, btBroadphaseProxy *proxy)
+      : m_pairCache(pairCache), m_proxy(proxy)
+  {
+  }
+
+  void Process(const btDbvtNode *leaf)
+  {
+    btBroadphaseProxy *other = static_cast<btBroadphaseProxy *>(leaf->data);
+    if (other != m_proxy) {
+      m_pairCache->addOverlappingPair(m_proxy, other);
+    }
+  }
+};
+
+CcdDbvtBroadphase::CcdDbvtBroadphase() : m_staticInserted(0)
+{
+  // Don't re-optimize the fixed set every step, it's rebuilt when statics are added.
+  m_fupdates = 0;
+}
+
+CcdDbvtBroadphase::~CcdDbvtBroadphase()
+{
+}
+
+btBroadphaseProxy *CcdDbvtBroadphase::createProxy(const btVector3 &aabbMin,
+                                                  const btVector3 &aabbMax,
+                                                  int shapeType,
+                                                  void *userPtr,
+                                                  int collisionFilterGroup,
+                                                  int collisionFilterMask,
+                                                  btDispatcher *dispatcher)
+{
+  if (!IsStaticProxy(userPtr)) {
+    return btDbvtBroadphase::createProxy(aabbMin,
+                                         aabbMax,
+                                         shapeType,
+                                         userPtr,
+                                         collisionFilterGroup,
+                                         collisionFilterMask,
+                                         dispatcher);
+  }
+
+  btDbvtProxy *proxy = new (btAlignedAlloc(sizeof(btDbvtProxy), 16))
+      btDbvtProxy(aabbMin, aabbMax, userPtr, collisionFilterGroup, collisionFilterMask);
+  const btDbvtVolume aabb = btDbvtVolume::FromMM(aabbMin, aabbMax);
+  proxy->stage = STAGECOUNT;
+  proxy->m_uniqueId = ++m_gid;
+  proxy->leaf = m_sets[FIXED_SET].insert(aabb, proxy);
+
+  // Link in the fixed proxy list as btDbvtBroadphase::destroyProxy expects.
+  proxy->links[0] = nullptr;
+  proxy->links[1] = m_stageRoots[STAGECOUNT];
+  if (m_stageRoots[STAGECOUNT]) {
+    m_stageRoots[STAGECOUNT]->links[0] = proxy;
+  }
+  m_stageRoots[STAGECOUNT] = proxy;
+
+  ++m_staticInserted;
+
+  // Proxies at rest don't query the tree again, register the pairs now.
+  CcdTreePairCollider collider(m_paircache, proxy);
+  m_sets[DYNAMIC_SET].collideTV(m_sets[DYNAMIC_SET].m_root, aabb, collider);
+  m_sets[FIXED_SET].collideTV(m_sets[FIXED_SET].m_root, aabb, collider);
+
+  return proxy;
+}
+
+void CcdDbvtBroadphase::setAabb(btBroadphaseProxy *absproxy,
+                                const btVector3 &aabbMin,
+                                const btVector3 &aabbMax,
+                                btDispatcher *dispatcher)
+{
+  btDbvtProxy *proxy = static_cast<btDbvtProxy *>(absproxy);
+  const btCollisionObject *object = static_cast<const btCollisionObject *>(
+      proxy->m_clientObject);
+  // Dynamic objects at rest are in the fixed tree too, they are moved back when awaken.
+  if (proxy->stage != STAGECOUNT || !object || !object->isStaticObject() ||
+      object->isKinematicObject())
+  {
+    btDbvtBroadphase::setAabb(absproxy, aabbMin, aabbMax, dispatcher);
+    return;
+  }
+
+  if (proxy->m_aabbMin == aabbMin && proxy->m_aabbMax == aabbMax) {
+    return;
+  }
+
+  // The static object was moved or scaled, update its leaf in place.
+  const btDbvtVolume aabb = btDbvtVolume::FromMM(aabbMin, aabbMax);
+  proxy->m_aabbMin = aabbMin;
+  proxy->m_aabbMax = aabbMax;
+  m_sets[FIXED_SET].update(proxy->leaf, aabb);
+  m_needcleanup = true;
+
+  CcdTreePairCollider collider(m_paircache, proxy);
+  m_sets[DYNAMIC_SET].collideTV(m_sets[DYNAMIC_SET].m_root, aabb, collider);
+  m_sets[FIXED_SET].collideTV(m_sets[FIXED_SET].m_root, aabb, collider);
+}
+
+void CcdDbvtBroadphase::calculateOverlappingPairs(btDispatcher *dispatcher)
+{
+#ifdef BT_DEBUG
+  // Check that no static proxy was moved to the dynamic tree.
+  for (int stage = 0; stage < STAGECOUNT; ++stage) {
+    for (btDbvtProxy *proxy = m_stageRoots[stage]; proxy; proxy = proxy->links[1]) {
+      const btCollisionObject *object = static_cast<const btCollisionObject *>(
+          proxy->m_clientObject);
+      btAssert(!object || !object->isStaticObject() || object->isKinematicObject());
+    }
+  }
+#endif
+
+
+  // Rebuild the fixed tree once when it was mostly filled by insertions.
+  if (m_staticInserted > 0 && m_staticInserted * 10 >= m_sets[FIXED_SET].m_leaves) {
+    m_sets[FIXED_SET].optimizeTopDown();
+    m_staticInserted = 0;
+  }
+
+  btDbvtBroadphase::calculateOverlappingPairs(dispatcher);
+}
+
+CcdGridBroadphase::Proxy::Proxy(const btVector3 &aabbMin,
+                                const btVector3 &aabbMax,
+                                void *userPtr,
+                                int collisionFilterGroup,
+                                int collisionFilterMask)
+    : btBroadphaseProxy(aabbMin, aabbMax, userPtr, collisionFilterGroup, collisionFilterMask),
+      m_static(false),
+      m_large(false),
+      m_moved(false),
+      m_leaf(nullptr),
+      m_index(-1),
+      m_stamp(0)
+{
+}
+
+CcdGridBroadphase::CcdGridBroadphase(btScalar cellSize, btOverlappingPairCache *pairCache)
+    : m_pairCache(pairCache),
+      m_ownsPairCache(false),
+      m_cellSize(cellSize),
+      m_invCellSize(btScalar(1) / cellSize),
+      m_staticInserted(0),
+      m_stamp(0),
+      m_uid(0)
+{
+  if (!m_pairCache) {
+    void *mem = btAlignedAlloc(sizeof(btHashedOverlappingPairCache), 16);
+    m_pairCache = new (mem) btHashedOverlappingPairCache();
+    m_ownsPairCache = true;
+  }
+}
+
+CcdGridBroadphase::~CcdGridBroadphase()
+{
+  for (Proxy *proxy : m_dynamicProxies) {
+    delete proxy;
+  }
+
+  struct StaticDeleter : btDbvt::ICollide {
+    void Process(const btDbvtNode *leaf)
+    {
+      delete static_cast<Proxy *>(leaf->data);
+    }
+  } deleter;
+  btDbvt::enumLeaves(m_staticTree.m_root, deleter);
+
+  if (m_ownsPairCache) {
+    m_pairCache->~btOverlappingPairCache();
+    btAlignedFree(m_pairCache);
+  }
+}
+
+void CcdGridBroadphase::ComputeCellRange(const btVector3 &aabbMin,
+                                         const btVector3 &aabbMax,
+                                         int cellMin[3],
+                                         int cellMax[3]) const
+{
+  for (unsigned short i = 0; i < 3; ++i) {
+    const btScalar min = btFloor(aabbMin[i] * m_invCellSize);
+    const btScalar max = btFloor(aabbMax[i] * m_invCellSize);
+    cellMin[i] = int(btClamped(min, btScalar(-gridCoordMax), btScalar(gridCoordMax)));
+    cellMax[i] = int(btClamped(max, btScalar(-gridCoordMax), btScalar(gridCoordMax)));
+  }
+}
+
+static uint64_t CellKey(int x, int y, int z)
+{
+  return ((uint64_t(x) & 0x1FFFFF) << 42) | ((uint64_t(y) & 0x1FFFFF) << 21) |
+         (uint64_t(z) & 0x1FFFFF);
+}
+
+static int CellCount(const int cellMin[3], const int cellMax[3])
+{
+  int64_t count = 1;
+  for (unsigned short i = 0; i < 3; ++i) {
+    count *= int64_t(cellMax[i]) - cellMin[i] + 1;
+    if (count > gridMaxCells) {
+      return gridMaxCells + 1;
+    }
+  }
+  return int(count);
+}
+
+void CcdGridBroadphase::InsertInGrid(Proxy *proxy)
+{
+  ComputeCellRange(proxy->m_aabbMin, proxy->m_aabbMax, proxy->m_cellMin, proxy->m_cellMax);
+
+  if (CellCount(proxy->m_cellMin, proxy->m_cellMax) > gridMaxCells) {
+    proxy->m_large = true;
+    m_largeProxies.push_back(proxy);
+    return;
+  }
+
+  proxy->m_large = false;
+  for (int x = proxy->m_cellMin[0]; x <= proxy->m_cellMax[0]; ++x) {
+    for (int y = proxy->m_cellMin[1]; y <= proxy->m_cellMax[1]; ++y) {
+      for (int z = proxy->m_cellMin[2]; z <= proxy->m_cellMax[2]; ++z) {
+        m_cells[CellKey(x, y, z)].push_back(proxy);
+      }
+    }
+  }
+}
+
+void CcdGridBroadphase::RemoveFromGrid(Proxy *proxy)
+{
+  if (proxy->m_large) {
+    m_largeProxies.erase(std::find(m_largeProxies.begin(), m_largeProxies.end(), proxy));
+    return;
+  }
+
+  for (int x = proxy->m_cellMin[0]; x <= proxy->m_cellMax[0]; ++x) {
+    for (int y = proxy->m_cellMin[1]; y <= proxy->m_cellMax[1]; ++y) {
+      for (int z = proxy->m_cellMin[2]; z <= proxy->m_cellMax[2]; ++z) {
+        auto it = m_cells.find(CellKey(x, y, z));
+        std::vector<Proxy *> &cell = it->second;
+        std::vector<Proxy *>::iterator pit = std::find(cell.begin(), cell.end(), proxy);
+        *pit = cell.back();
+        cell.pop_back();
+        // Don't keep the cells of the whole area traversed by moving objects.
+        if (cell.empty()) {
+          m_cells.erase(it);
+        }
+      }
+    }
+  }
+}
+
+void CcdGridBroadphase::MarkMoved(Proxy *proxy)
+{
+  if (!proxy->m_moved) {
+    proxy->m_moved = true;
+    m_movedProxies.push_back(proxy);
+  }
+}
+
+template<class Func>
+void CcdGridBroadphase::ForEachDynamic(const btVector3 &aabbMin,
+                                       const btVector3 &aabbMax,
+                                       Func func)
+{
+  const unsigned int stamp = ++m_stamp;
+
+  auto test = [&](Proxy *other) {
+    if (other->m_stamp == stamp) {
+      return;
+    }
+    other->m_stamp = stamp;
+    if (TestAabbAgainstAabb2(aabbMin, aabbMax, other->m_aabbMin, other->m_aabbMax)) {
+      func(other);
+    }
+  };
+
+  int cellMin[3];
+  int cellMax[3];
+  ComputeCellRange(aabbMin, aabbMax, cellMin, cellMax);
+
+  if (CellCount(cellMin, cellMax) > gridMaxCells) {
+    // Cheaper to test every proxy than to look for all the cells.
+    for (Proxy *other : m_dynamicProxies) {
+      test(other);
+    }
+    return;
+  }
+
+  for (int x = cellMin[0]; x <= cellMax[0]; ++x) {
+    for (int y = cellMin[1]; y <= cellMax[1]; ++y) {
+      for (int z = cellMin[2]; z <= cellMax[2]; ++z) {
+        auto it = m_cells.find(CellKey(x, y, z));
+        if (it != m_cells.end()) {
+          for (Proxy *other : it->second) {
+            test(other);
+          }
+        }
+      }
+    }
+  }
+
+  for (Proxy *other : m_largeProxies) {
+    test(other);
+  }
+}
+
+void CcdGridBroadphase::FindPairs(Proxy *proxy)
+{
+  if (!proxy->m_static) {
+    CcdTreePairCollider collider(m_pairCache, proxy);
+    m_staticTree.collideTV(
+        m_staticTree.m_root, btDbvtVolume::FromMM(proxy->m_aabbMin, proxy->m_aabbMax), collider);
+  }
+
+  ForEachDynamic(proxy->m_aabbMin, proxy->m_aabbMax, [this, proxy](Proxy *other) {
+    if (other != proxy) {
+      m_pairCache->addOverlappingPair(proxy, other);
+    }
+  });
+}
+
+btBroadphaseProxy *CcdGridBroadphase::createProxy(const btVector3 &aabbMin,
+                                                  const btVector3 &aabbMax,
+                                                  int shapeType,
+                                                  void *userPtr,
+                                                  int collisionFilterGroup,
+                                                  int collisionFilterMask,
+                                                  btDispatcher *dispatcher)
+{
+  Proxy *proxy = new Proxy(aabbMin, aabbMax, userPtr, collisionFilterGroup, collisionFilterMask);
+  proxy->m_uniqueId = ++m_uid;
+
+  if (IsStaticProxy(userPtr)) {
+    proxy->m_static = true;
+    proxy->m_leaf = m_staticTree.insert(btDbvtVolume::FromMM(aabbMin, aabbMax), proxy);
+    ++m_staticInserted;
+  }
+  else {
+    proxy->m_index = m_dynamicProxies.size();
+    m_dynamicProxies.push_back(proxy);
+    InsertInGrid(proxy);
+  }
+
+  MarkMoved(proxy);
+
+  return proxy;
+}
+
+void CcdGridBroadphase::destroyProxy(btBroadphaseProxy *proxy, btDispatcher *dispatcher)
+{
+  Proxy *gridProxy = static_cast<Proxy *>(proxy);
+
+  m_pairCache->removeOverlappingPairsContainingProxy(proxy, dispatcher);
+
+  if (gridProxy->m_static) {
+    m_staticTree.remove(gridProxy->m_leaf);
+  }
+  else {
+    RemoveFromGrid(gridProxy);
+    Proxy *last = m_dynamicProxies.back();
+    last->m_index = gridProxy->m_index;
+    m_dynamicProxies[gridProxy->m_index] = last;
+    m_dynamicProxies.pop_back();
+  }
+
+  if (gridProxy->m_moved) {
+    m_movedProxies.erase(std::find(m_movedProxies.begin(), m_movedProxies.end(), gridProxy));
+  }
+
+  delete gridProxy;
+}
+
+void CcdGridBroadphase::setAabb(btBroadphaseProxy *proxy,
+                                const btVector3 &aabbMin,
+                                const btVector3 &aabbMax,
+                                btDispatcher *dispatcher)
+{
+  // The world updates the AABB of every active object, even when not moving.
+  if (proxy->m_aabbMin == aabbMin && proxy->m_aabbMax == aabbMax) {
+    return;
+  }
+
+  Proxy *gridProxy = static_cast<Proxy *>(proxy);
+  gridProxy->m_aabbMin = aabbMin;
+  gridProxy->m_aabbMax = aabbMax;
+
+  if (gridProxy->m_static) {
+    m_staticTree.update(gridProxy->m_leaf, btDbvtVolume::FromMM(aabbMin, aabbMax));
+  }
+  else {
+    int cellMin[3];
+    int cellMax[3];
+    ComputeCellRange(aabbMin, aabbMax, cellMin, cellMax);
+    if (!std::equal(cellMin, cellMin + 3, gridProxy->m_cellMin) ||
+        !std::equal(cellMax, cellMax + 3, gridProxy->m_cellMax))
+    {
+      RemoveFromGrid(gridProxy);
+      InsertInGrid(gridProxy);
+    }
+  }
+
+  MarkMoved(gridProxy);
+}
+
+void CcdGridBroadphase::getAabb(btBroadphaseProxy *proxy,
+                                btVector3 &aabbMin,
+                                btVector3 &aabbMax) const
+{
+  aabbMin = proxy->m_aabbMin;
+  aabbMax = proxy->m_aabbMax;
+}
+
+void CcdGridBroadphase::rayTest(const btVector3 &rayFrom,
+                                const btVector3 &rayTo,
+                                btBroadphaseRayCallback &rayCallback,
+                                const btVector3 &aabbMin,
+                                const btVector3 &aabbMax)
+{
+  struct RayCollider : btDbvt::ICollide {
+    btBroadphaseRayCallback &m_callback;
+
+    RayCollider(btBroadphaseRayCallback &callback) : m_callback(callback)
+    {
+    }
+
+    void Process(const btDbvtNode *leaf)
+    {
+      m_callback.process(static_cast<btBroadphaseProxy *>(leaf->data));
+    }
+  } collider(rayCallback);
+
+  m_staticTree.rayTestInternal(m_staticTree.m_root,
+                               rayFrom,
+                               rayTo,
+                               rayCallback.m_rayDirectionInverse,
+                               rayCallback.m_signs,
+                               rayCallback.m_lambda_max,
+                               aabbMin,
+                               aabbMax,
+                               m_rayTestStack,
+                               collider);
+
+  if (m_dynamicProxies.empty()) {
+    return;
+  }
+
+  const unsigned int stamp = ++m_stamp;
+
+  auto test = [&](Proxy *proxy) {
+    if (proxy->m_stamp == stamp) {
+      return;
+    }
+    proxy->m_stamp = stamp;
+
+    // Proxies are extended by the box swept along the ray.
+    btVector3 bounds[2];
+    bounds[0] = proxy->m_aabbMin - aabbMax;
+    bounds[1] = proxy->m_aabbMax - aabbMin;
+    btScalar lambda;
+    if (btRayAabb2(rayFrom,
+                   rayCallback.m_rayDirectionInverse,
+                   rayCallback.m_signs,
+                   bounds,
+                   lambda,
+                   0,
+                   rayCallback.m_lambda_max))
+    {
+      rayCallback.process(proxy);
+    }
+  };
+
+  for (Proxy *proxy : m_largeProxies) {
+    test(proxy);
+  }
+
+  const btVector3 dir = rayTo - rayFrom;
+  const btVector3 rayEnd = rayFrom + dir * rayCallback.m_lambda_max;
+
+  /* Cells around a ray cell overlapped by the swept box, and number of cells crossed by the
+   * ray. */
+  int boxMin[3];
+  int boxMax[3];
+  int64_t boxCellsNum = 1;
+  int64_t rayCellsNum = 1;
+  bool inGrid = true;
+  for (unsigned short i = 0; i < 3; ++i) {
+    const btScalar from = btFloor(rayFrom[i] * m_invCellSize);
+    const btScalar to = btFloor(rayEnd[i] * m_invCellSize);
+    inGrid &= (btFabs(from) < btScalar(gridCoordMax) && btFabs(to) < btScalar(gridCoordMax));
+    boxMin[i] = int(btClamped(
+        btFloor(aabbMin[i] * m_invCellSize), btScalar(-gridCoordMax), btScalar(0)));
+    boxMax[i] = int(
+        btClamped(btCeil(aabbMax[i] * m_invCellSize), btScalar(0), btScalar(gridCoordMax)));
+    boxCellsNum *= int64_t(boxMax[i]) - boxMin[i] + 1;
+    if (inGrid) {
+      rayCellsNum += int64_t(btFabs(to - from));
+    }
+  }
+  const int64_t proxiesNum = m_dynamicProxies.size();
+  if (!inGrid || boxCellsNum > proxiesNum || boxCellsNum * rayCellsNum > proxiesNum) {
+    // Cheaper to test every proxy than to look for all the cells.
+    for (Proxy *proxy : m_dynamicProxies) {
+      test(proxy);
+    }
+    return;
+  }
+
+  // Traverse the cells crossed by the ray (3D DDA), in ray parameter units.
+  int cell[3];
+  int step[3];
+  btScalar tMax[3];
+  btScalar tDelta[3];
+  for (unsigned short i = 0; i < 3; ++i) {
+    cell[i] = int(btFloor(rayFrom[i] * m_invCellSize));
+    if (dir[i] > btScalar(0)) {
+      step[i] = 1;
+      tMax[i] = (btScalar(cell[i] + 1) * m_cellSize - rayFrom[i]) / dir[i];
+      tDelta[i] = m_cellSize / dir[i];
+    }
+    else if (dir[i] < btScalar(0)) {
+      step[i] = -1;
+      tMax[i] = (btScalar(cell[i]) * m_cellSize - rayFrom[i]) / dir[i];
+      tDelta[i] = -m_cellSize / dir[i];
+    }
+    else {
+      step[i] = 0;
+      tMax[i] = BT_LARGE_FLOAT;
+      tDelta[i] = BT_LARGE_FLOAT;
+    }
+  }
+
+  while (true) {
+    for (int x = cell[0] + boxMin[0]; x <= cell[0] + boxMax[0]; ++x) {
+      for (int y = cell[1] + boxMin[1]; y <= cell[1] + boxMax[1]; ++y) {
+        for (int z = cell[2] + boxMin[2]; z <= cell[2] + boxMax[2]; ++z) {
+          auto it = m_cells.find(CellKey(x, y, z));
+          if (it != m_cells.end()) {
+            for (Proxy *proxy : it->second) {
+              test(proxy);
+            }
+          }
+        }
+      }
+    }
+
+    const unsigned short axis = (tMax[0] < tMax[1]) ? ((tMax[0] < tMax[2]) ? 0 : 2) :
+                                                      ((tMax[1] < tMax[2]) ? 1 : 2);
+    // The callback shortens the ray to the closest hit found.
+    if (tMax[axis] > rayCallback.m_lambda_max) {
+      break;
+    }
+    cell[axis] += step[axis];
+    tMax[axis] += tDelta[axis];
+  }
+}
+
+void CcdGridBroadphase::aabbTest(const btVector3 &aabbMin,
+                                 const btVector3 &aabbMax,
+                                 btBroadphaseAabbCallback &callback)
+{
+  struct AabbCollider : btDbvt::ICollide {
+    btBroadphaseAabbCallback &m_callback;
+
+    AabbCollider(btBroadphaseAabbCallback &callback) : m_callback(callback)
+    {
+    }
+
+    void Process(const btDbvtNode *leaf)
+    {
+      m_callback.process(static_cast<btBroadphaseProxy *>(leaf->data));
+    }
+  } collider(callback);
+
+  m_staticTree.collideTV(m_staticTree.m_root, btDbvtVolume::FromMM(aabbMin, aabbMax), collider);
+
+  ForEachDynamic(aabbMin, aabbMax, [&callback](Proxy *other) { callback.process(other); });
+}
+
+void CcdGridBroadphase::calculateOverlappingPairs(btDispatcher *dispatcher)
+{
+  // Build the static tree once when it was mostly filled by insertions.
+  if (m_staticInserted > 0 && m_staticInserted * 10 >= m_staticTree.m_leaves) {
+    m_staticTree.optimizeTopDown();
+    m_staticInserted = 0;
+  }
+
+  for (Proxy *proxy : m_movedProxies) {
+    FindPairs(proxy);
+    proxy->m_moved = false;
+  }
+  m_movedProxies.clear();
+
+  struct SeparatedPairCallback : btOverlapCallback {
+    virtual bool processOverlap(btBroadphasePair &pair)
+    {
+      return !TestAabbAgainstAabb2(pair.m_pProxy0->m_aabbMin,
+                                   pair.m_pProxy0->m_aabbMax,
+                                   pair.m_pProxy1->m_aabbMin,
+                                   pair.m_pProxy1->m_aabbMax);
+    }
+  } separatedPairCallback;
+  m_pairCache->processAllOverlappingPairs(&separatedPairCallback, dispatcher);
+}
+
+btOverlappingPairCache *CcdGridBroadphase::getOverlappingPairCache()
+{
+  return m_pairCache;
+}
+
+const btOverlappingPairCache *CcdGridBroadphase::getOverlappingPairCache() const
+{
+  return m_pairCache;
+}
+
+void CcdGridBroadphase::getBroadphaseAabb(btVector3 &aabbMin, btVector3 &aabbMax) const
+{
+  if (m_staticTree.m_root) {
+    aabbMin = m_staticTree.m_root->volume.Mins();
+    aabbMax = m_staticTree.m_root->volume.Maxs();
+  }
+  else {
+    aabbMin.setValue(BT_LARGE_FLOAT, BT_LARGE_FLOAT, BT_LARGE_FLOAT);
+    aabbMax.setValue(-BT_LARGE_FLOAT, -BT_LARGE_FLOAT, -BT_LARGE_FLOAT);
+  }
+
+  for (const Proxy *proxy : m_dynamicProxies) {
+    aabbMin.setMin(proxy->m_aabbMin);
+    aabbMax.setMax(proxy->m_aabbMax);
+  }
+}
+
+void CcdGridBroadphase::printStats()
+{
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "BulletCollision/BroadphaseCollision/btDbvtBroadphase.h"
+
+/** Dynamic AABB tree broadphase keeping static objects out of the dynamic set.
+ * Static proxies are inserted directly in the fixed tree instead of moving through the dynamic
+ * tree, the fixed tree is built top-down when many statics were added (e.g at scene conversion)
+ * and is not re-optimized incrementally every step.
+ */
+class CcdDbvtBroadphase : public btDbvtBroadphase {
+ private:
+  /// Number of static proxies inserted since the last top-down build of the fixed tree.
+  int m_staticInserted;
+
+ public:
+  CcdDbvtBroadphase();
+  virtual ~CcdDbvtBroadphase();
+
+  virtual btBroadphaseProxy *createProxy(const btVector3 &aabbMin,
+                                         const btVector3 &aabbMax,
+                                         int shapeType,
+                                         void *userPtr,
+                                         int collisionFilterGroup,
+                                         int collisionFilterMask,
+                                         btDispatcher *dispatcher);
+  /** Static proxies stay in the fixed tree, btDbvtBroadphase would move them to the dynamic tree
+   * as the world updates the AABB of all objects every step.
+   */
+  virtual void setAabb(btBroadphaseProxy *proxy,
+                       const btVector3 &aabbMin,
+                       const btVector3 &aabbMax,
+                       btDispatcher *dispatcher);
+  virtual void calculateOverlappingPairs(btDispatcher *dispatcher);
+};
+
+/** Uniform grid broadphase for large worlds.
+ * Non static proxies are stored in a sparse (hashed) uniform grid, static proxies in an AABB tree
+ * built once. Only the proxies which moved since the last step look for new pairs.
+ */
+class CcdGridBroadphase : public btBroadphaseInterface {
+ public:
+  struct Proxy : public btBroadphaseProxy {
+    Proxy(const btVector3 &aabbMin,
+          const btVector3 &aabbMax,
+          void *userPtr,
+          int collisionFilterGroup,
+          int collisionFilterMask);
+
+    bool m_static;
+    /// Proxy covering too many cells, not stored in the grid.
+    bool m_large;
+    bool m_moved;
+    /// Static tree leaf.
+    btDbvtNode *m_leaf;
+    /// Index in the dynamic proxy list.
+    int m_index;
+    /// Cell range the proxy is stored in.
+    int m_cellMin[3];
+    int m_cellMax[3];
+    /// Query stamp used to test a proxy only once per query.
+    unsigned int m_stamp;
+  };
+
+ private:
+  btOverlappingPairCache *m_pairCache;
+  bool m_ownsPairCache;
+
+  btScalar m_cellSize;
+  btScalar m_invCellSize;
+
+  btDbvt m_staticTree;
+  int m_staticInserted;
+
+  std::vector<Proxy *> m_dynamicProxies;
+  std::vector<Proxy *> m_largeProxies;
+  std::vector<Proxy *> m_movedProxies;
+  std::unordered_map<uint64_t, std::vector<Proxy *>> m_cells;
+
+  btAlignedObjectArray<const btDbvtNode *> m_rayTestStack;
+
+  unsigned int m_stamp;
+  int m_uid;
+
+  void ComputeCellRange(const btVector3 &aabbMin,
+                        const btVector3 &aabbMax,
+                        int cellMin[3],
+                        int cellMax[3]) const;
+  void InsertInGrid(Proxy *proxy);
+  void RemoveFromGrid(Proxy *proxy);
+  void MarkMoved(Proxy *proxy);
+
+  /// Call func for every non static proxy which AABB overlaps the given one, once per proxy.
+  template<class Func>
+  void ForEachDynamic(const btVector3 &aabbMin, const btVector3 &aabbMax, Func func);
+  void FindPairs(Proxy *proxy);
+
+ public:
+  CcdGridBroadphase(btScalar cellSize, btOverlappingPairCache *pairCache = nullptr);
+  virtual ~CcdGridBroadphase();
+
+  virtual btBroadphaseProxy *createProxy(const btVector3 &aabbMin,
+                                         const btVector3 &aabbMax,
+                                         int shapeType,
+                                         void *userPtr,
+                                         int collisionFilterGroup,
+                                         int collisionFilterMask,
+                                         btDispatcher *dispatcher);
+  virtual void destroyProxy(btBroadphaseProxy *proxy, btDispatcher *dispatcher);
+  virtual void setAabb(btBroadphaseProxy *proxy,
+                       const btVector3 &aabbMin,
+                       const btVector3 &aabbMax,
+                       btDispatcher *dispatcher);
+  virtual void getAabb(btBroadphaseProxy *proxy, btVector3 &aabbMin, btVector3 &aabbMax) const;
+
+  virtual void rayTest(const btVector3 &rayFrom,
+                       const btVector3 &rayTo,
+                       btBroadphaseRayCallback &rayCallback,
+                       const btVector3 &aabbMin = btVector3(0, 0, 0),
+                       const btVector3 &aabbMax = btVector3(0, 0, 0));
+  virtual void aabbTest(const btVector3 &aabbMin,
+                        const btVector3 &aabbMax,
+                        btBroadphaseAabbCallback &callback);
+
+  virtual void calculateOverlappingPairs(btDispatcher *dispatcher);
+
+  virtual btOverlappingPairCache *getOverlappingPairCache();
+  virtual const btOverlappingPairCache *getOverlappingPairCache() const;
+
+  virtual void getBroadphaseAabb(btVector3 &aabbMin, btVector3 &aabbMax) const;
+
+  virtual void printStats();
+};
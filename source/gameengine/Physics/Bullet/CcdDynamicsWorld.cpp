@@ -0,0 +1,239 @@
+#include "CcdDynamicsWorld.h"
+
+#include "BulletCollision/CollisionDispatch/btSimulationIslandManager.h"
+#include "BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolver.h"
+
+#include "BLI_task.hh"
+
+CcdDynamicsWorld::CcdDynamicsWorld(btDispatcher *dispatcher,
+                                   btBroadphaseInterface *pairCache,
+                                   btConstraintSolver *constraintSolver,
+                                   btCollisionConfiguration *collisionConfiguration)
+    : btSoftRigidDynamicsWorld(dispatcher, pairCache, constraintSolver, collisionConfiguration),
+      m_parallelIslands(false),
+      m_numBatches(0)
+{
+}
+
+CcdDynamicsWorld::~CcdDynamicsWorld()
+{
+}
+
+bool CcdDynamicsWorld::GetParallelIslands() const
+{
+  return m_parallelIslands;
+}
+
+void CcdDynamicsWorld::SetParallelIslands(bool parallel)
+{
+  m_parallelIslands = parallel;
+}
+
+int CcdDynamicsWorld::FindRoot(int node)
+{
+  while (m_unionFind[node] != node) {
+    m_unionFind[node] = m_unionFind[m_unionFind[node]];
+    node = m_unionFind[node];
+  }
+  return node;
+}
+
+void CcdDynamicsWorld::Union(int node1, int node2)
+{
+  const int root1 = FindRoot(node1);
+  const int root2 = FindRoot(node2);
+  // Keep islands as roots so that the node of a kinematic body is never used as batch key.
+  if (root1 < root2) {
+    m_unionFind[root2] = root1;
+  }
+  else if (root2 < root1) {
+    m_unionFind[root1] = root2;
+  }
+}
+
+void CcdDynamicsWorld::UnionKinematic(int island, const btCollisionObject *object)
+{
+  /* The sequential impulse solver stores a solver body index in kinematic bodies, static bodies
+   * and non rigid objects are shared safely as they use a fixed solver body. */
+  if (object->isKinematicObject() && btRigidBody::upcast(object)) {
+    Union(island, m_collisionObjects.size() + object->getWorldArrayIndex());
+  }
+}
+
+void CcdDynamicsWorld::solveConstraints(btContactSolverInfo &solverInfo)
+{
+  if (!m_parallelIslands) {
+    btSoftRigidDynamicsWorld::solveConstraints(solverInfo);
+    return;
+  }
+
+  btDispatcher *dispatcher = getDispatcher();
+  // Update island tags and sleeping states like the serial solve does.
+  m_islandManager->buildIslands(dispatcher, this);
+
+  const int numObjects = m_collisionObjects.size();
+
+  // An island is solved if at least one of its bodies is active.
+  m_islandAwake.assign(numObjects, 0);
+  for (int i = 0; i < numObjects; ++i) {
+    const btCollisionObject *object = m_collisionObjects[i];
+    const int island = object->getIslandTag();
+    if (island >= 0 && (object->getActivationState() == ACTIVE_TAG ||
+                        object->getActivationState() == DISABLE_DEACTIVATION))
+    {
+      m_islandAwake[island] = 1;
+    }
+  }
+
+  // Island tags use the nodes [0, numObjects[, kinematic bodies the nodes after.
+  m_unionFind.resize(numObjects * 2);
+  for (int i = 0, size = numObjects * 2; i < size; ++i) {
+    m_unionFind[i] = i;
+  }
+
+  m_manifolds.clear();
+  for (int i = 0, size = dispatcher->getNumManifolds(); i < size; ++i) {
+    btPersistentManifold *manifold = dispatcher->getManifoldByIndexInternal(i);
+    if (getDispatchInfo().m_deterministicOverlappingPairs && manifold->getNumContacts() == 0) {
+      continue;
+    }
+
+    const btCollisionObject *colObj0 = manifold->getBody0();
+    const btCollisionObject *colObj1 = manifold->getBody1();
+    if (colObj0->getActivationState() == ISLAND_SLEEPING &&
+        colObj1->getActivationState() == ISLAND_SLEEPING)
+    {
+      continue;
+    }
+
+    // Kinematic objects don't merge islands, but wake up all connected objects.
+    if (colObj0->isKinematicObject() && colObj0->getActivationState() != ISLAND_SLEEPING &&
+        colObj0->hasContactResponse())
+    {
+      colObj1->activate();
+    }
+    if (colObj1->isKinematicObject() && colObj1->getActivationState() != ISLAND_SLEEPING &&
+        colObj1->hasContactResponse())
+    {
+      colObj0->activate();
+    }
+
+    if (!dispatcher->needsResponse(colObj0, colObj1)) {
+      continue;
+    }
+
+    const int island = (colObj0->getIslandTag() >= 0) ? colObj0->getIslandTag() :
+                                                         colObj1->getIslandTag();
+    if (island < 0 || !m_islandAwake[island]) {
+      continue;
+    }
+
+    UnionKinematic(island, colObj0);
+    UnionKinematic(island, colObj1);
+    m_manifolds.push_back(manifold);
+  }
+
+  m_activeConstraints.clear();
+  for (int i = 0, size = m_constraints.size(); i < size; ++i) {
+    btTypedConstraint *con = m_constraints[i];
+    if (!con->isEnabled()) {
+      continue;
+    }
+
+    const btRigidBody &bodyA = con->getRigidBodyA();
+    const btRigidBody &bodyB = con->getRigidBodyB();
+    const int island = (bodyA.getIslandTag() >= 0) ? bodyA.getIslandTag() : bodyB.getIslandTag();
+    if (island < 0 || !m_islandAwake[island]) {
+      continue;
+    }
+
+    UnionKinematic(island, &bodyA);
+    UnionKinematic(island, &bodyB);
+    m_activeConstraints.push_back(con);
+  }
+
+  // Count the bodies of each group of islands.
+  m_islandSize.assign(numObjects, 0);
+  for (int i = 0; i < numObjects; ++i) {
+    const int island = m_collisionObjects[i]->getIslandTag();
+    if (island >= 0 && m_islandAwake[island]) {
+      ++m_islandSize[FindRoot(island)];
+    }
+  }
+
+  /* Gather small groups in the same batch as the solver does for serial solve, the overhead of
+   * a solve call and a task is too high for islands made of a few bodies. */
+  const int minBatchSize = solverInfo.m_minimumSolverBatchSize;
+  m_batchOfRoot.assign(numObjects, -1);
+  m_numBatches = 0;
+  int batchSize = minBatchSize;
+  for (int root = 0; root < numObjects; ++root) {
+    if (m_islandSize[root] == 0) {
+      continue;
+    }
+    if (batchSize >= minBatchSize) {
+      ++m_numBatches;
+      batchSize = 0;
+    }
+    m_batchOfRoot[root] = m_numBatches - 1;
+    batchSize += m_islandSize[root];
+  }
+
+  if (m_numBatches == 0) {
+    return;
+  }
+
+  // Batches are kept between steps to reuse their storage.
+  if (m_batches.size() < m_numBatches) {
+    m_batches.resize(m_numBatches);
+  }
+  for (unsigned int i = 0; i < m_numBatches; ++i) {
+    IslandBatch &batch = m_batches[i];
+    batch.m_bodies.clear();
+    batch.m_manifolds.clear();
+    batch.m_constraints.clear();
+  }
+
+  for (int i = 0; i < numObjects; ++i) {
+    btCollisionObject *object = m_collisionObjects[i];
+    const int island = object->getIslandTag();
+    if (island >= 0 && m_islandAwake[island]) {
+      m_batches[m_batchOfRoot[FindRoot(island)]].m_bodies.push_back(object);
+    }
+  }
+
+  for (btPersistentManifold *manifold : m_manifolds) {
+    const btCollisionObject *colObj0 = manifold->getBody0();
+    const int island = (colObj0->getIslandTag() >= 0) ? colObj0->getIslandTag() :
+                                                         manifold->getBody1()->getIslandTag();
+    m_batches[m_batchOfRoot[FindRoot(island)]].m_manifolds.push_back(manifold);
+  }
+
+  for (btTypedConstraint *con : m_activeConstraints) {
+    const int islandA = con->getRigidBodyA().getIslandTag();
+    const int island = (islandA >= 0) ? islandA : con->getRigidBodyB().getIslandTag();
+    m_batches[m_batchOfRoot[FindRoot(island)]].m_constraints.push_back(con);
+  }
+
+  blender::threading::parallel_for(
+      blender::IndexRange(m_numBatches), 1, [&](const blender::IndexRange range) {
+        std::unique_ptr<btSequentialImpulseConstraintSolver> &solver = m_threadSolvers.local();
+        if (!solver) {
+          solver.reset(new btSequentialImpulseConstraintSolver());
+        }
+
+        for (const int64_t i : range) {
+          IslandBatch &batch = m_batches[i];
+          // No debug drawer, drawing is not thread safe.
+          solver->solveGroup(batch.m_bodies.data(),
+                             batch.m_bodies.size(),
+                             batch.m_manifolds.data(),
+                             batch.m_manifolds.size(),
+                             batch.m_constraints.data(),
+                             batch.m_constraints.size(),
+                             solverInfo,
+                             nullptr,
+                             dispatcher);
+        }
+      });
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "BulletSoftBody/btSoftRigidDynamicsWorld.h"
+
+#include "BLI_enumerable_thread_specific.hh"
+
+class btSequentialImpulseConstraintSolver;
+
+/** Dynamics world used by the game engine.
+ * In addition to the soft and rigid body simulation it can solve the constraints of independent
+ * simulation islands in parallel using Blender task scheduler, each thread owning its own
+ * sequential impulse solver.
+ */
+class CcdDynamicsWorld : public btSoftRigidDynamicsWorld {
+ private:
+  /// Islands sharing a kinematic body are solved together, the solver writes into the body.
+  struct IslandBatch {
+    std::vector<btCollisionObject *> m_bodies;
+    std::vector<btPersistentManifold *> m_manifolds;
+    std::vector<btTypedConstraint *> m_constraints;
+  };
+
+  bool m_parallelIslands;
+
+  /// Temporary data reused every step to avoid allocations.
+  std::vector<int> m_unionFind;
+  std::vector<char> m_islandAwake;
+  std::vector<int> m_islandSize;
+  std::vector<int> m_batchOfRoot;
+  std::vector<btPersistentManifold *> m_manifolds;
+  std::vector<btTypedConstraint *> m_activeConstraints;
+  std::vector<IslandBatch> m_batches;
+  unsigned int m_numBatches;
+
+  blender::threading::EnumerableThreadSpecific<std::unique_ptr<btSequentialImpulseConstraintSolver>>
+      m_threadSolvers;
+
+  int FindRoot(int node);
+  void Union(int node1, int node2);
+  /// Union the island with a kinematic body touching it.
+  void UnionKinematic(int island, const btCollisionObject *object);
+
+ protected:
+  virtual void solveConstraints(btContactSolverInfo &solverInfo);
+
+ public:
+  CcdDynamicsWorld(btDispatcher *dispatcher,
+                   btBroadphaseInterface *pairCache,
+                   btConstraintSolver *constraintSolver,
+                   btCollisionConfiguration *collisionConfiguration);
+  virtual ~CcdDynamicsWorld();
+
+  bool GetParallelIslands() const;
+  void SetParallelIslands(bool parallel);
+};
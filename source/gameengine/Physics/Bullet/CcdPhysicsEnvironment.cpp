@@ -26,6 +26,7 @@
 #include "DNA_object_force_types.h"
 #include "DNA_scene_types.h"
 
+#include "BulletCollision/BroadphaseCollision/btAxisSweep3.h"
 #include "BulletCollision/CollisionDispatch/btGhostObject.h"
 #include "BulletCollision/Gimpact/btGImpactCollisionAlgorithm.h"
 #include "BulletCollision/NarrowPhaseCollision/btRaycastCallback.h"
@@ -35,8 +36,11 @@
 
 #include "BL_SceneConverter.h"
 #include "CM_List.h"
+#include "CcdBroadphase.h"
 #include "CcdConstraint.h"
+#include "CcdDynamicsWorld.h"
 #include "CcdGraphicController.h"
+#include "CcdSnapshot.h"
 #include "KX_ClientObjectInfo.h"
 #include "KX_GameObject.h"
 #include "MT_MinMax.h"
@@ -366,16 +370,23 @@ void CcdPhysicsEnvironment::SetDebugDrawer(btIDebugDraw *debugDrawer)
   m_debugDrawer = debugDrawer;
 }
 
-CcdPhysicsEnvironment::CcdPhysicsEnvironment(PHY_SolverType solverType, bool useDbvtCulling)
+CcdPhysicsEnvironment::CcdPhysicsEnvironment(PHY_SolverType solverType,
+                                             PHY_BroadphaseType broadphaseType,
+                                             float worldSize,
+                                             float cellSize,
+                                             bool useDbvtCulling)
     : m_cullingCache(nullptr),
       m_cullingTree(nullptr),
       m_numIterations(10),
       m_numTimeSubSteps(1),
+      m_stepCount(0),
       m_solverType(PHY_SOLVER_NONE),
       m_deactivationTime(2.0f),
       m_linearDeactivationThreshold(0.8f),
       m_angularDeactivationThreshold(1.0f),
       m_contactBreakingThreshold(0.02f),
+      m_controllersRevision(0),
+      m_dynamicsWorld(nullptr),
       m_solver(nullptr),
       m_filterCallback(nullptr),
       m_ghostPairCallback(nullptr),
@@ -391,7 +402,23 @@ CcdPhysicsEnvironment::CcdPhysicsEnvironment(PHY_SolverType solverType, bool use
   btGImpactCollisionAlgorithm::registerAlgorithm(dispatcher);
   m_ownDispatcher = dispatcher;
 
-  m_broadphase = new btDbvtBroadphase();
+  switch (broadphaseType) {
+    case PHY_BROADPHASE_AXIS_SWEEP: {
+      // Objects outside of the bounds are clamped and collide inefficiently.
+      const btVector3 worldMax(worldSize, worldSize, worldSize);
+      m_broadphase = new bt32BitAxisSweep3(-worldMax, worldMax, 131072);
+      break;
+    }
+    case PHY_BROADPHASE_GRID: {
+      m_broadphase = new CcdGridBroadphase(cellSize);
+      break;
+    }
+    case PHY_BROADPHASE_DBVT:
+    default: {
+      m_broadphase = new CcdDbvtBroadphase();
+      break;
+    }
+  }
   // avoid any collision in the culling tree
   if (useDbvtCulling) {
     m_cullingCache = new btNullPairCache();
@@ -406,8 +433,10 @@ CcdPhysicsEnvironment::CcdPhysicsEnvironment(PHY_SolverType solverType, bool use
   SetSolverType(solverType);  // issues with quickstep and memory allocations
   //	m_dynamicsWorld = new
   // btDiscreteDynamicsWorld(dispatcher,m_broadphase,m_solver,m_collisionConfiguration);
-  m_dynamicsWorld = new btSoftRigidDynamicsWorld(
+  CcdDynamicsWorld *dynamicsWorld = new CcdDynamicsWorld(
       dispatcher, m_broadphase, m_solver, m_collisionConfiguration);
+  dynamicsWorld->SetParallelIslands(m_solverType == PHY_SOLVER_PARALLEL);
+  m_dynamicsWorld = dynamicsWorld;
   m_dynamicsWorld->setInternalTickCallback(&CcdPhysicsEnvironment::StaticSimulationSubtickCallback,
                                            this);
   // m_dynamicsWorld->getSolverInfo().m_linearSlop = 0.01f;
@@ -425,6 +454,8 @@ void CcdPhysicsEnvironment::AddCcdPhysicsController(CcdPhysicsController *ctrl)
     return;
   }
 
+  ++m_controllersRevision;
+
   btRigidBody *body = ctrl->GetRigidBody();
   btCollisionObject *obj = ctrl->GetCollisionObject();
 
@@ -565,6 +596,8 @@ bool CcdPhysicsEnvironment::RemoveCcdPhysicsController(CcdPhysicsController *ctr
     return false;
   }
 
+  ++m_controllersRevision;
+
   // also remove constraint
   btRigidBody *body = ctrl->GetRigidBody();
   if (body) {
@@ -721,6 +754,15 @@ void CcdPhysicsEnvironment::SimulationSubtickCallback(btScalar timeStep)
   }
 }
 
+/** Only the dynamic rigid bodies are interpolated, kinematic objects are moved by the logic
+ * and soft bodies deform their mesh.
+ */
+static bool is_interpolated(CcdPhysicsController *ctrl)
+{
+  btRigidBody *body = ctrl->GetRigidBody();
+  return (body && !body->isStaticOrKinematicObject());
+}
+
 bool CcdPhysicsEnvironment::ProceedDeltaTime(double curTime, float timeStep, float interval)
 {
   std::set<CcdPhysicsController *>::iterator it;
@@ -731,7 +773,12 @@ bool CcdPhysicsEnvironment::ProceedDeltaTime(double curTime, float timeStep, flo
   gContactBreakingThreshold = m_contactBreakingThreshold;
 
   for (it = m_controllers.begin(); it != m_controllers.end(); it++) {
-    (*it)->SynchronizeMotionStates(timeStep);
+    CcdPhysicsController *ctrl = *it;
+    ctrl->SynchronizeMotionStates(timeStep);
+    // The transform before the step is the beginning of the render interpolation.
+    if (is_interpolated(ctrl)) {
+      ctrl->GetMotionState()->BeginInterpolationStep();
+    }
   }
 
   float subStep = timeStep / float(m_numTimeSubSteps);
@@ -752,6 +799,7 @@ bool CcdPhysicsEnvironment::ProceedDeltaTime(double curTime, float timeStep, flo
   }
 
   CallbackTriggers();
+  ++m_stepCount;
 
   return true;
 }
@@ -765,6 +813,33 @@ void CcdPhysicsEnvironment::UpdateSoftBodies()
   }
 }
 
+unsigned int CcdPhysicsEnvironment::GetStepCount() const
+{
+  return m_stepCount;
+}
+
+void CcdPhysicsEnvironment::InterpolateMotionStates(float alpha)
+{
+  for (CcdPhysicsController *ctrl : m_controllers) {
+    if (is_interpolated(ctrl)) {
+      const btTransform &xform = ctrl->GetRigidBody()->getCenterOfMassTransform();
+      ctrl->GetMotionState()->InterpolateWorldTransform(
+          alpha, ToMoto(xform.getOrigin()), ToMoto(xform.getBasis()));
+    }
+  }
+}
+
+void CcdPhysicsEnvironment::RestoreMotionStates()
+{
+  // Objects made static or kinematic since the interpolation are restored too.
+  for (CcdPhysicsController *ctrl : m_controllers) {
+    PHY_IMotionState *motionState = ctrl->GetMotionState();
+    if (motionState) {
+      motionState->RestoreWorldTransform();
+    }
+  }
+}
+
 class ClosestRayResultCallbackNotMe : public btCollisionWorld::ClosestRayResultCallback {
   btCollisionObject *m_owner;
   btCollisionObject *m_parent;
@@ -1010,6 +1085,8 @@ void CcdPhysicsEnvironment::SetSolverType(PHY_SolverType solverType)
     return;
   }
 
+  btConstraintSolver *oldSolver = m_solver;
+
   switch (solverType) {
     case PHY_SOLVER_SEQUENTIAL: {
       m_solver = new btSequentialImpulseConstraintSolver();
@@ -1020,11 +1097,27 @@ void CcdPhysicsEnvironment::SetSolverType(PHY_SolverType solverType)
       m_solver = new btNNCGConstraintSolver();
       break;
     }
+    case PHY_SOLVER_PARALLEL: {
+      /* Islands are solved by a sequential impulse solver per thread in the dynamics world,
+       * this one is only used when the world needs a solver outside of the step. */
+      m_solver = new btSequentialImpulseConstraintSolver();
+      break;
+    }
     default: {
       BLI_assert(false);
+      // Keep the current solver.
+      return;
     }
   };
   m_solverType = solverType;
+
+  // The world doesn't exist yet when called from the constructor.
+  if (m_dynamicsWorld) {
+    m_dynamicsWorld->setConstraintSolver(m_solver);
+    static_cast<CcdDynamicsWorld *>(m_dynamicsWorld)
+        ->SetParallelIslands(m_solverType == PHY_SOLVER_PARALLEL);
+    delete oldSolver;
+  }
 }
 
 void CcdPhysicsEnvironment::GetGravity(MT_Vector3 &grav)
@@ -1985,6 +2078,12 @@ void CcdPhysicsEnvironment::MergeEnvironment(PHY_IPhysicsEnvironment *other_env)
 
 CcdPhysicsEnvironment::~CcdPhysicsEnvironment()
 {
+  /* Snapshots are owned by Python and can outlive the environment, an other environment could
+   * then be allocated at the same address. */
+  for (CcdSnapshot *snapshot : m_snapshots) {
+    snapshot->Detach();
+  }
+
   m_wrapperVehicles.clear();
 
   // m_broadphase->DestroyScene();
@@ -2699,6 +2798,162 @@ void CcdPhysicsEnvironment::ExportFile(const std::string &filename)
   }
 }
 
+PHY_ISnapshot *CcdPhysicsEnvironment::CreateSnapshot()
+{
+  CcdSnapshot *snapshot = new CcdSnapshot(this);
+  snapshot->m_bodies.reserve(m_dynamicsWorld->getNumCollisionObjects());
+  snapshot->m_constraints.reserve(m_dynamicsWorld->getNumConstraints());
+  m_snapshots.push_back(snapshot);
+  return snapshot;
+}
+
+void CcdPhysicsEnvironment::RemoveSnapshot(CcdSnapshot *snapshot)
+{
+  CM_ListRemoveIfFound(m_snapshots, snapshot);
+}
+
+bool CcdPhysicsEnvironment::SaveSnapshot(PHY_ISnapshot *snapshot)
+{
+  CcdSnapshot *ccdSnapshot = static_cast<CcdSnapshot *>(snapshot);
+  if (ccdSnapshot->GetEnvironment() != this) {
+    return false;
+  }
+
+  std::vector<CcdSnapshot::BodyState> &bodies = ccdSnapshot->m_bodies;
+  std::vector<CcdSnapshot::ConstraintState> &constraints = ccdSnapshot->m_constraints;
+
+  // The storage only grows, saving the same world again doesn't allocate.
+  bodies.clear();
+  constraints.clear();
+
+  const btCollisionObjectArray &objects = m_dynamicsWorld->getCollisionObjectArray();
+  for (int i = 0, size = objects.size(); i < size; ++i) {
+    btCollisionObject *object = objects[i];
+    CcdPhysicsController *ctrl = static_cast<CcdPhysicsController *>(object->getUserPointer());
+    // Static objects never move, kinematic ones are driven by the scene graph and soft bodies
+    // are not supported.
+    if (!ctrl || ctrl->GetConstructionInfo().m_bSensor || ctrl->GetSoftBody() ||
+        object->isStaticOrKinematicObject())
+    {
+      continue;
+    }
+
+    btRigidBody *body = ctrl->GetRigidBody();
+    if (!body && !ctrl->GetCharacterController()) {
+      continue;
+    }
+
+    CcdSnapshot::BodyState state;
+    state.m_controller = ctrl;
+    state.m_object = object;
+    state.m_activationState = object->getActivationState();
+    state.m_deactivationTime = object->getDeactivationTime();
+    if (body) {
+      state.m_transform = body->getCenterOfMassTransform();
+      state.m_linearVelocity = body->getLinearVelocity();
+      state.m_angularVelocity = body->getAngularVelocity();
+      state.m_rigidBody = true;
+    }
+    else {
+      state.m_transform = object->getWorldTransform();
+      state.m_linearVelocity.setZero();
+      state.m_angularVelocity.setZero();
+      state.m_rigidBody = false;
+    }
+    bodies.push_back(state);
+  }
+
+  for (int i = 0, size = m_dynamicsWorld->getNumConstraints(); i < size; ++i) {
+    btTypedConstraint *con = m_dynamicsWorld->getConstraint(i);
+    CcdSnapshot::ConstraintState state;
+    state.m_identifier = con->getUserConstraintId();
+    state.m_breakingThreshold = con->getBreakingImpulseThreshold();
+    state.m_enabled = con->isEnabled();
+    constraints.push_back(state);
+  }
+
+  ccdSnapshot->m_revision = m_controllersRevision;
+  ccdSnapshot->m_valid = true;
+
+  return true;
+}
+
+bool CcdPhysicsEnvironment::RestoreSnapshot(const PHY_ISnapshot *snapshot)
+{
+  const CcdSnapshot *ccdSnapshot = static_cast<const CcdSnapshot *>(snapshot);
+  if (ccdSnapshot->GetEnvironment() != this || !ccdSnapshot->IsValid()) {
+    return false;
+  }
+
+  /* When no controller were added or removed since the save every recorded pointer is still
+   * alive, else each controller is checked and the ones removed meanwhile are skipped. */
+  const bool unchanged = (ccdSnapshot->m_revision == m_controllersRevision);
+
+  for (const CcdSnapshot::BodyState &state : ccdSnapshot->m_bodies) {
+    CcdPhysicsController *ctrl = state.m_controller;
+    if (!unchanged && (m_controllers.find(ctrl) == m_controllers.end() ||
+                       ctrl->GetCollisionObject() != state.m_object))
+    {
+      continue;
+    }
+
+    btCollisionObject *object = state.m_object;
+    if (state.m_rigidBody) {
+      btRigidBody *body = static_cast<btRigidBody *>(object);
+      body->setCenterOfMassTransform(state.m_transform);
+      body->setInterpolationWorldTransform(state.m_transform);
+      body->setLinearVelocity(state.m_linearVelocity);
+      body->setAngularVelocity(state.m_angularVelocity);
+      body->setInterpolationLinearVelocity(state.m_linearVelocity);
+      body->setInterpolationAngularVelocity(state.m_angularVelocity);
+      body->clearForces();
+    }
+    else {
+      object->setWorldTransform(state.m_transform);
+      object->setInterpolationWorldTransform(state.m_transform);
+    }
+    object->forceActivationState(state.m_activationState);
+    object->setDeactivationTime(state.m_deactivationTime);
+
+    // Update the game object immediately, without waiting for the next simulation step.
+    PHY_IMotionState *motionState = ctrl->GetMotionState();
+    motionState->SetWorldOrientation(ToMoto(state.m_transform.getBasis()));
+    motionState->SetWorldPosition(ToMoto(state.m_transform.getOrigin()));
+    motionState->CalculateWorldTransformations();
+  }
+
+  const std::vector<CcdSnapshot::ConstraintState> &constraints = ccdSnapshot->m_constraints;
+  const int numConstraints = m_dynamicsWorld->getNumConstraints();
+  for (unsigned int i = 0, size = constraints.size(); i < size; ++i) {
+    const CcdSnapshot::ConstraintState &state = constraints[i];
+    btTypedConstraint *con = nullptr;
+    // Constraints usually keep their order in the world, else look for the identifier.
+    if (i < (unsigned int)numConstraints &&
+        m_dynamicsWorld->getConstraint(i)->getUserConstraintId() == state.m_identifier)
+    {
+      con = m_dynamicsWorld->getConstraint(i);
+    }
+    else {
+      for (int j = 0; j < numConstraints; ++j) {
+        btTypedConstraint *other = m_dynamicsWorld->getConstraint(j);
+        if (other->getUserConstraintId() == state.m_identifier) {
+          con = other;
+          break;
+        }
+      }
+    }
+
+    if (!con) {
+      continue;
+    }
+
+    con->setEnabled(state.m_enabled);
+    con->setBreakingImpulseThreshold(state.m_breakingThreshold);
+  }
+
+  return true;
+}
+
 struct BlenderDebugDraw : public btIDebugDraw {
   BlenderDebugDraw() : m_debugMode(0)
   {
@@ -2748,9 +3003,19 @@ CcdPhysicsEnvironment *CcdPhysicsEnvironment::Create(Scene *blenderscene, bool v
   static const PHY_SolverType solverTypeTable[] = {
       PHY_SOLVER_SEQUENTIAL,  // GAME_SOLVER_SEQUENTIAL
       PHY_SOLVER_NNCG,        // GAME_SOLVER_NNGC
+      PHY_SOLVER_PARALLEL,    // GAME_SOLVER_PARALLEL
+  };
+  static const PHY_BroadphaseType broadphaseTypeTable[] = {
+      PHY_BROADPHASE_DBVT,        // GAME_BROADPHASE_DBVT
+      PHY_BROADPHASE_AXIS_SWEEP,  // GAME_BROADPHASE_AXIS_SWEEP
+      PHY_BROADPHASE_GRID,        // GAME_BROADPHASE_GRID
   };
   CcdPhysicsEnvironment *ccdPhysEnv = new CcdPhysicsEnvironment(
-      solverTypeTable[blenderscene->gm.solverType], false);
+      solverTypeTable[blenderscene->gm.solverType],
+      broadphaseTypeTable[blenderscene->gm.broadphaseType],
+      blenderscene->gm.broadphaseWorldSize,
+      blenderscene->gm.broadphaseCellSize,
+      false);
   ccdPhysEnv->SetDebugDrawer(new BlenderDebugDraw());
   ccdPhysEnv->SetDeactivationLinearTreshold(blenderscene->gm.lineardeactthreshold);
   ccdPhysEnv->SetDeactivationAngularTreshold(blenderscene->gm.angulardeactthreshold);
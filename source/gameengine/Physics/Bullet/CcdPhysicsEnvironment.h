@@ -49,6 +49,7 @@ class PHY_IVehicle;
 class CcdGraphicController;
 class CcdOverlapFilterCallBack;
 class CcdShapeConstructionInfo;
+class CcdSnapshot;
 
 /** CcdPhysicsEnvironment is an experimental mainloop for physics simulation using optional
  * continuous collision detection. Physics Environment takes care of stepping the simulation and is
@@ -85,6 +86,9 @@ class CcdPhysicsEnvironment : public PHY_IPhysicsEnvironment {
   /// timestep subdivisions
   int m_numTimeSubSteps;
 
+  /// Number of calls to ProceedDeltaTime.
+  unsigned int m_stepCount;
+
   PHY_SolverType m_solverType;
 
   float m_deactivationTime;
@@ -92,10 +96,22 @@ class CcdPhysicsEnvironment : public PHY_IPhysicsEnvironment {
   float m_angularDeactivationThreshold;
   float m_contactBreakingThreshold;
 
+  /// Incremented each time a controller is added or removed, used to validate snapshots.
+  unsigned int m_controllersRevision;
+  /// Snapshots created by the environment, detached when it is freed.
+  std::vector<CcdSnapshot *> m_snapshots;
+
   void ProcessFhSprings(double curTime, float timeStep);
 
  public:
-  CcdPhysicsEnvironment(PHY_SolverType solverType, bool useDbvtCulling);
+  /** \param worldSize Half size of the world bounds used by the axis sweep broadphase.
+   * \param cellSize Cell size used by the grid broadphase.
+   */
+  CcdPhysicsEnvironment(PHY_SolverType solverType,
+                        PHY_BroadphaseType broadphaseType,
+                        float worldSize,
+                        float cellSize,
+                        bool useDbvtCulling);
 
   virtual ~CcdPhysicsEnvironment();
 
@@ -134,6 +150,11 @@ class CcdPhysicsEnvironment : public PHY_IPhysicsEnvironment {
 
   virtual void UpdateSoftBodies();
 
+  virtual unsigned int GetStepCount() const;
+
+  virtual void InterpolateMotionStates(float alpha);
+  virtual void RestoreMotionStates();
+
   /**
    * Called by Bullet for every physical simulation (sub)tick.
    * Our constructor registers this callback to Bullet, which stores a pointer to 'this' in
@@ -325,6 +346,12 @@ class CcdPhysicsEnvironment : public PHY_IPhysicsEnvironment {
   class btDispatcher *m_ownDispatcher;
 
   virtual void ExportFile(const std::string &filename);
+
+  virtual PHY_ISnapshot *CreateSnapshot();
+  virtual bool SaveSnapshot(PHY_ISnapshot *snapshot);
+  virtual bool RestoreSnapshot(const PHY_ISnapshot *snapshot);
+  /// Called by a snapshot being freed.
+  void RemoveSnapshot(CcdSnapshot *snapshot);
 };
 
 class CcdCollData : public PHY_ICollData {
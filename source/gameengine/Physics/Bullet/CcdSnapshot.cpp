@@ -0,0 +1,79 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Physics/Bullet/CcdSnapshot.cpp
+ *  \ingroup physbullet
+ */
+
+#include "CcdSnapshot.h"
+#include "CcdPhysicsEnvironment.h"
+
+CcdSnapshot::CcdSnapshot(CcdPhysicsEnvironment *environment)
+    : m_environment(environment), m_revision(0), m_valid(false)
+{
+}
+
+CcdSnapshot::~CcdSnapshot()
+{
+  if (m_environment) {
+    m_environment->RemoveSnapshot(this);
+  }
+}
+
+CcdPhysicsEnvironment *CcdSnapshot::GetEnvironment() const
+{
+  return m_environment;
+}
+
+bool CcdSnapshot::IsValid() const
+{
+  return m_valid;
+}
+
+void CcdSnapshot::Detach()
+{
+  m_environment = nullptr;
+  m_valid = false;
+  m_bodies.clear();
+  m_constraints.clear();
+}
+
+PHY_IPhysicsEnvironment *CcdSnapshot::GetPhysicsEnvironment() const
+{
+  return m_environment;
+}
+
+unsigned int CcdSnapshot::GetNumBodies() const
+{
+  return m_bodies.size();
+}
+
+unsigned int CcdSnapshot::GetNumConstraints() const
+{
+  return m_constraints.size();
+}
+
+size_t CcdSnapshot::GetSize() const
+{
+  return m_bodies.capacity() * sizeof(BodyState) +
+         m_constraints.capacity() * sizeof(ConstraintState);
+}
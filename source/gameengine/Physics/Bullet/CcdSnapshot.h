@@ -0,0 +1,89 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file CcdSnapshot.h
+ *  \ingroup physbullet
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "LinearMath/btTransform.h"
+#include "LinearMath/btVector3.h"
+
+#include "PHY_ISnapshot.h"
+
+class CcdPhysicsController;
+class CcdPhysicsEnvironment;
+class btCollisionObject;
+
+/** Bullet implementation of a physics snapshot.
+ * Bodies and constraints are stored in flat arrays in the order of the dynamics world,
+ * restoring a snapshot into an unchanged world is then a linear pass without lookups.
+ */
+class CcdSnapshot : public PHY_ISnapshot {
+  friend class CcdPhysicsEnvironment;
+
+ public:
+  struct BodyState {
+    CcdPhysicsController *m_controller;
+    btCollisionObject *m_object;
+    btTransform m_transform;
+    btVector3 m_linearVelocity;
+    btVector3 m_angularVelocity;
+    int m_activationState;
+    float m_deactivationTime;
+    /// False for non rigid bodies (e.g character), only the transform is used.
+    bool m_rigidBody;
+  };
+
+  struct ConstraintState {
+    int m_identifier;
+    float m_breakingThreshold;
+    bool m_enabled;
+  };
+
+ private:
+  /// Owner environment, a snapshot can't be restored in an other one. Null once it is freed.
+  CcdPhysicsEnvironment *m_environment;
+  /// Value of the environment controller list revision at save.
+  unsigned int m_revision;
+  bool m_valid;
+
+  std::vector<BodyState> m_bodies;
+  std::vector<ConstraintState> m_constraints;
+
+ public:
+  CcdSnapshot(CcdPhysicsEnvironment *environment);
+  virtual ~CcdSnapshot();
+
+  CcdPhysicsEnvironment *GetEnvironment() const;
+  bool IsValid() const;
+  /// Forget the environment being freed and the bodies it owns.
+  void Detach();
+
+  virtual PHY_IPhysicsEnvironment *GetPhysicsEnvironment() const;
+  virtual unsigned int GetNumBodies() const;
+  virtual unsigned int GetNumConstraints() const;
+  virtual size_t GetSize() const;
+};
@@ -99,4 +99,11 @@ typedef enum PHY_SolverType {
   PHY_SOLVER_NONE,
   PHY_SOLVER_SEQUENTIAL,
   PHY_SOLVER_NNCG,
+  PHY_SOLVER_PARALLEL,
 } PHY_SolverType;
+
+typedef enum PHY_BroadphaseType {
+  PHY_BROADPHASE_DBVT,
+  PHY_BROADPHASE_AXIS_SWEEP,
+  PHY_BROADPHASE_GRID,
+} PHY_BroadphaseType;
@@ -54,4 +54,25 @@ class PHY_IMotionState {
   virtual void SetWorldOrientation(const MT_Quaternion &quat) = 0;
 
   virtual void CalculateWorldTransformations() = 0;
+
+  /** Start a physics step, the current transform is kept as the beginning of the render
+   * interpolation until the next step.
+   */
+  virtual void BeginInterpolationStep()
+  {
+  }
+  /** Set a transform between the beginning (0) and the result (1) of the last physics step,
+   * used only for rendering when the physics runs at a lower rate. pos and ori are the current
+   * transform of the physics object, when it was moved since the last step the interpolation
+   * starts again from it.
+   */
+  virtual void InterpolateWorldTransform(float alpha,
+                                         const MT_Vector3 &pos,
+                                         const MT_Matrix3x3 &ori)
+  {
+  }
+  /// Set back the result of the last physics step after InterpolateWorldTransform.
+  virtual void RestoreWorldTransform()
+  {
+  }
 };
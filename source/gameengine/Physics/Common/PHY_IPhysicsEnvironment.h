@@ -40,6 +40,7 @@
 #include <array>
 
 class PHY_IConstraint;
+class PHY_ISnapshot;
 class PHY_IVehicle;
 class PHY_ICharacter;
 class RAS_MeshObject;
@@ -124,6 +125,23 @@ class PHY_IPhysicsEnvironment {
 
   virtual void UpdateSoftBodies() = 0;
 
+  /// Return the number of integration steps performed, collisions are only reported by a step.
+  virtual unsigned int GetStepCount() const
+  {
+    return 0;
+  }
+
+  /** Set the dynamic objects between the beginning (0) and the result (1) of the last
+   * integration step, used to render at a higher rate than the physics.
+   */
+  virtual void InterpolateMotionStates(float alpha)
+  {
+  }
+  /// Set back the dynamic objects to the last integration step after InterpolateMotionStates.
+  virtual void RestoreMotionStates()
+  {
+  }
+
   /// draw debug lines (make sure to call this during the render phase, otherwise lines are not
   /// drawn properly)
   virtual void DebugDrawWorld()
@@ -269,6 +287,22 @@ class PHY_IPhysicsEnvironment {
 
   virtual void ExportFile(const std::string &filename){};
 
+  /// Create an empty snapshot able to store the state of this environment, nullptr if unsupported.
+  virtual PHY_ISnapshot *CreateSnapshot()
+  {
+    return nullptr;
+  }
+  /// Copy the transform, velocities, activation and constraint state into the snapshot.
+  virtual bool SaveSnapshot(PHY_ISnapshot *snapshot)
+  {
+    return false;
+  }
+  /// Apply back a state previously saved, bodies removed since the save are ignored.
+  virtual bool RestoreSnapshot(const PHY_ISnapshot *snapshot)
+  {
+    return false;
+  }
+
   virtual void MergeEnvironment(PHY_IPhysicsEnvironment *other_env) = 0;
 
   virtual void ConvertObject(BL_SceneConverter *converter,
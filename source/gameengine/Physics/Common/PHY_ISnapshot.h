@@ -0,0 +1,52 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file PHY_ISnapshot.h
+ *  \ingroup phys
+ */
+
+#pragma once
+
+#include <cstddef>
+
+class PHY_IPhysicsEnvironment;
+
+/** Opaque copy of the dynamic state of a physics environment.
+ * A snapshot is created by its environment, filled by PHY_IPhysicsEnvironment::SaveSnapshot
+ * and applied back with PHY_IPhysicsEnvironment::RestoreSnapshot. Its storage is allocated once
+ * and reused so that saving and restoring every frame doesn't allocate.
+ */
+class PHY_ISnapshot {
+ public:
+  PHY_ISnapshot() = default;
+  virtual ~PHY_ISnapshot() = default;
+
+  /// Environment which created the snapshot, nullptr once this environment is freed.
+  virtual PHY_IPhysicsEnvironment *GetPhysicsEnvironment() const = 0;
+
+  /// Number of bodies recorded by the last save.
+  virtual unsigned int GetNumBodies() const = 0;
+  /// Number of constraints recorded by the last save.
+  virtual unsigned int GetNumConstraints() const = 0;
+  /// Size in bytes of the storage reserved by the snapshot.
+  virtual size_t GetSize() const = 0;
+};
@@ -16,13 +16,18 @@
 #    endif
 #  endif
 
+#  include <ctime>
 #  include <stdint.h>
 #  include <string>
 
 #  include "MEM_guardedalloc.h"
 
-#  include "Exception.h"
 #  include "BLI_time.h"
+#  include "DNA_scene_types.h"
+
+#  include "BKE_writeffmpeg.hh"
+
+#  include "Exception.h"
 
 
 extern "C" {
@@ -53,6 +58,11 @@ VideoFFmpeg::VideoFFmpeg(HRESULT *hRslt)
       m_frameDeinterlaced(nullptr),
       m_frameRGB(nullptr),
       m_imgConvertCtx(nullptr),
+      m_imgDirectCtx(nullptr),
+      m_cacheConvertCtx(nullptr),
+      m_frameDirect(nullptr),
+      m_zeroCopy(true),
+      m_directEnabled(false),
       m_deinterlace(false),
       m_preseek(0),
       m_videoStream(-1),
@@ -69,7 +79,11 @@ VideoFFmpeg::VideoFFmpeg(HRESULT *hRslt)
       m_isThreaded(false),
       m_isStreaming(false),
       m_stopThread(false),
-      m_cacheStarted(false)
+      m_cacheStarted(false),
+      m_frameCacheHead(0),
+      m_frameCacheCount(0),
+      m_packetCacheHead(0),
+      m_packetCacheCount(0)
 {
   // set video format
   m_format = RGB24;
@@ -79,15 +93,17 @@ VideoFFmpeg::VideoFFmpeg(HRESULT *hRslt)
   *hRslt = S_OK;
   BLI_listbase_clear(&m_thread);
   pthread_mutex_init(&m_cacheMutex, nullptr);
-  BLI_listbase_clear(&m_frameCacheFree);
-  BLI_listbase_clear(&m_frameCacheBase);
-  BLI_listbase_clear(&m_packetCacheFree);
-  BLI_listbase_clear(&m_packetCacheBase);
+  pthread_cond_init(&m_cacheCond, nullptr);
+  memset(&m_noCacheFrame, 0, sizeof(m_noCacheFrame));
+  memset(m_frameCache, 0, sizeof(m_frameCache));
+  memset(m_packetCache, 0, sizeof(m_packetCache));
 }
 
 // destructor
 VideoFFmpeg::~VideoFFmpeg()
 {
+  pthread_cond_destroy(&m_cacheCond);
+  pthread_mutex_destroy(&m_cacheMutex);
 }
 
 void VideoFFmpeg::refresh(void)
@@ -117,19 +133,27 @@ bool VideoFFmpeg::release()
     m_frame = nullptr;
   }
   if (m_frameDeinterlaced) {
-    MEM_freeN(m_frameDeinterlaced->data[0]);
     av_frame_free(&m_frameDeinterlaced);
     m_frameDeinterlaced = nullptr;
   }
   if (m_frameRGB) {
-    MEM_freeN(m_frameRGB->data[0]);
     av_frame_free(&m_frameRGB);
     m_frameRGB = nullptr;
   }
+  if (m_frameDirect) {
+    av_frame_free(&m_frameDirect);
+    m_frameDirect = nullptr;
+  }
   if (m_imgConvertCtx) {
-    sws_freeContext(m_imgConvertCtx);
+    BKE_ffmpeg_sws_release_context(m_imgConvertCtx);
     m_imgConvertCtx = nullptr;
   }
+  if (m_imgDirectCtx) {
+    BKE_ffmpeg_sws_release_context(m_imgDirectCtx);
+    m_imgDirectCtx = nullptr;
+  }
+  m_noCacheFrame.frame = nullptr;
+  m_noCacheFrame.planes = nullptr;
   m_status = SourceStopped;
   m_lastFrame = -1;
   return true;
@@ -139,31 +163,64 @@ AVFrame *VideoFFmpeg::allocFrameRGB()
 {
   AVFrame *frame;
   frame = av_frame_alloc();
-  if (m_format == RGBA32) {
-    av_image_fill_arrays(
-        frame->data,
-        frame->linesize,
-        (uint8_t *)MEM_callocN(
-            av_image_get_buffer_size(AV_PIX_FMT_RGBA, m_codecCtx->width, m_codecCtx->height, 1),
-            "ffmpeg rgba"),
-        AV_PIX_FMT_RGBA,
-        m_codecCtx->width,
-        m_codecCtx->height,
-        1);
+  frame->format = (m_format == RGBA32) ? AV_PIX_FMT_RGBA : AV_PIX_FMT_RGB24;
+  frame->width = m_codecCtx->width;
+  frame->height = m_codecCtx->height;
+  // no line padding: the image filters expect contiguous rows
+  if (av_frame_get_buffer(frame, 1) < 0) {
+    av_frame_free(&frame);
+    return nullptr;
+  }
+  return frame;
+}
+
+void VideoFFmpeg::convertFrame(struct SwsContext *ctx, AVFrame *dst, const AVFrame *src)
+{
+  // the scaling context is created with a thread count so that the conversion
+  // is split in slices when ffmpeg supports it
+  BKE_ffmpeg_sws_scale_frame(ctx, dst, src);
+}
+
+static void videoffmpeg_buffer_free_noop(void * /*opaque*/, uint8_t * /*data*/) {}
+
+bool VideoFFmpeg::canProcessDirect(void)
+{
+  // filters and power of 2 scaling work on the RGB frame
+  return m_zeroCopy && m_imgDirectCtx != nullptr && m_pyfilter == nullptr && !m_scale;
+}
+
+void VideoFFmpeg::processDirect(const AVFrame *planes)
+{
+  // if scale was changed
+  if (m_scaleChange)
+    // reset image
+    init(m_orgSize[0], m_orgSize[1]);
+  if (m_image == nullptr || m_avail)
+    return;
+
+  const int linesize = m_size[0] * 4;
+  uint8_t *image = (uint8_t *)m_image;
+  // wrap the image buffer in the destination frame, it stays owned by ImageBase
+  m_frameDirect->buf[0] = av_buffer_create(
+      image, linesize * m_size[1], videoffmpeg_buffer_free_noop, nullptr, 0);
+  if (m_frameDirect->buf[0] == nullptr)
+    return;
+  m_frameDirect->format = AV_PIX_FMT_RGBA;
+  m_frameDirect->width = m_size[0];
+  m_frameDirect->height = m_size[1];
+  if (m_flip) {
+    // write the rows bottom to top, like convImage does when flipping
+    m_frameDirect->data[0] = image + (m_size[1] - 1) * linesize;
+    m_frameDirect->linesize[0] = -linesize;
   }
   else {
-    av_image_fill_arrays(
-        frame->data,
-        frame->linesize,
-        (uint8_t *)MEM_callocN(
-            av_image_get_buffer_size(AV_PIX_FMT_RGB24, m_codecCtx->width, m_codecCtx->height, 1),
-            "ffmpeg rgb"),
-        AV_PIX_FMT_RGB24,
-        m_codecCtx->width,
-        m_codecCtx->height,
-        1);
+    m_frameDirect->data[0] = image;
+    m_frameDirect->linesize[0] = linesize;
   }
-  return frame;
+  convertFrame(m_imgDirectCtx, m_frameDirect, planes);
+  av_frame_unref(m_frameDirect);
+  // source was processed
+  m_avail = true;
 }
 
 // set initial parameters
@@ -270,68 +327,64 @@ int VideoFFmpeg::openStream(const char *filename,
   m_videoStream = video_stream_index;
   m_frame = av_frame_alloc();
   m_frameDeinterlaced = av_frame_alloc();
+  m_frameDirect = av_frame_alloc();
 
   // allocate buffer if deinterlacing is required
-  av_image_fill_arrays(
-      m_frameDeinterlaced->data,
-      m_frameDeinterlaced->linesize,
-      (uint8_t *)MEM_callocN(
-          av_image_get_buffer_size(m_codecCtx->pix_fmt, m_codecCtx->width, m_codecCtx->height, 1),
-          "ffmpeg deinterlace"),
-      m_codecCtx->pix_fmt,
-      m_codecCtx->width,
-      m_codecCtx->height,
-      1);
+  m_frameDeinterlaced->format = m_codecCtx->pix_fmt;
+  m_frameDeinterlaced->width = m_codecCtx->width;
+  m_frameDeinterlaced->height = m_codecCtx->height;
+  av_frame_get_buffer(m_frameDeinterlaced, 1);
 
   // check if the pixel format supports Alpha
   if (m_codecCtx->pix_fmt == AV_PIX_FMT_RGB32 || m_codecCtx->pix_fmt == AV_PIX_FMT_BGR32 ||
       m_codecCtx->pix_fmt == AV_PIX_FMT_RGB32_1 || m_codecCtx->pix_fmt == AV_PIX_FMT_BGR32_1) {
     // allocate buffer to store final decoded frame
     m_format = RGBA32;
-    // allocate sws context
-    m_imgConvertCtx = sws_getContext(m_codecCtx->width,
-                                     m_codecCtx->height,
-                                     m_codecCtx->pix_fmt,
-                                     m_codecCtx->width,
-                                     m_codecCtx->height,
-                                     AV_PIX_FMT_RGBA,
-                                     SWS_FAST_BILINEAR,
-                                     nullptr,
-                                     nullptr,
-                                     nullptr);
   }
   else {
     // allocate buffer to store final decoded frame
     m_format = RGB24;
-    // allocate sws context
-    m_imgConvertCtx = sws_getContext(m_codecCtx->width,
-                                     m_codecCtx->height,
-                                     m_codecCtx->pix_fmt,
-                                     m_codecCtx->width,
-                                     m_codecCtx->height,
-                                     AV_PIX_FMT_RGB24,
-                                     SWS_FAST_BILINEAR,
-                                     nullptr,
-                                     nullptr,
-                                     nullptr);
   }
+  // get sws contexts, they are multi-threaded when ffmpeg supports it
+  m_imgConvertCtx = BKE_ffmpeg_sws_get_context(m_codecCtx->width,
+                                               m_codecCtx->height,
+                                               m_codecCtx->pix_fmt,
+                                               (m_format == RGBA32) ? AV_PIX_FMT_RGBA :
+                                                                      AV_PIX_FMT_RGB24,
+                                               SWS_FAST_BILINEAR);
+  // the image buffer is RGBA, decoded planes can be converted straight into it
+  m_imgDirectCtx = BKE_ffmpeg_sws_get_context(m_codecCtx->width,
+                                              m_codecCtx->height,
+                                              m_codecCtx->pix_fmt,
+                                              AV_PIX_FMT_RGBA,
+                                              SWS_FAST_BILINEAR);
   m_frameRGB = allocFrameRGB();
 
-  if (!m_imgConvertCtx) {
+  if (!m_imgConvertCtx || !m_frameRGB) {
+    if (m_imgConvertCtx) {
+      BKE_ffmpeg_sws_release_context(m_imgConvertCtx);
+      m_imgConvertCtx = nullptr;
+    }
+    if (m_imgDirectCtx) {
+      BKE_ffmpeg_sws_release_context(m_imgDirectCtx);
+      m_imgDirectCtx = nullptr;
+    }
     avcodec_free_context(&m_codecCtx);
     m_codecCtx = nullptr;
     avformat_close_input(&m_formatCtx);
     m_formatCtx = nullptr;
     av_frame_free(&m_frame);
     m_frame = nullptr;
-    MEM_freeN(m_frameDeinterlaced->data[0]);
     av_frame_free(&m_frameDeinterlaced);
     m_frameDeinterlaced = nullptr;
-    MEM_freeN(m_frameRGB->data[0]);
+    av_frame_free(&m_frameDirect);
+    m_frameDirect = nullptr;
     av_frame_free(&m_frameRGB);
     m_frameRGB = nullptr;
     return -1;
   }
+  m_noCacheFrame.frame = m_frameRGB;
+  m_noCacheFrame.planes = m_frame;
   return 0;
 }
 
@@ -340,8 +393,10 @@ int VideoFFmpeg::openStream(const char *filename,
  * It provides a frame caching service.
  * The main thread is responsible for positioning the frame pointer in the
  * file correctly before calling startCache() which starts this thread.
- * The cache is organized in two layers: 1) a cache of 20-30 undecoded packets to keep
- * memory and CPU low 2) a cache of 5 decoded frames.
+ * The cache is organized in two layers: 1) a ring of 20-30 undecoded packets to keep
+ * memory and CPU low 2) a ring of decoded frames allocated once when the cache starts.
+ * When the frame ring is full the thread sleeps on m_cacheCond until the main thread
+ * releases a frame or asks the thread to stop, there is no polling.
  * If the main thread does not find the frame in the cache (because the video has restarted
  * or because the GE is lagging), it stops the cache with StopCache() (this is a synchronous
  * function: it sends a signal to stop the cache thread and wait for confirmation), then
@@ -352,8 +407,10 @@ void *VideoFFmpeg::cacheThread(void *data)
   VideoFFmpeg *video = (VideoFFmpeg *)data;
   // holds the frame that is being decoded
   CacheFrame *currentFrame = nullptr;
-  CachePacket *cachePacket;
+  AVPacket *cachePacket;
   bool endOfFile = false;
+  // a non blocking stream had no data to give
+  bool readStalled;
   int frameFinished = 0;
   double timeBase = av_q2d(video->m_formatCtx->streams[video->m_videoStream]->time_base);
   int64_t startTs = video->m_formatCtx->streams[video->m_videoStream]->start_time;
@@ -366,25 +423,21 @@ void *VideoFFmpeg::cacheThread(void *data)
     // In case the stream/file contains other stream than the one we are looking for,
     // allow a bit of cycling to get rid quickly of those frames
     frameFinished = 0;
-    while (!endOfFile &&
-           (cachePacket = (CachePacket *)video->m_packetCacheFree.first) != nullptr &&
-           frameFinished < 25) {
+    readStalled = false;
+    while (!endOfFile && video->m_packetCacheCount < CACHE_PACKET_SIZE && frameFinished < 25) {
       // free packet => packet cache is not full yet, just read more
-      if (av_read_frame(video->m_formatCtx, &cachePacket->packet) >= 0) {
-        if (cachePacket->packet.stream_index == video->m_videoStream) {
-          // make sure fresh memory is allocated for the packet and move it to queue
-          AVPacket newPacket;
-          av_packet_ref(&newPacket, &cachePacket->packet);
-          cachePacket->packet = newPacket;
-
-          BLI_remlink(&video->m_packetCacheFree, cachePacket);
-          BLI_addtail(&video->m_packetCacheBase, cachePacket);
+      cachePacket = video->m_packetCache[(video->m_packetCacheHead + video->m_packetCacheCount) %
+                                         CACHE_PACKET_SIZE];
+      if (av_read_frame(video->m_formatCtx, cachePacket) >= 0) {
+        if (cachePacket->stream_index == video->m_videoStream) {
+          // the packet owns its memory, just append it to the ring
+          video->m_packetCacheCount++;
           break;
         }
         else {
           // this is not a good packet for us, just leave it on free queue
           // Note: here we could handle sound packet
-          av_packet_unref(&cachePacket->packet);
+          av_packet_unref(cachePacket);
           frameFinished++;
         }
       }
@@ -392,27 +445,38 @@ void *VideoFFmpeg::cacheThread(void *data)
         if (video->m_isFile)
           // this mark the end of the file
           endOfFile = true;
+        else
+          readStalled = true;
         // if we cannot read a packet, no need to continue
         break;
       }
     }
     // frame cache is also used by main thread, lock
     if (currentFrame == nullptr) {
-      // no current frame being decoded, take free one
+      // no current frame being decoded, take free one at the tail of the ring
       pthread_mutex_lock(&video->m_cacheMutex);
-      if ((currentFrame = (CacheFrame *)video->m_frameCacheFree.first) != nullptr)
-        BLI_remlink(&video->m_frameCacheFree, currentFrame);
+      if (video->m_frameCacheCount < CACHE_FRAME_SIZE) {
+        currentFrame =
+            &video->m_frameCache[(video->m_frameCacheHead + video->m_frameCacheCount) %
+                                 CACHE_FRAME_SIZE];
+      }
+      else if (video->m_packetCacheCount == CACHE_PACKET_SIZE || endOfFile || readStalled) {
+        // nothing to read nor to decode, sleep until the main thread releases a frame
+        while (video->m_frameCacheCount == CACHE_FRAME_SIZE && !video->m_stopThread)
+          pthread_cond_wait(&video->m_cacheCond, &video->m_cacheMutex);
+      }
       pthread_mutex_unlock(&video->m_cacheMutex);
     }
     if (currentFrame != nullptr) {
-      // this frame is out of free and busy queue, we can manipulate it without locking
+      // this frame is out of the ready part of the ring, we can manipulate it without locking
       frameFinished = 0;
-      while (!frameFinished &&
-             (cachePacket = (CachePacket *)video->m_packetCacheBase.first) != nullptr) {
-        BLI_remlink(&video->m_packetCacheBase, cachePacket);
+      while (!frameFinished && video->m_packetCacheCount > 0) {
+        cachePacket = video->m_packetCache[video->m_packetCacheHead];
+        video->m_packetCacheHead = (video->m_packetCacheHead + 1) % CACHE_PACKET_SIZE;
+        video->m_packetCacheCount--;
         // use m_frame because when caching, it is not used in main thread
         // we can't use currentFrame directly because we need to convert to RGB first
-        avcodec_send_packet(video->m_codecCtx, &cachePacket->packet);
+        avcodec_send_packet(video->m_codecCtx, cachePacket);
         frameFinished = avcodec_receive_frame(video->m_codecCtx, video->m_frame) == 0;
 
         if (frameFinished) {
@@ -421,6 +485,7 @@ void *VideoFFmpeg::cacheThread(void *data)
           /* This means the data wasnt read properly, this check stops crashing */
           if (input->data[0] != 0 || input->data[1] != 0 || input->data[2] != 0 ||
               input->data[3] != 0) {
+            currentFrame->direct = false;
             if (video->m_deinterlace) {
               if (av_image_deinterlace((AVFrame *)video->m_frameDeinterlaced,
                                        (const AVFrame *)video->m_frame,
@@ -430,48 +495,57 @@ void *VideoFFmpeg::cacheThread(void *data)
                 input = video->m_frameDeinterlaced;
               }
             }
-            // convert to RGB24
-            sws_scale(video->m_imgConvertCtx,
-                      input->data,
-                      input->linesize,
-                      0,
-                      video->m_codecCtx->height,
-                      currentFrame->frame->data,
-                      currentFrame->frame->linesize);
+            else if (video->m_directEnabled) {
+              // keep a reference on the decoded planes, the main thread converts them
+              // straight into the image buffer
+              av_frame_move_ref(currentFrame->planes, video->m_frame);
+              currentFrame->direct = true;
+            }
+            if (!currentFrame->direct) {
+              // convert to RGB24
+              convertFrame(video->m_cacheConvertCtx, currentFrame->frame, input);
+            }
             // move frame to queue, this frame is necessarily the next one
-            video->m_curPosition = (long)((cachePacket->packet.dts - startTs) *
+            video->m_curPosition = (long)((cachePacket->dts - startTs) *
                                               (video->m_baseFrameRate * timeBase) +
                                           0.5);
             currentFrame->framePosition = video->m_curPosition;
             pthread_mutex_lock(&video->m_cacheMutex);
-            BLI_addtail(&video->m_frameCacheBase, currentFrame);
+            video->m_frameCacheCount++;
             pthread_mutex_unlock(&video->m_cacheMutex);
             currentFrame = nullptr;
           }
         }
-        av_packet_unref(&cachePacket->packet);
-        BLI_addtail(&video->m_packetCacheFree, cachePacket);
+        av_packet_unref(cachePacket);
       }
       if (currentFrame && endOfFile) {
         // no more packet and end of file => put a special frame that indicates that
         currentFrame->framePosition = -1;
+        currentFrame->direct = false;
         pthread_mutex_lock(&video->m_cacheMutex);
-        BLI_addtail(&video->m_frameCacheBase, currentFrame);
+        video->m_frameCacheCount++;
         pthread_mutex_unlock(&video->m_cacheMutex);
         currentFrame = nullptr;
         // no need to stay any longer in this thread
         break;
       }
+      if (currentFrame && readStalled && video->m_packetCacheCount == 0) {
+        // the stream has no data yet, wait a bit unless the main thread wants to stop us
+        struct timespec deadline;
+        timespec_get(&deadline, TIME_UTC);
+        deadline.tv_nsec += 5000000;
+        if (deadline.tv_nsec >= 1000000000) {
+          deadline.tv_sec++;
+          deadline.tv_nsec -= 1000000000;
+        }
+        pthread_mutex_lock(&video->m_cacheMutex);
+        if (!video->m_stopThread)
+          pthread_cond_timedwait(&video->m_cacheCond, &video->m_cacheMutex, &deadline);
+        pthread_mutex_unlock(&video->m_cacheMutex);
+      }
     }
-    // small sleep to avoid unnecessary looping
-    BLI_time_sleep_ms(10);
-  }
-  // before quitting, put back the current frame to queue to allow freeing
-  if (currentFrame) {
-    pthread_mutex_lock(&video->m_cacheMutex);
-    BLI_addtail(&video->m_frameCacheFree, currentFrame);
-    pthread_mutex_unlock(&video->m_cacheMutex);
   }
+  // the current frame was never published, it is freed with the rest of the ring
   return 0;
 }
 
@@ -481,16 +555,27 @@ void *VideoFFmpeg::cacheThread(void *data)
 bool VideoFFmpeg::startCache()
 {
   if (!m_cacheStarted && m_isThreaded) {
+    // the cache thread gets its own scaling context, the main thread keeps using the others
+    m_cacheConvertCtx = BKE_ffmpeg_sws_get_context(m_codecCtx->width,
+                                                   m_codecCtx->height,
+                                                   m_codecCtx->pix_fmt,
+                                                   (m_format == RGBA32) ? AV_PIX_FMT_RGBA :
+                                                                          AV_PIX_FMT_RGB24,
+                                                   SWS_FAST_BILINEAR);
+    if (m_cacheConvertCtx == nullptr)
+      return false;
     m_stopThread = false;
     for (int i = 0; i < CACHE_FRAME_SIZE; i++) {
-      CacheFrame *frame = new CacheFrame();
-      frame->frame = allocFrameRGB();
-      BLI_addtail(&m_frameCacheFree, frame);
+      m_frameCache[i].framePosition = -1;
+      m_frameCache[i].frame = allocFrameRGB();
+      m_frameCache[i].planes = av_frame_alloc();
+      m_frameCache[i].direct = false;
     }
     for (int i = 0; i < CACHE_PACKET_SIZE; i++) {
-      CachePacket *packet = new CachePacket();
-      BLI_addtail(&m_packetCacheFree, packet);
+      m_packetCache[i] = av_packet_alloc();
     }
+    m_frameCacheHead = m_frameCacheCount = 0;
+    m_packetCacheHead = m_packetCacheCount = 0;
     BLI_threadpool_init(&m_thread, cacheThread, 1);
     BLI_threadpool_insert(&m_thread, this);
     m_cacheStarted = true;
@@ -501,48 +586,43 @@ bool VideoFFmpeg::startCache()
 void VideoFFmpeg::stopCache()
 {
   if (m_cacheStarted) {
+    pthread_mutex_lock(&m_cacheMutex);
     m_stopThread = true;
+    pthread_cond_signal(&m_cacheCond);
+    pthread_mutex_unlock(&m_cacheMutex);
     BLI_threadpool_end(&m_thread);
     // now delete the cache
-    CacheFrame *frame;
-    CachePacket *packet;
-    while ((frame = (CacheFrame *)m_frameCacheBase.first) != nullptr) {
-      BLI_remlink(&m_frameCacheBase, frame);
-      MEM_freeN(frame->frame->data[0]);
-      av_free(frame->frame);
-      delete frame;
-    }
-    while ((frame = (CacheFrame *)m_frameCacheFree.first) != nullptr) {
-      BLI_remlink(&m_frameCacheFree, frame);
-      MEM_freeN(frame->frame->data[0]);
-      av_free(frame->frame);
-      delete frame;
-    }
-    while ((packet = (CachePacket *)m_packetCacheBase.first) != nullptr) {
-      BLI_remlink(&m_packetCacheBase, packet);
-      av_packet_unref(&packet->packet);
-      delete packet;
+    for (int i = 0; i < CACHE_FRAME_SIZE; i++) {
+      av_frame_free(&m_frameCache[i].frame);
+      av_frame_free(&m_frameCache[i].planes);
     }
-    while ((packet = (CachePacket *)m_packetCacheFree.first) != nullptr) {
-      BLI_remlink(&m_packetCacheFree, packet);
-      delete packet;
+    for (int i = 0; i < CACHE_PACKET_SIZE; i++) {
+      // free also unreferences the packets still waiting for decoding
+      av_packet_free(&m_packetCache[i]);
     }
+    m_frameCacheHead = m_frameCacheCount = 0;
+    m_packetCacheHead = m_packetCacheCount = 0;
+    BKE_ffmpeg_sws_release_context(m_cacheConvertCtx);
+    m_cacheConvertCtx = nullptr;
     m_cacheStarted = false;
   }
 }
 
-void VideoFFmpeg::releaseFrame(AVFrame *frame)
+void VideoFFmpeg::releaseFrame(CacheFrame *frame)
 {
-  if (frame == m_frameRGB) {
+  if (frame == &m_noCacheFrame) {
     // this is not a frame from the cache, ignore
     return;
   }
-  // this frame MUST be the first one of the queue
+  // this frame MUST be the head of the ring
   pthread_mutex_lock(&m_cacheMutex);
-  CacheFrame *cacheFrame = (CacheFrame *)m_frameCacheBase.first;
-  assert(cacheFrame != nullptr && cacheFrame->frame == frame);
-  BLI_remlink(&m_frameCacheBase, cacheFrame);
-  BLI_addtail(&m_frameCacheFree, cacheFrame);
+  assert(m_frameCacheCount > 0 && &m_frameCache[m_frameCacheHead] == frame);
+  av_frame_unref(frame->planes);
+  frame->direct = false;
+  m_frameCacheHead = (m_frameCacheHead + 1) % CACHE_FRAME_SIZE;
+  m_frameCacheCount--;
+  // wake up the cache thread if it was waiting for a free frame
+  pthread_cond_signal(&m_cacheCond);
   pthread_mutex_unlock(&m_cacheMutex);
 }
 
@@ -803,7 +883,9 @@ void VideoFFmpeg::calcImage(unsigned int texId, double ts)
     long actFrame = (m_isImage) ? m_lastFrame + 1 : long(actTime * actFrameRate());
     // if actual frame differs from last frame
     if (actFrame != m_lastFrame) {
-      AVFrame *frame;
+      CacheFrame *frame;
+      // the cache thread reads this flag when it decodes ahead
+      m_directEnabled = canProcessDirect() && !m_deinterlace;
       // get image
       if ((frame = grabFrame(actFrame)) != nullptr) {
         if (!m_isFile && !m_cacheStarted) {
@@ -820,7 +902,17 @@ void VideoFFmpeg::calcImage(unsigned int texId, double ts)
         // init image, if needed
         init(short(m_codecCtx->width), short(m_codecCtx->height));
         // process image
-        process((BYTE *)(frame->data[0]));
+        if (frame->direct && canProcessDirect()) {
+          // no filter nor scaling, skip the intermediate RGB frame
+          processDirect(frame->planes);
+        }
+        else {
+          if (frame->direct) {
+            // a filter was set after the frame was decoded
+            convertFrame(m_imgConvertCtx, frame->frame, frame->planes);
+          }
+          process((BYTE *)(frame->frame->data[0]));
+        }
         // finished with the frame, release it so that cache can reuse it
         releaseFrame(frame);
         // in case it is an image, automatically stop reading it
@@ -857,7 +949,7 @@ void VideoFFmpeg::setPositions(void)
 }
 
 // position pointer in file, position in second
-AVFrame *VideoFFmpeg::grabFrame(long position)
+VideoFFmpeg::CacheFrame *VideoFFmpeg::grabFrame(long position)
 {
   AVPacket packet;
   int frameFinished;
@@ -871,9 +963,9 @@ AVFrame *VideoFFmpeg::grabFrame(long position)
     // when cache is active, we must not read the file directly
     do {
       pthread_mutex_lock(&m_cacheMutex);
-      frame = (CacheFrame *)m_frameCacheBase.first;
+      frame = (m_frameCacheCount > 0) ? &m_frameCache[m_frameCacheHead] : nullptr;
       pthread_mutex_unlock(&m_cacheMutex);
-      // no need to remove the frame from the queue: the cache thread does not touch the head, only
+      // no need to remove the frame from the ring: the cache thread does not touch the head, only
       // the tail
       if (frame == nullptr) {
         // no frame in cache, in case of file it is an abnormal situation
@@ -893,7 +985,7 @@ AVFrame *VideoFFmpeg::grabFrame(long position)
       // for streaming, always return the next frame,
       // that's what grabFrame does in non cache mode anyway.
       if (m_isStreaming || frame->framePosition == position) {
-        return frame->frame;
+        return frame;
       }
       // for cam, skip old frames to keep image realtime.
       // There should be no risk of clock drift since it all happens on the same CPU
@@ -903,10 +995,7 @@ AVFrame *VideoFFmpeg::grabFrame(long position)
         return nullptr;
       }
       // this frame is not useful, release it
-      pthread_mutex_lock(&m_cacheMutex);
-      BLI_remlink(&m_frameCacheBase, frame);
-      BLI_addtail(&m_frameCacheFree, frame);
-      pthread_mutex_unlock(&m_cacheMutex);
+      releaseFrame(frame);
     } while (true);
   }
   double timeBase = av_q2d(m_formatCtx->streams[m_videoStream]->time_base);
@@ -1023,6 +1112,7 @@ AVFrame *VideoFFmpeg::grabFrame(long position)
           break;
         }
 
+        m_noCacheFrame.direct = false;
         if (m_deinterlace) {
           if (av_image_deinterlace((AVFrame *)m_frameDeinterlaced,
                                    (const AVFrame *)m_frame,
@@ -1032,14 +1122,15 @@ AVFrame *VideoFFmpeg::grabFrame(long position)
             input = m_frameDeinterlaced;
           }
         }
-        // convert to RGB24
-        sws_scale(m_imgConvertCtx,
-                  input->data,
-                  input->linesize,
-                  0,
-                  m_codecCtx->height,
-                  m_frameRGB->data,
-                  m_frameRGB->linesize);
+        else if (m_directEnabled && !m_isThreaded) {
+          // m_frame holds the planes until the next decoding, convert them later.
+          // Not when the cache is about to start as its thread decodes in m_frame.
+          m_noCacheFrame.direct = true;
+        }
+        if (!m_noCacheFrame.direct) {
+          // convert to RGB24
+          convertFrame(m_imgConvertCtx, m_frameRGB, input);
+        }
         av_packet_unref(&packet);
         frameLoaded = true;
         break;
@@ -1057,7 +1148,7 @@ AVFrame *VideoFFmpeg::grabFrame(long position)
         m_isThreaded = false;
       }
     }
-    return m_frameRGB;
+    return &m_noCacheFrame;
   }
   return nullptr;
 }
@@ -1161,6 +1252,29 @@ static int VideoFFmpeg_setDeinterlace(PyImage *self, PyObject *value, void *clos
   return 0;
 }
 
+// get zero copy
+static PyObject *VideoFFmpeg_getZeroCopy(PyImage *self, void *closure)
+{
+  if (getFFmpeg(self)->getZeroCopy())
+    Py_RETURN_TRUE;
+  else
+    Py_RETURN_FALSE;
+}
+
+// set zero copy
+static int VideoFFmpeg_setZeroCopy(PyImage *self, PyObject *value, void *closure)
+{
+  // check parameter, report failure
+  if (value == nullptr || !PyBool_Check(value)) {
+    PyErr_SetString(PyExc_TypeError, "The value must be a bool");
+    return -1;
+  }
+  // set zero copy
+  getFFmpeg(self)->setZeroCopy(value == Py_True);
+  // success
+  return 0;
+}
+
 // methods structure
 static PyMethodDef videoMethods[] = {  // methods from VideoBase class
     {"play", (PyCFunction)Video_play, METH_NOARGS, "Play (restart) video"},
@@ -1219,6 +1333,11 @@ static PyGetSetDef videoGetSets[] = {  // methods from VideoBase class
      (setter)VideoFFmpeg_setDeinterlace,
      (char *)"deinterlace image",
      nullptr},
+    {(char *)"zeroCopy",
+     (getter)VideoFFmpeg_getZeroCopy,
+     (setter)VideoFFmpeg_setZeroCopy,
+     (char *)"convert decoded frames straight into the image when no filter is set",
+     nullptr},
     {nullptr}};
 
 // python type declaration
@@ -13,6 +13,7 @@
 #    include <inttypes.h>
 #  endif
 
+#  include <atomic>
 #  include <pthread.h>
 
 #  include "BLI_blenlib.h"
@@ -77,6 +78,14 @@ class VideoFFmpeg : public VideoBase {
   {
     m_deinterlace = deinterlace;
   }
+  bool getZeroCopy(void)
+  {
+    return m_zeroCopy;
+  }
+  void setZeroCopy(bool zeroCopy)
+  {
+    m_zeroCopy = zeroCopy;
+  }
   char *getImageName(void)
   {
     return (m_isImage) ? (char *)m_imageName.c_str() : nullptr;
@@ -93,6 +102,16 @@ class VideoFFmpeg : public VideoBase {
   AVFrame *m_frameRGB;
   // conversion from raw to RGB is done with sws_scale
   struct SwsContext *m_imgConvertCtx;
+  // conversion from raw to RGBA straight into the image buffer
+  struct SwsContext *m_imgDirectCtx;
+  // conversion from raw to RGB owned by the cache thread
+  struct SwsContext *m_cacheConvertCtx;
+  // frame wrapping the image buffer as destination of the direct conversion
+  AVFrame *m_frameDirect;
+  // allow decoded planes to be converted straight into the image buffer
+  bool m_zeroCopy;
+  // direct conversion is possible, set by main thread and read by cache thread
+  std::atomic<bool> m_directEnabled;
   // should the codec be deinterlaced?
   bool m_deinterlace;
   // number of frame of preseek
@@ -154,38 +173,52 @@ class VideoFFmpeg : public VideoBase {
   /// common function to video file and capture
   int openStream(const char *filename, const AVInputFormat *inputFormat, AVDictionary **formatParams);
 
-  /// check if a frame is available and load it in pFrame, return true if a frame could be
-  /// retrieved
-  AVFrame *grabFrame(long frame);
+  typedef struct {
+    long framePosition;
+    // converted RGB frame, pre-allocated
+    AVFrame *frame;
+    // decoded planes, referenced from the decoder when the frame was not converted
+    AVFrame *planes;
+    // the picture is in planes and still needs to be converted
+    bool direct;
+  } CacheFrame;
+
+  /// check if a frame is available and load it, return nullptr if no frame could be retrieved
+  CacheFrame *grabFrame(long frame);
 
   /// in case of caching, put the frame back in free queue
-  void releaseFrame(AVFrame *frame);
+  void releaseFrame(CacheFrame *frame);
+
+  /// can the decoded planes be converted straight into the image buffer
+  bool canProcessDirect(void);
+  /// convert decoded planes straight into the image buffer
+  void processDirect(const AVFrame *planes);
 
   /// start thread to load the video file/capture/stream
   bool startCache();
   void stopCache();
 
  private:
-  typedef struct {
-    Link link;
-    long framePosition;
-    AVFrame *frame;
-  } CacheFrame;
-  typedef struct {
-    Link link;
-    AVPacket packet;
-  } CachePacket;
-
   bool m_stopThread;
   bool m_cacheStarted;
   ListBase m_thread;
-  ListBase m_frameCacheBase;   // list of frames that are ready
-  ListBase m_frameCacheFree;   // list of frames that are unused
-  ListBase m_packetCacheBase;  // list of packets that are ready for decoding
-  ListBase m_packetCacheFree;  // list of packets that are unused
+  // frame used when the cache is not running
+  CacheFrame m_noCacheFrame;
+  // ring of frames, m_frameCacheCount frames starting at m_frameCacheHead are ready
+  CacheFrame m_frameCache[CACHE_FRAME_SIZE];
+  int m_frameCacheHead;
+  int m_frameCacheCount;
+  // ring of packets ready for decoding, used solely by the cache thread
+  AVPacket *m_packetCache[CACHE_PACKET_SIZE];
+  int m_packetCacheHead;
+  int m_packetCacheCount;
   pthread_mutex_t m_cacheMutex;
+  // signaled when a frame is released or the cache thread must stop
+  pthread_cond_t m_cacheCond;
 
   AVFrame *allocFrameRGB();
+  /// convert decoded planes into a RGB frame
+  static void convertFrame(struct SwsContext *ctx, AVFrame *dst, const AVFrame *src);
   static void *cacheThread(void *);
 };
 